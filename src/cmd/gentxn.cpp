@@ -18,9 +18,15 @@
  */
 
 #include <boost/filesystem.hpp>
+#include <algorithm>
+#include <atomic>
 #include <climits>
 #include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 #include "libCrypto/Schnorr.h"
 #include "libCrypto/Sha2.h"
@@ -48,6 +54,8 @@ std::vector<KeyPairAddress> get_genesis_keypair_and_address() {
   return result;
 }
 
+std::mutex mutexOutput;
+
 void gen_txn_file(const std::string& prefix, const KeyPairAddress& from,
                   const Address& toAddr, const NonceRange& nonce_range) {
   const auto& privKey = std::get<0>(from);
@@ -64,18 +72,23 @@ void gen_txn_file(const std::string& prefix, const KeyPairAddress& from,
   // ".zil";
 
   std::string txn_filename(oss.str());
-  std::ofstream txn_file(txn_filename, std::fstream::binary);
 
+  // Serialize the whole batch first so that the file is written in one go
   std::vector<unsigned char> buf;
+  buf.reserve((end - begin) * Transaction::GetMinSerializedSize());
+  unsigned int curr_offset = 0;
 
   for (auto nonce = begin; nonce < end; nonce++) {
     Transaction txn{0, nonce, toAddr, std::make_pair(privKey, pubKey), nonce, 1,
                     1, {},    {}};
 
-    txn.Serialize(buf, 0);
-    txn_file.write(reinterpret_cast<char*>(buf.data()), buf.size());
+    curr_offset = txn.Serialize(buf, curr_offset);
   }
 
+  std::ofstream txn_file(txn_filename, std::fstream::binary);
+  txn_file.write(reinterpret_cast<char*>(buf.data()), buf.size());
+
+  std::lock_guard<std::mutex> g(mutexOutput);
   if (txn_file) {
     std::cout << "Write to file " << txn_filename << "\n";
   } else {
@@ -84,7 +97,7 @@ void gen_txn_file(const std::string& prefix, const KeyPairAddress& from,
 }
 
 void usage(const std::string& prog) {
-  std::cout << "Usage: " << prog << " [BEGIN [END]]\n";
+  std::cout << "Usage: " << prog << " [BEGIN [END [THREADS]]]\n";
   std::cout << "\n";
   std::cout << "Description:\n";
   std::cout
@@ -95,6 +108,8 @@ void usage(const std::string& prog) {
          "to one random wallet\n";
   std::cout << "\tThe batch size is decided by NUM_TXN_TO_SEND_PER_ACCOUNT "
                "(constants.xml)\n";
+  std::cout << "\tFiles are generated by THREADS threads (default to the "
+               "number of cores)\n";
 }
 
 int main(int argc, char** argv) {
@@ -114,7 +129,14 @@ int main(int argc, char** argv) {
     end = strtoul(argv[2], nullptr, 10);
   }
 
-  if (begin == ULONG_MAX || end == ULONG_MAX || begin > end) {
+  unsigned long num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+  if (argc > 3) {
+    num_threads = strtoul(argv[3], nullptr, 10);
+  }
+
+  if (begin == ULONG_MAX || end == ULONG_MAX || begin > end ||
+      num_threads == 0 || num_threads == ULONG_MAX) {
     usage(prog);
     return 1;
   }
@@ -140,13 +162,32 @@ int main(int argc, char** argv) {
   std::cout << "Batch size (NUM_TXN_TO_SEND_PER_ACCOUNT): " << batch_size
             << "\n";
 
-  for (auto batch = begin; batch < end; batch++) {
-    auto begin_nonce = batch * batch_size;
-    auto end_nonce = (batch + 1) * batch_size;
-    auto nonce_range = std::make_tuple(begin_nonce, end_nonce);
+  std::cout << "Threads: " << num_threads << "\n";
+
+  // Each (batch, account) pair is one file, handed out to the workers in order
+  const unsigned long num_jobs = (end - begin) * fromAccounts.size();
+  std::atomic<unsigned long> next_job{0};
+
+  auto worker = [&]() {
+    for (auto job = next_job++; job < num_jobs; job = next_job++) {
+      auto batch = begin + job / fromAccounts.size();
+      auto& from = fromAccounts[job % fromAccounts.size()];
+
+      auto begin_nonce = batch * batch_size;
+      auto end_nonce = (batch + 1) * batch_size;
+      auto nonce_range = std::make_tuple(begin_nonce, end_nonce);
 
-    for (auto& from : fromAccounts) {
       gen_txn_file(txn_path, from, toAddr, nonce_range);
     }
+  };
+
+  std::vector<std::thread> workers;
+  for (unsigned long i = 1; i < num_threads; i++) {
+    workers.emplace_back(worker);
+  }
+  worker();
+
+  for (auto& t : workers) {
+    t.join();
   }
 }
@@ -79,6 +79,18 @@ unsigned int ReadGpuConstants(std::string propertyName) {
 }
 
 const unsigned int MSG_VERSION{ReadFromConstantsFile("MSG_VERSION")};
+const unsigned int ROOT_HASH_VERSION{
+    ReadFromConstantsFile("ROOT_HASH_VERSION")};
+const unsigned int ROOT_HASH_VERSION_EPOCH{
+    ReadFromConstantsFile("ROOT_HASH_VERSION_EPOCH")};
+const unsigned int STATE_DELTA_VERSION{
+    ReadFromConstantsFile("STATE_DELTA_VERSION")};
+const unsigned int STATE_DELTA_VERSION_EPOCH{
+    ReadFromConstantsFile("STATE_DELTA_VERSION_EPOCH")};
+const unsigned int TXN_SELECTION_VERSION{
+    ReadFromConstantsFile("TXN_SELECTION_VERSION")};
+const unsigned int TXN_SELECTION_VERSION_EPOCH{
+    ReadFromConstantsFile("TXN_SELECTION_VERSION_EPOCH")};
 const unsigned int DS_MULTICAST_CLUSTER_SIZE{
     ReadFromConstantsFile("DS_MULTICAST_CLUSTER_SIZE")};
 const unsigned int COMM_SIZE{ReadFromConstantsFile("COMM_SIZE")};
@@ -112,6 +124,10 @@ const unsigned int NUM_FINAL_BLOCK_PER_POW{
 const unsigned int NUM_DS_KEEP_TX_BODY{
     ReadFromConstantsFile("NUM_DS_KEEP_TX_BODY")};
 const uint32_t MAXMESSAGE{ReadFromConstantsFile("MAXMESSAGE")};
+const uint32_t MAX_MESSAGE_SIZE_IN_BYTES{
+    ReadFromConstantsFile("MAX_MESSAGE_SIZE_IN_BYTES")};
+const unsigned int EXECUTOR_NUM_THREADS{
+    ReadFromConstantsFile("EXECUTOR_NUM_THREADS")};
 const unsigned int MAXSUBMITTXNPERNODE{
     ReadFromConstantsFile("MAXSUBMITTXNPERNODE")};
 const unsigned int MICROBLOCK_GAS_LIMIT{
@@ -188,6 +204,34 @@ const unsigned int NUM_OF_TREEBASED_CHILD_CLUSTERS{
     ReadFromConstantsFile("NUM_OF_TREEBASED_CHILD_CLUSTERS")};
 const unsigned int FETCH_LOOKUP_MSG_MAX_RETRY{
     ReadFromConstantsFile("FETCH_LOOKUP_MSG_MAX_RETRY")};
+const unsigned int MAX_IDLE_CONN_PER_PEER{
+    ReadFromConstantsFile("MAX_IDLE_CONN_PER_PEER")};
+const unsigned int PEER_CONN_IDLE_TIMEOUT_IN_SECONDS{
+    ReadFromConstantsFile("PEER_CONN_IDLE_TIMEOUT_IN_SECONDS")};
+const unsigned int NUM_CPU_MINING_THREADS{
+    ReadFromConstantsFile("NUM_CPU_MINING_THREADS")};
+const unsigned int LEVELDB_BLOCK_CACHE_SIZE_MB{
+    ReadFromConstantsFile("LEVELDB_BLOCK_CACHE_SIZE_MB")};
+const unsigned int LEVELDB_BLOOM_FILTER_BITS_PER_KEY{
+    ReadFromConstantsFile("LEVELDB_BLOOM_FILTER_BITS_PER_KEY")};
+const unsigned int LEVELDB_WRITE_BUFFER_SIZE_MB{
+    ReadFromConstantsFile("LEVELDB_WRITE_BUFFER_SIZE_MB")};
+const unsigned int ACCOUNT_CACHE_SIZE{
+    ReadFromConstantsFile("ACCOUNT_CACHE_SIZE")};
+const unsigned int DB_SYNC_CHUNK_SIZE_KB{
+    ReadFromConstantsFile("DB_SYNC_CHUNK_SIZE_KB")};
+const unsigned int DB_SYNC_NUM_RANGES{
+    ReadFromConstantsFile("DB_SYNC_NUM_RANGES")};
+const unsigned int DB_SYNC_BANDWIDTH_LIMIT_KBPS{
+    ReadFromConstantsFile("DB_SYNC_BANDWIDTH_LIMIT_KBPS")};
+const unsigned int DB_SYNC_CHUNK_TIMEOUT_IN_SECONDS{
+    ReadFromConstantsFile("DB_SYNC_CHUNK_TIMEOUT_IN_SECONDS")};
+const unsigned int DB_SYNC_TIMEOUT_IN_SECONDS{
+    ReadFromConstantsFile("DB_SYNC_TIMEOUT_IN_SECONDS")};
+const unsigned int TRIE_NODE_CACHE_SIZE_MB{
+    ReadFromConstantsFile("TRIE_NODE_CACHE_SIZE_MB")};
+const unsigned int NUM_STATE_ROOTS_TO_KEEP{
+    ReadFromConstantsFile("NUM_STATE_ROOTS_TO_KEEP")};
 
 const bool EXCLUDE_PRIV_IP{ReadFromOptionsFile("EXCLUDE_PRIV_IP") == "true"};
 const bool TEST_NET_MODE{ReadFromOptionsFile("TEST_NET_MODE") == "true"};
@@ -203,6 +247,12 @@ const bool GOSSIP_CUSTOM_ROUNDS_SETTINGS{
     ReadFromOptionsFile("GOSSIP_CUSTOM_ROUNDS_SETTINGS") == "true"};
 const bool BROADCAST_TREEBASED_CLUSTER_MODE{
     ReadFromOptionsFile("BROADCAST_TREEBASED_CLUSTER_MODE") == "true"};
+const bool PERSISTENT_PEER_CONNECTIONS{
+    ReadFromOptionsFile("PERSISTENT_PEER_CONNECTIONS") == "true"};
+const bool ASYNC_TXBODY_COMMIT{ReadFromOptionsFile("ASYNC_TXBODY_COMMIT") ==
+                               "true"};
+const bool LAZY_STATE_LOADING{ReadFromOptionsFile("LAZY_STATE_LOADING") ==
+                              "true"};
 const std::vector<std::string> GENESIS_WALLETS{
     ReadAccountsFromConstantsFile("wallet_address")};
 const std::vector<std::string> GENESIS_KEYS{
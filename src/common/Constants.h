@@ -115,6 +115,12 @@ extern const std::string TXN_PATH;
 extern const std::string DB_HOST;
 
 extern const unsigned int MSG_VERSION;
+extern const unsigned int ROOT_HASH_VERSION;
+extern const unsigned int ROOT_HASH_VERSION_EPOCH;
+extern const unsigned int STATE_DELTA_VERSION;
+extern const unsigned int STATE_DELTA_VERSION_EPOCH;
+extern const unsigned int TXN_SELECTION_VERSION;
+extern const unsigned int TXN_SELECTION_VERSION_EPOCH;
 extern const unsigned int DS_MULTICAST_CLUSTER_SIZE;
 extern const unsigned int COMM_SIZE;
 extern const unsigned int NUM_DS_ELECTION;
@@ -134,6 +140,8 @@ extern const unsigned int DS_MICROBLOCK_CONSENSUS_OBJECT_TIMEOUT;
 extern const unsigned int NUM_FINAL_BLOCK_PER_POW;
 extern const unsigned int NUM_DS_KEEP_TX_BODY;
 extern const uint32_t MAXMESSAGE;
+extern const uint32_t MAX_MESSAGE_SIZE_IN_BYTES;
+extern const unsigned int EXECUTOR_NUM_THREADS;
 extern const unsigned int MAXSUBMITTXNPERNODE;
 extern const unsigned int MICROBLOCK_GAS_LIMIT;
 extern const unsigned int TX_SHARING_CLUSTER_SIZE;
@@ -177,6 +185,20 @@ extern const unsigned int SHARD_DELAY_WAKEUP_IN_SECONDS;
 extern const unsigned int NUM_FORWARDED_BLOCK_RECEIVERS_PER_SHARD;
 extern const unsigned int NUM_OF_TREEBASED_CHILD_CLUSTERS;
 extern const unsigned int FETCH_LOOKUP_MSG_MAX_RETRY;
+extern const unsigned int MAX_IDLE_CONN_PER_PEER;
+extern const unsigned int PEER_CONN_IDLE_TIMEOUT_IN_SECONDS;
+extern const unsigned int NUM_CPU_MINING_THREADS;
+extern const unsigned int LEVELDB_BLOCK_CACHE_SIZE_MB;
+extern const unsigned int LEVELDB_BLOOM_FILTER_BITS_PER_KEY;
+extern const unsigned int LEVELDB_WRITE_BUFFER_SIZE_MB;
+extern const unsigned int ACCOUNT_CACHE_SIZE;
+extern const unsigned int DB_SYNC_CHUNK_SIZE_KB;
+extern const unsigned int DB_SYNC_NUM_RANGES;
+extern const unsigned int DB_SYNC_BANDWIDTH_LIMIT_KBPS;
+extern const unsigned int DB_SYNC_CHUNK_TIMEOUT_IN_SECONDS;
+extern const unsigned int DB_SYNC_TIMEOUT_IN_SECONDS;
+extern const unsigned int TRIE_NODE_CACHE_SIZE_MB;
+extern const unsigned int NUM_STATE_ROOTS_TO_KEEP;
 
 extern const bool TEST_NET_MODE;
 extern const bool EXCLUDE_PRIV_IP;
@@ -190,6 +212,9 @@ extern const bool ARCHIVAL_NODE;
 extern const bool BROADCAST_GOSSIP_MODE;
 extern const bool GOSSIP_CUSTOM_ROUNDS_SETTINGS;
 extern const bool BROADCAST_TREEBASED_CLUSTER_MODE;
+extern const bool PERSISTENT_PEER_CONNECTIONS;
+extern const bool ASYNC_TXBODY_COMMIT;
+extern const bool LAZY_STATE_LOADING;
 
 extern const std::vector<std::string> GENESIS_WALLETS;
 extern const std::vector<std::string> GENESIS_KEYS;
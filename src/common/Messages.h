@@ -91,6 +91,8 @@ enum LookupInstructionType : unsigned char {
   SETTXNFROMLOOKUP = 0x1B,
   GETDIRBLOCKSFROMSEED = 0x1C,
   SETDIRBLOCKSFROMSEED = 0x1D,
+  GETDBCHUNKFROMLOOKUP = 0x1E,
+  SETDBCHUNKFROMLOOKUP = 0x1F,
 
 };
 
@@ -0,0 +1,508 @@
+/*
+ * Copyright (c) 2018 Zilliqa
+ * This source code is being disclosed to you solely for the purpose of your
+ * participation in testing Zilliqa. You may view, compile and run the code for
+ * that purpose and pursuant to the protocols and algorithms that are programmed
+ * into, and intended by, the code. You may not do anything else with the code
+ * without express permission from Zilliqa Research Pte. Ltd., including
+ * modifying or publishing the code (or any part of it), and developing or
+ * forming another public or private blockchain network. This source code is
+ * provided 'as is' and no warranties are given as to title or non-infringement,
+ * merchantability or fitness for purpose and, to the extent permitted by law,
+ * all liability for your use of the code is disclaimed. Some programs in this
+ * code are governed by the GNU General Public License v3.0 (available at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html) ('GPLv3'). The programs that
+ * are governed by GPLv3.0 are those programs that are located in the folders
+ * src/depends and tests/depends and which include a reference to GPLv3 in their
+ * program files.
+ */
+
+#ifndef __UINT256_H__
+#define __UINT256_H__
+
+#include <boost/functional/hash.hpp>
+#include <boost/multiprecision/cpp_int.hpp>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "common/Serializable.h"
+
+/// Fixed-width unsigned 256-bit integer used for balances, nonces and gas.
+///
+/// Stored as four 64-bit limbs, least significant first, so the type is
+/// trivially copyable and never allocates. Arithmetic wraps modulo 2^256 like
+/// boost::multiprecision::uint256_t; the Checked* functions report overflow
+/// instead. Converts implicitly to and from the boost type so the rest of the
+/// code can mix the two.
+class Uint256 {
+  uint64_t m_limbs[4];
+
+  static constexpr unsigned int NUM_LIMBS = 4;
+
+ public:
+  /// Number of bytes in the big-endian encoding.
+  static constexpr unsigned int SIZE = 32;
+
+  constexpr Uint256() : m_limbs{0, 0, 0, 0} {}
+
+  constexpr Uint256(uint64_t value) : m_limbs{value, 0, 0, 0} {}
+
+  constexpr Uint256(uint64_t l3, uint64_t l2, uint64_t l1, uint64_t l0)
+      : m_limbs{l0, l1, l2, l3} {}
+
+  Uint256(const boost::multiprecision::uint256_t& value) : Uint256() {
+    boost::multiprecision::uint256_t v = value;
+    for (unsigned int i = 0; i < NUM_LIMBS; i++) {
+      m_limbs[i] = static_cast<uint64_t>(v & UINT64_MAX);
+      v >>= 64;
+    }
+  }
+
+  operator boost::multiprecision::uint256_t() const {
+    boost::multiprecision::uint256_t result = m_limbs[NUM_LIMBS - 1];
+    for (unsigned int i = NUM_LIMBS - 1; i > 0; i--) {
+      result <<= 64;
+      result |= m_limbs[i - 1];
+    }
+    return result;
+  }
+
+  /// Returns limb i, 0 being the least significant.
+  constexpr uint64_t Limb(unsigned int i) const { return m_limbs[i]; }
+
+  constexpr bool IsZero() const {
+    return (m_limbs[0] | m_limbs[1] | m_limbs[2] | m_limbs[3]) == 0;
+  }
+
+  /// True if the value fits in the lowest limb.
+  constexpr bool FitsUint64() const {
+    return (m_limbs[1] | m_limbs[2] | m_limbs[3]) == 0;
+  }
+
+  /// Index of the highest set bit plus one, 0 for zero.
+  constexpr unsigned int BitLength() const {
+    for (unsigned int i = NUM_LIMBS; i > 0; i--) {
+      if (m_limbs[i - 1] != 0) {
+        return (i - 1) * 64 + 64 - __builtin_clzll(m_limbs[i - 1]);
+      }
+    }
+    return 0;
+  }
+
+  // Comparison
+
+  friend constexpr bool operator==(const Uint256& a, const Uint256& b) {
+    return (a.m_limbs[0] == b.m_limbs[0]) && (a.m_limbs[1] == b.m_limbs[1]) &&
+           (a.m_limbs[2] == b.m_limbs[2]) && (a.m_limbs[3] == b.m_limbs[3]);
+  }
+
+  friend constexpr bool operator!=(const Uint256& a, const Uint256& b) {
+    return !(a == b);
+  }
+
+  friend constexpr bool operator<(const Uint256& a, const Uint256& b) {
+    for (unsigned int i = NUM_LIMBS; i > 0; i--) {
+      if (a.m_limbs[i - 1] != b.m_limbs[i - 1]) {
+        return a.m_limbs[i - 1] < b.m_limbs[i - 1];
+      }
+    }
+    return false;
+  }
+
+  friend constexpr bool operator>(const Uint256& a, const Uint256& b) {
+    return b < a;
+  }
+
+  friend constexpr bool operator<=(const Uint256& a, const Uint256& b) {
+    return !(b < a);
+  }
+
+  friend constexpr bool operator>=(const Uint256& a, const Uint256& b) {
+    return !(a < b);
+  }
+
+  // Checked arithmetic
+
+  /// result = a + b. Returns false, leaving result untouched, on overflow.
+  static constexpr bool CheckedAdd(const Uint256& a, const Uint256& b,
+                                   Uint256& result) {
+    Uint256 sum;
+    uint64_t carry = 0;
+    for (unsigned int i = 0; i < NUM_LIMBS; i++) {
+      const uint64_t s = a.m_limbs[i] + carry;
+      carry = (s < carry) ? 1 : 0;
+      sum.m_limbs[i] = s + b.m_limbs[i];
+      carry += (sum.m_limbs[i] < s) ? 1 : 0;
+    }
+    if (carry != 0) {
+      return false;
+    }
+    result = sum;
+    return true;
+  }
+
+  /// result = a - b. Returns false, leaving result untouched, if b > a.
+  static constexpr bool CheckedSub(const Uint256& a, const Uint256& b,
+                                   Uint256& result) {
+    Uint256 diff;
+    uint64_t borrow = 0;
+    for (unsigned int i = 0; i < NUM_LIMBS; i++) {
+      const uint64_t d = a.m_limbs[i] - b.m_limbs[i];
+      const uint64_t b1 = (a.m_limbs[i] < b.m_limbs[i]) ? 1 : 0;
+      diff.m_limbs[i] = d - borrow;
+      const uint64_t b2 = (d < borrow) ? 1 : 0;
+      borrow = b1 | b2;
+    }
+    if (borrow != 0) {
+      return false;
+    }
+    result = diff;
+    return true;
+  }
+
+  /// result = a * b. Returns false, leaving result untouched, on overflow.
+  static constexpr bool CheckedMul(const Uint256& a, const Uint256& b,
+                                   Uint256& result) {
+    if ((a.BitLength() + b.BitLength()) > 257) {
+      return false;
+    }
+    bool overflow = false;
+    const Uint256 product = Multiply(a, b, overflow);
+    if (overflow) {
+      return false;
+    }
+    result = product;
+    return true;
+  }
+
+  // Wrapping arithmetic
+
+  friend constexpr Uint256 operator+(const Uint256& a, const Uint256& b) {
+    Uint256 sum;
+    uint64_t carry = 0;
+    for (unsigned int i = 0; i < NUM_LIMBS; i++) {
+      const uint64_t s = a.m_limbs[i] + carry;
+      carry = (s < carry) ? 1 : 0;
+      sum.m_limbs[i] = s + b.m_limbs[i];
+      carry += (sum.m_limbs[i] < s) ? 1 : 0;
+    }
+    return sum;
+  }
+
+  friend constexpr Uint256 operator-(const Uint256& a, const Uint256& b) {
+    Uint256 diff;
+    uint64_t borrow = 0;
+    for (unsigned int i = 0; i < NUM_LIMBS; i++) {
+      const uint64_t d = a.m_limbs[i] - b.m_limbs[i];
+      const uint64_t b1 = (a.m_limbs[i] < b.m_limbs[i]) ? 1 : 0;
+      diff.m_limbs[i] = d - borrow;
+      const uint64_t b2 = (d < borrow) ? 1 : 0;
+      borrow = b1 | b2;
+    }
+    return diff;
+  }
+
+  friend constexpr Uint256 operator*(const Uint256& a, const Uint256& b) {
+    bool overflow = false;
+    return Multiply(a, b, overflow);
+  }
+
+  friend constexpr Uint256 operator/(const Uint256& a, const Uint256& b) {
+    Uint256 quotient, remainder;
+    DivMod(a, b, quotient, remainder);
+    return quotient;
+  }
+
+  friend constexpr Uint256 operator%(const Uint256& a, const Uint256& b) {
+    Uint256 quotient, remainder;
+    DivMod(a, b, quotient, remainder);
+    return remainder;
+  }
+
+  friend constexpr Uint256 operator<<(const Uint256& a, unsigned int shift) {
+    Uint256 result;
+    if (shift >= 256) {
+      return result;
+    }
+    const unsigned int limbShift = shift / 64;
+    const unsigned int bitShift = shift % 64;
+    for (unsigned int i = NUM_LIMBS; i > limbShift; i--) {
+      const unsigned int dst = i - 1;
+      const unsigned int src = dst - limbShift;
+      result.m_limbs[dst] = a.m_limbs[src] << bitShift;
+      if ((bitShift != 0) && (src > 0)) {
+        result.m_limbs[dst] |= a.m_limbs[src - 1] >> (64 - bitShift);
+      }
+    }
+    return result;
+  }
+
+  friend constexpr Uint256 operator>>(const Uint256& a, unsigned int shift) {
+    Uint256 result;
+    if (shift >= 256) {
+      return result;
+    }
+    const unsigned int limbShift = shift / 64;
+    const unsigned int bitShift = shift % 64;
+    for (unsigned int dst = 0; dst + limbShift < NUM_LIMBS; dst++) {
+      const unsigned int src = dst + limbShift;
+      result.m_limbs[dst] = a.m_limbs[src] >> bitShift;
+      if ((bitShift != 0) && (src + 1 < NUM_LIMBS)) {
+        result.m_limbs[dst] |= a.m_limbs[src + 1] << (64 - bitShift);
+      }
+    }
+    return result;
+  }
+
+  friend constexpr Uint256 operator&(const Uint256& a, const Uint256& b) {
+    return Uint256(a.m_limbs[3] & b.m_limbs[3], a.m_limbs[2] & b.m_limbs[2],
+                   a.m_limbs[1] & b.m_limbs[1], a.m_limbs[0] & b.m_limbs[0]);
+  }
+
+  friend constexpr Uint256 operator|(const Uint256& a, const Uint256& b) {
+    return Uint256(a.m_limbs[3] | b.m_limbs[3], a.m_limbs[2] | b.m_limbs[2],
+                   a.m_limbs[1] | b.m_limbs[1], a.m_limbs[0] | b.m_limbs[0]);
+  }
+
+  // Mixed operations. Without these, boost's operator templates would claim
+  // calls involving uint256_t and fail to convert Uint256 into a backend, and
+  // integer literals would be ambiguous between the two conversions.
+
+#define UINT256_MIXED_OP(RET, OP)                                        \
+  friend RET operator OP(const Uint256& a,                               \
+                         const boost::multiprecision::uint256_t& b) {    \
+    return a OP Uint256(b);                                              \
+  }                                                                      \
+  friend RET operator OP(const boost::multiprecision::uint256_t& a,      \
+                         const Uint256& b) {                             \
+    return Uint256(a) OP b;                                              \
+  }                                                                      \
+  template <class T, typename std::enable_if<std::is_integral<T>::value, \
+                                             int>::type = 0>             \
+  friend constexpr RET operator OP(const Uint256& a, T b) {              \
+    return a OP Uint256(static_cast<uint64_t>(b));                       \
+  }                                                                      \
+  template <class T, typename std::enable_if<std::is_integral<T>::value, \
+                                             int>::type = 0>             \
+  friend constexpr RET operator OP(T a, const Uint256& b) {              \
+    return Uint256(static_cast<uint64_t>(a)) OP b;                       \
+  }
+
+  UINT256_MIXED_OP(Uint256, +)
+  UINT256_MIXED_OP(Uint256, -)
+  UINT256_MIXED_OP(Uint256, *)
+  UINT256_MIXED_OP(Uint256, /)
+  UINT256_MIXED_OP(Uint256, %)
+  UINT256_MIXED_OP(bool, ==)
+  UINT256_MIXED_OP(bool, !=)
+  UINT256_MIXED_OP(bool, <)
+  UINT256_MIXED_OP(bool, >)
+  UINT256_MIXED_OP(bool, <=)
+  UINT256_MIXED_OP(bool, >=)
+
+#undef UINT256_MIXED_OP
+
+  constexpr Uint256& operator+=(const Uint256& b) { return *this = *this + b; }
+  constexpr Uint256& operator-=(const Uint256& b) { return *this = *this - b; }
+  constexpr Uint256& operator*=(const Uint256& b) { return *this = *this * b; }
+  constexpr Uint256& operator/=(const Uint256& b) { return *this = *this / b; }
+  constexpr Uint256& operator%=(const Uint256& b) { return *this = *this % b; }
+  constexpr Uint256& operator<<=(unsigned int s) { return *this = *this << s; }
+  constexpr Uint256& operator>>=(unsigned int s) { return *this = *this >> s; }
+  constexpr Uint256& operator++() { return *this += 1; }
+  constexpr Uint256& operator--() { return *this -= 1; }
+
+  /// Sets quotient and remainder of a / b. Division by zero gives zero for
+  /// both, matching what callers get after SafeMath rejects it.
+  static constexpr void DivMod(const Uint256& a, const Uint256& b,
+                               Uint256& quotient, Uint256& remainder) {
+    quotient = Uint256();
+    remainder = Uint256();
+    if (b.IsZero()) {
+      return;
+    }
+
+    if (b.FitsUint64()) {
+      // One limb at a time through 128-bit division
+      const uint64_t divisor = b.m_limbs[0];
+      unsigned __int128 rem = 0;
+      for (unsigned int i = NUM_LIMBS; i > 0; i--) {
+        const unsigned __int128 cur = (rem << 64) | a.m_limbs[i - 1];
+        quotient.m_limbs[i - 1] = static_cast<uint64_t>(cur / divisor);
+        rem = cur % divisor;
+      }
+      remainder.m_limbs[0] = static_cast<uint64_t>(rem);
+      return;
+    }
+
+    if (a < b) {
+      remainder = a;
+      return;
+    }
+
+    // Shift-subtract over the bits that can be set in the quotient
+    const unsigned int shift = a.BitLength() - b.BitLength();
+    Uint256 divisor = b << shift;
+    remainder = a;
+    for (unsigned int i = shift + 1; i > 0; i--) {
+      if (remainder >= divisor) {
+        remainder = remainder - divisor;
+        quotient.m_limbs[(i - 1) / 64] |= uint64_t(1) << ((i - 1) % 64);
+      }
+      divisor = divisor >> 1;
+    }
+  }
+
+  // Encoding
+
+  /// Writes the value as SIZE big-endian bytes to out.
+  void ToBigEndian(unsigned char* out) const {
+    for (unsigned int i = 0; i < NUM_LIMBS; i++) {
+      const uint64_t limb = m_limbs[NUM_LIMBS - 1 - i];
+      for (unsigned int j = 0; j < 8; j++) {
+        out[i * 8 + j] = static_cast<unsigned char>(limb >> (56 - j * 8));
+      }
+    }
+  }
+
+  /// Writes the value as SIZE big-endian bytes at offset, growing dst if
+  /// needed.
+  void SerializeBE(std::vector<unsigned char>& dst, unsigned int offset) const {
+    if (dst.size() < offset + SIZE) {
+      dst.resize(offset + SIZE);
+    }
+    ToBigEndian(dst.data() + offset);
+  }
+
+  /// Reads len (at most SIZE) big-endian bytes at offset. Returns zero if src
+  /// is too short, like Serializable::GetNumber.
+  static Uint256 DeserializeBE(const std::vector<unsigned char>& src,
+                               unsigned int offset, unsigned int len = SIZE) {
+    Uint256 result;
+    if ((len > SIZE) || (offset + len > src.size())) {
+      return result;
+    }
+    const unsigned char* in = src.data() + offset;
+    for (unsigned int i = 0; i < len; i++) {
+      const unsigned int bytePos = len - 1 - i;
+      result.m_limbs[bytePos / 8] |= static_cast<uint64_t>(in[i])
+                                     << ((bytePos % 8) * 8);
+    }
+    return result;
+  }
+
+  /// Decimal representation.
+  std::string str() const {
+    if (FitsUint64()) {
+      return std::to_string(m_limbs[0]);
+    }
+
+    // Peel off 19 decimal digits at a time
+    const Uint256 chunk(UINT64_C(10000000000000000000));
+    std::string result;
+    Uint256 rest = *this;
+    while (!rest.FitsUint64()) {
+      Uint256 quotient, remainder;
+      DivMod(rest, chunk, quotient, remainder);
+      std::string digits = std::to_string(remainder.m_limbs[0]);
+      result.insert(0, std::string(19 - digits.size(), '0') + digits);
+      rest = quotient;
+    }
+    return std::to_string(rest.m_limbs[0]) + result;
+  }
+
+  /// Same as boost::multiprecision::number::convert_to.
+  template <class T>
+  T convert_to() const {
+    return static_cast<boost::multiprecision::uint256_t>(*this)
+        .template convert_to<T>();
+  }
+
+ private:
+  static constexpr Uint256 Multiply(const Uint256& a, const Uint256& b,
+                                    bool& overflow) {
+    Uint256 result;
+    overflow = false;
+    for (unsigned int i = 0; i < NUM_LIMBS; i++) {
+      if (a.m_limbs[i] == 0) {
+        continue;
+      }
+      uint64_t carry = 0;
+      for (unsigned int j = 0; j < NUM_LIMBS; j++) {
+        const unsigned __int128 cur =
+            static_cast<unsigned __int128>(a.m_limbs[i]) * b.m_limbs[j] +
+            carry;
+        const uint64_t lo = static_cast<uint64_t>(cur);
+        carry = static_cast<uint64_t>(cur >> 64);
+        if (i + j < NUM_LIMBS) {
+          const uint64_t sum = result.m_limbs[i + j] + lo;
+          carry += (sum < lo) ? 1 : 0;
+          result.m_limbs[i + j] = sum;
+        } else if ((lo != 0) || (carry != 0)) {
+          overflow = true;
+        }
+      }
+      if (carry != 0) {
+        overflow = true;
+      }
+    }
+    return result;
+  }
+};
+
+inline std::ostream& operator<<(std::ostream& os, const Uint256& value) {
+  os << value.str();
+  return os;
+}
+
+inline std::size_t hash_value(const Uint256& value) {
+  std::size_t seed = 0;
+  for (unsigned int i = 0; i < 4; i++) {
+    boost::hash_combine(seed, value.Limb(i));
+  }
+  return seed;
+}
+
+namespace std {
+template <>
+struct hash<Uint256> {
+  size_t operator()(const Uint256& value) const noexcept {
+    return hash_value(value);
+  }
+};
+}  // namespace std
+
+/// Big-endian Uint256 reads and writes without going through shifts per byte.
+template <>
+inline Uint256 Serializable::GetNumber<Uint256>(
+    const std::vector<unsigned char>& src, unsigned int offset,
+    unsigned int numerictype_len) {
+  return Uint256::DeserializeBE(src, offset, numerictype_len);
+}
+
+template <>
+inline void Serializable::SetNumber<Uint256>(std::vector<unsigned char>& dst,
+                                             unsigned int offset,
+                                             Uint256 value,
+                                             unsigned int numerictype_len) {
+  if (numerictype_len == Uint256::SIZE) {
+    value.SerializeBE(dst, offset);
+    return;
+  }
+
+  std::vector<unsigned char> full;
+  value.SerializeBE(full, 0);
+  if (dst.size() < offset + numerictype_len) {
+    dst.resize(offset + numerictype_len);
+  }
+  for (unsigned int i = 0; i < numerictype_len; i++) {
+    dst[offset + numerictype_len - 1 - i] =
+        (i < Uint256::SIZE) ? full[Uint256::SIZE - 1 - i] : 0;
+  }
+}
+
+#endif  // __UINT256_H__
@@ -14,6 +14,8 @@
 * and which include a reference to GPLv3 in their program files.
 **/
 
+#include <algorithm>
+#include <cctype>
 #include <string>
 
 #include <boost/filesystem.hpp>
@@ -36,9 +38,7 @@ LevelDB::LevelDB(const string & dbName, const string & subdirectory)
         boost::filesystem::create_directories("./" + PERSISTENCE_PATH);
     }
 
-    leveldb::Options options;
-    options.max_open_files = 256;
-    options.create_if_missing = true;
+    leveldb::Options options = GetOptions();
 
     leveldb::DB* db;
     leveldb::Status status;
@@ -67,6 +67,183 @@ LevelDB::LevelDB(const string & dbName, const string & subdirectory)
     m_db.reset(db);
 }
 
+leveldb::Options LevelDB::GetOptions()
+{
+    leveldb::Options options;
+    options.max_open_files = 256;
+    options.create_if_missing = true;
+
+    if (LEVELDB_WRITE_BUFFER_SIZE_MB > 0)
+    {
+        options.write_buffer_size = LEVELDB_WRITE_BUFFER_SIZE_MB << 20;
+    }
+
+    if (LEVELDB_BLOCK_CACHE_SIZE_MB > 0)
+    {
+        if (!m_blockCache)
+        {
+            m_blockCache.reset(leveldb::NewLRUCache((size_t)LEVELDB_BLOCK_CACHE_SIZE_MB << 20));
+        }
+        options.block_cache = m_blockCache.get();
+    }
+
+    if (LEVELDB_BLOOM_FILTER_BITS_PER_KEY > 0)
+    {
+        if (!m_filterPolicy)
+        {
+            m_filterPolicy.reset(leveldb::NewBloomFilterPolicy(LEVELDB_BLOOM_FILTER_BITS_PER_KEY));
+        }
+        options.filter_policy = m_filterPolicy.get();
+    }
+
+    return options;
+}
+
+string LevelDB::BlockNumToKey(uint64_t blockNum)
+{
+    string key(sizeof(uint64_t), '\0');
+
+    for (int i = sizeof(uint64_t) - 1; i >= 0; i--)
+    {
+        key[i] = (char)(blockNum & 0xFF);
+        blockNum >>= 8;
+    }
+
+    return key;
+}
+
+uint64_t LevelDB::KeyToBlockNum(const leveldb::Slice & key)
+{
+    uint64_t blockNum = 0;
+
+    for (size_t i = 0; i < key.size() && i < sizeof(uint64_t); i++)
+    {
+        blockNum = (blockNum << 8) | (unsigned char)key[i];
+    }
+
+    return blockNum;
+}
+
+int LevelDB::MigrateBlockNumKeys()
+{
+    auto isDecimal = [](const leveldb::Slice & key)
+    {
+        return key.size() > 0 &&
+               std::all_of(key.data(), key.data() + key.size(), ::isdigit);
+    };
+
+    // New keys start with a zero byte and sort before any decimal key, so
+    // only the last key needs checking to know if anything is left to do
+    std::unique_ptr<leveldb::Iterator> it(m_db->NewIterator(leveldb::ReadOptions()));
+    it->SeekToLast();
+    if (!it->Valid() || !isDecimal(it->key()))
+    {
+        return 0;
+    }
+
+    LOG_GENERAL(INFO, "Migrating block number keys of " << m_dbName);
+
+    const unsigned int BATCH_SIZE = 10000;
+    ldb::WriteBatch batch;
+    unsigned int inBatch = 0;
+    int migrated = 0;
+
+    for (it->SeekToFirst(); it->Valid(); it->Next())
+    {
+        if (!isDecimal(it->key()))
+        {
+            continue;
+        }
+
+        batch.Put(BlockNumToKey(stoull(it->key().ToString())), it->value());
+        batch.Delete(it->key());
+        migrated++;
+
+        if (++inBatch == BATCH_SIZE)
+        {
+            if (!m_db->Write(leveldb::WriteOptions(), &batch).ok())
+            {
+                return -1;
+            }
+            batch.Clear();
+            inBatch = 0;
+        }
+    }
+
+    if (inBatch > 0 && !m_db->Write(leveldb::WriteOptions(), &batch).ok())
+    {
+        return -1;
+    }
+
+    LOG_GENERAL(INFO, "Migrated " << migrated << " keys of " << m_dbName);
+
+    return migrated;
+}
+
+int LevelDB::MigrateHexNodeKeys()
+{
+    // Raw keys can't be told apart from hex ones by sort order, so a marker
+    // records that the database has been migrated
+    const std::string MIGRATED_MARKER = "binaryNodeKeys";
+    if (Exists(MIGRATED_MARKER))
+    {
+        return 0;
+    }
+
+    auto isHex = [](const leveldb::Slice & key)
+    {
+        return key.size() == 2 * dev::h256::size &&
+               std::all_of(key.data(), key.data() + key.size(), ::isxdigit);
+    };
+
+    const unsigned int BATCH_SIZE = 10000;
+    ldb::WriteBatch batch;
+    unsigned int inBatch = 0;
+    int migrated = 0;
+
+    std::unique_ptr<leveldb::Iterator> it(m_db->NewIterator(leveldb::ReadOptions()));
+    for (it->SeekToFirst(); it->Valid(); it->Next())
+    {
+        if (!isHex(it->key()))
+        {
+            continue;
+        }
+
+        if (migrated == 0)
+        {
+            LOG_GENERAL(INFO, "Migrating trie node keys of " << m_dbName);
+        }
+
+        const dev::bytes rawKey = dev::fromHex(it->key().ToString());
+        batch.Put(dev::bytesConstRef(&rawKey), it->value());
+        batch.Delete(it->key());
+        migrated++;
+
+        if (++inBatch == BATCH_SIZE)
+        {
+            if (!m_db->Write(leveldb::WriteOptions(), &batch).ok())
+            {
+                return -1;
+            }
+            batch.Clear();
+            inBatch = 0;
+        }
+    }
+
+    batch.Put(MIGRATED_MARKER, "1");
+    if (!m_db->Write(leveldb::WriteOptions(), &batch).ok())
+    {
+        return -1;
+    }
+
+    if (migrated > 0)
+    {
+        LOG_GENERAL(INFO, "Migrated " << migrated << " keys of " << m_dbName);
+    }
+
+    return migrated;
+}
+
 leveldb::Slice toSlice(boost::multiprecision::uint256_t num)
 {
     dev::FixedHash<32> h;
@@ -103,7 +280,7 @@ string LevelDB::Lookup(const std::string & key) const
 string LevelDB::Lookup(const boost::multiprecision::uint256_t & blockNum) const
 {
     string value;
-    leveldb::Status s = m_db->Get(leveldb::ReadOptions(), blockNum.convert_to<string>(), &value);
+    leveldb::Status s = m_db->Get(leveldb::ReadOptions(), BlockNumToKey(blockNum.convert_to<uint64_t>()), &value);
 
     if (!s.ok())
     {
@@ -155,7 +332,7 @@ int LevelDB::Insert(const boost::multiprecision::uint256_t & blockNum,
                     const vector<unsigned char> & body)
 {
     leveldb::Status s = m_db->Put(leveldb::WriteOptions(), 
-                                  leveldb::Slice(blockNum.convert_to<string>()), 
+                                  leveldb::Slice(BlockNumToKey(blockNum.convert_to<uint64_t>())), 
                                   leveldb::Slice(vector_ref<const unsigned char>(&body[0], 
                                                                                  body.size())));
 
@@ -171,7 +348,7 @@ int LevelDB::Insert(const boost::multiprecision::uint256_t & blockNum,
                     const std::string & body)
 {
     leveldb::Status s = m_db->Put(leveldb::WriteOptions(), 
-                                  leveldb::Slice(blockNum.convert_to<string>()), 
+                                  leveldb::Slice(BlockNumToKey(blockNum.convert_to<uint64_t>())), 
                                   leveldb::Slice(body.c_str(), body.size()));
 
     if (!s.ok())
@@ -244,7 +421,7 @@ int LevelDB::BatchInsert(std::unordered_map<dev::h256, std::pair<std::string, un
     {
         if (i.second.second)
         {
-            batch.Put(leveldb::Slice(i.first.hex()), 
+            batch.Put(i.first.ref(), 
                       leveldb::Slice(i.second.first.data(), i.second.first.size()));
         }
     }
@@ -269,6 +446,116 @@ int LevelDB::BatchInsert(std::unordered_map<dev::h256, std::pair<std::string, un
     return 0;
 }
 
+int LevelDB::BatchInsert(const std::vector<std::pair<dev::h256, std::vector<unsigned char>>> & entries)
+{
+    ldb::WriteBatch batch;
+
+    for (const auto & entry: entries)
+    {
+        batch.Put(leveldb::Slice(entry.first.hex()),
+                  leveldb::Slice(vector_ref<const unsigned char>(entry.second.data(),
+                                                                 entry.second.size())));
+    }
+
+    ldb::Status s = m_db->Write(leveldb::WriteOptions(), &batch);
+
+    if (!s.ok())
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+int LevelDB::BatchInsert(const std::vector<std::pair<std::string, std::string>> & entries)
+{
+    ldb::WriteBatch batch;
+
+    for (const auto & entry: entries)
+    {
+        batch.Put(leveldb::Slice(entry.first), leveldb::Slice(entry.second));
+    }
+
+    ldb::Status s = m_db->Write(leveldb::WriteOptions(), &batch);
+
+    if (!s.ok())
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+int LevelDB::BatchDelete(const std::vector<std::string> & keys)
+{
+    ldb::WriteBatch batch;
+
+    for (const auto & key: keys)
+    {
+        batch.Delete(leveldb::Slice(key));
+    }
+
+    ldb::Status s = m_db->Write(leveldb::WriteOptions(), &batch);
+
+    if (!s.ok())
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+bool LevelDB::GetRange(const std::string & rangeBegin, const std::string & rangeEnd,
+                       const std::string & startAfter, size_t maxBytes,
+                       std::vector<std::pair<std::string, std::string>> & entries,
+                       std::string & lastKey) const
+{
+    std::unique_ptr<leveldb::Iterator> it(m_db->NewIterator(leveldb::ReadOptions()));
+
+    lastKey = startAfter;
+
+    if (startAfter.empty())
+    {
+        it->Seek(rangeBegin);
+    }
+    else
+    {
+        it->Seek(startAfter);
+        if (it->Valid() && it->key() == leveldb::Slice(startAfter))
+        {
+            it->Next();
+        }
+    }
+
+    size_t bytes = 0;
+
+    for (; it->Valid(); it->Next())
+    {
+        if (!rangeEnd.empty() && it->key().compare(rangeEnd) >= 0)
+        {
+            return true;
+        }
+
+        if (bytes >= maxBytes)
+        {
+            return false;
+        }
+
+        entries.emplace_back(it->key().ToString(), it->value().ToString());
+        bytes += it->key().size() + it->value().size();
+        lastKey = entries.back().first;
+    }
+
+    if (!it->status().ok())
+    {
+        LOG_GENERAL(WARNING, "Failed to iterate " << m_dbName << ": "
+                    << it->status().ToString());
+        return false;
+    }
+
+    return true;
+}
+
 bool LevelDB::Exists(const dev::h256 & key) const
 {
     auto ret = Lookup(key);
@@ -300,7 +587,7 @@ int LevelDB::DeleteKey(const dev::h256 & key)
 
 int LevelDB::DeleteKey(const boost::multiprecision::uint256_t & blockNum)
 {
-    leveldb::Status s = m_db->Delete(leveldb::WriteOptions(), ldb::Slice(blockNum.convert_to<string>()));
+    leveldb::Status s = m_db->Delete(leveldb::WriteOptions(), ldb::Slice(BlockNumToKey(blockNum.convert_to<uint64_t>())));
     if (!s.ok())
     {
         return -1;
@@ -320,6 +607,35 @@ int LevelDB::DeleteKey(const std::string & key)
     return 0;
 }
 
+uint64_t LevelDB::GetApproximateSize() const
+{
+    // Keys of every database sort below a run of 0xff longer than any of them
+    leveldb::Range all("", std::string(64, '\xff'));
+    uint64_t size = 0;
+    m_db->GetApproximateSizes(&all, 1, &size);
+    return size;
+}
+
+unsigned int LevelDB::GetReadAmplification() const
+{
+    const unsigned int NUM_LEVELS = 7;
+    unsigned int tables = 0;
+
+    for (unsigned int level = 0; level < NUM_LEVELS; level++)
+    {
+        std::string files;
+        if (!m_db->GetProperty("leveldb.num-files-at-level" + std::to_string(level), &files))
+        {
+            break;
+        }
+
+        unsigned int numFiles = std::stoul(files);
+        tables += (level == 0) ? numFiles : std::min(numFiles, 1u);
+    }
+
+    return tables;
+}
+
 int LevelDB::DeleteDB()
 {
     if (LOOKUP_NODE_MODE)
@@ -370,9 +686,7 @@ bool LevelDB::ResetDBForNormalNode()
     {
         boost::filesystem::remove_all("./" + PERSISTENCE_PATH + "/" + this->m_dbName);
 
-        leveldb::Options options;
-        options.max_open_files = 256;
-        options.create_if_missing = true;
+        leveldb::Options options = GetOptions();
 
         leveldb::DB* db;
 
@@ -414,9 +728,7 @@ bool LevelDB::ResetDBForLookupNode()
     {
         boost::filesystem::remove_all("./" + PERSISTENCE_PATH + "/" + this->m_dbName);
 
-        leveldb::Options options;
-        options.max_open_files = 256;
-        options.create_if_missing = true;
+        leveldb::Options options = GetOptions();
 
         leveldb::DB* db;
 
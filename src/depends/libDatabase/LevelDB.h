@@ -23,7 +23,9 @@
 #include <unordered_map>
 #include <vector>
 
+#include <leveldb/cache.h>
 #include <leveldb/db.h>
+#include <leveldb/filter_policy.h>
 
 #include "depends/common/Common.h"
 #include "depends/common/FixedHash.h"
@@ -38,7 +40,15 @@ class LevelDB
     
     std::string m_subdirectory;
 
+    /// Shared by every reopen of m_db, so declared before it.
+    std::shared_ptr<leveldb::Cache> m_blockCache;
+
+    std::shared_ptr<const leveldb::FilterPolicy> m_filterPolicy;
+
     std::shared_ptr<leveldb::DB> m_db;
+
+    /// Returns the options used to open the database, as tuned in constants.xml.
+    leveldb::Options GetOptions();
     
 public:
 
@@ -48,6 +58,21 @@ public:
     /// Destructor.
     ~LevelDB() = default;
 
+    /// Encodes a block number as a fixed-width big-endian key, so that keys
+    /// sort in numeric order.
+    static std::string BlockNumToKey(uint64_t blockNum);
+
+    /// Decodes a key made by BlockNumToKey.
+    static uint64_t KeyToBlockNum(const leveldb::Slice & key);
+
+    /// Rewrites block number keys stored as decimal strings into the
+    /// BlockNumToKey encoding. Returns the number of keys migrated, or -1.
+    int MigrateBlockNumKeys();
+
+    /// Rewrites trie node keys stored as the hex of their hash into the raw
+    /// 32 bytes of the hash. Returns the number of keys migrated, or -1.
+    int MigrateHexNodeKeys();
+
     /// Returns the reference to the leveldb database instance.
     std::shared_ptr<leveldb::DB> GetDB();
 
@@ -96,6 +121,24 @@ public:
     int BatchInsert(std::unordered_map<dev::h256, std::pair<std::string, unsigned>> & m_main,
                     std::unordered_map<dev::h256, std::pair<dev::bytes, bool>> & m_aux);
 
+    /// Sets the values at the specified keys in a single write batch.
+    int BatchInsert(const std::vector<std::pair<dev::h256, std::vector<unsigned char>>> & entries);
+
+    /// Sets the values at the specified raw keys in a single write batch.
+    int BatchInsert(const std::vector<std::pair<std::string, std::string>> & entries);
+
+    /// Deletes the values at the specified raw keys in a single write batch.
+    int BatchDelete(const std::vector<std::string> & keys);
+
+    /// Reads the keys of [rangeBegin, rangeEnd) that follow startAfter (from
+    /// rangeBegin if empty) in key order, until about maxBytes are read.
+    /// An empty rangeEnd has no upper bound. lastKey is set to the last key
+    /// read. Returns true if the range has been read to its end.
+    bool GetRange(const std::string & rangeBegin, const std::string & rangeEnd,
+                  const std::string & startAfter, size_t maxBytes,
+                  std::vector<std::pair<std::string, std::string>> & entries,
+                  std::string & lastKey) const;
+
     /// Returns true if value corresponding to specified key exists.
     bool Exists(const dev::h256 & key) const;
     bool Exists(const boost::multiprecision::uint256_t & blockNum) const;
@@ -110,6 +153,13 @@ public:
     /// Deletes the value at the specified key.
     int DeleteKey(const std::string & key);
 
+    /// Returns the approximate size on disk of the whole key space in bytes.
+    uint64_t GetApproximateSize() const;
+
+    /// Returns the number of tables a point lookup may have to read in the
+    /// worst case: every file of level 0 plus one per deeper non-empty level.
+    unsigned int GetReadAmplification() const;
+
     /// Deletes the entire database.
     int DeleteDB();
     int DeleteDBForNormalNode();
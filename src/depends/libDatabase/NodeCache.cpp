@@ -0,0 +1,104 @@
+/**
+* Copyright (c) 2018 Zilliqa 
+* This source code is being disclosed to you solely for the purpose of your participation in 
+* testing Zilliqa. You may view, compile and run the code for that purpose and pursuant to 
+* the protocols and algorithms that are programmed into, and intended by, the code. You may 
+* not do anything else with the code without express permission from Zilliqa Research Pte. Ltd., 
+* including modifying or publishing the code (or any part of it), and developing or forming 
+* another public or private blockchain network. This source code is provided ‘as is’ and no 
+* warranties are given as to title or non-infringement, merchantability or fitness for purpose 
+* and, to the extent permitted by law, all liability for your use of the code is disclaimed. 
+* Some programs in this code are governed by the GNU General Public License v3.0 (available at 
+* https://www.gnu.org/licenses/gpl-3.0.en.html) (‘GPLv3’). The programs that are governed by 
+* GPLv3.0 are those programs that are located in the folders src/depends and tests/depends 
+* and which include a reference to GPLv3 in their program files.
+**/
+
+#include "NodeCache.h"
+
+using namespace std;
+
+NodeCache::NodeCache(size_t capacityBytes) : m_shardCapacity(capacityBytes / NUM_SHARDS)
+{
+}
+
+bool NodeCache::Get(const dev::h256 & key, string & value)
+{
+    if (m_shardCapacity == 0)
+    {
+        return false;
+    }
+
+    Shard & shard = GetShard(key);
+    lock_guard<mutex> g(shard.m_mutex);
+
+    auto it = shard.m_index.find(key);
+    if (it == shard.m_index.end())
+    {
+        m_misses++;
+        return false;
+    }
+
+    shard.m_entries.splice(shard.m_entries.begin(), shard.m_entries, it->second);
+    value = it->second->second;
+    m_hits++;
+    return true;
+}
+
+void NodeCache::Put(const dev::h256 & key, const string & value)
+{
+    if (m_shardCapacity == 0 || EntrySize(value) > m_shardCapacity)
+    {
+        return;
+    }
+
+    Shard & shard = GetShard(key);
+    lock_guard<mutex> g(shard.m_mutex);
+
+    auto it = shard.m_index.find(key);
+    if (it != shard.m_index.end())
+    {
+        // A node's value never changes for a given hash
+        shard.m_entries.splice(shard.m_entries.begin(), shard.m_entries, it->second);
+        return;
+    }
+
+    shard.m_entries.emplace_front(key, value);
+    shard.m_index.emplace(key, shard.m_entries.begin());
+    shard.m_bytes += EntrySize(value);
+
+    while (shard.m_bytes > m_shardCapacity)
+    {
+        const auto & oldest = shard.m_entries.back();
+        shard.m_bytes -= EntrySize(oldest.second);
+        shard.m_index.erase(oldest.first);
+        shard.m_entries.pop_back();
+    }
+}
+
+void NodeCache::Erase(const dev::h256 & key)
+{
+    Shard & shard = GetShard(key);
+    lock_guard<mutex> g(shard.m_mutex);
+
+    auto it = shard.m_index.find(key);
+    if (it == shard.m_index.end())
+    {
+        return;
+    }
+
+    shard.m_bytes -= EntrySize(it->second->second);
+    shard.m_entries.erase(it->second);
+    shard.m_index.erase(it);
+}
+
+void NodeCache::Clear()
+{
+    for (auto & shard: m_shards)
+    {
+        lock_guard<mutex> g(shard.m_mutex);
+        shard.m_entries.clear();
+        shard.m_index.clear();
+        shard.m_bytes = 0;
+    }
+}
@@ -0,0 +1,75 @@
+/**
+* Copyright (c) 2018 Zilliqa 
+* This source code is being disclosed to you solely for the purpose of your participation in 
+* testing Zilliqa. You may view, compile and run the code for that purpose and pursuant to 
+* the protocols and algorithms that are programmed into, and intended by, the code. You may 
+* not do anything else with the code without express permission from Zilliqa Research Pte. Ltd., 
+* including modifying or publishing the code (or any part of it), and developing or forming 
+* another public or private blockchain network. This source code is provided ‘as is’ and no 
+* warranties are given as to title or non-infringement, merchantability or fitness for purpose 
+* and, to the extent permitted by law, all liability for your use of the code is disclaimed. 
+* Some programs in this code are governed by the GNU General Public License v3.0 (available at 
+* https://www.gnu.org/licenses/gpl-3.0.en.html) (‘GPLv3’). The programs that are governed by 
+* GPLv3.0 are those programs that are located in the folders src/depends and tests/depends 
+* and which include a reference to GPLv3 in their program files.
+**/
+
+#ifndef __NODECACHE_H__
+#define __NODECACHE_H__
+
+#include <array>
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "depends/common/FixedHash.h"
+
+/// LRU cache of trie node values keyed by their hash, split in shards that
+/// are locked separately so that concurrent lookups rarely contend.
+class NodeCache
+{
+    struct Shard
+    {
+        std::mutex m_mutex;
+        /// Most recently used first
+        std::list<std::pair<dev::h256, std::string>> m_entries;
+        std::unordered_map<dev::h256, std::list<std::pair<dev::h256, std::string>>::iterator> m_index;
+        size_t m_bytes = 0;
+    };
+
+    static const unsigned int NUM_SHARDS = 16;
+
+    std::array<Shard, NUM_SHARDS> m_shards;
+
+    size_t m_shardCapacity;
+
+    std::atomic<uint64_t> m_hits{0};
+    std::atomic<uint64_t> m_misses{0};
+
+    Shard & GetShard(const dev::h256 & key) { return m_shards[key[0] % NUM_SHARDS]; }
+
+    static size_t EntrySize(const std::string & value) { return dev::h256::size + value.size(); }
+
+public:
+
+    /// A capacity of 0 disables the cache.
+    explicit NodeCache(size_t capacityBytes);
+
+    /// Sets value and returns true if the node is cached.
+    bool Get(const dev::h256 & key, std::string & value);
+
+    /// Caches the node, evicting the least recently used ones of its shard.
+    void Put(const dev::h256 & key, const std::string & value);
+
+    void Erase(const dev::h256 & key);
+
+    void Clear();
+
+    uint64_t GetHits() const { return m_hits; }
+
+    uint64_t GetMisses() const { return m_misses; }
+};
+
+#endif // __NODECACHE_H__
@@ -24,17 +24,77 @@
 #include "depends/common/Common.h"
 #include "depends/common/SHA3.h"
 #include "OverlayDB.h"
+#include "libUtils/Logger.h"
 
 using namespace std;
 using namespace dev;
 
+namespace
+{
+	/// Appended to a node's hash to key its reference count, aux data uses 255.
+	const byte REFCOUNT_SUFFIX = 254;
+	const std::string JOURNAL_PREFIX = "pruneJournal:";
+	const std::string JOURNAL_END_KEY = "pruneJournalEnd";
+
+	std::string nodeKey(dev::h256 const& _h)
+	{
+		return std::string((char const*)_h.data(), dev::h256::size);
+	}
+
+	std::string refCountKey(dev::h256 const& _h)
+	{
+		return nodeKey(_h) + (char)REFCOUNT_SUFFIX;
+	}
+
+	std::string journalKey(uint64_t _index)
+	{
+		return JOURNAL_PREFIX + LevelDB::BlockNumToKey(_index);
+	}
+}
+
 namespace dev
 {
 	h256 const EmptyTrie = sha3(rlp(""));
 
+	OverlayDB::OverlayDB(const std::string & dbName):
+		OverlayDB(dbName, NUM_STATE_ROOTS_TO_KEEP)
+	{
+	}
+
+	OverlayDB::OverlayDB(const std::string & dbName, unsigned int keepRoots):
+		m_levelDB(dbName),
+		m_cache((size_t)TRIE_NODE_CACHE_SIZE_MB << 20),
+		m_keepRoots(keepRoots)
+	{
+		if (m_levelDB.MigrateHexNodeKeys() < 0)
+			LOG_GENERAL(WARNING, "Failed to migrate the node keys of " << dbName);
+
+		std::string journalEnd = m_levelDB.Lookup(JOURNAL_END_KEY);
+		if (!journalEnd.empty())
+			m_journalEnd = LevelDB::KeyToBlockNum(journalEnd);
+
+		if (m_keepRoots > 0)
+			m_pruner = thread(&OverlayDB::pruneLoop, this);
+	}
+
+	OverlayDB::~OverlayDB()
+	{
+		{
+			lock_guard<mutex> g(m_pruneMutex);
+			m_stopPruner = true;
+		}
+		m_pruneCondition.notify_all();
+
+		if (m_pruner.joinable())
+			m_pruner.join();
+	}
+
 	void OverlayDB::ResetDB()
 	{
+		lock_guard<mutex> g(m_pruneMutex);
 		m_levelDB.ResetDB();
+		m_cache.Clear();
+		m_journalEnd = 0;
 	}
 
 	void OverlayDB::commit()
@@ -44,7 +104,14 @@ namespace dev
 	// #endif
 		{
 			shared_lock<shared_timed_mutex> lock(x_this);
-			m_levelDB.BatchInsert(m_main, m_aux);
+			if (m_keepRoots == 0)
+				m_levelDB.BatchInsert(m_main, m_aux);
+			else
+				commitCounted();
+
+			for (auto const& i: m_main)
+				if (i.second.second)
+					m_cache.Put(i.first, i.second.first);
 		}
 			
 	// #if DEV_GUARDED_DB
@@ -54,9 +121,179 @@ namespace dev
 			unique_lock<shared_timed_mutex> lock(x_this);
 			m_aux.clear();
 			m_main.clear();
+			m_diskKills.clear();
+		}
+
+		if (m_keepRoots > 0)
+		{
+			{
+				lock_guard<mutex> g(m_pruneMutex);
+				m_prunePending = true;
+			}
+			m_pruneCondition.notify_one();
 		}
 	}
 
+	void OverlayDB::commitCounted()
+	{
+		lock_guard<mutex> g(m_pruneMutex);
+
+		std::unordered_map<h256, int64_t> deltas;
+		for (auto const& i: m_main)
+			if (i.second.second)
+				deltas[i.first] += i.second.second;
+		for (auto const& i: m_diskKills)
+			deltas[i.first] -= i.second;
+
+		std::vector<std::pair<std::string, std::string>> entries;
+		std::string unreferenced;
+
+		for (auto const& i: deltas)
+		{
+			if (i.second == 0)
+				continue;
+
+			std::string count = m_levelDB.Lookup(refCountKey(i.first));
+			if (count.empty())
+			{
+				// Nodes written before reference counts were kept, or synced
+				// from another node, are never pruned
+				if (i.second < 0 || m_levelDB.Exists(nodeKey(i.first)))
+					continue;
+
+				entries.emplace_back(nodeKey(i.first), m_main.at(i.first).first);
+				entries.emplace_back(refCountKey(i.first), LevelDB::BlockNumToKey(i.second));
+				continue;
+			}
+
+			int64_t refs = (int64_t)LevelDB::KeyToBlockNum(count) + i.second;
+			if (refs < 0)
+			{
+				LOG_GENERAL(WARNING, "Node " << i.first << " killed more often than inserted");
+				refs = 0;
+			}
+
+			// Rewritten in case it is unreferenced and about to be pruned
+			if (i.second > 0)
+				entries.emplace_back(nodeKey(i.first), m_main.at(i.first).first);
+			entries.emplace_back(refCountKey(i.first), LevelDB::BlockNumToKey(refs));
+			if (refs == 0)
+				unreferenced += nodeKey(i.first);
+		}
+
+		for (auto const& i: m_aux)
+		{
+			if (i.second.second)
+			{
+				bytes b = i.first.asBytes();
+				b.push_back(255);	// for aux
+				entries.emplace_back(std::string(b.begin(), b.end()),
+					std::string(i.second.first.begin(), i.second.first.end()));
+			}
+		}
+
+		if (!unreferenced.empty())
+			entries.emplace_back(journalKey(m_journalEnd), unreferenced);
+		entries.emplace_back(JOURNAL_END_KEY, LevelDB::BlockNumToKey(m_journalEnd + 1));
+
+		if (m_levelDB.BatchInsert(entries) != 0)
+		{
+			LOG_GENERAL(WARNING, "Failed to commit to " << m_levelDB.GetDBName());
+			return;
+		}
+
+		m_journalEnd++;
+	}
+
+	void OverlayDB::pruneLoop()
+	{
+		while (true)
+		{
+			{
+				unique_lock<mutex> lock(m_pruneMutex);
+				m_pruneCondition.wait(lock, [this] { return m_stopPruner || m_prunePending; });
+				if (m_stopPruner)
+					return;
+				m_prunePending = false;
+			}
+
+			prune();
+		}
+	}
+
+	void OverlayDB::prune()
+	{
+		uint64_t sizeBefore = 0;
+		unsigned int readAmpBefore = 0;
+		uint64_t entries = 0;
+		uint64_t pruned = 0;
+
+		// The lock is taken per journal entry so that commits aren't held up
+		while (true)
+		{
+			lock_guard<mutex> g(m_pruneMutex);
+			if (m_stopPruner || m_journalEnd < m_keepRoots)
+				break;
+
+			std::vector<std::pair<std::string, std::string>> journal;
+			std::string lastKey;
+			m_levelDB.GetRange(journalKey(0), journalKey(m_journalEnd - m_keepRoots + 1), "", 1,
+				journal, lastKey);
+			if (journal.empty())
+				break;
+
+			if (entries++ == 0)
+			{
+				sizeBefore = m_levelDB.GetApproximateSize();
+				readAmpBefore = m_levelDB.GetReadAmplification();
+			}
+
+			pruned += pruneJournalEntry(journal.front());
+		}
+
+		if (entries == 0)
+			return;
+
+		lock_guard<mutex> g(m_pruneMutex);
+		uint64_t const hits = m_cache.GetHits();
+		uint64_t const lookups = hits + m_cache.GetMisses();
+		LOG_GENERAL(INFO, "Pruned " << pruned << " nodes of " << m_levelDB.GetDBName()
+			<< " from " << entries << " roots. Size " << sizeBefore << " -> "
+			<< m_levelDB.GetApproximateSize() << " bytes, read amplification "
+			<< readAmpBefore << " -> " << m_levelDB.GetReadAmplification()
+			<< " tables, node cache hits " << hits << "/" << lookups);
+	}
+
+	uint64_t OverlayDB::pruneJournalEntry(std::pair<std::string, std::string> const& _entry)
+	{
+		std::vector<std::string> keys;
+
+		for (size_t i = 0; i + h256::size <= _entry.second.size(); i += h256::size)
+		{
+			h256 const h((byte const*)_entry.second.data() + i, h256::ConstructFromPointer);
+
+			// Referenced again since it was journaled
+			std::string count = m_levelDB.Lookup(refCountKey(h));
+			if (count.empty() || LevelDB::KeyToBlockNum(count) > 0)
+				continue;
+
+			keys.emplace_back(nodeKey(h));
+			keys.emplace_back(refCountKey(h));
+			m_cache.Erase(h);
+		}
+
+		uint64_t const pruned = keys.size() / 2;
+		keys.emplace_back(_entry.first);
+
+		if (m_levelDB.BatchDelete(keys) != 0)
+		{
+			LOG_GENERAL(WARNING, "Failed to prune " << m_levelDB.GetDBName());
+			return 0;
+		}
+
+		return pruned;
+	}
+
 	bytes OverlayDB::lookupAux(h256 const& _h) const
 	{
 		bytes ret = MemoryDB::lookupAux(_h);
@@ -76,28 +313,33 @@ namespace dev
 		unique_lock<shared_timed_mutex> lock(x_this);
 	// #endif
 		m_main.clear();
+		m_diskKills.clear();
 	}
 
 	std::string OverlayDB::lookup(h256 const& _h) const
 	{
 		std::string ret = MemoryDB::lookup(_h);
-	
-		if (ret.empty())
-			ret = m_levelDB.Lookup(_h);
+		if (!ret.empty() || m_cache.Get(_h, ret))
+			return ret;
+
+		ret = m_levelDB.Lookup(_h.ref());
+		if (!ret.empty())
+			m_cache.Put(_h, ret);
 	
 		return ret;
 	}
 
 	bool OverlayDB::exists(h256 const& _h) const
 	{
-		if (MemoryDB::exists(_h))
-			return true;
-
-		return m_levelDB.Exists(_h);
+		return !lookup(_h).empty();
 	}
 
 	void OverlayDB::kill(h256 const& _h)
 	{
-		MemoryDB::kill(_h);
+		if (!MemoryDB::kill(_h) && m_keepRoots > 0)
+		{
+			unique_lock<shared_timed_mutex> lock(x_this);
+			m_diskKills[_h]++;
+		}
 	}
-}
\ No newline at end of file
+}
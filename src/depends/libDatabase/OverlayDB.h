@@ -19,13 +19,17 @@
 #ifndef __OVERLAYDB_H__
 #define __OVERLAYDB_H__
 
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <thread>
 
 #include "common/Constants.h"
 #include "depends/common/Common.h"
 #include "depends/common/RLP.h"
 #include "LevelDB.h"
 #include "MemoryDB.h"
+#include "NodeCache.h"
 
 namespace dev
 {
@@ -33,8 +37,10 @@ namespace dev
 	class OverlayDB: public MemoryDB
 	{
 	public:
-		explicit OverlayDB(const std::string & dbName): m_levelDB(dbName) {}
-		~OverlayDB() = default;
+		explicit OverlayDB(const std::string & dbName);
+		/// Prunes the nodes unreferenced for keepRoots commits, or never if 0.
+		OverlayDB(const std::string & dbName, unsigned int keepRoots);
+		~OverlayDB();
 
 		void ResetDB();
 
@@ -47,10 +53,42 @@ namespace dev
 
 		bytes lookupAux(h256 const& _h) const;
 
+		/// Returns the backing database, e.g. to copy its nodes in bulk.
+		LevelDB& levelDB() { return m_levelDB; }
+
 	private:
 		using MemoryDB::clear;
 
+		/// Writes the pending nodes along with their reference counts, and
+		/// journals the nodes no longer referenced. Caller holds x_this.
+		void commitCounted();
+
+		void pruneLoop();
+		/// Deletes the journaled nodes that are still unreferenced once
+		/// NUM_STATE_ROOTS_TO_KEEP roots have been committed after them.
+		void prune();
+		uint64_t pruneJournalEntry(std::pair<std::string, std::string> const& _entry);
+
 		LevelDB m_levelDB;
+
+		mutable NodeCache m_cache;
+
+		/// Kills of nodes that are only on disk, applied to their persisted
+		/// reference counts on commit.
+		std::unordered_map<h256, unsigned> m_diskKills;
+
+		/// 0 when pruning is off and reference counts aren't kept.
+		const unsigned int m_keepRoots;
+
+		/// Number of commits, i.e. state roots, journaled so far.
+		uint64_t m_journalEnd = 0;
+
+		/// Serialises commits, pruning and resets of the database.
+		std::mutex m_pruneMutex;
+		std::condition_variable m_pruneCondition;
+		bool m_prunePending = false;
+		bool m_stopPruner = false;
+		std::thread m_pruner;
 	};
 }
 
@@ -20,6 +20,7 @@
 #include "ConsensusCommon.h"
 #include "common/Constants.h"
 #include "common/Messages.h"
+#include "libCrypto/AggregateKeyCache.h"
 #include "libMessage/Messenger.h"
 #include "libMessage/ZilliqaMessage.pb.h"
 #include "libNetwork/P2PComm.h"
@@ -111,14 +112,10 @@ bool ConsensusCommon::VerifyMessage(const vector<unsigned char>& msg,
 PubKey ConsensusCommon::AggregateKeys(const vector<bool> peer_map) {
   LOG_MARKER();
 
-  vector<PubKey> keys;
-  deque<pair<PubKey, Peer>>::const_iterator j = m_committee.begin();
-  for (unsigned int i = 0; i < peer_map.size(); i++, j++) {
-    if (peer_map.at(i)) {
-      keys.emplace_back(j->first);
-    }
-  }
-  shared_ptr<PubKey> result = MultiSig::AggregatePubKeys(keys);
+  shared_ptr<const PubKey> result = AggregateKeyCache::GetInstance().Aggregate(
+      m_committee,
+      [](const pair<PubKey, Peer>& kv) -> const PubKey& { return kv.first; },
+      peer_map);
   if (result == nullptr) {
     return PubKey();
   }
@@ -227,7 +227,7 @@ bool ConsensusLeader::ProcessMessageCommitFailure(
     auto main_func = [this]() mutable -> void {
       m_shardCommitFailureHandlerFunc(m_commitFailureMap);
     };
-    DetachedFunction(1, main_func);
+    DetachedFunction(Executor::CONSENSUS, 1, main_func);
   }
 
   return true;
@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2018 Zilliqa
+ * This source code is being disclosed to you solely for the purpose of your
+ * participation in testing Zilliqa. You may view, compile and run the code for
+ * that purpose and pursuant to the protocols and algorithms that are programmed
+ * into, and intended by, the code. You may not do anything else with the code
+ * without express permission from Zilliqa Research Pte. Ltd., including
+ * modifying or publishing the code (or any part of it), and developing or
+ * forming another public or private blockchain network. This source code is
+ * provided 'as is' and no warranties are given as to title or non-infringement,
+ * merchantability or fitness for purpose and, to the extent permitted by law,
+ * all liability for your use of the code is disclaimed. Some programs in this
+ * code are governed by the GNU General Public License v3.0 (available at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html) ('GPLv3'). The programs that
+ * are governed by GPLv3.0 are those programs that are located in the folders
+ * src/depends and tests/depends and which include a reference to GPLv3 in their
+ * program files.
+ */
+
+#include <algorithm>
+
+#include "AggregateKeyCache.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+AggregateKeyCache& AggregateKeyCache::GetInstance() {
+  static AggregateKeyCache cache;
+  return cache;
+}
+
+shared_ptr<const PubKey> AggregateKeyCache::Aggregate(
+    const vector<const PubKey*>& members, const vector<bool>& bitmap) {
+  if (members.size() != bitmap.size() ||
+      find(bitmap.begin(), bitmap.end(), true) == bitmap.end()) {
+    LOG_GENERAL(WARNING, "Nothing to aggregate, committee size = "
+                             << members.size()
+                             << ", bitmap size = " << bitmap.size());
+    return nullptr;
+  }
+
+  shared_ptr<Committee> committee = FindCommittee(members);
+
+  if (committee == nullptr) {
+    committee = MakeCommittee(members);
+    if (committee == nullptr) {
+      return nullptr;
+    }
+
+    lock_guard<mutex> g(m_mutexCommittees);
+    m_committees.emplace_front(committee);
+    if (m_committees.size() > MAX_COMMITTEES) {
+      m_committees.pop_back();
+    }
+  } else {
+    lock_guard<mutex> g(m_mutexCommittees);
+    auto it = committee->m_aggregates.find(bitmap);
+    if (it != committee->m_aggregates.end()) {
+      return it->second;
+    }
+  }
+
+  // The committee itself is immutable, so this needs no lock
+  shared_ptr<const PubKey> aggregate = Derive(*committee, bitmap);
+  if (aggregate == nullptr) {
+    return nullptr;
+  }
+
+  lock_guard<mutex> g(m_mutexCommittees);
+  if (committee->m_aggregates.size() >= MAX_AGGREGATES) {
+    committee->m_aggregates.clear();
+  }
+  committee->m_aggregates.emplace(bitmap, aggregate);
+
+  return aggregate;
+}
+
+void AggregateKeyCache::Clear() {
+  lock_guard<mutex> g(m_mutexCommittees);
+  m_committees.clear();
+}
+
+shared_ptr<AggregateKeyCache::Committee> AggregateKeyCache::FindCommittee(
+    const vector<const PubKey*>& members) {
+  lock_guard<mutex> g(m_mutexCommittees);
+
+  for (auto it = m_committees.begin(); it != m_committees.end(); it++) {
+    const auto& cached = (*it)->m_members;
+    if (cached.size() != members.size() ||
+        !equal(cached.begin(), cached.end(), members.begin(),
+               [](const array<unsigned char, PUB_KEY_SIZE>& compressed,
+                  const PubKey* key) {
+                 return compressed == key->m_compressed;
+               })) {
+      continue;
+    }
+
+    m_committees.splice(m_committees.begin(), m_committees, it);
+    return m_committees.front();
+  }
+
+  return nullptr;
+}
+
+shared_ptr<AggregateKeyCache::Committee> AggregateKeyCache::MakeCommittee(
+    const vector<const PubKey*>& members) {
+  const Curve& curve = Schnorr::GetInstance().GetCurve();
+
+  unique_ptr<BN_CTX, void (*)(BN_CTX*)> ctx(BN_CTX_new(), BN_CTX_free);
+  if (ctx == nullptr) {
+    LOG_GENERAL(WARNING, "Memory allocation failure");
+    return nullptr;
+  }
+
+  auto committee = make_shared<Committee>();
+  committee->m_members.reserve(members.size());
+  committee->m_keys.reserve(members.size());
+  committee->m_negatedKeys.reserve(members.size());
+
+  for (const PubKey* key : members) {
+    committee->m_members.emplace_back(key->m_compressed);
+    committee->m_keys.emplace_back(*key);
+    committee->m_negatedKeys.emplace_back(*key);
+
+    PubKey& negated = committee->m_negatedKeys.back();
+    if (EC_POINT_invert(curve.m_group.get(), negated.m_P.get(), ctx.get()) ==
+        0) {
+      LOG_GENERAL(WARNING, "Pubkey negation failed");
+      return nullptr;
+    }
+    negated.UpdateCompressed();
+
+    if (committee->m_keys.size() == 1) {
+      committee->m_sum = *key;
+    } else if (EC_POINT_add(curve.m_group.get(), committee->m_sum.m_P.get(),
+                            committee->m_sum.m_P.get(), key->m_P.get(),
+                            ctx.get()) == 0) {
+      LOG_GENERAL(WARNING, "Pubkey aggregation failed");
+      return nullptr;
+    }
+  }
+  committee->m_sum.UpdateCompressed();
+
+  LOG_GENERAL(INFO, "Cached the aggregate key of a committee of "
+                        << members.size());
+
+  return committee;
+}
+
+shared_ptr<const PubKey> AggregateKeyCache::Derive(
+    const Committee& committee, const vector<bool>& bitmap) {
+  const Curve& curve = Schnorr::GetInstance().GetCurve();
+
+  unique_ptr<BN_CTX, void (*)(BN_CTX*)> ctx(BN_CTX_new(), BN_CTX_free);
+  if (ctx == nullptr) {
+    LOG_GENERAL(WARNING, "Memory allocation failure");
+    return nullptr;
+  }
+
+  // Co-signature bitmaps are mostly full, so usually it is cheaper to take
+  // the absent members out of the committee sum than to add the present ones
+  const size_t numPresent = count(bitmap.begin(), bitmap.end(), true);
+  const bool subtractAbsent = numPresent * 2 > bitmap.size();
+
+  shared_ptr<PubKey> aggregate;
+  if (subtractAbsent) {
+    aggregate = make_shared<PubKey>(committee.m_sum);
+  }
+
+  for (unsigned int i = 0; i < bitmap.size(); i++) {
+    if (bitmap[i] == subtractAbsent) {
+      continue;
+    }
+
+    const PubKey& term =
+        subtractAbsent ? committee.m_negatedKeys[i] : committee.m_keys[i];
+    if (aggregate == nullptr) {
+      aggregate = make_shared<PubKey>(term);
+    } else if (EC_POINT_add(curve.m_group.get(), aggregate->m_P.get(),
+                            aggregate->m_P.get(), term.m_P.get(),
+                            ctx.get()) == 0) {
+      LOG_GENERAL(WARNING, "Pubkey aggregation failed");
+      return nullptr;
+    }
+  }
+  aggregate->UpdateCompressed();
+
+  return aggregate;
+}
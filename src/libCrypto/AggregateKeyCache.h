@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2018 Zilliqa
+ * This source code is being disclosed to you solely for the purpose of your
+ * participation in testing Zilliqa. You may view, compile and run the code for
+ * that purpose and pursuant to the protocols and algorithms that are programmed
+ * into, and intended by, the code. You may not do anything else with the code
+ * without express permission from Zilliqa Research Pte. Ltd., including
+ * modifying or publishing the code (or any part of it), and developing or
+ * forming another public or private blockchain network. This source code is
+ * provided 'as is' and no warranties are given as to title or non-infringement,
+ * merchantability or fitness for purpose and, to the extent permitted by law,
+ * all liability for your use of the code is disclaimed. Some programs in this
+ * code are governed by the GNU General Public License v3.0 (available at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html) ('GPLv3'). The programs that
+ * are governed by GPLv3.0 are those programs that are located in the folders
+ * src/depends and tests/depends and which include a reference to GPLv3 in their
+ * program files.
+ */
+
+#ifndef __AGGREGATEKEYCACHE_H__
+#define __AGGREGATEKEYCACHE_H__
+
+#include <array>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "Schnorr.h"
+
+/// Aggregates the public keys of the committee members set in a co-signature
+/// bitmap. The sum of each recently seen committee is computed once, and an
+/// aggregate is derived from it by subtracting the few members who did not
+/// sign. Aggregates are also remembered per bitmap, since CS1 and CS2 of the
+/// same block are checked more than once.
+class AggregateKeyCache {
+ public:
+  /// Committees kept before the least recently used one is dropped.
+  static constexpr unsigned int MAX_COMMITTEES = 8;
+
+  /// Aggregates kept per committee before they are all dropped.
+  static constexpr unsigned int MAX_AGGREGATES = 64;
+
+  /// Returns the singleton AggregateKeyCache instance.
+  static AggregateKeyCache& GetInstance();
+
+  /// Returns the aggregate of the keys of the committee members whose bit is
+  /// set in bitmap, or nullptr if none is set or the sizes differ. keyOf
+  /// returns the PubKey of a committee member.
+  template <class Committee, class KeyOf>
+  std::shared_ptr<const PubKey> Aggregate(const Committee& committee,
+                                          const KeyOf& keyOf,
+                                          const std::vector<bool>& bitmap) {
+    std::vector<const PubKey*> members;
+    members.reserve(committee.size());
+    for (const auto& member : committee) {
+      members.emplace_back(&keyOf(member));
+    }
+    return Aggregate(members, bitmap);
+  }
+
+  /// Returns the aggregate of members[i] for each i set in bitmap.
+  std::shared_ptr<const PubKey> Aggregate(
+      const std::vector<const PubKey*>& members,
+      const std::vector<bool>& bitmap);
+
+  /// Drops all the cached committees.
+  void Clear();
+
+ private:
+  AggregateKeyCache() = default;
+  ~AggregateKeyCache() = default;
+
+  AggregateKeyCache(AggregateKeyCache const&) = delete;
+  void operator=(AggregateKeyCache const&) = delete;
+
+  struct Committee {
+    std::vector<std::array<unsigned char, PUB_KEY_SIZE>> m_members;
+    std::vector<PubKey> m_keys;
+    std::vector<PubKey> m_negatedKeys;
+    PubKey m_sum;
+    std::unordered_map<std::vector<bool>, std::shared_ptr<const PubKey>>
+        m_aggregates;
+  };
+
+  static std::shared_ptr<Committee> MakeCommittee(
+      const std::vector<const PubKey*>& members);
+
+  static std::shared_ptr<const PubKey> Derive(const Committee& committee,
+                                              const std::vector<bool>& bitmap);
+
+  std::shared_ptr<Committee> FindCommittee(
+      const std::vector<const PubKey*>& members);
+
+  std::mutex m_mutexCommittees;
+  /// Most recently used first.
+  std::list<std::shared_ptr<Committee>> m_committees;
+};
+
+#endif  // __AGGREGATEKEYCACHE_H__
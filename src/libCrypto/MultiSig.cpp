@@ -566,6 +566,7 @@ shared_ptr<PubKey> MultiSig::AggregatePubKeys(const vector<PubKey>& pubkeys) {
       return nullptr;
     }
   }
+  aggregatedPubkey->UpdateCompressed();
 
   return aggregatedPubkey;
 }
@@ -29,7 +29,10 @@
 #include <openssl/obj_mac.h>
 #include "Sha2.h"
 
+#include <algorithm>
 #include <array>
+#include <condition_variable>
+#include <cstring>
 
 #include "Schnorr.h"
 #include "libUtils/Logger.h"
@@ -267,6 +270,7 @@ PubKey::PubKey()
     : m_P(EC_POINT_new(Schnorr::GetInstance().GetCurve().m_group.get()),
           EC_POINT_clear_free),
       m_initialized(false) {
+  m_compressed.fill(0x00);
   if (m_P == nullptr) {
     LOG_GENERAL(WARNING, "Memory allocation failure");
     // throw exception();
@@ -277,6 +281,7 @@ PubKey::PubKey(const PrivKey& privkey)
     : m_P(EC_POINT_new(Schnorr::GetInstance().GetCurve().m_group.get()),
           EC_POINT_clear_free),
       m_initialized(false) {
+  m_compressed.fill(0x00);
   if (m_P == nullptr) {
     LOG_GENERAL(WARNING, "Memory allocation failure");
     // throw exception();
@@ -300,10 +305,12 @@ PubKey::PubKey(const PrivKey& privkey)
     }
 
     m_initialized = true;
+    UpdateCompressed();
   }
 }
 
 PubKey::PubKey(const vector<unsigned char>& src, unsigned int offset) {
+  m_compressed.fill(0x00);
   if (Deserialize(src, offset) != 0) {
     LOG_GENERAL(WARNING, "We failed to init PubKey.");
   }
@@ -312,7 +319,8 @@ PubKey::PubKey(const vector<unsigned char>& src, unsigned int offset) {
 PubKey::PubKey(const PubKey& src)
     : m_P(EC_POINT_new(Schnorr::GetInstance().GetCurve().m_group.get()),
           EC_POINT_clear_free),
-      m_initialized(false) {
+      m_initialized(false),
+      m_compressed(src.m_compressed) {
   if (m_P == nullptr) {
     LOG_GENERAL(WARNING, "Memory allocation failure");
     // throw exception();
@@ -328,6 +336,13 @@ PubKey::PubKey(const PubKey& src)
   }
 }
 
+PubKey::PubKey(PubKey&& src) noexcept
+    : m_P(std::move(src.m_P)),
+      m_initialized(src.m_initialized),
+      m_compressed(src.m_compressed) {
+  src.m_initialized = false;
+}
+
 PubKey::~PubKey() {}
 
 bool PubKey::Initialized() const { return m_initialized; }
@@ -335,7 +350,10 @@ bool PubKey::Initialized() const { return m_initialized; }
 unsigned int PubKey::Serialize(vector<unsigned char>& dst,
                                unsigned int offset) const {
   if (m_initialized) {
-    ECPOINTSerialize::SetNumber(dst, offset, PUB_KEY_SIZE, m_P);
+    if (dst.size() < offset + PUB_KEY_SIZE) {
+      dst.resize(offset + PUB_KEY_SIZE);
+    }
+    copy(m_compressed.begin(), m_compressed.end(), dst.begin() + offset);
   }
 
   return PUB_KEY_SIZE;
@@ -349,8 +367,10 @@ int PubKey::Deserialize(const vector<unsigned char>& src, unsigned int offset) {
     if (m_P == nullptr) {
       LOG_GENERAL(WARNING, "Deserialization failure");
       m_initialized = false;
+      m_compressed.fill(0x00);
     } else {
       m_initialized = true;
+      UpdateCompressed();
     }
   } catch (const std::exception& e) {
     LOG_GENERAL(WARNING, "Error with PubKey::Deserialize." << ' ' << e.what());
@@ -360,67 +380,49 @@ int PubKey::Deserialize(const vector<unsigned char>& src, unsigned int offset) {
 }
 
 PubKey& PubKey::operator=(const PubKey& src) {
+  if (m_P == nullptr) {
+    // Moved-from key
+    m_P.reset(EC_POINT_new(Schnorr::GetInstance().GetCurve().m_group.get()),
+              EC_POINT_clear_free);
+  }
   m_initialized = (EC_POINT_copy(m_P.get(), src.m_P.get()) == 1);
+  m_compressed = src.m_compressed;
   return *this;
 }
 
-bool PubKey::operator<(const PubKey& r) const {
-  unique_ptr<BN_CTX, void (*)(BN_CTX*)> ctx(BN_CTX_new(), BN_CTX_free);
-  if (ctx == nullptr) {
-    LOG_GENERAL(WARNING, "Memory allocation failure");
-    // throw exception();
-    return false;
-  }
-
-  shared_ptr<BIGNUM> lhs_bnvalue(
-      EC_POINT_point2bn(Schnorr::GetInstance().GetCurve().m_group.get(),
-                        m_P.get(), POINT_CONVERSION_COMPRESSED, NULL,
-                        ctx.get()),
-      BN_clear_free);
-  shared_ptr<BIGNUM> rhs_bnvalue(
-      EC_POINT_point2bn(Schnorr::GetInstance().GetCurve().m_group.get(),
-                        r.m_P.get(), POINT_CONVERSION_COMPRESSED, NULL,
-                        ctx.get()),
-      BN_clear_free);
+PubKey& PubKey::operator=(PubKey&& src) noexcept {
+  swap(m_P, src.m_P);
+  swap(m_initialized, src.m_initialized);
+  swap(m_compressed, src.m_compressed);
+  return *this;
+}
 
+bool PubKey::operator<(const PubKey& r) const {
   return (m_initialized && r.m_initialized &&
-          (BN_cmp(lhs_bnvalue.get(), rhs_bnvalue.get()) == -1));
+          (memcmp(m_compressed.data(), r.m_compressed.data(), PUB_KEY_SIZE) <
+           0));
 }
 
 bool PubKey::operator>(const PubKey& r) const {
-  unique_ptr<BN_CTX, void (*)(BN_CTX*)> ctx(BN_CTX_new(), BN_CTX_free);
-  if (ctx == nullptr) {
-    LOG_GENERAL(WARNING, "Memory allocation failure");
-    // throw exception();
-    return false;
-  }
-
-  shared_ptr<BIGNUM> lhs_bnvalue(
-      EC_POINT_point2bn(Schnorr::GetInstance().GetCurve().m_group.get(),
-                        m_P.get(), POINT_CONVERSION_COMPRESSED, NULL,
-                        ctx.get()),
-      BN_clear_free);
-  shared_ptr<BIGNUM> rhs_bnvalue(
-      EC_POINT_point2bn(Schnorr::GetInstance().GetCurve().m_group.get(),
-                        r.m_P.get(), POINT_CONVERSION_COMPRESSED, NULL,
-                        ctx.get()),
-      BN_clear_free);
-
   return (m_initialized && r.m_initialized &&
-          (BN_cmp(lhs_bnvalue.get(), rhs_bnvalue.get()) == 1));
+          (memcmp(m_compressed.data(), r.m_compressed.data(), PUB_KEY_SIZE) >
+           0));
 }
 
 bool PubKey::operator==(const PubKey& r) const {
-  unique_ptr<BN_CTX, void (*)(BN_CTX*)> ctx(BN_CTX_new(), BN_CTX_free);
-  if (ctx == nullptr) {
-    LOG_GENERAL(WARNING, "Memory allocation failure");
-    // throw exception();
-    return false;
-  }
-
   return (m_initialized && r.m_initialized &&
-          (EC_POINT_cmp(Schnorr::GetInstance().GetCurve().m_group.get(),
-                        m_P.get(), r.m_P.get(), ctx.get()) == 0));
+          (memcmp(m_compressed.data(), r.m_compressed.data(), PUB_KEY_SIZE) ==
+           0));
+}
+
+void PubKey::UpdateCompressed() {
+  if (EC_POINT_point2oct(Schnorr::GetInstance().GetCurve().m_group.get(),
+                         m_P.get(), POINT_CONVERSION_COMPRESSED,
+                         m_compressed.data(), PUB_KEY_SIZE,
+                         NULL) != PUB_KEY_SIZE) {
+    LOG_GENERAL(WARNING, "Failed to compress public key");
+    m_compressed.fill(0x00);
+  }
 }
 
 Signature::Signature()
@@ -462,6 +464,13 @@ Signature::Signature(const Signature& src)
   }
 }
 
+Signature::Signature(Signature&& src) noexcept
+    : m_r(std::move(src.m_r)),
+      m_s(std::move(src.m_s)),
+      m_initialized(src.m_initialized) {
+  src.m_initialized = false;
+}
+
 Signature::~Signature() {}
 
 bool Signature::Initialized() const { return m_initialized; }
@@ -507,18 +516,50 @@ int Signature::Deserialize(const vector<unsigned char>& src,
 }
 
 Signature& Signature::operator=(const Signature& src) {
+  if ((m_r == nullptr) || (m_s == nullptr)) {
+    // Moved-from signature
+    m_r.reset(BN_new(), BN_clear_free);
+    m_s.reset(BN_new(), BN_clear_free);
+  }
   m_initialized = ((BN_copy(m_r.get(), src.m_r.get()) == m_r.get()) &&
                    (BN_copy(m_s.get(), src.m_s.get()) == m_s.get()));
   return *this;
 }
 
+Signature& Signature::operator=(Signature&& src) noexcept {
+  swap(m_r, src.m_r);
+  swap(m_s, src.m_s);
+  swap(m_initialized, src.m_initialized);
+  return *this;
+}
+
 bool Signature::operator==(const Signature& r) const {
   return (m_initialized && r.m_initialized &&
           ((BN_cmp(m_r.get(), r.m_r.get()) == 0) &&
            (BN_cmp(m_s.get(), r.m_s.get()) == 0)));
 }
 
-Schnorr::Schnorr() {}
+namespace {
+/// Scratch objects for one thread's signature verifications, so that
+/// concurrent calls to Schnorr::Verify don't share any OpenSSL state.
+struct VerifyContext {
+  unique_ptr<BN_CTX, void (*)(BN_CTX*)> m_ctx;
+  unique_ptr<BIGNUM, void (*)(BIGNUM*)> m_challenge;
+  unique_ptr<EC_POINT, void (*)(EC_POINT*)> m_Q;
+
+  VerifyContext(const EC_GROUP* group)
+      : m_ctx(BN_CTX_new(), BN_CTX_free),
+        m_challenge(BN_new(), BN_clear_free),
+        m_Q(EC_POINT_new(group), EC_POINT_clear_free) {}
+
+  bool Initialized() const {
+    return (m_ctx != nullptr) && (m_challenge != nullptr) && (m_Q != nullptr);
+  }
+};
+}  // namespace
+
+Schnorr::Schnorr()
+    : m_verifyPool(max(thread::hardware_concurrency(), 1u), "VerifyPool") {}
 
 Schnorr::~Schnorr() {}
 
@@ -548,7 +589,8 @@ bool Schnorr::Sign(const vector<unsigned char>& message, unsigned int offset,
                    unsigned int size, const PrivKey& privkey,
                    const PubKey& pubkey, Signature& result) {
   // LOG_MARKER();
-  lock_guard<mutex> g(m_mutexSchnorr);
+  // No lock needed: the curve is only read and all the scratch objects below
+  // belong to this call, so signatures can be made in parallel
 
   // Initial checks
 
@@ -718,7 +760,9 @@ bool Schnorr::Verify(const vector<unsigned char>& message, unsigned int offset,
                      unsigned int size, const Signature& toverify,
                      const PubKey& pubkey) {
   // LOG_MARKER();
-  lock_guard<mutex> g(m_mutexSchnorr);
+
+  // No lock is needed here: the curve is only read, and all scratch state
+  // lives in the calling thread's VerifyContext
 
   // Initial checks
 
@@ -760,13 +804,12 @@ bool Schnorr::Verify(const vector<unsigned char>& message, unsigned int offset,
     bool err2 = false;
 
     // Regenerate the commitmment part of the signature
-    unique_ptr<BIGNUM, void (*)(BIGNUM*)> challenge_built(BN_new(),
-                                                          BN_clear_free);
-    unique_ptr<EC_POINT, void (*)(EC_POINT*)> Q(
-        EC_POINT_new(m_curve.m_group.get()), EC_POINT_clear_free);
-    unique_ptr<BN_CTX, void (*)(BN_CTX*)> ctx(BN_CTX_new(), BN_CTX_free);
+    thread_local VerifyContext vctx(m_curve.m_group.get());
+    BIGNUM* challenge_built = vctx.m_challenge.get();
+    EC_POINT* Q = vctx.m_Q.get();
+    BN_CTX* ctx = vctx.m_ctx.get();
 
-    if ((challenge_built != nullptr) && (ctx != nullptr) && (Q != nullptr)) {
+    if (vctx.Initialized()) {
       // 1. Check if r,s is in [1, ..., order-1]
       err2 = (BN_is_zero(toverify.m_r.get()) ||
               (BN_cmp(toverify.m_r.get(), m_curve.m_order.get()) != -1));
@@ -786,8 +829,8 @@ bool Schnorr::Verify(const vector<unsigned char>& message, unsigned int offset,
 
       // 2. Compute Q = sG + r*kpub
       err2 =
-          (EC_POINT_mul(m_curve.m_group.get(), Q.get(), toverify.m_s.get(),
-                        pubkey.m_P.get(), toverify.m_r.get(), ctx.get()) == 0);
+          (EC_POINT_mul(m_curve.m_group.get(), Q, toverify.m_s.get(),
+                        pubkey.m_P.get(), toverify.m_r.get(), ctx) == 0);
       err = err || err2;
       if (err2) {
         LOG_GENERAL(WARNING, "Commit regenerate failed");
@@ -795,7 +838,7 @@ bool Schnorr::Verify(const vector<unsigned char>& message, unsigned int offset,
       }
 
       // 3. If Q = O (the neutral point), return 0;
-      err2 = (EC_POINT_is_at_infinity(m_curve.m_group.get(), Q.get()));
+      err2 = (EC_POINT_is_at_infinity(m_curve.m_group.get(), Q));
       err = err || err2;
       if (err2) {
         LOG_GENERAL(WARNING, "Commit at infinity");
@@ -804,7 +847,7 @@ bool Schnorr::Verify(const vector<unsigned char>& message, unsigned int offset,
 
       // 4. r' = H(Q, kpub, m)
       // 4.1 Convert the committment to octets first
-      err2 = (EC_POINT_point2oct(m_curve.m_group.get(), Q.get(),
+      err2 = (EC_POINT_point2oct(m_curve.m_group.get(), Q,
                                  POINT_CONVERSION_COMPRESSED, buf.data(),
                                  PUBKEY_COMPRESSED_SIZE_BYTES,
                                  NULL) != PUBKEY_COMPRESSED_SIZE_BYTES);
@@ -839,7 +882,7 @@ bool Schnorr::Verify(const vector<unsigned char>& message, unsigned int offset,
       vector<unsigned char> digest = sha2.Finalize();
 
       // 5. return r' == r
-      err2 = (BN_bin2bn(digest.data(), digest.size(), challenge_built.get()) ==
+      err2 = (BN_bin2bn(digest.data(), digest.size(), challenge_built) ==
               NULL);
       err = err || err2;
       if (err2) {
@@ -847,8 +890,8 @@ bool Schnorr::Verify(const vector<unsigned char>& message, unsigned int offset,
         return false;
       }
 
-      err2 = (BN_nnmod(challenge_built.get(), challenge_built.get(),
-                       m_curve.m_order.get(), NULL) == 0);
+      err2 = (BN_nnmod(challenge_built, challenge_built,
+                       m_curve.m_order.get(), ctx) == 0);
       err = err || err2;
       if (err2) {
         LOG_GENERAL(WARNING, "Challenge rebuild mod failed");
@@ -861,13 +904,69 @@ bool Schnorr::Verify(const vector<unsigned char>& message, unsigned int offset,
       // throw exception();
       return false;
     }
-    return (!err) && (BN_cmp(challenge_built.get(), toverify.m_r.get()) == 0);
+    return (!err) && (BN_cmp(challenge_built, toverify.m_r.get()) == 0);
   } catch (const std::exception& e) {
     LOG_GENERAL(WARNING, "Error with Schnorr::Verify." << ' ' << e.what());
     return false;
   }
 }
 
+bool Schnorr::BatchVerify(const vector<VerifyEntry>& entries,
+                          vector<bool>& results) {
+  // LOG_MARKER();
+
+  // The signature is (challenge, response) and doesn't carry the commitment
+  // point, which has to be rebuilt and hashed per signature. So signatures
+  // can't be folded into one random-linear-combination check; instead each
+  // two-term multiplication sG + rP runs on its own verification thread.
+
+  const unsigned int numEntries = entries.size();
+  const unsigned int numThreads = m_verifyPool.GetNumThreads();
+  const unsigned int MIN_ENTRIES_PER_JOB = 16;
+
+  vector<unsigned char> valid(numEntries, 0);
+
+  auto verifyRange = [this, &entries, &valid](unsigned int begin,
+                                              unsigned int end) -> void {
+    for (unsigned int i = begin; i < end; i++) {
+      const auto& entry = entries.at(i);
+      valid.at(i) = Verify(get<0>(entry), get<1>(entry), get<2>(entry));
+    }
+  };
+
+  if ((numThreads <= 1) || (numEntries < 2 * MIN_ENTRIES_PER_JOB)) {
+    verifyRange(0, numEntries);
+  } else {
+    const unsigned int numJobs =
+        min(numThreads, numEntries / MIN_ENTRIES_PER_JOB);
+    const unsigned int perJob = (numEntries + numJobs - 1) / numJobs;
+
+    mutex mutexJobsLeft;
+    condition_variable cvJobsLeft;
+    unsigned int jobsLeft = numJobs;
+
+    for (unsigned int job = 0; job < numJobs; job++) {
+      const unsigned int begin = job * perJob;
+      const unsigned int end = min(numEntries, begin + perJob);
+      m_verifyPool.AddJob([&, begin, end]() -> void {
+        verifyRange(begin, end);
+
+        lock_guard<mutex> g(mutexJobsLeft);
+        if (--jobsLeft == 0) {
+          cvJobsLeft.notify_all();
+        }
+      });
+    }
+
+    unique_lock<mutex> g(mutexJobsLeft);
+    cvJobsLeft.wait(g, [&jobsLeft] { return jobsLeft == 0; });
+  }
+
+  results.assign(valid.begin(), valid.end());
+  return all_of(valid.begin(), valid.end(),
+                [](unsigned char v) { return v != 0; });
+}
+
 void Schnorr::PrintPoint(const EC_POINT* point) {
   LOG_MARKER();
   lock_guard<mutex> g(m_mutexSchnorr);
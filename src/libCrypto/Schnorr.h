@@ -24,13 +24,16 @@
 #include <openssl/ec.h>
 
 #include <array>
+#include <boost/functional/hash.hpp>
 #include <memory>
 #include <mutex>
+#include <tuple>
 #include <vector>
 
 #include "common/Constants.h"
 #include "common/Serializable.h"
 #include "libUtils/DataConversion.h"
+#include "libUtils/ThreadPool.h"
 
 /// Stores the NID_secp256k1 curve parameters for the elliptic curve scheme used
 /// in Zilliqa.
@@ -131,6 +134,9 @@ struct PubKey : public Serializable {
   /// Flag to indicate if parameters have been initialized.
   bool m_initialized;
 
+  /// Compressed encoding of m_P, used for comparisons and hashing.
+  std::array<unsigned char, PUB_KEY_SIZE> m_compressed;
+
   /// Default constructor for an uninitialized key.
   PubKey();
 
@@ -143,6 +149,9 @@ struct PubKey : public Serializable {
   /// Copy constructor.
   PubKey(const PubKey&);
 
+  /// Move constructor.
+  PubKey(PubKey&& src) noexcept;
+
   /// Destructor.
   ~PubKey();
 
@@ -159,6 +168,9 @@ struct PubKey : public Serializable {
   /// Assignment operator.
   PubKey& operator=(const PubKey& src);
 
+  /// Move assignment operator.
+  PubKey& operator=(PubKey&& src) noexcept;
+
   /// Less-than comparison operator (for sorting keys in lookup table).
   bool operator<(const PubKey& r) const;
 
@@ -168,6 +180,9 @@ struct PubKey : public Serializable {
   /// Equality operator.
   bool operator==(const PubKey& r) const;
 
+  /// Recomputes m_compressed. Call after modifying m_P directly.
+  void UpdateCompressed();
+
   /// Utility std::string conversion function for public key info.
   explicit operator std::string() const {
     return "0x" + DataConversion::SerializableToHexStr(*this);
@@ -179,6 +194,17 @@ inline std::ostream& operator<<(std::ostream& os, const PubKey& p) {
   return os;
 }
 
+// define its hash function in order to used as key in map
+namespace std {
+template <>
+struct hash<PubKey> {
+  size_t operator()(PubKey const& pubKey) const noexcept {
+    return boost::hash_range(pubKey.m_compressed.begin(),
+                             pubKey.m_compressed.end());
+  }
+};
+}  // namespace std
+
 /// Stores information on an EC-Schnorr signature.
 struct Signature : public Serializable {
   /// Challenge scalar.
@@ -199,6 +225,9 @@ struct Signature : public Serializable {
   /// Copy constructor.
   Signature(const Signature&);
 
+  /// Move constructor.
+  Signature(Signature&& src) noexcept;
+
   /// Destructor.
   ~Signature();
 
@@ -215,6 +244,9 @@ struct Signature : public Serializable {
   /// Assignment operator.
   Signature& operator=(const Signature&);
 
+  /// Move assignment operator.
+  Signature& operator=(Signature&& src) noexcept;
+
   /// Equality comparison operator.
   bool operator==(const Signature& r) const;
 
@@ -233,6 +265,9 @@ inline std::ostream& operator<<(std::ostream& os, const Signature& s) {
 class Schnorr {
   Curve m_curve;
 
+  /// Parallel jobs of BatchVerify.
+  ThreadPool m_verifyPool;
+
   Schnorr();
   ~Schnorr();
 
@@ -277,6 +312,16 @@ class Schnorr {
               unsigned int size, const Signature& toverify,
               const PubKey& pubkey);
 
+  /// Message, signature and public key of one signature to check.
+  using VerifyEntry =
+      std::tuple<std::vector<unsigned char>, Signature, PubKey>;
+
+  /// Checks many signatures at once, spread over the verification threads.
+  /// results[i] holds the outcome for entries[i]. Returns true if all are
+  /// valid.
+  bool BatchVerify(const std::vector<VerifyEntry>& entries,
+                   std::vector<bool>& results);
+
   /// Utility function for printing EC_POINT coordinates.
   void PrintPoint(const EC_POINT* point);
 };
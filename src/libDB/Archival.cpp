@@ -73,7 +73,7 @@ void Archival::InitSync() {
       }
     }
   };
-  DetachedFunction(1, func);
+  DetachedFunction(DetachedFunction::LongRunning(), 1, func);
 }
 
 bool Archival::Execute(
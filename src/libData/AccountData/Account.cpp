@@ -41,7 +41,7 @@ Account::Account(const vector<unsigned char>& src, unsigned int offset) {
   }
 }
 
-Account::Account(const uint256_t& balance, const uint256_t& nonce)
+Account::Account(const Uint256& balance, const Uint256& nonce)
     : m_balance(balance),
       m_nonce(nonce),
       m_storageRoot(h256()),
@@ -118,11 +118,11 @@ unsigned int Account::Serialize(vector<unsigned char>& dst,
   unsigned int curOffset = offset;
 
   // Balance
-  SetNumber<uint256_t>(dst, curOffset, m_balance, UINT256_SIZE);
+  SetNumber<Uint256>(dst, curOffset, m_balance, UINT256_SIZE);
   // LOG_GENERAL(INFO, "balance: " << m_balance);
   curOffset += UINT256_SIZE;
   // Nonce
-  SetNumber<uint256_t>(dst, curOffset, m_nonce, UINT256_SIZE);
+  SetNumber<Uint256>(dst, curOffset, m_nonce, UINT256_SIZE);
   // LOG_GENERAL(INFO, "nonce: " << m_nonce);
   curOffset += UINT256_SIZE;
   // Storage Root
@@ -201,11 +201,11 @@ int Account::DeserializeAddOffset(const vector<unsigned char>& src,
 
   try {
     // Balance
-    m_balance = GetNumber<uint256_t>(src, offset, UINT256_SIZE);
+    m_balance = GetNumber<Uint256>(src, offset, UINT256_SIZE);
     // LOG_GENERAL(INFO, "balance: " << m_balance);
     offset += UINT256_SIZE;
     // Nonce
-    m_nonce = GetNumber<uint256_t>(src, offset, UINT256_SIZE);
+    m_nonce = GetNumber<Uint256>(src, offset, UINT256_SIZE);
     // LOG_GENERAL(INFO, "nonce: " << m_nonce);
     offset += UINT256_SIZE;
     // Storage Root
@@ -320,23 +320,24 @@ unsigned int Account::SerializeDelta(vector<unsigned char>& dst,
   unsigned int curOffset = offset;
 
   // Balance Delta
-  int256_t balanceDelta =
-      int256_t(newAccount.GetBalance()) - int256_t(oldAccount->GetBalance());
-  // LOG_GENERAL(INFO, "Balance Delta: " << balanceDelta);
+  const Uint256& newBalance = newAccount.GetBalance();
+  const Uint256& oldBalance = oldAccount->GetBalance();
+  const bool balanceIncreased = newBalance > oldBalance;
   // Sign
-  dst.push_back(balanceDelta > 0 ? NumberSign::POSITIVE : NumberSign::NEGATIVE);
+  dst.push_back(balanceIncreased ? NumberSign::POSITIVE : NumberSign::NEGATIVE);
   curOffset += 1;
-  uint256_t balanceDeltaNum(abs(balanceDelta));
+  const Uint256 balanceDeltaNum =
+      balanceIncreased ? newBalance - oldBalance : oldBalance - newBalance;
   // Number
-  SetNumber<uint256_t>(dst, curOffset, balanceDeltaNum, UINT256_SIZE);
+  SetNumber<Uint256>(dst, curOffset, balanceDeltaNum, UINT256_SIZE);
   curOffset += UINT256_SIZE;
 
   // Nonce Delta
-  uint256_t nonceDelta = newAccount.GetNonce() - oldAccount->GetNonce();
+  const Uint256 nonceDelta = newAccount.GetNonce() - oldAccount->GetNonce();
   // LOG_GENERAL(INFO,
   //             "newNonce: " << newAccount.GetNonce()
   //                          << " oldNonce: " << oldAccount->GetNonce());
-  SetNumber<uint256_t>(dst, curOffset, nonceDelta, UINT256_SIZE);
+  SetNumber<Uint256>(dst, curOffset, nonceDelta, UINT256_SIZE);
   // LOG_GENERAL(INFO, "Nonce Delta: " << nonceDelta);
   curOffset += UINT256_SIZE;
 
@@ -443,15 +444,15 @@ int Account::DeserializeDelta(const vector<unsigned char>& src,
     unsigned char numsign = src[offset];
     offset += 1;
     // Num
-    uint256_t balanceDeltaNum = GetNumber<uint256_t>(src, offset, UINT256_SIZE);
+    Uint256 balanceDeltaNum = GetNumber<Uint256>(src, offset, UINT256_SIZE);
     offset += UINT256_SIZE;
     int balanceDelta = (numsign == NumberSign::POSITIVE)
-                           ? (int)balanceDeltaNum
-                           : 0 - (int)balanceDeltaNum;
+                           ? balanceDeltaNum.convert_to<int>()
+                           : 0 - balanceDeltaNum.convert_to<int>();
     // LOG_GENERAL(INFO, "balanceDelta: " << balanceDelta);
     account.ChangeBalance(balanceDelta);
     // Nonce Delta
-    uint256_t nonceDelta = GetNumber<uint256_t>(src, offset, UINT256_SIZE);
+    Uint256 nonceDelta = GetNumber<Uint256>(src, offset, UINT256_SIZE);
     // LOG_GENERAL(INFO, "nonceDelta: " << nonceDelta);
     account.IncreaseNonceBy(nonceDelta);
     offset += UINT256_SIZE;
@@ -572,16 +573,16 @@ int Account::DeserializeDelta(const vector<unsigned char>& src,
   return 0;
 }
 
-bool Account::IncreaseBalance(const uint256_t& delta) {
-  return SafeMath<uint256_t>::add(m_balance, delta, m_balance);
+bool Account::IncreaseBalance(const Uint256& delta) {
+  return SafeMath<Uint256>::add(m_balance, delta, m_balance);
 }
 
-bool Account::DecreaseBalance(const uint256_t& delta) {
+bool Account::DecreaseBalance(const Uint256& delta) {
   if (m_balance < delta) {
     return false;
   }
 
-  return SafeMath<uint256_t>::sub(m_balance, delta, m_balance);
+  return SafeMath<Uint256>::sub(m_balance, delta, m_balance);
 }
 
 bool Account::ChangeBalance(const int256_t& delta) {
@@ -594,7 +595,7 @@ bool Account::IncreaseNonce() {
   return true;
 }
 
-bool Account::IncreaseNonceBy(const uint256_t& nonceDelta) {
+bool Account::IncreaseNonceBy(const Uint256& nonceDelta) {
   m_nonce += nonceDelta;
   return true;
 }
@@ -751,13 +752,13 @@ Address Account::GetAddressFromPublicKey(const PubKey& pubKey) {
 }
 
 Address Account::GetAddressForContract(const Address& sender,
-                                       const uint256_t& nonce) {
+                                       const Uint256& nonce) {
   Address address;
 
   SHA2<HASH_TYPE::HASH_VARIANT_256> sha2;
   sha2.Update(sender.asBytes());
   vector<unsigned char> nonceBytes;
-  SetNumber<uint256_t>(nonceBytes, 0, nonce, UINT256_SIZE);
+  SetNumber<Uint256>(nonceBytes, 0, nonce, UINT256_SIZE);
   sha2.Update(nonceBytes);
 
   const vector<unsigned char>& output = sha2.Finalize();
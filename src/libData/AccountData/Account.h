@@ -29,6 +29,7 @@
 #include "Address.h"
 #include "common/Constants.h"
 #include "common/Serializable.h"
+#include "common/Uint256.h"
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-parameter"
@@ -45,8 +46,8 @@ template <class KeyType, class DB>
 using AccountTrieDB = dev::SpecificTrieDB<dev::GenericTrieDB<DB>, KeyType>;
 
 class Account : public Serializable {
-  boost::multiprecision::uint256_t m_balance;
-  boost::multiprecision::uint256_t m_nonce;
+  Uint256 m_balance;
+  Uint256 m_nonce;
   dev::h256 m_storageRoot, m_prevRoot;
   dev::h256 m_codeHash;
   // The associated code for this account.
@@ -66,8 +67,7 @@ class Account : public Serializable {
   Account(const std::vector<unsigned char>& src, unsigned int offset);
 
   /// Constructor for a account.
-  Account(const boost::multiprecision::uint256_t& balance,
-          const boost::multiprecision::uint256_t& nonce);
+  Account(const Uint256& balance, const Uint256& nonce);
 
   /// Returns true if account is a contract account
   bool isContract() const { return m_codeHash != dev::h256(); }
@@ -101,29 +101,25 @@ class Account : public Serializable {
   }
 
   /// Increases account balance by the specified delta amount.
-  bool IncreaseBalance(const boost::multiprecision::uint256_t& delta);
+  bool IncreaseBalance(const Uint256& delta);
 
   /// Decreases account balance by the specified delta amount.
-  bool DecreaseBalance(const boost::multiprecision::uint256_t& delta);
+  bool DecreaseBalance(const Uint256& delta);
 
   bool ChangeBalance(const boost::multiprecision::int256_t& delta);
 
-  void SetBalance(const boost::multiprecision::uint256_t& balance) {
-    m_balance = balance;
-  }
+  void SetBalance(const Uint256& balance) { m_balance = balance; }
 
   /// Returns the account balance.
-  const boost::multiprecision::uint256_t& GetBalance() const {
-    return m_balance;
-  }
+  const Uint256& GetBalance() const { return m_balance; }
 
   /// Increases account nonce by 1.
   bool IncreaseNonce();
 
-  bool IncreaseNonceBy(const boost::multiprecision::uint256_t& nonceDelta);
+  bool IncreaseNonceBy(const Uint256& nonceDelta);
 
   /// Returns the account nonce.
-  const boost::multiprecision::uint256_t& GetNonce() const { return m_nonce; }
+  const Uint256& GetNonce() const { return m_nonce; }
 
   void SetStorageRoot(const dev::h256& root);
 
@@ -170,8 +166,8 @@ class Account : public Serializable {
   static Address GetAddressFromPublicKey(const PubKey& pubKey);
 
   /// Computes an account address from a sender and its nonce
-  static Address GetAddressForContract(
-      const Address& sender, const boost::multiprecision::uint256_t& nonce);
+  static Address GetAddressForContract(const Address& sender,
+                                       const Uint256& nonce);
 
   friend inline std::ostream& operator<<(std::ostream& out,
                                          Account const& account);
@@ -17,6 +17,8 @@
  * program files.
  */
 
+#include <algorithm>
+
 #include <leveldb/db.h>
 
 #include "AccountStore.h"
@@ -67,6 +69,8 @@ int AccountStore::Deserialize(const vector<unsigned char>& src,
   // [Addr n] [Account n] LOG_MARKER();
 
   try {
+    lock_guard<recursive_mutex> a(m_mutexAccounts);
+
     unsigned int curOffset = offset;
     uint256_t totalNumOfAccounts =
         GetNumber<uint256_t>(src, curOffset, UINT256_SIZE);
@@ -102,7 +106,12 @@ int AccountStore::Deserialize(const vector<unsigned char>& src,
   return 0;
 }
 
-void AccountStore::SerializeDelta() {
+bool IsDirtyStateDeltaBlock(const uint64_t& blockNum) {
+  return STATE_DELTA_VERSION >= DIRTY_STATE_DELTA_VERSION &&
+         blockNum >= STATE_DELTA_VERSION_EPOCH;
+}
+
+void AccountStore::SerializeDelta(const uint64_t& blockNum) {
   LOG_MARKER();
 
   lock_guard<mutex> g(m_mutexDelta);
@@ -112,7 +121,24 @@ void AccountStore::SerializeDelta() {
   // 2] [Account 2] .... [Addr n] [Account n]
   unsigned int curOffset = 0;
 
-  uint256_t totalNumOfAccounts = m_accountStoreTemp->GetNumOfAccounts();
+  // Every account in the temp store or, from the dirty delta version on,
+  // only the changed ones, in address order
+  const auto& tempAccounts = *m_accountStoreTemp->GetAddressToAccount();
+  vector<map<Address, Account>::const_iterator> deltaAccounts;
+  if (IsDirtyStateDeltaBlock(blockNum)) {
+    for (const auto& address : m_accountStoreTemp->GetDirtyAccounts()) {
+      auto it = tempAccounts.find(address);
+      if (it != tempAccounts.end()) {
+        deltaAccounts.emplace_back(it);
+      }
+    }
+  } else {
+    for (auto it = tempAccounts.begin(); it != tempAccounts.end(); ++it) {
+      deltaAccounts.emplace_back(it);
+    }
+  }
+
+  uint256_t totalNumOfAccounts = deltaAccounts.size();
   LOG_GENERAL(INFO, "Debug: Total number of account deltas to serialize: "
                         << totalNumOfAccounts);
   SetNumber<uint256_t>(m_stateDeltaSerialized, curOffset, totalNumOfAccounts,
@@ -121,7 +147,8 @@ void AccountStore::SerializeDelta() {
 
   vector<unsigned char> address_vec;
   // [Addr 1] [Account 1] [Addr 2] [Account 2] .... [Addr n] [Account n]
-  for (const auto& entry : *m_accountStoreTemp->GetAddressToAccount()) {
+  for (const auto& it : deltaAccounts) {
+    const auto& entry = *it;
     // LOG_GENERAL(INFO, "Addr: " << entry.first);
 
     // Address
@@ -137,6 +164,15 @@ void AccountStore::SerializeDelta() {
         m_stateDeltaSerialized, curOffset, account, entry.second);
     curOffset += size_needed;
   }
+
+  if (all_of(m_stateDeltaSerialized.begin(), m_stateDeltaSerialized.end(),
+             [](unsigned char c) { return c == 0; })) {
+    m_stateDeltaHash = StateHash();
+  } else {
+    SHA2<HASH_TYPE::HASH_VARIANT_256> sha2;
+    sha2.Update(m_stateDeltaSerialized);
+    m_stateDeltaHash = StateHash(sha2.Finalize());
+  }
 }
 
 unsigned int AccountStore::GetSerializedDelta(vector<unsigned char>& dst) {
@@ -157,6 +193,7 @@ int AccountStore::DeserializeDelta(const vector<unsigned char>& src,
 
   try {
     lock_guard<mutex> g(m_mutexDelta);
+    lock_guard<recursive_mutex> a(m_mutexAccounts);
 
     unsigned int curOffset = offset;
     uint256_t totalNumOfAccounts =
@@ -220,6 +257,42 @@ int AccountStore::DeserializeDeltaTemp(const vector<unsigned char>& src,
   return m_accountStoreTemp->DeserializeDelta(src, offset);
 }
 
+int AccountStore::MergeShardDeltaTemp(const vector<unsigned char>& src,
+                                      uint32_t shardId) {
+  lock_guard<mutex> g(m_mutexDelta);
+
+  vector<Address> exclusiveWrites;
+  if (m_accountStoreTemp->DeserializeDelta(src, 0, &exclusiveWrites) != 0) {
+    return -1;
+  }
+
+  int conflicts = 0;
+  for (const auto& address : exclusiveWrites) {
+    auto writer = m_exclusiveWriters.emplace(address, shardId).first;
+    if (writer->second != shardId) {
+      LOG_GENERAL(WARNING, "Conflicting writes to account "
+                               << address << " from shards " << writer->second
+                               << " and " << shardId);
+      conflicts++;
+    }
+  }
+
+  return conflicts;
+}
+
+int AccountStore::DeserializeDeltasTemp(
+    const vector<vector<unsigned char>>& deltas) {
+  lock_guard<mutex> g(m_mutexDelta);
+
+  for (const auto& delta : deltas) {
+    if (m_accountStoreTemp->DeserializeDelta(delta, 0) != 0) {
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
 void AccountStore::MoveRootToDisk(const h256& root) {
   // convert h256 to bytes
   if (!BlockStorage::GetBlockStorage().PutMetadata(STATEROOT, root.asBytes()))
@@ -229,20 +302,30 @@ void AccountStore::MoveRootToDisk(const h256& root) {
 void AccountStore::MoveUpdatesToDisk() {
   LOG_MARKER();
 
-  ContractStorage::GetContractStorage().GetStateDB().commit();
-  for (auto i : *m_addressToAccount) {
-    if (!ContractStorage::GetContractStorage().PutContractCode(
-            i.first, i.second.GetCode())) {
+  lock_guard<recursive_mutex> g(m_mutexAccounts);
+
+  ContractStorage& contractStorage = ContractStorage::GetContractStorage();
+  contractStorage.GetStateDB().commit();
+  for (const auto& address : GetDirtyAccounts()) {
+    auto it = m_addressToAccount->find(address);
+    if (it == m_addressToAccount->end()) {
+      continue;
+    }
+    // Contract code never changes, so only new contracts need writing
+    if (it->second.isContract() &&
+        contractStorage.GetContractCode(address).empty() &&
+        !contractStorage.PutContractCode(address, it->second.GetCode())) {
       LOG_GENERAL(WARNING, "Write Contract Code to Disk Failed");
       continue;
     }
-    i.second.Commit();
+    it->second.Commit();
   }
 
   try {
     m_state.db()->commit();
     m_prevRoot = m_state.root();
     MoveRootToDisk(m_prevRoot);
+    CommitDirtyAccounts();
   } catch (const boost::exception& e) {
     LOG_GENERAL(WARNING, "Error with AccountStore::MoveUpdatesToDisk. "
                              << boost::diagnostic_information(e));
@@ -252,6 +335,8 @@ void AccountStore::MoveUpdatesToDisk() {
 void AccountStore::DiscardUnsavedUpdates() {
   LOG_MARKER();
 
+  lock_guard<recursive_mutex> g(m_mutexAccounts);
+
   ContractStorage::GetContractStorage().GetStateDB().rollback();
   for (auto i : *m_addressToAccount) {
     i.second.RollBack();
@@ -261,6 +346,7 @@ void AccountStore::DiscardUnsavedUpdates() {
     m_state.db()->rollback();
     m_state.setRoot(m_prevRoot);
     m_addressToAccount->clear();
+    ClearAccountCache();
   } catch (const boost::exception& e) {
     LOG_GENERAL(WARNING, "Error with AccountStore::DiscardUnsavedUpdates. "
                              << boost::diagnostic_information(e));
@@ -275,29 +361,24 @@ bool AccountStore::RetrieveFromDisk() {
   }
 
   try {
+    lock_guard<recursive_mutex> g(m_mutexAccounts);
+
     h256 root(rootBytes);
     m_state.setRoot(root);
+    m_prevRoot = root;
+
+    // Accounts are paged in from the trie by GetAccount when first used
+    if (LAZY_STATE_LOADING) {
+      LOG_GENERAL(INFO, "State root set to " << root.hex());
+      return true;
+    }
+
+    Account account;
     for (const auto& i : m_state) {
       Address address(i.first);
-      LOG_GENERAL(INFO, "Address: " << address.hex());
-      dev::RLP rlp(i.second);
-      if (rlp.itemCount() != 4) {
-        LOG_GENERAL(WARNING, "Account data corrupted");
+      if (!GetAccountFromTrie(address, dev::RLP(i.second), account)) {
         continue;
       }
-      Account account(rlp[0].toInt<uint256_t>(), rlp[1].toInt<uint256_t>());
-      // Code Hash
-      if (rlp[3].toHash<h256>() != h256()) {
-        // Extract Code Content
-        account.SetCode(
-            ContractStorage::GetContractStorage().GetContractCode(address));
-        if (rlp[3].toHash<h256>() != account.GetCodeHash()) {
-          LOG_GENERAL(WARNING, "Account Code Content doesn't match Code Hash")
-          continue;
-        }
-        // Storage Root
-        account.SetStorageRoot(rlp[2].toHash<h256>());
-      }
       m_addressToAccount->insert({address, account});
     }
   } catch (const boost::exception& e) {
@@ -308,6 +389,30 @@ bool AccountStore::RetrieveFromDisk() {
   return true;
 }
 
+bool AccountStore::GetStateNodesChunk(const string& rangeBegin,
+                                      const string& rangeEnd,
+                                      const string& startAfter,
+                                      size_t maxBytes,
+                                      vector<pair<string, string>>& nodes,
+                                      string& lastKey) {
+  bool complete = m_db.levelDB().GetRange(rangeBegin, rangeEnd, startAfter,
+                                          maxBytes, nodes, lastKey);
+
+  // Trie nodes are keyed by their raw hash, anything else is auxiliary data
+  // or pruning bookkeeping of the OverlayDB which doesn't need to be synced
+  nodes.erase(remove_if(nodes.begin(), nodes.end(),
+                        [](const pair<string, string>& node) {
+                          return node.first.size() != h256::size;
+                        }),
+              nodes.end());
+
+  return complete;
+}
+
+bool AccountStore::PutStateNodes(const vector<pair<string, string>>& nodes) {
+  return m_db.levelDB().BatchInsert(nodes) == 0;
+}
+
 bool AccountStore::UpdateAccountsTemp(const uint64_t& blockNum,
                                       const unsigned int& numShards,
                                       const bool& isDS,
@@ -336,6 +441,8 @@ bool AccountStore::UpdateCoinbaseTemp(const Address& rewardee,
 
 boost::multiprecision::uint256_t AccountStore::GetNonceTemp(
     const Address& address) {
+  lock_guard<mutex> g(m_mutexDelta);
+
   if (m_accountStoreTemp->GetAddressToAccount()->find(address) !=
       m_accountStoreTemp->GetAddressToAccount()->end()) {
     return m_accountStoreTemp->GetNonce(address);
@@ -346,23 +453,7 @@ boost::multiprecision::uint256_t AccountStore::GetNonceTemp(
 
 StateHash AccountStore::GetStateDeltaHash() {
   lock_guard<mutex> g(m_mutexDelta);
-
-  bool isEmpty = true;
-
-  for (unsigned char i : m_stateDeltaSerialized) {
-    if (i != 0) {
-      isEmpty = false;
-      break;
-    }
-  }
-
-  if (isEmpty) {
-    return StateHash();
-  }
-
-  SHA2<HASH_TYPE::HASH_VARIANT_256> sha2;
-  sha2.Update(m_stateDeltaSerialized);
-  return StateHash(sha2.Finalize());
+  return m_stateDeltaHash;
 }
 
 void AccountStore::CommitTemp() {
@@ -378,6 +469,8 @@ void AccountStore::InitTemp() {
 
   m_accountStoreTemp->Init();
   m_stateDeltaSerialized.clear();
+  m_stateDeltaHash = StateHash();
+  m_exclusiveWriters.clear();
 }
 
 void AccountStore::CommitTempReversible() {
@@ -391,6 +484,8 @@ void AccountStore::CommitTempReversible() {
 void AccountStore::RevertCommitTemp() {
   LOG_MARKER();
 
+  lock_guard<recursive_mutex> g(m_mutexAccounts);
+
   // Revert changed
   for (auto const entry : m_addressToAccountRevChanged) {
     (*m_addressToAccount)[entry.first] = entry.second;
@@ -43,6 +43,14 @@
 
 using StateHash = dev::h256;
 
+/// Version of STATE_DELTA_VERSION from which state deltas only hold the
+/// accounts changed in the temp store.
+const unsigned int DIRTY_STATE_DELTA_VERSION = 2;
+
+/// Returns true if the state delta of Tx block blockNum only holds the
+/// accounts changed in the temp store.
+bool IsDirtyStateDeltaBlock(const uint64_t& blockNum);
+
 class AccountStore;
 
 class AccountStoreTemp : public AccountStoreSC<std::map<Address, Account>> {
@@ -54,8 +62,11 @@ class AccountStoreTemp : public AccountStoreSC<std::map<Address, Account>> {
   //     const shared_ptr<unordered_map<Address, Account>>& addressToAccount);
   AccountStoreTemp(AccountStore& parent);
 
+  /// Appends to exclusiveWrites, if given, the accounts whose nonce or
+  /// contract state the delta changes.
   int DeserializeDelta(const std::vector<unsigned char>& src,
-                       unsigned int offset);
+                       unsigned int offset,
+                       std::vector<Address>* exclusiveWrites = nullptr);
 
   /// Returns the Account associated with the specified address.
   Account* GetAccount(const Address& address) override;
@@ -75,6 +86,12 @@ class AccountStore
   std::mutex m_mutexDelta;
 
   std::vector<unsigned char> m_stateDeltaSerialized;
+  /// Hash of m_stateDeltaSerialized, computed once by SerializeDelta
+  StateHash m_stateDeltaHash;
+
+  /// Shard that changed the nonce or contract state of each account in the
+  /// temp store. Balances may be changed by any number of shards.
+  std::unordered_map<Address, uint32_t> m_exclusiveWriters;
 
   AccountStore();
   ~AccountStore();
@@ -89,7 +106,8 @@ class AccountStore
   int Deserialize(const std::vector<unsigned char>& src,
                   unsigned int offset) override;
 
-  void SerializeDelta();
+  /// Serializes the changes in the temp store for the Tx block blockNum.
+  void SerializeDelta(const uint64_t& blockNum);
 
   unsigned int GetSerializedDelta(std::vector<unsigned char>& dst);
 
@@ -99,6 +117,16 @@ class AccountStore
   int DeserializeDeltaTemp(const std::vector<unsigned char>& src,
                            unsigned int offset);
 
+  /// Applies the state delta of a shard to the temp store, warning about
+  /// accounts whose nonce or contract state another shard changed too.
+  /// Returns the number of such accounts, or -1.
+  int MergeShardDeltaTemp(const std::vector<unsigned char>& src,
+                          uint32_t shardId);
+
+  /// Applies each delta to the temp store in order.
+  int DeserializeDeltasTemp(
+      const std::vector<std::vector<unsigned char>>& deltas);
+
   /// Empty the state trie, must be called explicitly otherwise will retrieve
   /// the historical data
   void Init() override;
@@ -110,6 +138,19 @@ class AccountStore
 
   bool RetrieveFromDisk();
 
+  /// Reads the state trie nodes of [rangeBegin, rangeEnd) following
+  /// startAfter, up to about maxBytes, as raw database entries.
+  /// Returns true if the range has been read to its end.
+  bool GetStateNodesChunk(
+      const std::string& rangeBegin, const std::string& rangeEnd,
+      const std::string& startAfter, size_t maxBytes,
+      std::vector<std::pair<std::string, std::string>>& nodes,
+      std::string& lastKey);
+
+  /// Adds raw state trie nodes read by GetStateNodesChunk on another node.
+  bool PutStateNodes(
+      const std::vector<std::pair<std::string, std::string>>& nodes);
+
   bool UpdateAccountsTemp(const uint64_t& blockNum,
                           const unsigned int& numShards, const bool& isDS,
                           const Transaction& transaction,
@@ -20,6 +20,8 @@
 #ifndef __ACCOUNTSTOREBASE_H__
 #define __ACCOUNTSTOREBASE_H__
 
+#include <set>
+
 #include <boost/multiprecision/cpp_int.hpp>
 
 #include "Account.h"
@@ -36,12 +38,17 @@ class AccountStoreBase : public Serializable {
  protected:
   std::shared_ptr<MAP> m_addressToAccount;
 
+  /// Accounts added, removed or changed since the last Init, in address
+  /// order.
+  std::set<Address> m_dirtyAccounts;
+
   AccountStoreBase();
 
-  bool CalculateGasRefund(const boost::multiprecision::uint256_t& gasDeposit,
-                          const boost::multiprecision::uint256_t& gasUnit,
-                          const boost::multiprecision::uint256_t& gasPrice,
-                          boost::multiprecision::uint256_t& gasRefund);
+  /// Records a change to the account, to be picked up by commits and deltas.
+  virtual void MarkDirtyAccount(const Address& address);
+
+  bool CalculateGasRefund(const Uint256& gasDeposit, const Uint256& gasUnit,
+                          const Uint256& gasPrice, Uint256& gasRefund);
 
  public:
   virtual void Init();
@@ -70,19 +77,19 @@ class AccountStoreBase : public Serializable {
 
   boost::multiprecision::uint256_t GetNumOfAccounts() const;
 
-  bool IncreaseBalance(const Address& address,
-                       const boost::multiprecision::uint256_t& delta);
-  bool DecreaseBalance(const Address& address,
-                       const boost::multiprecision::uint256_t& delta);
+  const std::set<Address>& GetDirtyAccounts() const;
+
+  bool IncreaseBalance(const Address& address, const Uint256& delta);
+  bool DecreaseBalance(const Address& address, const Uint256& delta);
 
   /// Updates the source and destination accounts included in the specified
   /// Transaction.
   bool TransferBalance(const Address& from, const Address& to,
-                       const boost::multiprecision::uint256_t& delta);
-  boost::multiprecision::uint256_t GetBalance(const Address& address);
+                       const Uint256& delta);
+  Uint256 GetBalance(const Address& address);
 
   bool IncreaseNonce(const Address& address);
-  boost::multiprecision::uint256_t GetNonce(const Address& address);
+  Uint256 GetNonce(const Address& address);
 
   virtual void PrintAccountState();
 };
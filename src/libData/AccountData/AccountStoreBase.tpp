@@ -30,6 +30,17 @@ AccountStoreBase<MAP>::AccountStoreBase() {
 template <class MAP>
 void AccountStoreBase<MAP>::Init() {
   m_addressToAccount->clear();
+  m_dirtyAccounts.clear();
+}
+
+template <class MAP>
+void AccountStoreBase<MAP>::MarkDirtyAccount(const Address& address) {
+  m_dirtyAccounts.emplace(address);
+}
+
+template <class MAP>
+const std::set<Address>& AccountStoreBase<MAP>::GetDirtyAccounts() const {
+  return m_dirtyAccounts;
 }
 
 template <class MAP>
@@ -108,6 +119,7 @@ int AccountStoreBase<MAP>::Deserialize(const std::vector<unsigned char>& src,
         return -1;
       }
       (*m_addressToAccount)[address] = account;
+      MarkDirtyAccount(address);
     }
   } catch (const std::exception& e) {
     LOG_GENERAL(WARNING,
@@ -123,7 +135,7 @@ bool AccountStoreBase<MAP>::UpdateAccounts(const Transaction& transaction,
   const PubKey& senderPubKey = transaction.GetSenderPubKey();
   const Address fromAddr = Account::GetAddressFromPublicKey(senderPubKey);
   Address toAddr = transaction.GetToAddr();
-  const boost::multiprecision::uint256_t& amount = transaction.GetAmount();
+  const Uint256& amount = transaction.GetAmount();
 
   Account* fromAccount = this->GetAccount(fromAddr);
   if (fromAccount == nullptr) {
@@ -140,11 +152,18 @@ bool AccountStoreBase<MAP>::UpdateAccounts(const Transaction& transaction,
     return false;
   }
 
-  // FIXME: Possible integer overflow here
-  boost::multiprecision::uint256_t gasDeposit =
-      transaction.GetGasLimit() * transaction.GetGasPrice();
+  Uint256 gasDeposit;
+  if (!SafeMath<Uint256>::mul(transaction.GetGasLimit(),
+                              transaction.GetGasPrice(), gasDeposit)) {
+    return false;
+  }
 
-  if (fromAccount->GetBalance() < transaction.GetAmount() + gasDeposit) {
+  Uint256 totalCost;
+  if (!SafeMath<Uint256>::add(amount, gasDeposit, totalCost)) {
+    return false;
+  }
+
+  if (fromAccount->GetBalance() < totalCost) {
     LOG_GENERAL(WARNING,
                 "The account (balance: "
                     << fromAccount->GetBalance()
@@ -166,7 +185,7 @@ bool AccountStoreBase<MAP>::UpdateAccounts(const Transaction& transaction,
     return false;
   }
 
-  boost::multiprecision::uint256_t gasRefund;
+  Uint256 gasRefund;
   if (!CalculateGasRefund(gasDeposit, NORMAL_TRAN_GAS,
                           transaction.GetGasPrice(), gasRefund)) {
     return false;
@@ -185,19 +204,15 @@ bool AccountStoreBase<MAP>::UpdateAccounts(const Transaction& transaction,
 
 template <class MAP>
 bool AccountStoreBase<MAP>::CalculateGasRefund(
-    const boost::multiprecision::uint256_t& gasDeposit,
-    const boost::multiprecision::uint256_t& gasUnit,
-    const boost::multiprecision::uint256_t& gasPrice,
-    boost::multiprecision::uint256_t& gasRefund) {
-  boost::multiprecision::uint256_t gasFee;
-  if (!SafeMath<boost::multiprecision::uint256_t>::mul(gasUnit, gasPrice,
-                                                       gasFee)) {
+    const Uint256& gasDeposit, const Uint256& gasUnit, const Uint256& gasPrice,
+    Uint256& gasRefund) {
+  Uint256 gasFee;
+  if (!SafeMath<Uint256>::mul(gasUnit, gasPrice, gasFee)) {
     LOG_GENERAL(WARNING, "gasUnit * transaction.GetGasPrice() overflow!");
     return false;
   }
 
-  if (!SafeMath<boost::multiprecision::uint256_t>::sub(gasDeposit, gasFee,
-                                                       gasRefund)) {
+  if (!SafeMath<Uint256>::sub(gasDeposit, gasFee, gasRefund)) {
     LOG_GENERAL(WARNING, "gasDeposit - gasFee overflow!");
     return false;
   }
@@ -219,6 +234,7 @@ void AccountStoreBase<MAP>::AddAccount(const Address& address,
 
   if (!IsAccountExist(address)) {
     m_addressToAccount->insert(std::make_pair(address, account));
+    MarkDirtyAccount(address);
     // UpdateStateTrie(address, account);
   }
 }
@@ -233,6 +249,7 @@ template <class MAP>
 void AccountStoreBase<MAP>::RemoveAccount(const Address& address) {
   if (IsAccountExist(address)) {
     m_addressToAccount->erase(address);
+    MarkDirtyAccount(address);
   }
 }
 
@@ -254,7 +271,7 @@ boost::multiprecision::uint256_t AccountStoreBase<MAP>::GetNumOfAccounts()
 
 template <class MAP>
 bool AccountStoreBase<MAP>::IncreaseBalance(
-    const Address& address, const boost::multiprecision::uint256_t& delta) {
+    const Address& address, const Uint256& delta) {
   // LOG_MARKER();
 
   if (delta == 0) {
@@ -266,6 +283,7 @@ bool AccountStoreBase<MAP>::IncreaseBalance(
   // LOG_GENERAL(INFO, "address: " << address);
 
   if (account != nullptr && account->IncreaseBalance(delta)) {
+    MarkDirtyAccount(address);
     // UpdateStateTrie(address, *account);
     // LOG_GENERAL(INFO, "account: " << *account);
     return true;
@@ -284,7 +302,7 @@ bool AccountStoreBase<MAP>::IncreaseBalance(
 
 template <class MAP>
 bool AccountStoreBase<MAP>::DecreaseBalance(
-    const Address& address, const boost::multiprecision::uint256_t& delta) {
+    const Address& address, const Uint256& delta) {
   // LOG_MARKER();
 
   if (delta == 0) {
@@ -298,13 +316,18 @@ bool AccountStoreBase<MAP>::DecreaseBalance(
     return false;
   }
 
-  return account->DecreaseBalance(delta);
+  if (!account->DecreaseBalance(delta)) {
+    return false;
+  }
+
+  MarkDirtyAccount(address);
+  return true;
 }
 
 template <class MAP>
-bool AccountStoreBase<MAP>::TransferBalance(
-    const Address& from, const Address& to,
-    const boost::multiprecision::uint256_t& delta) {
+bool AccountStoreBase<MAP>::TransferBalance(const Address& from,
+                                            const Address& to,
+                                            const Uint256& delta) {
   // LOG_MARKER();
   // FIXME: Is there any elegent way to implement this atomic change on balance?
   if (DecreaseBalance(from, delta)) {
@@ -319,8 +342,7 @@ bool AccountStoreBase<MAP>::TransferBalance(
 }
 
 template <class MAP>
-boost::multiprecision::uint256_t AccountStoreBase<MAP>::GetBalance(
-    const Address& address) {
+Uint256 AccountStoreBase<MAP>::GetBalance(const Address& address) {
   // LOG_MARKER();
 
   const Account* account = GetAccount(address);
@@ -347,6 +369,7 @@ bool AccountStoreBase<MAP>::IncreaseNonce(const Address& address) {
   }
 
   if (account->IncreaseNonce()) {
+    MarkDirtyAccount(address);
     // LOG_GENERAL(INFO, "Increase nonce done");
     // UpdateStateTrie(address, *account);
     return true;
@@ -357,8 +380,7 @@ bool AccountStoreBase<MAP>::IncreaseNonce(const Address& address) {
 }
 
 template <class MAP>
-boost::multiprecision::uint256_t AccountStoreBase<MAP>::GetNonce(
-    const Address& address) {
+Uint256 AccountStoreBase<MAP>::GetNonce(const Address& address) {
   // LOG_MARKER();
 
   Account* account = GetAccount(address);
@@ -54,38 +54,45 @@ class AccountStoreSC : public AccountStoreBase<MAP> {
   Address m_curContractAddr;
   Address m_curSenderAddr;
 
-  boost::multiprecision::uint256_t m_curAmount;
-  boost::multiprecision::uint256_t m_curGasLimit;
-  boost::multiprecision::uint256_t m_curGasPrice;
+  Uint256 m_curAmount;
+  Uint256 m_curGasLimit;
+  Uint256 m_curGasPrice;
 
   unsigned int m_curNumShards;
   bool m_curIsDS;
   TransactionReceipt m_curTranReceipt;
 
-  bool ParseCreateContractOutput(boost::multiprecision::uint256_t& gasRemained);
-  bool ParseCreateContractJsonOutput(
-      const Json::Value& _json, boost::multiprecision::uint256_t& gasRemained);
-  bool ParseCallContractOutput(boost::multiprecision::uint256_t& gasRemained);
-  bool ParseCallContractJsonOutput(
-      const Json::Value& _json, boost::multiprecision::uint256_t& gasRemained);
+  bool ParseCreateContractOutput(const std::string& outStr,
+                                 Uint256& gasRemained);
+  bool ParseCreateContractJsonOutput(const Json::Value& _json,
+                                     Uint256& gasRemained);
+  bool ParseCallContractOutput(const std::string& outStr,
+                               Uint256& gasRemained);
+  bool ParseCallContractJsonOutput(const Json::Value& _json,
+                                   Uint256& gasRemained);
   Json::Value GetBlockStateJson(const uint64_t& BlockNum) const;
 
-  std::string GetCreateContractCmdStr(
-      const boost::multiprecision::uint256_t& available_gas);
-  std::string GetCallContractCmdStr(
-      const boost::multiprecision::uint256_t& available_gas);
+  std::string GetCreateContractCmdStr(const Uint256& available_gas);
+  std::string GetCallContractCmdStr(const Uint256& available_gas);
 
   // Generate input for interpreter to check the correctness of contract
   void ExportCreateContractFiles(const Account& contract);
 
   void ExportContractFiles(const Account& contract);
-  bool ExportCallContractFiles(const Account& contract,
-                               const Transaction& transaction);
   void ExportCallContractFiles(const Account& contract,
                                const Json::Value& contractData);
 
+  bool GetCallContractMessage(const Transaction& transaction,
+                              Json::Value& msgObj);
+
+  /// Runs SCILLA_BINARY on the exported contract files and returns its output
+  /// JSON. A null message creates the contract, otherwise the message is
+  /// sent to it.
+  bool RunInterpreter(const Account& contract, const Json::Value* message,
+                      const Uint256& available_gas, std::string& output);
+
   bool TransferBalanceAtomic(const Address& from, const Address& to,
-                             const boost::multiprecision::uint256_t& delta);
+                             const Uint256& delta);
   void CommitTransferBalanceAtomic();
   void DiscardTransferBalanceAtomic();
 
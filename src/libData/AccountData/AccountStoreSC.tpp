@@ -55,13 +55,13 @@ bool AccountStoreSC<MAP>::UpdateAccounts(const uint64_t& blockNum,
   const Address fromAddr = Account::GetAddressFromPublicKey(senderPubKey);
   Address toAddr = transaction.GetToAddr();
 
-  const boost::multiprecision::uint256_t& amount = transaction.GetAmount();
+  const Uint256& amount = transaction.GetAmount();
 
-  boost::multiprecision::uint256_t gasRemained = transaction.GetGasLimit();
+  Uint256 gasRemained = transaction.GetGasLimit();
 
-  boost::multiprecision::uint256_t gasDeposit;
-  if (!SafeMath<boost::multiprecision::uint256_t>::mul(
-          gasRemained, transaction.GetGasPrice(), gasDeposit)) {
+  Uint256 gasDeposit;
+  if (!SafeMath<Uint256>::mul(gasRemained, transaction.GetGasPrice(),
+                              gasDeposit)) {
     return false;
   }
 
@@ -153,23 +153,21 @@ bool AccountStoreSC<MAP>::UpdateAccounts(const uint64_t& blockNum,
 
     m_curBlockNum = blockNum;
 
-    ExportCreateContractFiles(*toAccount);
-
+    std::string output;
     bool ret = true;
-    if (!SysCommand::ExecuteCmdWithoutOutput(
-            GetCreateContractCmdStr(gasRemained))) {
+    if (!RunInterpreter(*toAccount, nullptr, gasRemained, output)) {
       ret = false;
     }
-    if (ret && !ParseCreateContractOutput(gasRemained)) {
+    if (ret && !ParseCreateContractOutput(output, gasRemained)) {
       ret = false;
     }
     if (!ret) {
       gasRemained = std::min(transaction.GetGasLimit() - CONTRACT_CREATE_GAS,
                              gasRemained);
     }
-    boost::multiprecision::uint256_t gasRefund;
-    if (!SafeMath<boost::multiprecision::uint256_t>::mul(
-            gasRemained, transaction.GetGasPrice(), gasRefund)) {
+    Uint256 gasRefund;
+    if (!SafeMath<Uint256>::mul(gasRemained, transaction.GetGasPrice(),
+                                gasRefund)) {
       this->m_addressToAccount->erase(toAddr);
       return false;
     }
@@ -243,7 +241,8 @@ bool AccountStoreSC<MAP>::UpdateAccounts(const uint64_t& blockNum,
     }
 
     m_curBlockNum = blockNum;
-    if (!ExportCallContractFiles(*toAccount, transaction)) {
+    Json::Value msgObj;
+    if (!GetCallContractMessage(transaction, msgObj)) {
       return false;
     }
 
@@ -264,13 +263,13 @@ bool AccountStoreSC<MAP>::UpdateAccounts(const uint64_t& blockNum,
     //     this->IncreaseBalance(fromAddr, gasDeposit);
     //     return false;
     // }
+    std::string output;
     bool ret = true;
-    if (!SysCommand::ExecuteCmdWithoutOutput(
-            GetCallContractCmdStr(gasRemained))) {
+    if (!RunInterpreter(*toAccount, &msgObj, gasRemained, output)) {
       ret = false;
     }
 
-    if (ret && !ParseCallContractOutput(gasRemained)) {
+    if (ret && !ParseCallContractOutput(output, gasRemained)) {
       ret = false;
     }
     if (!ret) {
@@ -280,9 +279,9 @@ bool AccountStoreSC<MAP>::UpdateAccounts(const uint64_t& blockNum,
     } else {
       CommitTransferBalanceAtomic();
     }
-    boost::multiprecision::uint256_t gasRefund;
-    if (!SafeMath<boost::multiprecision::uint256_t>::mul(
-            gasRemained, transaction.GetGasPrice(), gasRefund)) {
+    Uint256 gasRefund;
+    if (!SafeMath<Uint256>::mul(gasRemained, transaction.GetGasPrice(),
+                                gasRefund)) {
       return false;
     }
 
@@ -382,16 +381,11 @@ void AccountStoreSC<MAP>::ExportContractFiles(const Account& contract) {
 }
 
 template <class MAP>
-bool AccountStoreSC<MAP>::ExportCallContractFiles(
-    const Account& contract, const Transaction& transaction) {
-  LOG_MARKER();
-
-  ExportContractFiles(contract);
-
+bool AccountStoreSC<MAP>::GetCallContractMessage(
+    const Transaction& transaction, Json::Value& msgObj) {
   // Message Json
   std::string dataStr(transaction.GetData().begin(),
                       transaction.GetData().end());
-  Json::Value msgObj;
   if (!JSONUtils::convertStrtoJson(dataStr, msgObj)) {
     return false;
   }
@@ -401,8 +395,6 @@ bool AccountStoreSC<MAP>::ExportCallContractFiles(
       Account::GetAddressFromPublicKey(transaction.GetSenderPubKey()).hex();
   msgObj["_amount"] = transaction.GetAmount().convert_to<std::string>();
 
-  JSONUtils::writeJsontoFile(INPUT_MESSAGE_JSON, msgObj);
-
   return true;
 }
 
@@ -416,9 +408,39 @@ void AccountStoreSC<MAP>::ExportCallContractFiles(
   JSONUtils::writeJsontoFile(INPUT_MESSAGE_JSON, contractData);
 }
 
+template <class MAP>
+bool AccountStoreSC<MAP>::RunInterpreter(
+    const Account& contract, const Json::Value* message,
+    const Uint256& available_gas, std::string& output) {
+  if (message == nullptr) {
+    ExportCreateContractFiles(contract);
+    if (!SysCommand::ExecuteCmdWithoutOutput(
+            GetCreateContractCmdStr(available_gas))) {
+      return false;
+    }
+  } else {
+    ExportCallContractFiles(contract, *message);
+    if (!SysCommand::ExecuteCmdWithoutOutput(
+            GetCallContractCmdStr(available_gas))) {
+      return false;
+    }
+  }
+
+  std::ifstream in(OUTPUT_JSON, std::ios::binary);
+
+  if (!in.is_open()) {
+    LOG_GENERAL(WARNING,
+                "Error opening output file or no output file generated");
+    return false;
+  }
+  output.assign(std::istreambuf_iterator<char>(in),
+                std::istreambuf_iterator<char>());
+  return true;
+}
+
 template <class MAP>
 std::string AccountStoreSC<MAP>::GetCreateContractCmdStr(
-    const boost::multiprecision::uint256_t& available_gas) {
+    const Uint256& available_gas) {
   std::string ret = SCILLA_BINARY + " -init " + INIT_JSON + " -iblockchain " +
                     INPUT_BLOCKCHAIN_JSON + " -o " + OUTPUT_JSON + " -i " +
                     INPUT_CODE + " -libdir " + SCILLA_LIB + " -gaslimit " +
@@ -429,7 +451,7 @@ std::string AccountStoreSC<MAP>::GetCreateContractCmdStr(
 
 template <class MAP>
 std::string AccountStoreSC<MAP>::GetCallContractCmdStr(
-    const boost::multiprecision::uint256_t& available_gas) {
+    const Uint256& available_gas) {
   std::string ret = SCILLA_BINARY + " -init " + INIT_JSON + " -istate " +
                     INPUT_STATE_JSON + " -iblockchain " +
                     INPUT_BLOCKCHAIN_JSON + " -imessage " + INPUT_MESSAGE_JSON +
@@ -441,19 +463,10 @@ std::string AccountStoreSC<MAP>::GetCallContractCmdStr(
 }
 
 template <class MAP>
-bool AccountStoreSC<MAP>::ParseCreateContractOutput(
-    boost::multiprecision::uint256_t& gasRemained) {
+bool AccountStoreSC<MAP>::ParseCreateContractOutput(const std::string& outStr,
+                                                    Uint256& gasRemained) {
   // LOG_MARKER();
 
-  std::ifstream in(OUTPUT_JSON, std::ios::binary);
-
-  if (!in.is_open()) {
-    LOG_GENERAL(WARNING,
-                "Error opening output file or no output file generated");
-    return false;
-  }
-  std::string outStr{std::istreambuf_iterator<char>(in),
-                     std::istreambuf_iterator<char>()};
   LOG_GENERAL(INFO, "Output: " << std::endl << outStr);
   Json::CharReaderBuilder builder;
   std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
@@ -470,7 +483,7 @@ bool AccountStoreSC<MAP>::ParseCreateContractOutput(
 
 template <class MAP>
 bool AccountStoreSC<MAP>::ParseCreateContractJsonOutput(
-    const Json::Value& _json, boost::multiprecision::uint256_t& gasRemained) {
+    const Json::Value& _json, Uint256& gasRemained) {
   // LOG_MARKER();
   if (!_json.isMember("gas_remaining")) {
     LOG_GENERAL(
@@ -505,19 +518,10 @@ bool AccountStoreSC<MAP>::ParseCreateContractJsonOutput(
 }
 
 template <class MAP>
-bool AccountStoreSC<MAP>::ParseCallContractOutput(
-    boost::multiprecision::uint256_t& gasRemained) {
+bool AccountStoreSC<MAP>::ParseCallContractOutput(const std::string& outStr,
+                                                  Uint256& gasRemained) {
   // LOG_MARKER();
 
-  std::ifstream in(OUTPUT_JSON, std::ios::binary);
-
-  if (!in.is_open()) {
-    LOG_GENERAL(WARNING,
-                "Error opening output file or no output file generated");
-    return false;
-  }
-  std::string outStr{std::istreambuf_iterator<char>(in),
-                     std::istreambuf_iterator<char>()};
   LOG_GENERAL(INFO, "Output: " << std::endl << outStr);
   Json::CharReaderBuilder builder;
   std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
@@ -534,7 +538,7 @@ bool AccountStoreSC<MAP>::ParseCallContractOutput(
 
 template <class MAP>
 bool AccountStoreSC<MAP>::ParseCallContractJsonOutput(
-    const Json::Value& _json, boost::multiprecision::uint256_t& gasRemained) {
+    const Json::Value& _json, Uint256& gasRemained) {
   // LOG_MARKER();
   if (!_json.isMember("gas_remaining")) {
     LOG_GENERAL(
@@ -594,6 +598,7 @@ bool AccountStoreSC<MAP>::ParseCallContractJsonOutput(
     Account* contractAccount = this->GetAccount(m_curContractAddr);
     if (vname != "_balance") {
       contractAccount->SetStorage(vname, type, value);
+      this->MarkDirtyAccount(m_curContractAddr);
     }
   }
 
@@ -649,23 +654,21 @@ bool AccountStoreSC<MAP>::ParseCallContractJsonOutput(
   input_message["_tag"] = _json["message"]["_tag"];
   input_message["params"] = _json["message"]["params"];
 
-  ExportCallContractFiles(*account, input_message);
-
   if (!TransferBalanceAtomic(
           m_curContractAddr, recipient,
           atoi(_json["message"]["_amount"].asString().c_str()))) {
     return false;
   }
 
-  if (!SysCommand::ExecuteCmdWithoutOutput(
-          GetCallContractCmdStr(gasRemained))) {
-    LOG_GENERAL(WARNING,
-                "ExecuteCmd failed: " << GetCallContractCmdStr(gasRemained));
+  std::string output;
+  if (!RunInterpreter(*account, &input_message, gasRemained, output)) {
+    LOG_GENERAL(WARNING, "Running interpreter failed on contract: "
+                             << recipient);
     return false;
   }
   Address t_address = m_curContractAddr;
   m_curContractAddr = recipient;
-  if (!ParseCallContractOutput(gasRemained)) {
+  if (!ParseCallContractOutput(output, gasRemained)) {
     LOG_GENERAL(WARNING, "ParseCallContractOutput failed of calling contract: "
                              << recipient);
     return false;
@@ -675,9 +678,9 @@ bool AccountStoreSC<MAP>::ParseCallContractJsonOutput(
 }
 
 template <class MAP>
-bool AccountStoreSC<MAP>::TransferBalanceAtomic(
-    const Address& from, const Address& to,
-    const boost::multiprecision::uint256_t& delta) {
+bool AccountStoreSC<MAP>::TransferBalanceAtomic(const Address& from,
+                                                const Address& to,
+                                                const Uint256& delta) {
   // LOG_MARKER();
   return m_accountStoreAtomic->TransferBalance(from, to, delta);
 }
@@ -689,6 +692,7 @@ void AccountStoreSC<MAP>::CommitTransferBalanceAtomic() {
     Account* account = this->GetAccount(entry.first);
     if (account != nullptr) {
       account->SetBalance(entry.second.GetBalance());
+      this->MarkDirtyAccount(entry.first);
     } else {
       // this->m_addressToAccount.emplace(std::make_pair(entry.first,
       // entry.second));
@@ -51,7 +51,8 @@ AccountStoreTemp::GetAddressToAccount() {
 }
 
 int AccountStoreTemp::DeserializeDelta(const vector<unsigned char>& src,
-                                       unsigned int offset) {
+                                       unsigned int offset,
+                                       vector<Address>* exclusiveWrites) {
   LOG_MARKER();
   // [Total number of acount deltas (uint256_t)] [Addr 1] [AccountDelta 1] [Addr
   // 2] [Account 2] .... [Addr n] [Account n]
@@ -93,7 +94,13 @@ int AccountStoreTemp::DeserializeDelta(const vector<unsigned char>& src,
 
         continue;
       }
+      if (exclusiveWrites != nullptr &&
+          (account.GetNonce() != oriAccount->GetNonce() ||
+           account.GetStorageRoot() != oriAccount->GetStorageRoot())) {
+        exclusiveWrites->emplace_back(address);
+      }
       (*m_addressToAccount)[address] = account;
+      MarkDirtyAccount(address);
     }
   } catch (const std::exception& e) {
     LOG_GENERAL(WARNING,
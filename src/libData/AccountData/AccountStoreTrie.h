@@ -20,6 +20,11 @@
 #ifndef __ACCOUNTSTORETRIE_H__
 #define __ACCOUNTSTORETRIE_H__
 
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
 #include "AccountStoreSC.h"
 #include "depends/libDatabase/MemoryDB.h"
 #include "depends/libDatabase/OverlayDB.h"
@@ -31,15 +36,55 @@ class AccountStoreTrie : public AccountStoreSC<MAP> {
   dev::SpecificTrieDB<dev::GenericTrieDB<DB>, Address> m_state;
   dev::h256 m_prevRoot;
 
+  /// Accounts loaded from m_state and unchanged since, least recently used
+  /// first. Only these are evicted once ACCOUNT_CACHE_SIZE is exceeded.
+  std::list<Address> m_cleanAccounts;
+  std::unordered_map<Address, std::list<Address>::iterator>
+      m_cleanAccountsIndex;
+  /// Dirty accounts whose trie entry was written since the last commit.
+  /// Other dirty accounts (e.g. genesis ones) are never evicted.
+  std::unordered_set<Address> m_trieUpdatedAccounts;
+  std::mutex m_mutexAccountCache;
+  /// Held by everything that loads, changes, evicts or drops accounts in
+  /// m_addressToAccount or m_state, so that GetAccountCopy and Serialize
+  /// can read them from other threads, e.g. RPC.
+  mutable std::recursive_mutex m_mutexAccounts;
+
   AccountStoreTrie();
 
   bool UpdateStateTrie(const Address& address, const Account& account);
   bool RemoveFromTrie(const Address& address);
+  /// Builds the account stored in m_state under address from its RLP entry.
+  bool GetAccountFromTrie(const Address& address, const dev::RLP& rlp,
+                          Account& account) const;
+
+  /// Moves a clean account to the most recently used end of the cache.
+  void TouchCleanAccount(const Address& address);
+  /// Tracks an account just loaded from m_state.
+  void AddCleanAccount(const Address& address);
+  /// Evicts the least recently used clean accounts beyond
+  /// ACCOUNT_CACHE_SIZE. Only done on commit, so pointers returned by
+  /// GetAccount stay valid until the next MoveUpdatesToDisk.
+  void EvictCleanAccounts();
+  /// Pins an account in memory until the next CommitDirtyAccounts.
+  void MarkDirtyAccount(const Address& address) override;
+  /// Clears the dirty set, making the accounts whose trie entry was written
+  /// evictable again.
+  void CommitDirtyAccounts();
+  void ClearAccountCache();
 
  public:
   virtual void Init() override;
 
   Account* GetAccount(const Address& address) override;
+  /// Copies out the account at address for readers running alongside the
+  /// node thread, e.g. RPC. Returns false if there is no such account.
+  bool GetAccountCopy(const Address& address, Account& account);
+
+  /// Serializes every account in m_state, including evicted and not yet
+  /// loaded ones. In-memory accounts take precedence over their entries.
+  unsigned int Serialize(std::vector<unsigned char>& dst,
+                         unsigned int offset) const override;
 
   dev::h256 GetStateRootHash() const;
   bool UpdateStateTrieAll();
@@ -29,7 +29,10 @@ AccountStoreTrie<DB, MAP>::AccountStoreTrie()
 
 template <class DB, class MAP>
 void AccountStoreTrie<DB, MAP>::Init() {
+  std::lock_guard<std::recursive_mutex> g(m_mutexAccounts);
+
   AccountStoreSC<MAP>::Init();
+  ClearAccountCache();
   m_state.init();
   m_prevRoot = m_state.root();
 }
@@ -38,8 +41,11 @@ template <class DB, class MAP>
 Account* AccountStoreTrie<DB, MAP>::GetAccount(const Address& address) {
   using namespace boost::multiprecision;
 
+  std::lock_guard<std::recursive_mutex> g(m_mutexAccounts);
+
   Account* account = AccountStoreBase<MAP>::GetAccount(address);
   if (account != nullptr) {
+    TouchCleanAccount(address);
     return account;
   }
 
@@ -48,43 +54,128 @@ Account* AccountStoreTrie<DB, MAP>::GetAccount(const Address& address) {
     return nullptr;
   }
 
-  dev::RLP accountDataRLP(accountDataString);
-  if (accountDataRLP.itemCount() != RLP_ITEM_COUNT) {
-    LOG_GENERAL(WARNING, "Account data corrupted");
+  Account loaded;
+  if (!GetAccountFromTrie(address, dev::RLP(accountDataString), loaded)) {
     return nullptr;
   }
 
-  auto it2 = this->m_addressToAccount->emplace(
-      std::piecewise_construct, std::forward_as_tuple(address),
-      std::forward_as_tuple(accountDataRLP[0].toInt<uint256_t>(),
-                            accountDataRLP[1].toInt<uint256_t>()));
+  auto it2 = this->m_addressToAccount->emplace(address, std::move(loaded));
+
+  AddCleanAccount(address);
+
+  return &it2.first->second;
+}
+
+template <class DB, class MAP>
+bool AccountStoreTrie<DB, MAP>::GetAccountFromTrie(const Address& address,
+                                                   const dev::RLP& rlp,
+                                                   Account& account) const {
+  using namespace boost::multiprecision;
+
+  if (rlp.itemCount() != RLP_ITEM_COUNT) {
+    LOG_GENERAL(WARNING, "Account data corrupted");
+    return false;
+  }
+
+  account = Account(rlp[0].toInt<uint256_t>(), rlp[1].toInt<uint256_t>());
 
   // Code Hash
-  if (accountDataRLP[3].toHash<dev::h256>() != dev::h256()) {
+  if (rlp[3].toHash<dev::h256>() != dev::h256()) {
     // Extract Code Content
-    it2.first->second.SetCode(
+    account.SetCode(
         ContractStorage::GetContractStorage().GetContractCode(address));
-    if (accountDataRLP[3].toHash<dev::h256>() !=
-        it2.first->second.GetCodeHash()) {
+    if (rlp[3].toHash<dev::h256>() != account.GetCodeHash()) {
       LOG_GENERAL(WARNING, "Account Code Content doesn't match Code Hash")
-      this->m_addressToAccount->erase(it2.first);
-      return nullptr;
+      return false;
     }
     // Storage Root
-    it2.first->second.SetStorageRoot(accountDataRLP[2].toHash<dev::h256>());
+    account.SetStorageRoot(rlp[2].toHash<dev::h256>());
   }
 
-  return &it2.first->second;
+  return true;
+}
+
+template <class DB, class MAP>
+bool AccountStoreTrie<DB, MAP>::GetAccountCopy(const Address& address,
+                                               Account& account) {
+  std::lock_guard<std::recursive_mutex> g(m_mutexAccounts);
+
+  const Account* found = GetAccount(address);
+  if (found == nullptr) {
+    return false;
+  }
+  account = *found;
+  return true;
+}
+
+template <class DB, class MAP>
+unsigned int AccountStoreTrie<DB, MAP>::Serialize(
+    std::vector<unsigned char>& dst, unsigned int offset) const {
+  // [Total number of accounts (uint256_t)] [Addr 1] [Account 1] [Addr 2]
+  // [Account 2] .... [Addr n] [Account n]
+  std::lock_guard<std::recursive_mutex> g(m_mutexAccounts);
+
+  if (dst.size() < offset + UINT256_SIZE) {
+    dst.resize(offset + UINT256_SIZE);
+  }
+  unsigned int curOffset = offset + UINT256_SIZE;
+  boost::multiprecision::uint256_t totalNumOfAccounts = 0;
+
+  auto serializeAccount = [&](const Address& address, const Account& account) {
+    const std::vector<unsigned char> address_vec = address.asBytes();
+    copy(address_vec.begin(), address_vec.end(), std::back_inserter(dst));
+    curOffset += ACC_ADDR_SIZE;
+    curOffset += account.Serialize(dst, curOffset);
+    totalNumOfAccounts++;
+  };
+
+  for (const auto& entry : *this->m_addressToAccount) {
+    serializeAccount(entry.first, entry.second);
+  }
+
+  Account account;
+  for (const auto& i : m_state) {
+    Address address(i.first);
+    if (this->m_addressToAccount->find(address) !=
+        this->m_addressToAccount->end()) {
+      continue;
+    }
+    if (!GetAccountFromTrie(address, dev::RLP(i.second), account)) {
+      continue;
+    }
+    serializeAccount(address, account);
+  }
+
+  Serializable::SetNumber<boost::multiprecision::uint256_t>(
+      dst, offset, totalNumOfAccounts, UINT256_SIZE);
+
+  LOG_GENERAL(INFO, "Serialized " << totalNumOfAccounts << " accounts");
+
+  return curOffset - offset;
 }
 
 template <class DB, class MAP>
 bool AccountStoreTrie<DB, MAP>::UpdateStateTrie(const Address& address,
                                                 const Account& account) {
   // LOG_MARKER();
+  std::lock_guard<std::recursive_mutex> g(m_mutexAccounts);
+
+  // Balance and nonce go in as compacted big-endian bytes, which RLP encodes
+  // the same as the integers, without a round trip through bigint
+  unsigned char balance[Uint256::SIZE], nonce[Uint256::SIZE];
+  account.GetBalance().ToBigEndian(balance);
+  account.GetNonce().ToBigEndian(nonce);
+
   dev::RLPStream rlpStream(RLP_ITEM_COUNT);
-  rlpStream << account.GetBalance() << account.GetNonce()
-            << account.GetStorageRoot() << account.GetCodeHash();
+  rlpStream.append(dev::bytesConstRef(balance, Uint256::SIZE), true);
+  rlpStream.append(dev::bytesConstRef(nonce, Uint256::SIZE), true);
+  rlpStream << account.GetStorageRoot() << account.GetCodeHash();
   m_state.insert(address, &rlpStream.out());
+  MarkDirtyAccount(address);
+  {
+    std::lock_guard<std::mutex> g(m_mutexAccountCache);
+    m_trieUpdatedAccounts.emplace(address);
+  }
 
   return true;
 }
@@ -92,20 +183,93 @@ bool AccountStoreTrie<DB, MAP>::UpdateStateTrie(const Address& address,
 template <class DB, class MAP>
 bool AccountStoreTrie<DB, MAP>::RemoveFromTrie(const Address& address) {
   // LOG_MARKER();
+  std::lock_guard<std::recursive_mutex> g(m_mutexAccounts);
+
   m_state.remove(address);
+  MarkDirtyAccount(address);
 
   return true;
 }
 
+template <class DB, class MAP>
+void AccountStoreTrie<DB, MAP>::TouchCleanAccount(const Address& address) {
+  std::lock_guard<std::mutex> g(m_mutexAccountCache);
+
+  auto it = m_cleanAccountsIndex.find(address);
+  if (it != m_cleanAccountsIndex.end()) {
+    m_cleanAccounts.splice(m_cleanAccounts.end(), m_cleanAccounts, it->second);
+  }
+}
+
+template <class DB, class MAP>
+void AccountStoreTrie<DB, MAP>::AddCleanAccount(const Address& address) {
+  std::lock_guard<std::mutex> g(m_mutexAccountCache);
+
+  m_cleanAccountsIndex.emplace(
+      address, m_cleanAccounts.insert(m_cleanAccounts.end(), address));
+}
+
+template <class DB, class MAP>
+void AccountStoreTrie<DB, MAP>::EvictCleanAccounts() {
+  while (ACCOUNT_CACHE_SIZE > 0 &&
+         m_cleanAccounts.size() > ACCOUNT_CACHE_SIZE) {
+    this->m_addressToAccount->erase(m_cleanAccounts.front());
+    m_cleanAccountsIndex.erase(m_cleanAccounts.front());
+    m_cleanAccounts.pop_front();
+  }
+}
+
+template <class DB, class MAP>
+void AccountStoreTrie<DB, MAP>::MarkDirtyAccount(const Address& address) {
+  std::lock_guard<std::mutex> g(m_mutexAccountCache);
+
+  auto it = m_cleanAccountsIndex.find(address);
+  if (it != m_cleanAccountsIndex.end()) {
+    m_cleanAccounts.erase(it->second);
+    m_cleanAccountsIndex.erase(it);
+  }
+  AccountStoreSC<MAP>::MarkDirtyAccount(address);
+}
+
+template <class DB, class MAP>
+void AccountStoreTrie<DB, MAP>::CommitDirtyAccounts() {
+  std::lock_guard<std::recursive_mutex> e(m_mutexAccounts);
+  std::lock_guard<std::mutex> g(m_mutexAccountCache);
+
+  for (const auto& address : m_trieUpdatedAccounts) {
+    if (this->m_addressToAccount->find(address) !=
+        this->m_addressToAccount->end()) {
+      m_cleanAccountsIndex.emplace(
+          address, m_cleanAccounts.insert(m_cleanAccounts.end(), address));
+    }
+  }
+  m_trieUpdatedAccounts.clear();
+  this->m_dirtyAccounts.clear();
+  EvictCleanAccounts();
+}
+
+template <class DB, class MAP>
+void AccountStoreTrie<DB, MAP>::ClearAccountCache() {
+  std::lock_guard<std::mutex> g(m_mutexAccountCache);
+  m_cleanAccounts.clear();
+  m_cleanAccountsIndex.clear();
+  m_trieUpdatedAccounts.clear();
+  this->m_dirtyAccounts.clear();
+}
+
 template <class DB, class MAP>
 dev::h256 AccountStoreTrie<DB, MAP>::GetStateRootHash() const {
   LOG_MARKER();
 
+  std::lock_guard<std::recursive_mutex> g(m_mutexAccounts);
+
   return m_state.root();
 }
 
 template <class DB, class MAP>
 bool AccountStoreTrie<DB, MAP>::UpdateStateTrieAll() {
+  std::lock_guard<std::recursive_mutex> g(m_mutexAccounts);
+
   for (auto const& entry : *(this->m_addressToAccount)) {
     if (!UpdateStateTrie(entry.first, entry.second)) {
       return false;
@@ -118,6 +282,8 @@ bool AccountStoreTrie<DB, MAP>::UpdateStateTrieAll() {
 template <class DB, class MAP>
 void AccountStoreTrie<DB, MAP>::RepopulateStateTrie() {
   LOG_MARKER();
+  std::lock_guard<std::recursive_mutex> g(m_mutexAccounts);
+
   m_state.init();
   m_prevRoot = m_state.root();
   UpdateStateTrieAll();
@@ -47,18 +47,18 @@ unsigned int Transaction::SerializeCoreFields(std::vector<unsigned char>& dst,
 
   SetNumber<uint256_t>(dst, offset, m_version, UINT256_SIZE);
   offset += UINT256_SIZE;
-  SetNumber<uint256_t>(dst, offset, m_nonce, UINT256_SIZE);
+  SetNumber<Uint256>(dst, offset, m_nonce, UINT256_SIZE);
   offset += UINT256_SIZE;
   copy(m_toAddr.asArray().begin(), m_toAddr.asArray().end(),
        dst.begin() + offset);
   offset += ACC_ADDR_SIZE;
   m_senderPubKey.Serialize(dst, offset);
   offset += PUB_KEY_SIZE;
-  SetNumber<uint256_t>(dst, offset, m_amount, UINT256_SIZE);
+  SetNumber<Uint256>(dst, offset, m_amount, UINT256_SIZE);
   offset += UINT256_SIZE;
-  SetNumber<uint256_t>(dst, offset, m_gasPrice, UINT256_SIZE);
+  SetNumber<Uint256>(dst, offset, m_gasPrice, UINT256_SIZE);
   offset += UINT256_SIZE;
-  SetNumber<uint256_t>(dst, offset, m_gasLimit, UINT256_SIZE);
+  SetNumber<Uint256>(dst, offset, m_gasLimit, UINT256_SIZE);
   offset += UINT256_SIZE;
   SetNumber<uint32_t>(dst, offset, (uint32_t)m_code.size(), sizeof(uint32_t));
   offset += sizeof(uint32_t);
@@ -87,15 +87,28 @@ Transaction::Transaction(const Transaction& src)
       m_data(src.m_data),
       m_signature(src.m_signature) {}
 
+Transaction::Transaction(Transaction&& src) noexcept
+    : m_tranID(src.m_tranID),
+      m_version(std::move(src.m_version)),
+      m_nonce(std::move(src.m_nonce)),
+      m_toAddr(src.m_toAddr),
+      m_senderPubKey(std::move(src.m_senderPubKey)),
+      m_amount(std::move(src.m_amount)),
+      m_gasPrice(std::move(src.m_gasPrice)),
+      m_gasLimit(std::move(src.m_gasLimit)),
+      m_code(std::move(src.m_code)),
+      m_data(std::move(src.m_data)),
+      m_signature(std::move(src.m_signature)) {}
+
 Transaction::Transaction(const vector<unsigned char>& src,
                          unsigned int offset) {
   Deserialize(src, offset);
 }
 
-Transaction::Transaction(uint256_t version, const uint256_t& nonce,
+Transaction::Transaction(uint256_t version, const Uint256& nonce,
                          const Address& toAddr, const KeyPair& senderKeyPair,
-                         const uint256_t& amount, const uint256_t& gasPrice,
-                         const uint256_t& gasLimit,
+                         const Uint256& amount, const Uint256& gasPrice,
+                         const Uint256& gasLimit,
                          const vector<unsigned char>& code,
                          const vector<unsigned char>& data)
     : m_version(version),
@@ -127,10 +140,10 @@ Transaction::Transaction(uint256_t version, const uint256_t& nonce,
   }
 }
 
-Transaction::Transaction(uint256_t version, const uint256_t& nonce,
+Transaction::Transaction(uint256_t version, const Uint256& nonce,
                          const Address& toAddr, const PubKey& senderPubKey,
-                         const uint256_t& amount, const uint256_t& gasPrice,
-                         const uint256_t& gasLimit,
+                         const Uint256& amount, const Uint256& gasPrice,
+                         const Uint256& gasLimit,
                          const std::vector<unsigned char>& code,
                          const std::vector<unsigned char>& data,
                          const Signature& signature)
@@ -195,7 +208,7 @@ int Transaction::Deserialize(const vector<unsigned char>& src,
     offset += TRAN_SIG_SIZE;
     m_version = GetNumber<uint256_t>(src, offset, UINT256_SIZE);
     offset += UINT256_SIZE;
-    m_nonce = GetNumber<uint256_t>(src, offset, UINT256_SIZE);
+    m_nonce = GetNumber<Uint256>(src, offset, UINT256_SIZE);
     offset += UINT256_SIZE;
     copy(src.begin() + offset, src.begin() + offset + ACC_ADDR_SIZE,
          m_toAddr.asArray().begin());
@@ -205,11 +218,11 @@ int Transaction::Deserialize(const vector<unsigned char>& src,
       return -1;
     }
     offset += PUB_KEY_SIZE;
-    m_amount = GetNumber<uint256_t>(src, offset, UINT256_SIZE);
+    m_amount = GetNumber<Uint256>(src, offset, UINT256_SIZE);
     offset += UINT256_SIZE;
-    m_gasPrice = GetNumber<uint256_t>(src, offset, UINT256_SIZE);
+    m_gasPrice = GetNumber<Uint256>(src, offset, UINT256_SIZE);
     offset += UINT256_SIZE;
-    m_gasLimit = GetNumber<uint256_t>(src, offset, UINT256_SIZE);
+    m_gasLimit = GetNumber<Uint256>(src, offset, UINT256_SIZE);
     offset += UINT256_SIZE;
     uint32_t codeSize = GetNumber<uint32_t>(src, offset, sizeof(uint32_t));
     offset += sizeof(uint32_t);
@@ -241,7 +254,7 @@ const TxnHash& Transaction::GetTranID() const { return m_tranID; }
 
 const uint256_t& Transaction::GetVersion() const { return m_version; }
 
-const uint256_t& Transaction::GetNonce() const { return m_nonce; }
+const Uint256& Transaction::GetNonce() const { return m_nonce; }
 
 const Address& Transaction::GetToAddr() const { return m_toAddr; }
 
@@ -251,11 +264,11 @@ Address Transaction::GetSenderAddr() const {
   return Account::GetAddressFromPublicKey(GetSenderPubKey());
 }
 
-const uint256_t& Transaction::GetAmount() const { return m_amount; }
+const Uint256& Transaction::GetAmount() const { return m_amount; }
 
-const uint256_t& Transaction::GetGasPrice() const { return m_gasPrice; }
+const Uint256& Transaction::GetGasPrice() const { return m_gasPrice; }
 
-const uint256_t& Transaction::GetGasLimit() const { return m_gasLimit; }
+const Uint256& Transaction::GetGasLimit() const { return m_gasLimit; }
 
 const vector<unsigned char>& Transaction::GetCode() const { return m_code; }
 
@@ -303,6 +316,29 @@ unsigned int Transaction::GetMinSerializedSize() {
          UINT256_SIZE + sizeof(uint32_t) + sizeof(uint32_t);
 }
 
+unsigned int Transaction::GetSerializedSize(const vector<unsigned char>& src,
+                                            unsigned int offset) {
+  // m_code and m_data are the only variable-length fields and come last, each
+  // prefixed by its length
+  uint64_t size = GetMinSerializedSize() - sizeof(uint32_t);
+  if (offset + size > src.size()) {
+    return 0;
+  }
+  size += GetNumber<uint32_t>(src, offset + size - sizeof(uint32_t),
+                              sizeof(uint32_t));
+
+  if (offset + size + sizeof(uint32_t) > src.size()) {
+    return 0;
+  }
+  size += sizeof(uint32_t) + GetNumber<uint32_t>(src, offset + size,
+                                                 sizeof(uint32_t));
+
+  if (offset + size > src.size()) {
+    return 0;
+  }
+  return size;
+}
+
 bool Transaction::operator==(const Transaction& tran) const {
   return ((m_tranID == tran.m_tranID) && (m_signature == tran.m_signature));
 }
@@ -332,6 +368,22 @@ Transaction& Transaction::operator=(const Transaction& src) {
   return *this;
 }
 
+Transaction& Transaction::operator=(Transaction&& src) noexcept {
+  m_tranID = src.m_tranID;
+  m_signature = std::move(src.m_signature);
+  m_version = std::move(src.m_version);
+  m_nonce = std::move(src.m_nonce);
+  m_toAddr = src.m_toAddr;
+  m_senderPubKey = std::move(src.m_senderPubKey);
+  m_amount = std::move(src.m_amount);
+  m_gasPrice = std::move(src.m_gasPrice);
+  m_gasLimit = std::move(src.m_gasLimit);
+  m_code = std::move(src.m_code);
+  m_data = std::move(src.m_data);
+
+  return *this;
+}
+
 #if 0
 
 unsigned int Predicate::Serialize(vector<unsigned char> & dst, unsigned int offset) const
@@ -21,6 +21,7 @@
 #define __TRANSACTION_H__
 
 #include <array>
+#include <memory>
 #include <vector>
 
 #include <boost/multiprecision/cpp_int.hpp>
@@ -28,23 +29,26 @@
 #include "Address.h"
 #include "common/Constants.h"
 #include "common/Serializable.h"
+#include "common/Uint256.h"
 #include "depends/common/FixedHash.h"
 #include "libCrypto/Schnorr.h"
 
 using TxnHash = dev::h256;
 using KeyPair = std::pair<PrivKey, PubKey>;
 
+class Transaction;
+using TransactionPtr = std::shared_ptr<Transaction>;
+
 /// Stores information on a single transaction.
 class Transaction : public Serializable {
   TxnHash m_tranID;
   boost::multiprecision::uint256_t m_version;
-  boost::multiprecision::uint256_t
-      m_nonce;  // counter: the number of tx from m_fromAddr
+  Uint256 m_nonce;  // counter: the number of tx from m_fromAddr
   Address m_toAddr;
   PubKey m_senderPubKey;
-  boost::multiprecision::uint256_t m_amount;
-  boost::multiprecision::uint256_t m_gasPrice;
-  boost::multiprecision::uint256_t m_gasLimit;
+  Uint256 m_amount;
+  Uint256 m_gasPrice;
+  Uint256 m_gasLimit;
   std::vector<unsigned char> m_code;
   std::vector<unsigned char> m_data;
   Signature m_signature;
@@ -56,23 +60,22 @@ class Transaction : public Serializable {
   /// Copy constructor.
   Transaction(const Transaction& src);
 
+  /// Move constructor.
+  Transaction(Transaction&& src) noexcept;
+
   /// Constructor with specified transaction fields.
-  Transaction(boost::multiprecision::uint256_t version,
-              const boost::multiprecision::uint256_t& nonce,
+  Transaction(boost::multiprecision::uint256_t version, const Uint256& nonce,
               const Address& toAddr, const KeyPair& senderKeyPair,
-              const boost::multiprecision::uint256_t& amount,
-              const boost::multiprecision::uint256_t& gasPrice,
-              const boost::multiprecision::uint256_t& gasLimit,
+              const Uint256& amount, const Uint256& gasPrice,
+              const Uint256& gasLimit,
               const std::vector<unsigned char>& code = {},
               const std::vector<unsigned char>& data = {});
 
   /// Constructor with specified transaction fields.
-  Transaction(boost::multiprecision::uint256_t version,
-              const boost::multiprecision::uint256_t& nonce,
+  Transaction(boost::multiprecision::uint256_t version, const Uint256& nonce,
               const Address& toAddr, const PubKey& senderPubKey,
-              const boost::multiprecision::uint256_t& amount,
-              const boost::multiprecision::uint256_t& gasPrice,
-              const boost::multiprecision::uint256_t& gasLimit,
+              const Uint256& amount, const Uint256& gasPrice,
+              const Uint256& gasLimit,
               const std::vector<unsigned char>& code,
               const std::vector<unsigned char>& data,
               const Signature& signature);
@@ -96,6 +99,11 @@ class Transaction : public Serializable {
   /// Return the size of static typed variables for a minimum size check
   static unsigned int GetMinSerializedSize();
 
+  /// Returns the size of the transaction serialized at offset in src without
+  /// deserializing it, or 0 if src is too short to hold the whole transaction.
+  static unsigned int GetSerializedSize(const std::vector<unsigned char>& src,
+                                        unsigned int offset);
+
   /// Returns the transaction ID.
   const TxnHash& GetTranID() const;
 
@@ -103,7 +111,7 @@ class Transaction : public Serializable {
   const boost::multiprecision::uint256_t& GetVersion() const;
 
   /// Returns the transaction nonce.
-  const boost::multiprecision::uint256_t& GetNonce() const;
+  const Uint256& GetNonce() const;
 
   /// Returns the transaction destination account address.
   const Address& GetToAddr() const;
@@ -115,13 +123,13 @@ class Transaction : public Serializable {
   Address GetSenderAddr() const;
 
   /// Returns the transaction amount.
-  const boost::multiprecision::uint256_t& GetAmount() const;
+  const Uint256& GetAmount() const;
 
   /// Returns the gas price.
-  const boost::multiprecision::uint256_t& GetGasPrice() const;
+  const Uint256& GetGasPrice() const;
 
   /// Returns the gas limit.
-  const boost::multiprecision::uint256_t& GetGasLimit() const;
+  const Uint256& GetGasLimit() const;
 
   /// Returns the code.
   const std::vector<unsigned char>& GetCode() const;
@@ -150,6 +158,9 @@ class Transaction : public Serializable {
 
   /// Assignment operator.
   Transaction& operator=(const Transaction& src);
+
+  /// Move assignment operator.
+  Transaction& operator=(Transaction&& src) noexcept;
 };
 
 #endif  // __TRANSACTION_H__
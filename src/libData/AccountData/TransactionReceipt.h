@@ -63,6 +63,9 @@ class TransactionWithReceipt : public Serializable {
   TransactionWithReceipt(const Transaction& tran,
                          const TransactionReceipt& tranReceipt)
       : m_transaction(tran), m_tranReceipt(tranReceipt) {}
+  TransactionWithReceipt(Transaction&& tran, TransactionReceipt&& tranReceipt)
+      : m_transaction(std::move(tran)),
+        m_tranReceipt(std::move(tranReceipt)) {}
   TransactionWithReceipt(const std::vector<unsigned char>& src,
                          unsigned int offset) {
     Deserialize(src, offset);
@@ -97,6 +100,24 @@ class TransactionWithReceipt : public Serializable {
            m_tranReceipt.GetSerializedSize();
   }
 
+  /// Returns the size of the entry serialized at offset in src without
+  /// deserializing it, or 0 if src is too short to hold the whole entry.
+  static unsigned int GetSerializedSize(const std::vector<unsigned char>& src,
+                                        unsigned int offset) {
+    const uint64_t tranSize = Transaction::GetSerializedSize(src, offset);
+    if (tranSize == 0 || offset + tranSize + sizeof(uint32_t) > src.size()) {
+      return 0;
+    }
+
+    const uint64_t size =
+        tranSize + sizeof(uint32_t) +
+        GetNumber<uint32_t>(src, offset + tranSize, sizeof(uint32_t));
+    if (offset + size > src.size()) {
+      return 0;
+    }
+    return size;
+  }
+
   const Transaction& GetTransaction() const { return m_transaction; }
   const TransactionReceipt& GetTransactionReceipt() const {
     return m_tranReceipt;
@@ -17,6 +17,9 @@
  * program files.
  */
 
+#ifndef __MULTIINDEXCONTAINER_H__
+#define __MULTIINDEXCONTAINER_H__
+
 #include <boost/multi_index/composite_key.hpp>
 #include <boost/multi_index/hashed_index.hpp>
 #include <boost/multi_index/key_extractors.hpp>
@@ -29,10 +32,9 @@
 enum MULTI_INDEX_KEY : unsigned int { GAS_PRICE = 0, TXN_ID, PUBKEY_NONCE };
 
 typedef boost::multi_index::ordered_non_unique<
-    boost::multi_index::const_mem_fun<Transaction,
-                                      const boost::multiprecision::uint256_t&,
+    boost::multi_index::const_mem_fun<Transaction, const Uint256&,
                                       &Transaction::GetGasPrice>,
-    std::greater<boost::multiprecision::uint256_t>>
+    std::greater<Uint256>>
     ordered_non_unique_gas_key;
 
 typedef boost::multi_index::hashed_unique<boost::multi_index::const_mem_fun<
@@ -43,8 +45,7 @@ typedef boost::multi_index::ordered_unique<boost::multi_index::composite_key<
     Transaction,
     boost::multi_index::const_mem_fun<Transaction, const PubKey&,
                                       &Transaction::GetSenderPubKey>,
-    boost::multi_index::const_mem_fun<Transaction,
-                                      const boost::multiprecision::uint256_t&,
+    boost::multi_index::const_mem_fun<Transaction, const Uint256&,
                                       &Transaction::GetNonce>>>
     ordered_unique_comp_pubkey_nonce_key;
 
@@ -58,8 +59,12 @@ static std::size_t hash_value(const uint256_t& value) {
 }  // namespace multiprecision
 }  // namespace boost
 
+// Transactions are held by pointer so that they can be handed off without
+// copying their bodies
 typedef boost::multi_index::multi_index_container<
-    Transaction, boost::multi_index::indexed_by<
-                     ordered_non_unique_gas_key, hashed_unique_txnid_key,
-                     ordered_unique_comp_pubkey_nonce_key>>
-    gas_txnid_comp_txns;
\ No newline at end of file
+    TransactionPtr, boost::multi_index::indexed_by<
+                        ordered_non_unique_gas_key, hashed_unique_txnid_key,
+                        ordered_unique_comp_pubkey_nonce_key>>
+    gas_txnid_comp_txns;
+
+#endif  // __MULTIINDEXCONTAINER_H__
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2018 Zilliqa
+ * This source code is being disclosed to you solely for the purpose of your
+ * participation in testing Zilliqa. You may view, compile and run the code for
+ * that purpose and pursuant to the protocols and algorithms that are programmed
+ * into, and intended by, the code. You may not do anything else with the code
+ * without express permission from Zilliqa Research Pte. Ltd., including
+ * modifying or publishing the code (or any part of it), and developing or
+ * forming another public or private blockchain network. This source code is
+ * provided 'as is' and no warranties are given as to title or non-infringement,
+ * merchantability or fitness for purpose and, to the extent permitted by law,
+ * all liability for your use of the code is disclaimed. Some programs in this
+ * code are governed by the GNU General Public License v3.0 (available at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html) ('GPLv3'). The programs that
+ * are governed by GPLv3.0 are those programs that are located in the folders
+ * src/depends and tests/depends and which include a reference to GPLv3 in their
+ * program files.
+ */
+
+#ifndef __SPENTTXNSTAGE_H__
+#define __SPENTTXNSTAGE_H__
+
+#include <functional>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "common/Uint256.h"
+#include "libData/AccountData/Address.h"
+#include "libData/AccountData/Transaction.h"
+#include "libData/DataStructures/MultiIndexContainer.h"
+
+/// Holds the transactions taken out of a created transaction pool because
+/// their nonce is spent, until it is known whether they can be dropped or
+/// must be put back. The pool and the stage are guarded by the caller, and
+/// the nonces are looked up without holding that guard.
+class SpentTxnStage {
+  std::vector<TransactionPtr> m_txns;
+
+ public:
+  /// A transaction of the pool as seen when it was snapshotted.
+  struct Candidate {
+    TxnHash m_tranID;
+    Address m_senderAddr;
+    Uint256 m_nonce;
+    Address m_toAddr;
+    Uint256 m_amount;
+  };
+
+  /// Lists the transactions of the pool, to be checked once its guard is
+  /// released.
+  static std::vector<Candidate> Snapshot(const gas_txnid_comp_txns& pool) {
+    std::vector<Candidate> candidates;
+    candidates.reserve(pool.size());
+    for (const auto& t : pool) {
+      candidates.push_back({t->GetTranID(), t->GetSenderAddr(), t->GetNonce(),
+                            t->GetToAddr(), t->GetAmount()});
+    }
+    return candidates;
+  }
+
+  /// Returns the candidates whose nonce is below their sender's next nonce.
+  /// getNextNonce is called once per sender.
+  static std::vector<TxnHash> FindSpent(
+      const std::vector<Candidate>& candidates,
+      const std::function<Uint256(const Address&)>& getNextNonce) {
+    std::unordered_map<Address, Uint256> nextNonces;
+    std::vector<TxnHash> spent;
+    for (const auto& c : candidates) {
+      auto it = nextNonces.find(c.m_senderAddr);
+      if (it == nextNonces.end()) {
+        it = nextNonces.emplace(c.m_senderAddr, getNextNonce(c.m_senderAddr))
+                 .first;
+      }
+      if (c.m_nonce < it->second) {
+        spent.emplace_back(c.m_tranID);
+      }
+    }
+    return spent;
+  }
+
+  /// Moves the spent transactions that are still in the pool to the stage.
+  /// Returns the number of transactions moved.
+  size_t Stage(gas_txnid_comp_txns& pool, const std::vector<TxnHash>& spent) {
+    auto& hashIdx = pool.get<MULTI_INDEX_KEY::TXN_ID>();
+    size_t staged = 0;
+    for (const auto& tranID : spent) {
+      auto it = hashIdx.find(tranID);
+      if (it != hashIdx.end()) {
+        m_txns.emplace_back(*it);
+        hashIdx.erase(it);
+        staged++;
+      }
+    }
+    return staged;
+  }
+
+  /// Puts the staged transactions back into the pool. One already back in the
+  /// pool with the same sender and nonce is kept if its gas price is higher.
+  void Restore(gas_txnid_comp_txns& pool) {
+    auto& compIdx = pool.get<MULTI_INDEX_KEY::PUBKEY_NONCE>();
+    for (auto& t : m_txns) {
+      auto it = compIdx.find(std::make_tuple(t->GetSenderPubKey(),
+                                             t->GetNonce()));
+      if (it == compIdx.end()) {
+        compIdx.insert(std::move(t));
+      } else if ((*it)->GetGasPrice() < t->GetGasPrice()) {
+        compIdx.replace(it, std::move(t));
+      }
+    }
+    m_txns.clear();
+  }
+
+  /// Drops the staged transactions.
+  void clear() { m_txns.clear(); }
+
+  /// Returns the number of staged transactions.
+  size_t size() const { return m_txns.size(); }
+
+  /// Returns true if no transactions are staged.
+  bool empty() const { return m_txns.empty(); }
+};
+
+#endif  // __SPENTTXNSTAGE_H__
@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2018 Zilliqa
+ * This source code is being disclosed to you solely for the purpose of your
+ * participation in testing Zilliqa. You may view, compile and run the code for
+ * that purpose and pursuant to the protocols and algorithms that are programmed
+ * into, and intended by, the code. You may not do anything else with the code
+ * without express permission from Zilliqa Research Pte. Ltd., including
+ * modifying or publishing the code (or any part of it), and developing or
+ * forming another public or private blockchain network. This source code is
+ * provided 'as is' and no warranties are given as to title or non-infringement,
+ * merchantability or fitness for purpose and, to the extent permitted by law,
+ * all liability for your use of the code is disclaimed. Some programs in this
+ * code are governed by the GNU General Public License v3.0 (available at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html) ('GPLv3'). The programs that
+ * are governed by GPLv3.0 are those programs that are located in the folders
+ * src/depends and tests/depends and which include a reference to GPLv3 in their
+ * program files.
+ */
+
+#ifndef __TXNPOOL_H__
+#define __TXNPOOL_H__
+
+#include <functional>
+#include <map>
+#include <set>
+#include <unordered_map>
+
+#include "common/Uint256.h"
+#include "libData/AccountData/Address.h"
+#include "libData/AccountData/Transaction.h"
+
+/// Holds transactions whose nonce is ahead of their sender's account nonce,
+/// and tracks which senders have their next transaction ready to execute.
+class TxnPool {
+  struct SenderTxns {
+    /// Next nonce the sender can execute.
+    Uint256 m_nextNonce;
+
+    /// Pending transactions ordered by nonce.
+    std::map<Uint256, Transaction> m_txns;
+  };
+
+  /// Ready senders, highest head gas price first, then by address.
+  struct ReadyCompare {
+    bool operator()(const std::pair<Uint256, Address>& l,
+                    const std::pair<Uint256, Address>& r) const {
+      return (l.first > r.first) || (l.first == r.first && l.second < r.second);
+    }
+  };
+
+  std::unordered_map<Address, SenderTxns> m_senders;
+  std::set<std::pair<Uint256, Address>, ReadyCompare> m_ready;
+  size_t m_size = 0;
+
+  /// Drops transactions the sender can no longer execute and adds the sender
+  /// to the ready set if its lowest pending nonce is the next nonce.
+  void UpdateSender(
+      std::unordered_map<Address, SenderTxns>::iterator senderIt) {
+    SenderTxns& sender = senderIt->second;
+
+    while (!sender.m_txns.empty() &&
+           sender.m_txns.begin()->first < sender.m_nextNonce) {
+      sender.m_txns.erase(sender.m_txns.begin());
+      m_size--;
+    }
+
+    if (sender.m_txns.empty()) {
+      m_senders.erase(senderIt);
+      return;
+    }
+
+    const Transaction& head = sender.m_txns.begin()->second;
+    if (head.GetNonce() == sender.m_nextNonce) {
+      m_ready.emplace(head.GetGasPrice(), senderIt->first);
+    }
+  }
+
+  /// Removes the sender from the ready set if it is there.
+  void UnmarkReady(
+      std::unordered_map<Address, SenderTxns>::const_iterator senderIt) {
+    const SenderTxns& sender = senderIt->second;
+    const Transaction& head = sender.m_txns.begin()->second;
+    if (head.GetNonce() == sender.m_nextNonce) {
+      m_ready.erase({head.GetGasPrice(), senderIt->first});
+    }
+  }
+
+ public:
+  /// Adds a transaction from the given sender, whose next executable nonce is
+  /// nextNonce. If a transaction with the same nonce is already pending, the
+  /// one with the higher gas price is kept. Returns false if the transaction
+  /// was not added.
+  bool Insert(const Address& senderAddr, Transaction t,
+              const Uint256& nextNonce) {
+    const Uint256 nonce = t.GetNonce();
+    if (nonce < nextNonce) {
+      return false;
+    }
+
+    auto senderIt = m_senders.find(senderAddr);
+    if (senderIt == m_senders.end()) {
+      senderIt = m_senders.emplace(senderAddr, SenderTxns()).first;
+    } else {
+      UnmarkReady(senderIt);
+    }
+
+    SenderTxns& sender = senderIt->second;
+    sender.m_nextNonce = nextNonce;
+
+    bool inserted = true;
+    auto txnIt = sender.m_txns.find(nonce);
+    if (txnIt == sender.m_txns.end()) {
+      sender.m_txns.emplace(nonce, std::move(t));
+      m_size++;
+    } else if (t.GetGasPrice() > txnIt->second.GetGasPrice()) {
+      txnIt->second = std::move(t);
+    } else {
+      inserted = false;
+    }
+
+    UpdateSender(senderIt);
+    return inserted;
+  }
+
+  /// Takes out the ready transaction with the highest gas price. The sender
+  /// stays out of the ready set until SetNextNonce is called for it.
+  bool PopReady(Transaction& t) {
+    if (m_ready.empty()) {
+      return false;
+    }
+
+    auto senderIt = m_senders.find(m_ready.begin()->second);
+    m_ready.erase(m_ready.begin());
+
+    SenderTxns& sender = senderIt->second;
+    t = std::move(sender.m_txns.begin()->second);
+    sender.m_txns.erase(sender.m_txns.begin());
+    m_size--;
+
+    if (sender.m_txns.empty()) {
+      m_senders.erase(senderIt);
+    } else {
+      // Keeps the remaining transactions out of the ready set until the
+      // popped one is known to have been applied
+      sender.m_nextNonce = t.GetNonce();
+    }
+
+    return true;
+  }
+
+  /// Records the next executable nonce of a sender, e.g. after one of its
+  /// transactions was applied, and updates the ready set accordingly.
+  void SetNextNonce(const Address& senderAddr, const Uint256& nextNonce) {
+    auto senderIt = m_senders.find(senderAddr);
+    if (senderIt == m_senders.end()) {
+      return;
+    }
+
+    UnmarkReady(senderIt);
+    senderIt->second.m_nextNonce = nextNonce;
+    UpdateSender(senderIt);
+  }
+
+  /// Reloads the next executable nonce of every sender, e.g. after the
+  /// account states have changed.
+  void Refresh(const std::function<Uint256(const Address&)>& getNextNonce) {
+    m_ready.clear();
+    for (auto it = m_senders.begin(); it != m_senders.end();) {
+      auto senderIt = it++;
+      senderIt->second.m_nextNonce = getNextNonce(senderIt->first);
+      UpdateSender(senderIt);
+    }
+  }
+
+  /// Returns the number of pending transactions.
+  size_t size() const { return m_size; }
+
+  /// Returns true if no transactions are pending.
+  bool empty() const { return m_size == 0; }
+
+  /// Returns the number of senders with a ready transaction.
+  size_t ready_size() const { return m_ready.size(); }
+
+  /// Removes all transactions.
+  void clear() {
+    m_senders.clear();
+    m_ready.clear();
+    m_size = 0;
+  }
+};
+
+#endif  // __TXNPOOL_H__
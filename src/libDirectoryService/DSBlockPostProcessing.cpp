@@ -419,7 +419,7 @@ void DirectoryService::StartFirstTxEpoch() {
     m_mediator.m_node->m_myshardId = m_shards.size();
     m_mediator.m_node->m_justDidFallback = false;
     m_mediator.m_node->CommitTxnPacketBuffer();
-    m_stateDeltaFromShards.clear();
+    m_stateDeltasFromShards.clear();
 
     if (TEST_NET_MODE) {
       LOG_GENERAL(INFO, "Updating shard whitelist");
@@ -89,7 +89,8 @@ void DirectoryService::StartSynchronization() {
     }
   };
 
-  DetachedFunction(1, func);
+  // Polls for the whole sync
+  DetachedFunction(DetachedFunction::LongRunning(), 1, func);
 }
 
 bool DirectoryService::CheckState(Action action) {
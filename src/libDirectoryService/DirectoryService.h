@@ -251,11 +251,13 @@ class DirectoryService : public Executable, public Broadcastable {
       std::vector<uint32_t>& shardIds,
       boost::multiprecision::uint256_t& allGasLimit,
       boost::multiprecision::uint256_t& allGasUsed, uint32_t& numTxs,
-      std::vector<bool>& isMicroBlockEmpty, uint32_t& numMicroBlocks);
+      std::vector<bool>& isMicroBlockEmpty, uint32_t& numMicroBlocks,
+      const uint64_t& blockNum);
   bool VerifyMicroBlockCoSignature(const MicroBlock& microBlock,
                                    uint32_t shardId);
   bool ProcessStateDelta(const std::vector<unsigned char>& stateDelta,
-                         const StateHash& microBlockStateDeltaHash);
+                         const StateHash& microBlockStateDeltaHash,
+                         uint32_t shardId);
 
   // FinalBlockValidator functions
   bool CheckBlockHash();
@@ -406,10 +408,10 @@ class DirectoryService : public Executable, public Broadcastable {
   /// The epoch number when DS tries doing Rejoin
   uint64_t m_latestActiveDSBlockNum = 0;
 
-  /// Serialized account store temp to revert to if ds microblock consensus
-  /// failed
-  std::vector<unsigned char> m_stateDeltaFromShards;
-  std::vector<unsigned char> m_stateDeltaWhenRunDSMB;
+  /// State deltas merged into the account store temp, replayed in order to
+  /// revert to if ds microblock consensus failed
+  std::vector<std::vector<unsigned char>> m_stateDeltasFromShards;
+  std::vector<std::vector<unsigned char>> m_stateDeltasWhenRunDSMB;
 
   /// Whether to send txn from ds microblock to lookup at finalblock consensus
   /// done
@@ -326,7 +326,7 @@ void DirectoryService::ProcessFinalBlockConsensusWhenDone() {
   }
 
   AccountStore::GetInstance().InitTemp();
-  m_stateDeltaFromShards.clear();
+  m_stateDeltasFromShards.clear();
   m_allPoWConns.clear();
   ClearDSPoWSolns();
   ResetPoWSubmissionCounter();
@@ -459,7 +459,7 @@ void DirectoryService::CommitFinalBlockConsensusBuffer() {
     auto runconsensus = [this, i]() {
       ProcessFinalBlockConsensusCore(i.second, MessageOffset::BODY, i.first);
     };
-    DetachedFunction(1, runconsensus);
+    DetachedFunction(Executor::CONSENSUS, 1, runconsensus);
   }
 }
 
@@ -558,7 +558,7 @@ bool DirectoryService::ProcessFinalBlockConsensusCore(
 
           ProcessFinalBlockConsensusCore(message, offset, from);
         };
-        DetachedFunction(1, rerunconsensus);
+        DetachedFunction(Executor::CONSENSUS, 1, rerunconsensus);
         return true;
       }
     }
@@ -48,7 +48,8 @@ void DirectoryService::ExtractDataFromMicroblocks(
     std::vector<MicroBlockHashSet>& microblockHashes,
     std::vector<uint32_t>& shardIds, uint256_t& allGasLimit,
     uint256_t& allGasUsed, uint32_t& numTxs,
-    std::vector<bool>& isMicroBlockEmpty, uint32_t& numMicroBlocks) {
+    std::vector<bool>& isMicroBlockEmpty, uint32_t& numMicroBlocks,
+    const uint64_t& blockNum) {
   if (LOOKUP_NODE_MODE) {
     LOG_GENERAL(WARNING,
                 "DirectoryService::ExtractDataFromMicroblocks not expected "
@@ -91,9 +92,10 @@ void DirectoryService::ExtractDataFromMicroblocks(
     }
   }
 
-  microblockTxnTrieRoot = ComputeTransactionsRoot(microblockHashes);
-  microblockDeltaTrieRoot = ComputeDeltasRoot(microblockHashes);
-  microblockTranReceiptRoot = ComputeTranReceiptsRoot(microblockHashes);
+  microblockTxnTrieRoot = ComputeTransactionsRoot(microblockHashes, blockNum);
+  microblockDeltaTrieRoot = ComputeDeltasRoot(microblockHashes, blockNum);
+  microblockTranReceiptRoot =
+      ComputeTranReceiptsRoot(microblockHashes, blockNum);
 
   LOG_EPOCH(INFO, to_string(m_mediator.m_currentEpochNum).c_str(),
             "Proposed FinalBlock TxnTrieRootHash : "
@@ -127,11 +129,6 @@ void DirectoryService::ComposeFinalBlock() {
   uint32_t numMicroBlocks = 0;
   StateHash stateDeltaHash = AccountStore::GetInstance().GetStateDeltaHash();
 
-  ExtractDataFromMicroblocks(microblockTxnTrieRoot, microblockDeltaTrieRoot,
-                             microblockTranReceiptRoot, microBlockHashes,
-                             shardIds, allGasLimit, allGasUsed, numTxs,
-                             isMicroBlockEmpty, numMicroBlocks);
-
   BlockHash prevHash;
   uint256_t timestamp = get_time_as_int();
 
@@ -147,6 +144,11 @@ void DirectoryService::ComposeFinalBlock() {
     blockNum = lastBlock.GetHeader().GetBlockNum() + 1;
   }
 
+  ExtractDataFromMicroblocks(microblockTxnTrieRoot, microblockDeltaTrieRoot,
+                             microblockTranReceiptRoot, microBlockHashes,
+                             shardIds, allGasLimit, allGasUsed, numTxs,
+                             isMicroBlockEmpty, numMicroBlocks, blockNum);
+
   if (m_mediator.m_dsBlockChain.GetBlockCount() <= 0) {
     LOG_GENERAL(WARNING, "assertion failed (" << __FILE__ << ":" << __LINE__
                                               << ": " << __FUNCTION__ << ")");
@@ -505,8 +507,8 @@ bool DirectoryService::CheckMicroBlocks(std::vector<unsigned char>& errorMsg) {
 
     // AccountStore::GetInstance().InitTemp();
     // LOG_GENERAL(WARNING, "Got missing microblocks, revert state delta");
-    // AccountStore::GetInstance().DeserializeDeltaTemp(
-    //     m_mediator.m_ds->m_stateDeltaFromShards, 0);
+    // AccountStore::GetInstance().DeserializeDeltasTemp(
+    //     m_mediator.m_ds->m_stateDeltasFromShards);
 
     m_consensusObject->SetConsensusErrorCode(
         ConsensusCommon::FINALBLOCK_MISSING_MICROBLOCKS);
@@ -637,14 +639,16 @@ bool DirectoryService::CheckMicroBlockHashRoot() {
     LOG_GENERAL(INFO, i);
   }
 
+  const uint64_t& blockNum = m_finalBlock->GetHeader().GetBlockNum();
+
   TxnHash microBlocksTxnRoot =
-      ComputeTransactionsRoot(m_finalBlock->GetMicroBlockHashes());
+      ComputeTransactionsRoot(m_finalBlock->GetMicroBlockHashes(), blockNum);
 
   StateHash microBlocksDeltaRoot =
-      ComputeDeltasRoot(m_finalBlock->GetMicroBlockHashes());
+      ComputeDeltasRoot(m_finalBlock->GetMicroBlockHashes(), blockNum);
 
   TxnHash microBlockTranReceiptsRoot =
-      ComputeTranReceiptsRoot(m_finalBlock->GetMicroBlockHashes());
+      ComputeTranReceiptsRoot(m_finalBlock->GetMicroBlockHashes(), blockNum);
 
   LOG_EPOCH(INFO, to_string(m_mediator.m_currentEpochNum).c_str(),
             "Expected FinalBlock txnRoot : "
@@ -983,11 +987,11 @@ void DirectoryService::RunConsensusOnFinalBlock(bool revertStateDelta) {
       LOG_GENERAL(WARNING,
                   "Failed DS microblock consensus, revert state delta");
       AccountStore::GetInstance().InitTemp();
-      AccountStore::GetInstance().DeserializeDeltaTemp(m_stateDeltaFromShards,
-                                                       0);
+      AccountStore::GetInstance().DeserializeDeltasTemp(
+          m_stateDeltasFromShards);
     }
 
-    AccountStore::GetInstance().SerializeDelta();
+    AccountStore::GetInstance().SerializeDelta(m_mediator.m_currentEpochNum);
 
     AccountStore::GetInstance().CommitTempReversible();
 
@@ -1032,7 +1036,7 @@ void DirectoryService::RunConsensusOnFinalBlock(bool revertStateDelta) {
       LOG_EPOCH(INFO, to_string(m_mediator.m_currentEpochNum).c_str(),
                 "Initiated final block view change. ");
       auto func2 = [this]() -> void { RunConsensusOnViewChange(); };
-      DetachedFunction(1, func2);
+      DetachedFunction(Executor::CONSENSUS, 1, func2);
     }
   };
 
@@ -29,6 +29,7 @@
 #include "depends/libDatabase/MemoryDB.h"
 #include "depends/libTrie/TrieDB.h"
 #include "depends/libTrie/TrieHash.h"
+#include "libCrypto/AggregateKeyCache.h"
 #include "libCrypto/Sha2.h"
 #include "libMediator/Mediator.h"
 #include "libMessage/Messenger.h"
@@ -54,9 +55,7 @@ bool DirectoryService::VerifyMicroBlockCoSignature(const MicroBlock& microBlock,
   LOG_MARKER();
 
   const vector<bool>& B2 = microBlock.GetB2();
-  vector<PubKey> keys;
-  unsigned int index = 0;
-  unsigned int count = 0;
+  vector<const PubKey*> members;
 
   if (shardId == m_shards.size()) {
     if (m_mediator.m_DSCommittee->size() != B2.size()) {
@@ -67,11 +66,7 @@ bool DirectoryService::VerifyMicroBlockCoSignature(const MicroBlock& microBlock,
     }
 
     for (const auto& ds : *m_mediator.m_DSCommittee) {
-      if (B2.at(index)) {
-        keys.emplace_back(ds.first);
-        count++;
-      }
-      index++;
+      members.emplace_back(&ds.first);
     }
   } else {
     const auto& shard = m_shards.at(shardId);
@@ -83,22 +78,20 @@ bool DirectoryService::VerifyMicroBlockCoSignature(const MicroBlock& microBlock,
       return false;
     }
 
-    // Generate the aggregated key
     for (const auto& kv : shard) {
-      if (B2.at(index)) {
-        keys.emplace_back(std::get<SHARD_NODE_PUBKEY>(kv));
-        count++;
-      }
-      index++;
+      members.emplace_back(&std::get<SHARD_NODE_PUBKEY>(kv));
     }
   }
 
-  if (count != ConsensusCommon::NumForConsensus(B2.size())) {
+  if (count(B2.begin(), B2.end(), true) !=
+      ConsensusCommon::NumForConsensus(B2.size())) {
     LOG_GENERAL(WARNING, "Cosig was not generated by enough nodes");
     return false;
   }
 
-  shared_ptr<PubKey> aggregatedKey = MultiSig::AggregatePubKeys(keys);
+  // Generate the aggregated key
+  shared_ptr<const PubKey> aggregatedKey =
+      AggregateKeyCache::GetInstance().Aggregate(members, B2);
   if (aggregatedKey == nullptr) {
     LOG_GENERAL(WARNING, "Aggregated key generation failed");
     return false;
@@ -115,8 +108,10 @@ bool DirectoryService::VerifyMicroBlockCoSignature(const MicroBlock& microBlock,
   if (!Schnorr::GetInstance().Verify(message, 0, message.size(),
                                      microBlock.GetCS2(), *aggregatedKey)) {
     LOG_GENERAL(WARNING, "Cosig verification failed");
-    for (auto& kv : keys) {
-      LOG_GENERAL(WARNING, kv);
+    for (unsigned int i = 0; i < B2.size(); i++) {
+      if (B2.at(i)) {
+        LOG_GENERAL(WARNING, *members.at(i));
+      }
     }
     return false;
   }
@@ -126,7 +121,7 @@ bool DirectoryService::VerifyMicroBlockCoSignature(const MicroBlock& microBlock,
 
 bool DirectoryService::ProcessStateDelta(
     const vector<unsigned char>& stateDelta,
-    const StateHash& microBlockStateDeltaHash) {
+    const StateHash& microBlockStateDeltaHash, uint32_t shardId) {
   LOG_MARKER();
 
   if (LOOKUP_NODE_MODE) {
@@ -171,15 +166,15 @@ bool DirectoryService::ProcessStateDelta(
     return false;
   }
 
-  if (AccountStore::GetInstance().DeserializeDeltaTemp(stateDelta, 0) != 0) {
+  if (AccountStore::GetInstance().MergeShardDeltaTemp(stateDelta, shardId) <
+      0) {
     LOG_GENERAL(WARNING,
-                "AccountStore::GetInstance().DeserializeDeltaTemp failed");
+                "AccountStore::GetInstance().MergeShardDeltaTemp failed");
     return false;
   }
 
-  m_stateDeltaFromShards.clear();
-  AccountStore::GetInstance().SerializeDelta();
-  AccountStore::GetInstance().GetSerializedDelta(m_stateDeltaFromShards);
+  // The merged delta is serialized once, when the final block is prepared
+  m_stateDeltasFromShards.emplace_back(stateDelta);
 
   return true;
 }
@@ -247,7 +242,8 @@ bool DirectoryService::ProcessMicroblockSubmissionFromShardCore(
             microBlocksAtEpoch.size()
                 << " of " << m_shards.size() << " microblocks received");
 
-  ProcessStateDelta(stateDelta, microBlock.GetHeader().GetStateDeltaHash());
+  ProcessStateDelta(stateDelta, microBlock.GetHeader().GetStateDeltaHash(),
+                    shardId);
 
   if (microBlocksAtEpoch.size() == m_shards.size()) {
     if (m_mode == PRIMARY_DS) {
@@ -527,7 +523,7 @@ bool DirectoryService::ProcessMissingMicroblockSubmission(
                   "AccountStore::GetInstance().DeserializeDelta failed");
       return false;
     }
-    AccountStore::GetInstance().SerializeDelta();
+    AccountStore::GetInstance().SerializeDelta(m_mediator.m_currentEpochNum);
   } else {
     LOG_GENERAL(INFO,
                 "State Delta Hash is empty, skip processing final state delta");
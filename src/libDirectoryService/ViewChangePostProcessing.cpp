@@ -29,6 +29,7 @@
 #include "depends/libDatabase/MemoryDB.h"
 #include "depends/libTrie/TrieDB.h"
 #include "depends/libTrie/TrieHash.h"
+#include "libCrypto/AggregateKeyCache.h"
 #include "libCrypto/Sha2.h"
 #include "libMediator/Mediator.h"
 #include "libMessage/Messenger.h"
@@ -53,22 +54,19 @@ void DirectoryService::ProcessViewChangeConsensusWhenDone() {
             "View change consensus is DONE!!!");
   m_pendingVCBlock->SetCoSignatures(*m_consensusObject);
 
-  unsigned int index = 0;
-  unsigned int count = 0;
-
-  vector<PubKey> keys;
-  for (auto const& kv : *m_mediator.m_DSCommittee) {
-    if (m_pendingVCBlock->GetB2().at(index)) {
-      keys.emplace_back(kv.first);
-      count++;
-    }
-    index++;
-  }
+  const vector<bool>& B2 = m_pendingVCBlock->GetB2();
 
   // Verify cosig against vcblock
-  shared_ptr<PubKey> aggregatedKey = MultiSig::AggregatePubKeys(keys);
+  shared_ptr<const PubKey> aggregatedKey =
+      AggregateKeyCache::GetInstance().Aggregate(
+          *m_mediator.m_DSCommittee,
+          [](const pair<PubKey, Peer>& kv) -> const PubKey& {
+            return kv.first;
+          },
+          B2);
   if (aggregatedKey == nullptr) {
     LOG_GENERAL(WARNING, "Aggregated key generation failed");
+    return;
   }
 
   vector<unsigned char> message;
@@ -82,8 +80,10 @@ void DirectoryService::ProcessViewChangeConsensusWhenDone() {
                                         m_pendingVCBlock->GetCS2(),
                                         *aggregatedKey)) {
     LOG_GENERAL(WARNING, "cosig verification fail");
-    for (auto& kv : keys) {
-      LOG_GENERAL(WARNING, kv);
+    for (unsigned int i = 0; i < B2.size(); i++) {
+      if (B2.at(i)) {
+        LOG_GENERAL(WARNING, m_mediator.m_DSCommittee->at(i).first);
+      }
     }
     return;
   }
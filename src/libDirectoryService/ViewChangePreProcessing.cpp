@@ -169,8 +169,8 @@ void DirectoryService::RunConsensusOnViewChange() {
 
   LOG_GENERAL(WARNING, "Run view change, revert state delta");
   AccountStore::GetInstance().InitTemp();
-  AccountStore::GetInstance().DeserializeDeltaTemp(
-      m_mediator.m_ds->m_stateDeltaWhenRunDSMB, 0);
+  AccountStore::GetInstance().DeserializeDeltasTemp(
+      m_mediator.m_ds->m_stateDeltasWhenRunDSMB);
   AccountStore::GetInstance().RevertCommitTemp();
 
   SetLastKnownGoodState();
@@ -233,7 +233,7 @@ void DirectoryService::ScheduleViewChangeTimeout() {
               "Initiated view change again");
 
     auto func = [this]() -> void { RunConsensusOnViewChange(); };
-    DetachedFunction(1, func);
+    DetachedFunction(Executor::CONSENSUS, 1, func);
   }
 }
 
@@ -0,0 +1,503 @@
+/*
+ * Copyright (c) 2018 Zilliqa
+ * This source code is being disclosed to you solely for the purpose of your
+ * participation in testing Zilliqa. You may view, compile and run the code for
+ * that purpose and pursuant to the protocols and algorithms that are programmed
+ * into, and intended by, the code. You may not do anything else with the code
+ * without express permission from Zilliqa Research Pte. Ltd., including
+ * modifying or publishing the code (or any part of it), and developing or
+ * forming another public or private blockchain network. This source code is
+ * provided 'as is' and no warranties are given as to title or non-infringement,
+ * merchantability or fitness for purpose and, to the extent permitted by law,
+ * all liability for your use of the code is disclaimed. Some programs in this
+ * code are governed by the GNU General Public License v3.0 (available at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html) ('GPLv3'). The programs that
+ * are governed by GPLv3.0 are those programs that are located in the folders
+ * src/depends and tests/depends and which include a reference to GPLv3 in their
+ * program files.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+#include "ChunkSync.h"
+#include "common/Constants.h"
+#include "depends/common/SHA3.h"
+#include "libCrypto/Sha2.h"
+#include "libData/AccountData/TransactionReceipt.h"
+#include "libUtils/DataConversion.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+using namespace std::chrono;
+
+namespace {
+/// A peer is no longer asked for chunks after this many failures in a row
+const unsigned int MAX_PEER_FAILURES = 3;
+const milliseconds WAKEUP_INTERVAL{50};
+
+string ToCheckpointField(const string& key) {
+  return key.empty() ? "-"
+                     : DataConversion::Uint8VecToHexStr(
+                           vector<unsigned char>(key.begin(), key.end()));
+}
+
+string FromCheckpointField(const string& field) {
+  if (field == "-") {
+    return "";
+  }
+  const auto bytes = DataConversion::HexStrToUint8Vec(field);
+  return string(bytes.begin(), bytes.end());
+}
+}  // namespace
+
+const string ChunkSync::HEX_KEY_ALPHABET = "0123456789abcdef";
+
+const string ChunkSync::BINARY_KEY_ALPHABET = []() {
+  string alphabet;
+  for (int c = 0; c < 256; c++) {
+    alphabet += static_cast<char>(c);
+  }
+  return alphabet;
+}();
+
+ChunkSync::ChunkSync(SyncDBType dbType, const string& checkpointPath,
+                     Verifier verifier, Writer writer, Requester requester)
+    : m_dbType(dbType),
+      m_checkpointPath(checkpointPath),
+      m_verifier(move(verifier)),
+      m_writer(move(writer)),
+      m_requester(move(requester)),
+      m_chunkSize(DB_SYNC_CHUNK_SIZE_KB * 1024),
+      m_numRanges(DB_SYNC_NUM_RANGES),
+      m_alphabet(HEX_KEY_ALPHABET),
+      m_bandwidthLimit(static_cast<uint64_t>(DB_SYNC_BANDWIDTH_LIMIT_KBPS) *
+                       1024),
+      m_chunkTimeout(seconds(DB_SYNC_CHUNK_TIMEOUT_IN_SECONDS)),
+      m_syncTimeout(seconds(DB_SYNC_TIMEOUT_IN_SECONDS)) {}
+
+vector<ChunkSync::Range> ChunkSync::SplitKeySpace(unsigned int numRanges,
+                                                  const string& alphabet) {
+  // Range boundaries are two character prefixes, keys sorting outside of the
+  // alphabet fall in the first or the last range
+  const size_t base = max(alphabet.size(), (size_t)1);
+  const size_t buckets = base * base;
+  numRanges = max(1u, min(numRanges, (unsigned int)buckets));
+
+  auto prefix = [&alphabet, base](size_t bucket) {
+    return string{alphabet[bucket / base], alphabet[bucket % base]};
+  };
+
+  vector<Range> ranges(numRanges);
+  for (unsigned int i = 0; i < numRanges; i++) {
+    if (i > 0) {
+      ranges[i].m_begin = prefix(i * buckets / numRanges);
+    }
+    if (i + 1 < numRanges) {
+      ranges[i].m_end = prefix((i + 1) * buckets / numRanges);
+    }
+  }
+
+  return ranges;
+}
+
+bool ChunkSync::Run(const vector<Peer>& peers) {
+  LOG_MARKER();
+
+  if (peers.empty()) {
+    LOG_GENERAL(WARNING, "No peers to sync from");
+    return false;
+  }
+
+  unique_lock<mutex> lock(m_mutex);
+
+  m_stopped = false;
+  m_peers.clear();
+  for (const auto& peer : peers) {
+    m_peers.emplace_back();
+    m_peers.back().m_peer = peer;
+  }
+
+  if (!LoadCheckpoint()) {
+    m_ranges.clear();
+    for (const auto& range : SplitKeySpace(m_numRanges, m_alphabet)) {
+      m_ranges.emplace_back();
+      m_ranges.back().m_range = range;
+    }
+  }
+
+  const auto start = steady_clock::now();
+  m_lastRefill = start;
+  m_tokens = m_chunkSize;
+
+  while (true) {
+    const auto now = steady_clock::now();
+
+    if (all_of(m_ranges.begin(), m_ranges.end(),
+               [](const RangeState& s) { return s.m_range.m_done; })) {
+      break;
+    }
+
+    if (m_stopped) {
+      LOG_GENERAL(INFO, "Sync stopped, progress kept in " << m_checkpointPath);
+      return false;
+    }
+
+    if (now - start > m_syncTimeout) {
+      LOG_GENERAL(WARNING, "Sync timed out, progress kept in "
+                               << m_checkpointPath);
+      return false;
+    }
+
+    ExpireRequests(now);
+
+    if (none_of(m_peers.begin(), m_peers.end(), [](const PeerState& p) {
+          return p.m_busy || (p.m_failures < MAX_PEER_FAILURES);
+        })) {
+      LOG_GENERAL(WARNING, "No peer left to sync from, progress kept in "
+                               << m_checkpointPath);
+      return false;
+    }
+
+    const vector<Request> requests = AssignRanges(now);
+
+    if (requests.empty()) {
+      m_cv.wait_for(lock, WAKEUP_INTERVAL);
+      continue;
+    }
+
+    // Requests may be answered before the requester returns
+    lock.unlock();
+    vector<const Request*> failed;
+    for (const auto& request : requests) {
+      if (!m_requester(request.m_peer, request.m_begin, request.m_end,
+                       request.m_startAfter, request.m_maxBytes)) {
+        failed.emplace_back(&request);
+      }
+    }
+    lock.lock();
+
+    for (const auto& request : failed) {
+      auto& state = m_ranges[request->m_range];
+      if ((state.m_peer >= 0) && (state.m_requestID == request->m_requestID)) {
+        ReleaseRange(state, true, 0);
+      }
+    }
+  }
+
+  if (remove(m_checkpointPath.c_str()) != 0) {
+    LOG_GENERAL(INFO, "No checkpoint to remove at " << m_checkpointPath);
+  }
+
+  LOG_GENERAL(INFO,
+              "Sync done: " << m_chunksReceived << " chunks, "
+                            << m_bytesReceived << " bytes in "
+                            << duration_cast<seconds>(steady_clock::now() -
+                                                      start)
+                                   .count()
+                            << " s");
+
+  return true;
+}
+
+bool ChunkSync::ProcessChunk(const string& rangeBegin, const string& startAfter,
+                             const string& lastKey, const Entries& entries,
+                             bool complete) {
+  size_t index;
+  uint64_t requestID;
+  Range range;
+
+  {
+    lock_guard<mutex> g(m_mutex);
+
+    auto it = find_if(m_ranges.begin(), m_ranges.end(),
+                      [&rangeBegin, &startAfter](const RangeState& s) {
+                        return (s.m_peer >= 0) &&
+                               (s.m_range.m_begin == rangeBegin) &&
+                               (s.m_range.m_cursor == startAfter);
+                      });
+    if (it == m_ranges.end()) {
+      LOG_GENERAL(INFO, "Ignoring chunk of a range not being fetched");
+      return false;
+    }
+
+    index = it - m_ranges.begin();
+    requestID = it->m_requestID;
+    range = it->m_range;
+  }
+
+  // Verification and writing are the expensive part, so they run unlocked
+  // while the range stays assigned to the request
+  const bool valid =
+      IsValidChunk(range, startAfter, lastKey, entries, complete);
+  const bool written = valid && (entries.empty() || m_writer(entries));
+
+  if (valid && !written) {
+    LOG_GENERAL(WARNING, "Failed to write synced entries");
+  }
+
+  uint64_t bytes = 0;
+  for (const auto& entry : entries) {
+    bytes += entry.first.size() + entry.second.size();
+  }
+
+  lock_guard<mutex> g(m_mutex);
+
+  if ((index >= m_ranges.size()) || (m_ranges[index].m_peer < 0) ||
+      (m_ranges[index].m_requestID != requestID)) {
+    LOG_GENERAL(INFO, "Chunk arrived after its request expired");
+    return false;
+  }
+
+  auto& state = m_ranges[index];
+  ReleaseRange(state, !valid, bytes);
+  m_cv.notify_all();
+
+  if (!written) {
+    return false;
+  }
+
+  state.m_range.m_cursor = lastKey;
+  state.m_range.m_done = complete;
+  m_bytesReceived += bytes;
+  m_chunksReceived++;
+
+  if (!SaveCheckpoint()) {
+    LOG_GENERAL(WARNING, "Failed to save checkpoint " << m_checkpointPath);
+  }
+
+  return true;
+}
+
+void ChunkSync::Stop() {
+  lock_guard<mutex> g(m_mutex);
+  m_stopped = true;
+  m_cv.notify_all();
+}
+
+uint64_t ChunkSync::GetBytesReceived() const {
+  lock_guard<mutex> g(m_mutex);
+  return m_bytesReceived;
+}
+
+uint64_t ChunkSync::GetChunksReceived() const {
+  lock_guard<mutex> g(m_mutex);
+  return m_chunksReceived;
+}
+
+bool ChunkSync::VerifyTxBody(const string& key, const string& value) {
+  if ((key.size() != 2 * TRAN_HASH_SIZE) ||
+      (value.size() < Transaction::GetMinSerializedSize())) {
+    return false;
+  }
+
+  TransactionWithReceipt body;
+  if (body.Deserialize(vector<unsigned char>(value.begin(), value.end()), 0) !=
+      0) {
+    return false;
+  }
+
+  vector<unsigned char> coreFields;
+  body.GetTransaction().SerializeCoreFields(coreFields, 0);
+
+  SHA2<HASH_TYPE::HASH_VARIANT_256> sha2;
+  sha2.Update(coreFields);
+  const TxnHash tranID(sha2.Finalize());
+
+  return (tranID == body.GetTransaction().GetTranID()) && (tranID.hex() == key);
+}
+
+bool ChunkSync::VerifyStateNode(const string& key, const string& value) {
+  const dev::h256 hash = dev::sha3(value);
+  return key == string(reinterpret_cast<const char*>(hash.data()), hash.size);
+}
+
+bool ChunkSync::IsValidChunk(const Range& range, const string& startAfter,
+                             const string& lastKey, const Entries& entries,
+                             bool complete) const {
+  // A chunk that doesn't end its range must move the cursor forward
+  if (!complete && (lastKey <= startAfter)) {
+    LOG_GENERAL(WARNING, "Chunk makes no progress");
+    return false;
+  }
+
+  if (!range.m_end.empty() && !complete && (lastKey >= range.m_end)) {
+    LOG_GENERAL(WARNING, "Chunk goes past the end of its range");
+    return false;
+  }
+
+  const string* previous = &startAfter;
+
+  for (const auto& entry : entries) {
+    if ((entry.first <= *previous) || (entry.first < range.m_begin) ||
+        (!range.m_end.empty() && (entry.first >= range.m_end))) {
+      LOG_GENERAL(WARNING, "Chunk entry out of order or out of its range");
+      return false;
+    }
+
+    if (!m_verifier(entry.first, entry.second)) {
+      LOG_GENERAL(WARNING, "Chunk entry failed verification");
+      return false;
+    }
+
+    previous = &entry.first;
+  }
+
+  if (!complete && !entries.empty() && (lastKey < entries.back().first)) {
+    LOG_GENERAL(WARNING, "Chunk entries go past its last key");
+    return false;
+  }
+
+  return true;
+}
+
+void ChunkSync::ReleaseRange(RangeState& state, bool failed,
+                             uint64_t bytesReceived) {
+  auto& peer = m_peers[state.m_peer];
+
+  peer.m_busy = false;
+  if (failed) {
+    peer.m_failures++;
+  } else {
+    peer.m_failures = 0;
+  }
+
+  // The request was charged for a full chunk
+  if (m_bandwidthLimit > 0) {
+    m_tokens += static_cast<double>(state.m_requestBytes) - bytesReceived;
+  }
+
+  state.m_peer = -1;
+}
+
+void ChunkSync::ExpireRequests(steady_clock::time_point now) {
+  for (auto& state : m_ranges) {
+    if ((state.m_peer >= 0) && (now - state.m_requestTime > m_chunkTimeout)) {
+      LOG_GENERAL(WARNING, "Chunk request to "
+                               << m_peers[state.m_peer].m_peer
+                               << " timed out");
+      ReleaseRange(state, true, 0);
+    }
+  }
+}
+
+vector<ChunkSync::Request> ChunkSync::AssignRanges(
+    steady_clock::time_point now) {
+  vector<Request> requests;
+  size_t next = 0;
+
+  RefillTokens(now);
+
+  for (size_t i = 0; i < m_peers.size(); i++) {
+    auto& peer = m_peers[i];
+    if (peer.m_busy || (peer.m_failures >= MAX_PEER_FAILURES)) {
+      continue;
+    }
+
+    while ((next < m_ranges.size()) &&
+           (m_ranges[next].m_range.m_done || (m_ranges[next].m_peer >= 0))) {
+      next++;
+    }
+
+    if (next == m_ranges.size()) {
+      break;
+    }
+
+    if (m_bandwidthLimit > 0) {
+      if (m_tokens < m_chunkSize) {
+        break;
+      }
+      m_tokens -= m_chunkSize;
+    }
+
+    auto& state = m_ranges[next];
+    state.m_peer = i;
+    state.m_requestID = ++m_nextRequestID;
+    state.m_requestBytes = m_chunkSize;
+    state.m_requestTime = now;
+    peer.m_busy = true;
+
+    requests.push_back({next, state.m_requestID, peer.m_peer,
+                        state.m_range.m_begin, state.m_range.m_end,
+                        state.m_range.m_cursor, m_chunkSize});
+  }
+
+  return requests;
+}
+
+void ChunkSync::RefillTokens(steady_clock::time_point now) {
+  if (m_bandwidthLimit == 0) {
+    return;
+  }
+
+  // Bursts are limited to one second worth of traffic, or one chunk
+  const double capacity =
+      max(static_cast<double>(m_bandwidthLimit), (double)m_chunkSize);
+  const double elapsed = duration<double>(now - m_lastRefill).count();
+
+  m_tokens = min(capacity, m_tokens + elapsed * m_bandwidthLimit);
+  m_lastRefill = now;
+}
+
+bool ChunkSync::LoadCheckpoint() {
+  ifstream file(m_checkpointPath);
+  if (!file) {
+    return false;
+  }
+
+  unsigned int dbType = 0;
+  size_t count = 0;
+  if (!(file >> dbType >> count) || (dbType != m_dbType) || (count == 0)) {
+    LOG_GENERAL(WARNING, "Ignoring checkpoint " << m_checkpointPath);
+    return false;
+  }
+
+  vector<RangeState> ranges(count);
+  for (auto& state : ranges) {
+    string begin, end, cursor;
+    if (!(file >> begin >> end >> cursor >> state.m_range.m_done)) {
+      LOG_GENERAL(WARNING, "Ignoring corrupted checkpoint "
+                               << m_checkpointPath);
+      return false;
+    }
+    state.m_range.m_begin = FromCheckpointField(begin);
+    state.m_range.m_end = FromCheckpointField(end);
+    state.m_range.m_cursor = FromCheckpointField(cursor);
+  }
+
+  m_ranges = move(ranges);
+
+  LOG_GENERAL(INFO,
+              "Resuming sync from "
+                  << m_checkpointPath << ", "
+                  << count_if(m_ranges.begin(), m_ranges.end(),
+                              [](const RangeState& s) {
+                                return s.m_range.m_done;
+                              })
+                  << " of " << m_ranges.size() << " ranges done");
+
+  return true;
+}
+
+bool ChunkSync::SaveCheckpoint() const {
+  // Written aside and renamed so that a crash never leaves a partial file
+  const string tmpPath = m_checkpointPath + ".tmp";
+
+  {
+    ofstream file(tmpPath, ios::trunc);
+    file << static_cast<unsigned int>(m_dbType) << " " << m_ranges.size()
+         << "\n";
+    for (const auto& state : m_ranges) {
+      file << ToCheckpointField(state.m_range.m_begin) << " "
+           << ToCheckpointField(state.m_range.m_end) << " "
+           << ToCheckpointField(state.m_range.m_cursor) << " "
+           << state.m_range.m_done << "\n";
+    }
+    if (!file) {
+      return false;
+    }
+  }
+
+  return rename(tmpPath.c_str(), m_checkpointPath.c_str()) == 0;
+}
@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2018 Zilliqa
+ * This source code is being disclosed to you solely for the purpose of your
+ * participation in testing Zilliqa. You may view, compile and run the code for
+ * that purpose and pursuant to the protocols and algorithms that are programmed
+ * into, and intended by, the code. You may not do anything else with the code
+ * without express permission from Zilliqa Research Pte. Ltd., including
+ * modifying or publishing the code (or any part of it), and developing or
+ * forming another public or private blockchain network. This source code is
+ * provided 'as is' and no warranties are given as to title or non-infringement,
+ * merchantability or fitness for purpose and, to the extent permitted by law,
+ * all liability for your use of the code is disclaimed. Some programs in this
+ * code are governed by the GNU General Public License v3.0 (available at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html) ('GPLv3'). The programs that
+ * are governed by GPLv3.0 are those programs that are located in the folders
+ * src/depends and tests/depends and which include a reference to GPLv3 in their
+ * program files.
+ */
+
+#ifndef __CHUNKSYNC_H__
+#define __CHUNKSYNC_H__
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "libNetwork/Peer.h"
+
+/// Databases that lookups can sync from each other in chunks.
+enum SyncDBType : unsigned char { SYNC_TX_BODIES = 0x00, SYNC_STATE = 0x01 };
+
+/// Requesting side of the chunked database sync between lookups.
+/// The key space is split in contiguous ranges which are fetched in parallel
+/// from several peers, one range per peer at a time and one chunk at a time
+/// in key order. Every chunk is verified entry by entry before it is written,
+/// and the progress of each range is saved to a checkpoint file so that an
+/// interrupted sync resumes where it stopped.
+class ChunkSync {
+ public:
+  typedef std::vector<std::pair<std::string, std::string>> Entries;
+
+  /// Returns true if value is the content expected under key.
+  typedef std::function<bool(const std::string& key, const std::string& value)>
+      Verifier;
+
+  /// Writes verified entries to the local database.
+  typedef std::function<bool(const Entries& entries)> Writer;
+
+  /// Asks peer for the chunk of [rangeBegin, rangeEnd) following startAfter.
+  typedef std::function<bool(const Peer& peer, const std::string& rangeBegin,
+                             const std::string& rangeEnd,
+                             const std::string& startAfter, uint32_t maxBytes)>
+      Requester;
+
+  /// A contiguous part of the key space.
+  struct Range {
+    std::string m_begin;
+    /// Exclusive, empty for the end of the key space
+    std::string m_end;
+    /// Last key written, empty if nothing was written yet
+    std::string m_cursor;
+    bool m_done = false;
+  };
+
+  /// Characters of the hex encoded hashes keying txBodies.
+  static const std::string HEX_KEY_ALPHABET;
+  /// Every byte, for the raw hashes keying state nodes.
+  static const std::string BINARY_KEY_ALPHABET;
+
+  ChunkSync(SyncDBType dbType, const std::string& checkpointPath,
+            Verifier verifier, Writer writer, Requester requester);
+
+  SyncDBType GetDBType() const { return m_dbType; }
+
+  void SetChunkSize(uint32_t bytes) { m_chunkSize = bytes; }
+  void SetNumRanges(unsigned int numRanges) { m_numRanges = numRanges; }
+  void SetKeyAlphabet(const std::string& alphabet) { m_alphabet = alphabet; }
+  /// 0 means no cap
+  void SetBandwidthLimit(uint64_t bytesPerSecond) {
+    m_bandwidthLimit = bytesPerSecond;
+  }
+  void SetTimeouts(std::chrono::milliseconds chunkTimeout,
+                   std::chrono::milliseconds syncTimeout) {
+    m_chunkTimeout = chunkTimeout;
+    m_syncTimeout = syncTimeout;
+  }
+
+  /// Splits the keys made of the characters of alphabet, which must be in
+  /// ascending order, into numRanges contiguous ranges.
+  static std::vector<Range> SplitKeySpace(unsigned int numRanges,
+                                          const std::string& alphabet);
+
+  /// Fetches every range not synced yet from peers, resuming from the
+  /// checkpoint if there is one. Blocks until all ranges are synced, Stop is
+  /// called, the sync times out, or no peer is left that answers correctly.
+  bool Run(const std::vector<Peer>& peers);
+
+  /// Hands over a chunk received for the range starting at rangeBegin, which
+  /// was requested to follow startAfter and was read up to lastKey.
+  bool ProcessChunk(const std::string& rangeBegin,
+                    const std::string& startAfter, const std::string& lastKey,
+                    const Entries& entries, bool complete);
+
+  /// Makes Run return at its next wake-up. The checkpoint is kept.
+  void Stop();
+
+  uint64_t GetBytesReceived() const;
+  uint64_t GetChunksReceived() const;
+
+  /// Returns true if value is a transaction body whose hash is key.
+  static bool VerifyTxBody(const std::string& key, const std::string& value);
+
+  /// Returns true if value is a state trie node whose hash is key.
+  static bool VerifyStateNode(const std::string& key, const std::string& value);
+
+ private:
+  struct RangeState {
+    Range m_range;
+    /// Index of the peer fetching the range, -1 if none
+    int m_peer = -1;
+    uint64_t m_requestID = 0;
+    uint32_t m_requestBytes = 0;
+    std::chrono::steady_clock::time_point m_requestTime;
+  };
+
+  struct PeerState {
+    Peer m_peer;
+    unsigned int m_failures = 0;
+    bool m_busy = false;
+  };
+
+  struct Request {
+    size_t m_range;
+    uint64_t m_requestID;
+    Peer m_peer;
+    std::string m_begin;
+    std::string m_end;
+    std::string m_startAfter;
+    uint32_t m_maxBytes;
+  };
+
+  bool IsValidChunk(const Range& range, const std::string& startAfter,
+                    const std::string& lastKey, const Entries& entries,
+                    bool complete) const;
+
+  /// The following are called with m_mutex held
+  void ReleaseRange(RangeState& state, bool failed, uint64_t bytesReceived);
+  void ExpireRequests(std::chrono::steady_clock::time_point now);
+  std::vector<Request> AssignRanges(std::chrono::steady_clock::time_point now);
+  void RefillTokens(std::chrono::steady_clock::time_point now);
+  bool LoadCheckpoint();
+  bool SaveCheckpoint() const;
+
+  const SyncDBType m_dbType;
+  const std::string m_checkpointPath;
+  const Verifier m_verifier;
+  const Writer m_writer;
+  const Requester m_requester;
+
+  uint32_t m_chunkSize;
+  unsigned int m_numRanges;
+  std::string m_alphabet;
+  uint64_t m_bandwidthLimit;
+  std::chrono::milliseconds m_chunkTimeout;
+  std::chrono::milliseconds m_syncTimeout;
+
+  mutable std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::vector<RangeState> m_ranges;
+  std::vector<PeerState> m_peers;
+  uint64_t m_nextRequestID = 0;
+  bool m_stopped = false;
+
+  /// Token bucket for the bandwidth cap, in bytes
+  double m_tokens = 0;
+  std::chrono::steady_clock::time_point m_lastRefill;
+
+  uint64_t m_bytesReceived = 0;
+  uint64_t m_chunksReceived = 0;
+};
+
+#endif  // __CHUNKSYNC_H__
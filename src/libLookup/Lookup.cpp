@@ -48,7 +48,6 @@
 #include "libUtils/DetachedFunction.h"
 #include "libUtils/GetTxnFromFile.h"
 #include "libUtils/SanityChecks.h"
-#include "libUtils/SysCommand.h"
 
 using namespace std;
 using namespace boost::multiprecision;
@@ -141,61 +140,64 @@ Transaction CreateValidTestingTransaction(PrivKey& fromPrivKey,
 bool Lookup::GenTxnToSend(size_t num_txn,
                           map<uint32_t, vector<unsigned char>>& mp,
                           uint32_t numShards) {
-  vector<unsigned char> txns;
+  // Views into the mapped txn files, appended straight into the shard buffers
+  vector<dev::bytesConstRef> slices;
 
   if (GENESIS_KEYS.size() == 0) {
     LOG_GENERAL(WARNING, "No genesis keys found");
     return false;
   }
 
+  if (numShards == 0) {
+    return false;
+  }
+
   unsigned int NUM_TXN_TO_DS = num_txn / GENESIS_KEYS.size();
 
+  auto appendSlices = [&slices](vector<unsigned char>& dst) {
+    size_t total = dst.size();
+    for (const auto& slice : slices) {
+      total += slice.size();
+    }
+    dst.reserve(total);
+    for (const auto& slice : slices) {
+      dst.insert(dst.end(), slice.begin(), slice.end());
+    }
+  };
+
   for (auto& privKeyHexStr : GENESIS_KEYS) {
     auto privKeyBytes{DataConversion::HexStrToUint8Vec(privKeyHexStr)};
     auto privKey = PrivKey{privKeyBytes, 0};
     auto pubKey = PubKey{privKey};
     auto addr = Account::GetAddressFromPublicKey(pubKey);
 
-    if (numShards == 0) {
-      return false;
-    }
     auto txnShard = Transaction::GetShardIndex(addr, numShards);
-    txns.clear();
+    slices.clear();
 
     uint256_t nonce = AccountStore::GetInstance().GetAccount(addr)->GetNonce();
 
-    if (!GetTxnFromFile::GetFromFile(addr, static_cast<uint32_t>(nonce) + 1,
-                                     num_txn, txns)) {
+    if (!GetTxnFromFile::GetSlices(addr, static_cast<uint32_t>(nonce) + 1,
+                                   num_txn, slices)) {
       LOG_GENERAL(WARNING, "Failed to get txns from file");
       return false;
     }
 
-    /*Address receiverAddr = GenOneReceiver();
-    unsigned int curr_offset = 0;
-    txns.reserve(n);
-    for (auto i = 0u; i != n; i++)
-    {
-
-        Transaction txn(0, nonce + i + 1, receiverAddr,
-                        make_pair(privKey, pubKey), 10 * i + 2, 1, 1, {},
-                        {});
-
-        curr_offset = txn.Serialize(txns, curr_offset);
-    }*/
-    //[Change back here]
-    copy(txns.begin(), txns.end(), back_inserter(mp[txnShard]));
+    appendSlices(mp[txnShard]);
 
     LOG_GENERAL(INFO, "[Batching] Last Nonce sent "
                           << nonce + num_txn << " of Addr " << addr.hex());
-    txns.clear();
+    slices.clear();
 
-    if (!GetTxnFromFile::GetFromFile(addr,
-                                     static_cast<uint32_t>(nonce) + num_txn + 1,
-                                     NUM_TXN_TO_DS, txns)) {
+    if (!GetTxnFromFile::GetSlices(addr,
+                                   static_cast<uint32_t>(nonce) + num_txn + 1,
+                                   NUM_TXN_TO_DS, slices)) {
       LOG_GENERAL(WARNING, "Failed to get txns for DS");
     }
 
-    copy(txns.begin(), txns.end(), back_inserter(mp[numShards]));
+    appendSlices(mp[numShards]);
+    slices.clear();
+
+    GetTxnFromFile::ReleaseSentFiles(addr, static_cast<uint32_t>(nonce) + 1);
   }
 
   return true;
@@ -884,12 +886,25 @@ bool Lookup::ProcessGetTxBlockFromSeed(const vector<unsigned char>& message,
                                                       << highBlockNum);
 
   vector<TxBlock> txBlocks;
-  uint64_t blockNum;
+  uint64_t blockNum = lowBlockNum;
+
+  // Stream the stored part of the range in one scan
+  BlockStorage::GetBlockStorage().GetTxBlocks(
+      lowBlockNum, highBlockNum,
+      [&txBlocks, &blockNum](const TxBlockSharedPtr& block) {
+        if (block->GetHeader().GetBlockNum() != blockNum) {
+          return false;
+        }
+        txBlocks.emplace_back(*block);
+        blockNum++;
+        return true;
+      });
 
   {
     lock_guard<mutex> g(m_mediator.m_node->m_mutexFinalBlock);
 
-    for (blockNum = lowBlockNum; blockNum <= highBlockNum; blockNum++) {
+    // Blocks not persisted yet come from the chain
+    for (; blockNum <= highBlockNum; blockNum++) {
       try {
         txBlocks.emplace_back(m_mediator.m_txBlockChain.GetBlock(blockNum));
       } catch (const char* e) {
@@ -1735,8 +1750,9 @@ bool Lookup::ProcessSetStateFromSeed(const vector<unsigned char>& message,
       m_currDSExpired = false;
     }
   } else if (m_syncType == SyncType::LOOKUP_SYNC) {
-    // rsync the txbodies here
-    if (RsyncTxBodies() && !m_currDSExpired) {
+    // fetch the txbodies and state trie nodes missed while offline
+    if (SyncDBFromLookups(SyncDBType::SYNC_TX_BODIES) &&
+        SyncDBFromLookups(SyncDBType::SYNC_STATE) && !m_currDSExpired) {
       if (FinishRejoinAsLookup()) {
         m_syncType = SyncType::NO_SYNC;
       }
@@ -1815,6 +1831,119 @@ bool Lookup::ProcessSetTxnsFromLookup(const vector<unsigned char>& message,
   return true;
 }
 
+bool Lookup::ProcessGetDBChunkFromLookup(const vector<unsigned char>& message,
+                                         unsigned int offset,
+                                         const Peer& from) {
+  if (!LOOKUP_NODE_MODE) {
+    LOG_GENERAL(WARNING,
+                "Lookup::ProcessGetDBChunkFromLookup not expected to be "
+                "called from other than the LookUp node.");
+    return true;
+  }
+
+  PubKey lookupPubKey;
+  uint32_t portNo = 0;
+  unsigned char dbType = 0;
+  string rangeBegin, rangeEnd, startAfter;
+  uint32_t maxBytes = 0;
+
+  if (!Messenger::GetLookupGetDBChunkFromLookup(
+          message, offset, lookupPubKey, portNo, dbType, rangeBegin, rangeEnd,
+          startAfter, maxBytes)) {
+    LOG_GENERAL(WARNING, "Messenger::GetLookupGetDBChunkFromLookup failed.");
+    return false;
+  }
+
+  if (!VerifyLookupNode(GetLookupNodes(), lookupPubKey)) {
+    LOG_EPOCH(WARNING, std::to_string(m_mediator.m_currentEpochNum).c_str(),
+              "The message sender pubkey: "
+                  << lookupPubKey << " is not in my lookup node list.");
+    return false;
+  }
+
+  maxBytes = min(maxBytes, DB_SYNC_CHUNK_SIZE_KB * 1024);
+
+  ChunkSync::Entries entries;
+  string lastKey;
+  bool complete;
+
+  switch (dbType) {
+    case SyncDBType::SYNC_TX_BODIES:
+      complete = BlockStorage::GetBlockStorage().GetTxBodiesChunk(
+          rangeBegin, rangeEnd, startAfter, maxBytes, entries, lastKey);
+      break;
+    case SyncDBType::SYNC_STATE:
+      complete = AccountStore::GetInstance().GetStateNodesChunk(
+          rangeBegin, rangeEnd, startAfter, maxBytes, entries, lastKey);
+      break;
+    default:
+      LOG_GENERAL(WARNING, "Unknown DB type " << (unsigned int)dbType);
+      return false;
+  }
+
+  uint128_t ipAddr = from.m_ipAddress;
+  Peer requestingNode(ipAddr, portNo);
+
+  vector<unsigned char> setChunkMessage = {
+      MessageType::LOOKUP, LookupInstructionType::SETDBCHUNKFROMLOOKUP};
+
+  if (!Messenger::SetLookupSetDBChunkFromLookup(
+          setChunkMessage, MessageOffset::BODY, m_mediator.m_selfKey, dbType,
+          rangeBegin, startAfter, lastKey, complete, entries)) {
+    LOG_GENERAL(WARNING, "Messenger::SetLookupSetDBChunkFromLookup failed.");
+    return false;
+  }
+
+  P2PComm::GetInstance().SendMessage(requestingNode, setChunkMessage);
+
+  return true;
+}
+
+bool Lookup::ProcessSetDBChunkFromLookup(const vector<unsigned char>& message,
+                                         unsigned int offset,
+                                         [[gnu::unused]] const Peer& from) {
+  if (!LOOKUP_NODE_MODE) {
+    LOG_GENERAL(WARNING,
+                "Lookup::ProcessSetDBChunkFromLookup not expected to be "
+                "called from other than the LookUp node.");
+    return true;
+  }
+
+  PubKey lookupPubKey;
+  unsigned char dbType = 0;
+  string rangeBegin, startAfter, lastKey;
+  bool complete = false;
+  ChunkSync::Entries entries;
+
+  if (!Messenger::GetLookupSetDBChunkFromLookup(
+          message, offset, lookupPubKey, dbType, rangeBegin, startAfter,
+          lastKey, complete, entries)) {
+    LOG_GENERAL(WARNING, "Messenger::GetLookupSetDBChunkFromLookup failed.");
+    return false;
+  }
+
+  if (!VerifyLookupNode(GetLookupNodes(), lookupPubKey)) {
+    LOG_EPOCH(WARNING, std::to_string(m_mediator.m_currentEpochNum).c_str(),
+              "The message sender pubkey: "
+                  << lookupPubKey << " is not in my lookup node list.");
+    return false;
+  }
+
+  shared_ptr<ChunkSync> chunkSync;
+  {
+    lock_guard<mutex> g(m_mutexChunkSync);
+    chunkSync = m_chunkSync;
+  }
+
+  if (!chunkSync || (chunkSync->GetDBType() != dbType)) {
+    LOG_GENERAL(INFO, "Not syncing DB type " << (unsigned int)dbType);
+    return false;
+  }
+
+  return chunkSync->ProcessChunk(rangeBegin, startAfter, lastKey, entries,
+                                 complete);
+}
+
 void Lookup::SendGetTxnFromLookup(const vector<TxnHash>& txnhashes) {
   vector<unsigned char> msg = {MessageType::LOOKUP,
                                LookupInstructionType::GETTXNFROMLOOKUP};
@@ -1863,6 +1992,7 @@ bool Lookup::ProcessSetTxBodyFromSeed(const vector<unsigned char>& message,
   vector<unsigned char> serializedTxBody;
   twr.Serialize(serializedTxBody, 0);
   BlockStorage::GetBlockStorage().PutTxBody(tranHash, serializedTxBody);
+  BlockStorage::GetBlockStorage().PutContractCreation(twr);
 
   return true;
 }
@@ -2313,29 +2443,8 @@ void Lookup::StartSynchronization() {
       this_thread::sleep_for(chrono::seconds(NEW_NODE_SYNC_INTERVAL));
     }
   };
-  DetachedFunction(1, func);
-}
-
-Peer Lookup::GetLookupPeerToRsync() {
-  if (!LOOKUP_NODE_MODE) {
-    LOG_GENERAL(WARNING,
-                "Lookup::GetLookupPeerToRsync not expected to be called "
-                "from other than the LookUp node.");
-    return Peer();
-  }
-
-  LOG_MARKER();
-
-  std::vector<Peer> t_Peers;
-  for (const auto& p : m_lookupNodes) {
-    if (p.second != m_mediator.m_selfPeer) {
-      t_Peers.emplace_back(p.second);
-    }
-  }
-
-  int index = rand() % t_Peers.size();
-
-  return t_Peers[index];
+  // Polls for the whole sync
+  DetachedFunction(DetachedFunction::LongRunning(), 1, func);
 }
 
 std::vector<unsigned char> Lookup::ComposeGetLookupOfflineMessage() {
@@ -2444,42 +2553,85 @@ bool Lookup::GetMyLookupOnline() {
   return true;
 }
 
-bool Lookup::RsyncTxBodies() {
+bool Lookup::SyncDBFromLookups(SyncDBType dbType) {
   if (!LOOKUP_NODE_MODE) {
     LOG_GENERAL(WARNING,
-                "Lookup::RsyncTxBodies not expected to be called from "
+                "Lookup::SyncDBFromLookups not expected to be called from "
                 "other than the LookUp node.");
     return true;
   }
 
   LOG_MARKER();
-  const Peer& p = GetLookupPeerToRsync();
-  string ipAddr = std::string(p.GetPrintableIPAddress());
-  string port = std::to_string(p.m_listenPortHost);
-  string dbNameStr =
-      BlockStorage::GetBlockStorage().GetDBName(BlockStorage::TX_BODY)[0];
-  string cmdStr;
-  if (ipAddr == "127.0.0.1" || ipAddr == "localhost") {
-    string indexStr = port;
-    indexStr.erase(indexStr.begin());
-    cmdStr = "rsync -iraz --size-only ../node_0" + indexStr + "/" +
-             PERSISTENCE_PATH + "/" + dbNameStr + "/* " + PERSISTENCE_PATH +
-             "/" + dbNameStr + "/";
+
+  vector<Peer> peers;
+  for (const auto& node : GetLookupNodes()) {
+    if (node.second != m_mediator.m_selfPeer) {
+      peers.emplace_back(node.second);
+    }
+  }
+
+  string dbName;
+  string keyAlphabet;
+  ChunkSync::Verifier verifier;
+  ChunkSync::Writer writer;
+
+  if (dbType == SyncDBType::SYNC_TX_BODIES) {
+    dbName =
+        BlockStorage::GetBlockStorage().GetDBName(BlockStorage::TX_BODY)[0];
+    keyAlphabet = ChunkSync::HEX_KEY_ALPHABET;
+    verifier = ChunkSync::VerifyTxBody;
+    writer = [](const ChunkSync::Entries& entries) {
+      return BlockStorage::GetBlockStorage().PutTxBodiesChunk(entries);
+    };
   } else {
-    cmdStr =
-        "rsync -iraz --size-only -e \"ssh -o "
-        "StrictHostKeyChecking=no\" ubuntu@" +
-        ipAddr + ":" + REMOTE_TEST_DIR + "/" + PERSISTENCE_PATH + "/" +
-        dbNameStr + "/* " + PERSISTENCE_PATH + "/" + dbNameStr + "/";
+    dbName = "state";
+    keyAlphabet = ChunkSync::BINARY_KEY_ALPHABET;
+    verifier = ChunkSync::VerifyStateNode;
+    writer = [](const ChunkSync::Entries& entries) {
+      return AccountStore::GetInstance().PutStateNodes(entries);
+    };
   }
-  LOG_GENERAL(INFO, cmdStr);
 
-  string output;
-  if (!SysCommand::ExecuteCmdWithOutput(cmdStr, output)) {
-    return false;
+  auto requester = [this, dbType](const Peer& peer, const string& rangeBegin,
+                                  const string& rangeEnd,
+                                  const string& startAfter,
+                                  uint32_t maxBytes) {
+    vector<unsigned char> getChunkMessage = {
+        MessageType::LOOKUP, LookupInstructionType::GETDBCHUNKFROMLOOKUP};
+
+    if (!Messenger::SetLookupGetDBChunkFromLookup(
+            getChunkMessage, MessageOffset::BODY, m_mediator.m_selfKey,
+            m_mediator.m_selfPeer.m_listenPortHost, dbType, rangeBegin,
+            rangeEnd, startAfter, maxBytes)) {
+      LOG_GENERAL(WARNING, "Messenger::SetLookupGetDBChunkFromLookup failed.");
+      return false;
+    }
+
+    P2PComm::GetInstance().SendMessage(peer, getChunkMessage);
+    return true;
+  };
+
+  auto chunkSync = make_shared<ChunkSync>(
+      dbType, PERSISTENCE_PATH + "/" + dbName + ".sync", verifier, writer,
+      requester);
+  chunkSync->SetKeyAlphabet(keyAlphabet);
+
+  {
+    lock_guard<mutex> g(m_mutexChunkSync);
+    m_chunkSync = chunkSync;
   }
-  LOG_GENERAL(INFO, "RunRsync: " << output);
-  return true;
+
+  LOG_GENERAL(INFO, "Syncing " << dbName << " from " << peers.size()
+                               << " lookups");
+
+  bool result = chunkSync->Run(peers);
+
+  {
+    lock_guard<mutex> g(m_mutexChunkSync);
+    m_chunkSync.reset();
+  }
+
+  return result;
 }
 
 void Lookup::RejoinAsLookup() {
@@ -2551,7 +2703,8 @@ bool Lookup::ToBlockMessage(unsigned char ins_byte) {
           ins_byte != LookupInstructionType::SETTXBLOCKFROMSEED &&
           ins_byte != LookupInstructionType::SETSTATEFROMSEED &&
           ins_byte != LookupInstructionType::SETLOOKUPOFFLINE &&
-          ins_byte != LookupInstructionType::SETLOOKUPONLINE);
+          ins_byte != LookupInstructionType::SETLOOKUPONLINE &&
+          ins_byte != LookupInstructionType::SETDBCHUNKFROMLOOKUP);
 }
 
 std::vector<unsigned char> Lookup::ComposeGetOfflineLookupNodes() {
@@ -2737,7 +2890,9 @@ bool Lookup::Execute(const vector<unsigned char>& message, unsigned int offset,
       &Lookup::ProcessGetTxnsFromLookup,
       &Lookup::ProcessSetTxnsFromLookup,
       &Lookup::ProcessGetDirectoryBlocksFromSeed,
-      &Lookup::ProcessSetDirectoryBlocksFromSeed};
+      &Lookup::ProcessSetDirectoryBlocksFromSeed,
+      &Lookup::ProcessGetDBChunkFromLookup,
+      &Lookup::ProcessSetDBChunkFromLookup};
 
   const unsigned char ins_byte = message.at(offset);
   const unsigned int ins_handlers_count =
@@ -2771,7 +2926,7 @@ bool Lookup::AlreadyJoinedNetwork() {
   return m_syncType == SyncType::NO_SYNC;
 }
 
-bool Lookup::AddToTxnShardMap(const Transaction& tx, uint32_t shardId) {
+bool Lookup::AddToTxnShardMap(Transaction tx, uint32_t shardId) {
   if (!LOOKUP_NODE_MODE) {
     LOG_GENERAL(WARNING,
                 "Lookup::AddToTxnShardMap not expected to be called from "
@@ -2781,7 +2936,7 @@ bool Lookup::AddToTxnShardMap(const Transaction& tx, uint32_t shardId) {
 
   lock_guard<mutex> g(m_txnShardMapMutex);
 
-  m_txnShardMap[shardId].push_back(tx);
+  m_txnShardMap[shardId].push_back(std::move(tx));
 
   return true;
 }
@@ -2827,7 +2982,8 @@ void Lookup::SenderTxnBatchThread() {
       break;
     }
   };
-  DetachedFunction(1, main_func);
+  // May wait for the shards to be known for a long time
+  DetachedFunction(DetachedFunction::LongRunning(), 1, main_func);
 }
 
 void Lookup::SendTxnPacketToNodes(uint32_t numShards) {
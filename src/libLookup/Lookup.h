@@ -25,10 +25,12 @@
 #include <condition_variable>
 #include <cstdlib>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <unordered_set>
 #include <vector>
 
+#include "ChunkSync.h"
 #include "common/Broadcastable.h"
 #include "common/Executable.h"
 #include "libCrypto/Schnorr.h"
@@ -79,12 +81,13 @@ class Lookup : public Executable, public Broadcastable {
   std::mutex m_MutexCVStartPoWSubmission;
   std::condition_variable cv_startPoWSubmission;
 
-  // Rsync the lost txBodies from remote lookup nodes if this lookup are doing
-  // its recovery
-  Peer GetLookupPeerToRsync();
+  /// Fetches the database missed while this lookup was down from the other
+  /// lookups, in verified chunks and resuming any interrupted previous sync
+  bool SyncDBFromLookups(SyncDBType dbType);
 
-  // Doing Rsync commands
-  bool RsyncTxBodies();
+  /// The sync in progress, which receives the chunks sent by other lookups
+  std::shared_ptr<ChunkSync> m_chunkSync;
+  std::mutex m_mutexChunkSync;
 
   /// Post processing after the DS node successfully synchronized with the
   /// network
@@ -195,7 +198,7 @@ class Lookup : public Executable, public Broadcastable {
   // Rejoin the network as a lookup node in case of failure happens in protocol
   void RejoinAsLookup();
 
-  bool AddToTxnShardMap(const Transaction& tx, uint32_t shardId);
+  bool AddToTxnShardMap(Transaction tx, uint32_t shardId);
 
   bool DeleteTxnShardMap(uint32_t shardId);
 
@@ -232,6 +235,11 @@ class Lookup : public Executable, public Broadcastable {
   bool ProcessSetTxnsFromLookup(const std::vector<unsigned char>& message,
                                 unsigned int offset,
                                 [[gnu::unused]] const Peer& from);
+  bool ProcessGetDBChunkFromLookup(const std::vector<unsigned char>& message,
+                                   unsigned int offset, const Peer& from);
+  bool ProcessSetDBChunkFromLookup(const std::vector<unsigned char>& message,
+                                   unsigned int offset,
+                                   [[gnu::unused]] const Peer& from);
   void SendGetTxnFromLookup(const std::vector<TxnHash>& txnhashes);
 
   void CommitMicroBlockStorage();
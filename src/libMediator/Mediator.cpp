@@ -214,7 +214,7 @@ void Mediator::HeartBeatLaunch() {
       }
     }
   };
-  DetachedFunction(1, func);
+  DetachedFunction(DetachedFunction::LongRunning(), 1, func);
 }
 
 void Mediator::HeartBeatPulse() {
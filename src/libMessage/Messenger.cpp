@@ -18,6 +18,7 @@
  */
 
 #include "Messenger.h"
+#include "libCrypto/Sha2.h"
 #include "libData/AccountData/AccountStore.h"
 #include "libData/AccountData/Transaction.h"
 #include "libData/BlockChainData/BlockLinkChain.h"
@@ -1073,6 +1074,47 @@ bool RepeatableToArray(const T& repeatable, vector<unsigned char>& dst,
   return true;
 }
 
+// Serializes each element exactly once, back to back, at the end of dst
+template <class T>
+void SerializablesToArray(const vector<T>& serializables,
+                          vector<unsigned char>& dst) {
+  unsigned int offset = dst.size();
+  for (const auto& serializable : serializables) {
+    offset = serializable.Serialize(dst, offset);
+  }
+}
+
+// Deserializes the back-to-back elements in src in place at the end of dst
+template <class T>
+bool ArrayToSerializables(const vector<unsigned char>& src, vector<T>& dst) {
+  unsigned int offset = 0;
+  while (offset < src.size()) {
+    const unsigned int size = T::GetSerializedSize(src, offset);
+    if (size == 0) {
+      LOG_GENERAL(WARNING, "Truncated element at offset " << offset);
+      return false;
+    }
+
+    dst.emplace_back();
+    if (dst.back().Deserialize(src, offset) != 0) {
+      LOG_GENERAL(WARNING,
+                  "Failed to deserialize element at offset " << offset);
+      return false;
+    }
+    offset += size;
+  }
+  return true;
+}
+
+// Messages carrying many transactions are parsed on an arena sized to the
+// packet, so the nested fields come out of one allocation
+google::protobuf::ArenaOptions PacketArenaOptions(const size_t packetSize) {
+  google::protobuf::ArenaOptions options;
+  options.start_block_size = packetSize;
+  options.max_block_size = max(options.max_block_size, packetSize);
+  return options;
+}
+
 template <class T, size_t S>
 void NumberToArray(const T& number, vector<unsigned char>& dst,
                    const unsigned int offset) {
@@ -1304,6 +1346,53 @@ bool GetConsensusAnnouncementCore(
 
   return true;
 }
+
+/// Hashes the content of a DB chunk, with every variable size field
+/// prefixed by its length so that fields can't be shifted into each other.
+void AppendDBChunkField(vector<unsigned char>& tmp, const string& field) {
+  const uint32_t size = field.size();
+  for (int shift = 24; shift >= 0; shift -= 8) {
+    tmp.push_back(static_cast<unsigned char>(size >> shift));
+  }
+  tmp.insert(tmp.end(), field.begin(), field.end());
+}
+
+vector<unsigned char> GetDBChunkRequestData(
+    const LookupGetDBChunkFromLookup& request) {
+  vector<unsigned char> tmp;
+
+  for (const uint32_t field :
+       {request.portno(), request.dbtype(), request.maxbytes()}) {
+    for (int shift = 24; shift >= 0; shift -= 8) {
+      tmp.push_back(static_cast<unsigned char>(field >> shift));
+    }
+  }
+  AppendDBChunkField(tmp, request.rangebegin());
+  AppendDBChunkField(tmp, request.rangeend());
+  AppendDBChunkField(tmp, request.startafter());
+
+  return tmp;
+}
+
+vector<unsigned char> GetDBChunkHash(const LookupSetDBChunkFromLookup& chunk) {
+  vector<unsigned char> tmp;
+
+  auto append = [&tmp](const string& field) { AppendDBChunkField(tmp, field); };
+
+  tmp.push_back(static_cast<unsigned char>(chunk.dbtype()));
+  append(chunk.rangebegin());
+  append(chunk.startafter());
+  append(chunk.lastkey());
+  tmp.push_back(chunk.complete() ? 1 : 0);
+  for (const auto& entry : chunk.entries()) {
+    append(entry.key());
+    append(entry.value());
+  }
+
+  SHA2<HASH_TYPE::HASH_VARIANT_256> sha2;
+  sha2.Update(tmp);
+  return sha2.Finalize();
+}
 }  // namespace
 
 // ============================================================================
@@ -2313,12 +2402,9 @@ bool Messenger::SetNodeForwardTransaction(
                                    hashes.m_tranReceiptHash.asArray().size());
   result.set_shardid(shardId);
 
-  unsigned int txnsCount = 0;
-
-  for (const auto& txn : txns) {
-    SerializableToProtobufByteArray(txn, *result.add_txnswithreceipt());
-    txnsCount++;
-  }
+  vector<unsigned char> txnBytes;
+  SerializablesToArray(txns, txnBytes);
+  result.set_txnswithreceipt(txnBytes.data(), txnBytes.size());
 
   if (!result.IsInitialized()) {
     LOG_GENERAL(WARNING, "NodeForwardTransaction initialization failed.");
@@ -2327,7 +2413,8 @@ bool Messenger::SetNodeForwardTransaction(
 
   LOG_GENERAL(INFO, "BlockNum: " << blockNum << " shardId: " << shardId
                                  << " Hashes: " << hashes
-                                 << " Txns: " << txnsCount);
+                                 << " Txns: " << txns.size()
+                                 << " Bytes: " << txnBytes.size());
 
   return SerializeToArray(result, dst, offset);
 }
@@ -2337,7 +2424,9 @@ bool Messenger::GetNodeForwardTransaction(const vector<unsigned char>& src,
                                           ForwardedTxnEntry& entry) {
   LOG_MARKER();
 
-  NodeForwardTransaction result;
+  google::protobuf::Arena arena(PacketArenaOptions(src.size() - offset));
+  auto& result =
+      *google::protobuf::Arena::CreateMessage<NodeForwardTransaction>(&arena);
 
   result.ParseFromArray(src.data() + offset, src.size() - offset);
 
@@ -2363,16 +2452,16 @@ bool Messenger::GetNodeForwardTransaction(const vector<unsigned char>& src,
 
   entry.m_shardId = result.shardid();
 
-  unsigned int txnsCount = 0;
-
-  for (const auto& txn : result.txnswithreceipt()) {
-    TransactionWithReceipt txr;
-    ProtobufByteArrayToSerializable(txn, txr);
-    entry.m_transactions.emplace_back(txr);
-    txnsCount++;
+  const vector<unsigned char> txnBytes(result.txnswithreceipt().begin(),
+                                       result.txnswithreceipt().end());
+  if (!ArrayToSerializables(txnBytes, entry.m_transactions)) {
+    LOG_GENERAL(WARNING, "Failed to deserialize transactions.");
+    return false;
   }
 
-  LOG_GENERAL(INFO, entry << endl << " Txns: " << txnsCount);
+  LOG_GENERAL(INFO, entry << endl
+                          << " Txns: " << entry.m_transactions.size()
+                          << " Bytes: " << txnBytes.size());
 
   return true;
 }
@@ -2426,42 +2515,40 @@ bool Messenger::SetNodeForwardTxnBlock(
   result.set_shardid(shardId);
   SerializableToProtobufByteArray(lookupKey.second, *result.mutable_pubkey());
 
-  unsigned int txnsCurrentCount = 0;
-  unsigned int txnsGeneratedCount = 0;
-
-  for (const auto& txn : txnsCurrent) {
-    SerializableToProtobufByteArray(txn, *result.add_transactions());
-    txnsCurrentCount++;
-  }
+  // Current txns are serialized once straight into the signed buffer, and the
+  // pre-generated stream is already in that format so it is only framed and
+  // appended. The signed buffer is then sent as is.
+  vector<unsigned char> txnBytes;
+  txnBytes.reserve(txnsCurrent.size() * Transaction::GetMinSerializedSize() +
+                   txnsGenerated.size());
+  SerializablesToArray(txnsCurrent, txnBytes);
 
+  unsigned int txnsGeneratedCount = 0;
   unsigned int txnStreamOffset = 0;
   while (txnStreamOffset < txnsGenerated.size()) {
-    Transaction txn;
-    if (txn.Deserialize(txnsGenerated, txnStreamOffset) != 0) {
-      LOG_GENERAL(WARNING, "Failed to deserialize generated transaction.");
+    const unsigned int txnSize =
+        Transaction::GetSerializedSize(txnsGenerated, txnStreamOffset);
+    if (txnSize == 0) {
+      LOG_GENERAL(WARNING, "Truncated generated transaction at offset "
+                               << txnStreamOffset);
       return false;
     }
 
-    SerializableToProtobufByteArray(txn, *result.add_transactions());
-
-    txnStreamOffset += txn.GetSerializedSize();
+    txnStreamOffset += txnSize;
     txnsGeneratedCount++;
   }
+  txnBytes.insert(txnBytes.end(), txnsGenerated.begin(), txnsGenerated.end());
 
   Signature signature;
-  if (result.transactions().size() > 0) {
-    std::vector<unsigned char> tmp;
-    if (!RepeatableToArray(result.transactions(), tmp, 0)) {
-      LOG_GENERAL(WARNING, "Failed to serialize transactions.");
-      return false;
-    }
-    if (!Schnorr::GetInstance().Sign(tmp, lookupKey.first, lookupKey.second,
-                                     signature)) {
+  if (!txnBytes.empty()) {
+    if (!Schnorr::GetInstance().Sign(txnBytes, lookupKey.first,
+                                     lookupKey.second, signature)) {
       LOG_GENERAL(WARNING, "Failed to sign transactions.");
       return false;
     }
   }
 
+  result.set_transactions(txnBytes.data(), txnBytes.size());
   SerializableToProtobufByteArray(signature, *result.mutable_signature());
 
   if (!result.IsInitialized()) {
@@ -2469,9 +2556,14 @@ bool Messenger::SetNodeForwardTxnBlock(
     return false;
   }
 
+  // Copies made of the txn bytes: the generated stream into the signed
+  // buffer, the buffer into the message, and the message into dst
+  const size_t bytesCopied = txnsGenerated.size() + 2 * txnBytes.size();
   LOG_GENERAL(INFO, "Epoch: " << epochNumber << " shardId: " << shardId
-                              << " Current txns: " << txnsCurrentCount
-                              << " Generated txns: " << txnsGeneratedCount);
+                              << " Current txns: " << txnsCurrent.size()
+                              << " Generated txns: " << txnsGeneratedCount
+                              << " Txn bytes: " << txnBytes.size()
+                              << " Bytes copied: " << bytesCopied);
 
   return SerializeToArray(result, dst, offset);
 }
@@ -2483,7 +2575,9 @@ bool Messenger::GetNodeForwardTxnBlock(const std::vector<unsigned char>& src,
                                        std::vector<Transaction>& txns) {
   LOG_MARKER();
 
-  NodeForwardTxnBlock result;
+  google::protobuf::Arena arena(PacketArenaOptions(src.size() - offset));
+  auto& result =
+      *google::protobuf::Arena::CreateMessage<NodeForwardTxnBlock>(&arena);
 
   result.ParseFromArray(src.data() + offset, src.size() - offset);
 
@@ -2496,29 +2590,33 @@ bool Messenger::GetNodeForwardTxnBlock(const std::vector<unsigned char>& src,
   shardId = result.shardid();
   ProtobufByteArrayToSerializable(result.pubkey(), lookupPubKey);
 
-  if (result.transactions().size() > 0) {
-    std::vector<unsigned char> tmp;
-    if (!RepeatableToArray(result.transactions(), tmp, 0)) {
-      LOG_GENERAL(WARNING, "Failed to serialize transactions.");
-      return false;
-    }
+  // The signature covers the transactions field byte for byte, so it is
+  // verified and deserialized from a single copy of it
+  const vector<unsigned char> txnBytes(result.transactions().begin(),
+                                       result.transactions().end());
+  if (!txnBytes.empty()) {
     Signature signature;
     ProtobufByteArrayToSerializable(result.signature(), signature);
 
-    if (!Schnorr::GetInstance().Verify(tmp, signature, lookupPubKey)) {
+    if (!Schnorr::GetInstance().Verify(txnBytes, signature, lookupPubKey)) {
       LOG_GENERAL(WARNING, "Invalid signature in transactions.");
       return false;
     }
 
-    for (const auto& txn : result.transactions()) {
-      Transaction t;
-      ProtobufByteArrayToSerializable(txn, t);
-      txns.emplace_back(t);
+    txns.reserve(txns.size() +
+                 txnBytes.size() / Transaction::GetMinSerializedSize());
+    if (!ArrayToSerializables(txnBytes, txns)) {
+      LOG_GENERAL(WARNING, "Failed to deserialize transactions.");
+      return false;
     }
   }
 
+  // Copies made of the txn bytes: parsing into the message, and the single
+  // copy that is verified and deserialized
   LOG_GENERAL(INFO, "Epoch: " << epochNumber << " Shard: " << shardId
-                              << " Received txns: " << txns.size());
+                              << " Received txns: " << txns.size()
+                              << " Txn bytes: " << txnBytes.size()
+                              << " Bytes copied: " << 2 * txnBytes.size());
 
   return true;
 }
@@ -4046,26 +4144,20 @@ bool Messenger::SetLookupSetTxnsFromLookup(
 
   LookupSetTxnsFromLookup result;
 
-  for (auto const& txn : txns) {
-    SerializableToProtobufByteArray(txn, *result.add_transactions());
-  }
+  vector<unsigned char> txnBytes;
+  SerializablesToArray(txns, txnBytes);
 
   SerializableToProtobufByteArray(lookupKey.second, *result.mutable_pubkey());
   Signature signature;
-  if (result.transactions().size() > 0) {
-    std::vector<unsigned char> tmp;
-    if (!RepeatableToArray(result.transactions(), tmp, 0)) {
-      LOG_GENERAL(WARNING, "Failed to serialize transactions.");
-      return false;
-    }
-
-    if (!Schnorr::GetInstance().Sign(tmp, lookupKey.first, lookupKey.second,
-                                     signature)) {
+  if (!txnBytes.empty()) {
+    if (!Schnorr::GetInstance().Sign(txnBytes, lookupKey.first,
+                                     lookupKey.second, signature)) {
       LOG_GENERAL(WARNING, "Failed to sign transactions.");
       return false;
     }
   }
 
+  result.set_transactions(txnBytes.data(), txnBytes.size());
   SerializableToProtobufByteArray(signature, *result.mutable_signature());
 
   if (!result.IsInitialized()) {
@@ -4081,7 +4173,9 @@ bool Messenger::GetLookupSetTxnsFromLookup(
     PubKey& lookupPubKey, vector<TransactionWithReceipt>& txns) {
   LOG_MARKER();
 
-  LookupSetTxnsFromLookup result;
+  google::protobuf::Arena arena(PacketArenaOptions(src.size() - offset));
+  auto& result =
+      *google::protobuf::Arena::CreateMessage<LookupSetTxnsFromLookup>(&arena);
 
   result.ParseFromArray(src.data() + offset, src.size() - offset);
 
@@ -4094,23 +4188,179 @@ bool Messenger::GetLookupSetTxnsFromLookup(
   Signature signature;
   ProtobufByteArrayToSerializable(result.signature(), signature);
 
-  if (result.transactions().size() > 0) {
-    std::vector<unsigned char> tmp;
-    if (!RepeatableToArray(result.transactions(), tmp, 0)) {
-      LOG_GENERAL(WARNING, "Failed to serialize transactions.");
-      return false;
-    }
-
-    if (!Schnorr::GetInstance().Verify(tmp, signature, lookupPubKey)) {
+  const vector<unsigned char> txnBytes(result.transactions().begin(),
+                                       result.transactions().end());
+  if (!txnBytes.empty()) {
+    if (!Schnorr::GetInstance().Verify(txnBytes, signature, lookupPubKey)) {
       LOG_GENERAL(WARNING, "Invalid signature in transactions.");
       return false;
     }
   }
 
-  for (auto const& protoTxn : result.transactions()) {
-    TransactionWithReceipt txn;
-    ProtobufByteArrayToSerializable(protoTxn, txn);
-    txns.emplace_back(txn);
+  if (!ArrayToSerializables(txnBytes, txns)) {
+    LOG_GENERAL(WARNING, "Failed to deserialize transactions.");
+    return false;
+  }
+
+  return true;
+}
+
+bool Messenger::SetLookupGetDBChunkFromLookup(
+    vector<unsigned char>& dst, const unsigned int offset,
+    const pair<PrivKey, PubKey>& lookupKey, const uint32_t portNo,
+    const unsigned char dbType, const string& rangeBegin,
+    const string& rangeEnd, const string& startAfter,
+    const uint32_t maxBytes) {
+  LOG_MARKER();
+
+  LookupGetDBChunkFromLookup result;
+
+  result.set_portno(portNo);
+  result.set_dbtype(dbType);
+  result.set_rangebegin(rangeBegin);
+  result.set_rangeend(rangeEnd);
+  result.set_startafter(startAfter);
+  result.set_maxbytes(maxBytes);
+
+  Signature signature;
+  if (!Schnorr::GetInstance().Sign(GetDBChunkRequestData(result),
+                                   lookupKey.first, lookupKey.second,
+                                   signature)) {
+    LOG_GENERAL(WARNING, "Failed to sign DB chunk request.");
+    return false;
+  }
+
+  SerializableToProtobufByteArray(lookupKey.second, *result.mutable_pubkey());
+  SerializableToProtobufByteArray(signature, *result.mutable_signature());
+
+  if (!result.IsInitialized()) {
+    LOG_GENERAL(WARNING, "LookupGetDBChunkFromLookup initialization failure");
+    return false;
+  }
+
+  return SerializeToArray(result, dst, offset);
+}
+
+bool Messenger::GetLookupGetDBChunkFromLookup(
+    const vector<unsigned char>& src, const unsigned int offset,
+    PubKey& lookupPubKey, uint32_t& portNo, unsigned char& dbType,
+    string& rangeBegin, string& rangeEnd, string& startAfter,
+    uint32_t& maxBytes) {
+  LOG_MARKER();
+
+  LookupGetDBChunkFromLookup result;
+
+  result.ParseFromArray(src.data() + offset, src.size() - offset);
+
+  if (!result.IsInitialized()) {
+    LOG_GENERAL(WARNING, "LookupGetDBChunkFromLookup initialization failure");
+    return false;
+  }
+
+  ProtobufByteArrayToSerializable(result.pubkey(), lookupPubKey);
+  Signature signature;
+  ProtobufByteArrayToSerializable(result.signature(), signature);
+
+  if (!Schnorr::GetInstance().Verify(GetDBChunkRequestData(result), signature,
+                                     lookupPubKey)) {
+    LOG_GENERAL(WARNING, "Invalid signature in DB chunk request.");
+    return false;
+  }
+
+  portNo = result.portno();
+  dbType = result.dbtype();
+  rangeBegin = result.rangebegin();
+  rangeEnd = result.rangeend();
+  startAfter = result.startafter();
+  maxBytes = result.maxbytes();
+
+  return true;
+}
+
+bool Messenger::SetLookupSetDBChunkFromLookup(
+    vector<unsigned char>& dst, const unsigned int offset,
+    const pair<PrivKey, PubKey>& lookupKey, const unsigned char dbType,
+    const string& rangeBegin, const string& startAfter, const string& lastKey,
+    const bool complete, const vector<pair<string, string>>& entries) {
+  LOG_MARKER();
+
+  LookupSetDBChunkFromLookup result;
+
+  result.set_dbtype(dbType);
+  result.set_rangebegin(rangeBegin);
+  result.set_startafter(startAfter);
+  result.set_lastkey(lastKey);
+  result.set_complete(complete);
+
+  for (const auto& entry : entries) {
+    auto protoEntry = result.add_entries();
+    protoEntry->set_key(entry.first);
+    protoEntry->set_value(entry.second);
+  }
+
+  const vector<unsigned char> chunkHash = GetDBChunkHash(result);
+  result.set_chunkhash(chunkHash.data(), chunkHash.size());
+
+  Signature signature;
+  if (!Schnorr::GetInstance().Sign(chunkHash, lookupKey.first,
+                                   lookupKey.second, signature)) {
+    LOG_GENERAL(WARNING, "Failed to sign DB chunk.");
+    return false;
+  }
+
+  SerializableToProtobufByteArray(lookupKey.second, *result.mutable_pubkey());
+  SerializableToProtobufByteArray(signature, *result.mutable_signature());
+
+  if (!result.IsInitialized()) {
+    LOG_GENERAL(WARNING, "LookupSetDBChunkFromLookup initialization failure");
+    return false;
+  }
+
+  return SerializeToArray(result, dst, offset);
+}
+
+bool Messenger::GetLookupSetDBChunkFromLookup(
+    const vector<unsigned char>& src, const unsigned int offset,
+    PubKey& lookupPubKey, unsigned char& dbType, string& rangeBegin,
+    string& startAfter, string& lastKey, bool& complete,
+    vector<pair<string, string>>& entries) {
+  LOG_MARKER();
+
+  LookupSetDBChunkFromLookup result;
+
+  result.ParseFromArray(src.data() + offset, src.size() - offset);
+
+  if (!result.IsInitialized()) {
+    LOG_GENERAL(WARNING, "LookupSetDBChunkFromLookup initialization failure");
+    return false;
+  }
+
+  const vector<unsigned char> chunkHash = GetDBChunkHash(result);
+  if (result.chunkhash() != string(chunkHash.begin(), chunkHash.end())) {
+    LOG_GENERAL(WARNING, "DB chunk hash mismatch.");
+    return false;
+  }
+
+  ProtobufByteArrayToSerializable(result.pubkey(), lookupPubKey);
+  Signature signature;
+  ProtobufByteArrayToSerializable(result.signature(), signature);
+
+  if (!Schnorr::GetInstance().Verify(chunkHash, signature, lookupPubKey)) {
+    LOG_GENERAL(WARNING, "Invalid signature in DB chunk.");
+    return false;
+  }
+
+  dbType = result.dbtype();
+  rangeBegin = result.rangebegin();
+  startAfter = result.startafter();
+  lastKey = result.lastkey();
+  complete = result.complete();
+
+  entries.clear();
+  entries.reserve(result.entries().size());
+  for (auto& entry : *result.mutable_entries()) {
+    entries.emplace_back(move(*entry.mutable_key()),
+                         move(*entry.mutable_value()));
   }
 
   return true;
@@ -476,6 +476,29 @@ class Messenger {
       const std::vector<unsigned char>& src, const unsigned int offset,
       PubKey& lookupPubKey, std::vector<TransactionWithReceipt>& txns);
 
+  static bool SetLookupGetDBChunkFromLookup(
+      std::vector<unsigned char>& dst, const unsigned int offset,
+      const std::pair<PrivKey, PubKey>& lookupKey, const uint32_t portNo,
+      const unsigned char dbType, const std::string& rangeBegin,
+      const std::string& rangeEnd, const std::string& startAfter,
+      const uint32_t maxBytes);
+  static bool GetLookupGetDBChunkFromLookup(
+      const std::vector<unsigned char>& src, const unsigned int offset,
+      PubKey& lookupPubKey, uint32_t& portNo, unsigned char& dbType,
+      std::string& rangeBegin, std::string& rangeEnd, std::string& startAfter,
+      uint32_t& maxBytes);
+  static bool SetLookupSetDBChunkFromLookup(
+      std::vector<unsigned char>& dst, const unsigned int offset,
+      const std::pair<PrivKey, PubKey>& lookupKey, const unsigned char dbType,
+      const std::string& rangeBegin, const std::string& startAfter,
+      const std::string& lastKey, const bool complete,
+      const std::vector<std::pair<std::string, std::string>>& entries);
+  static bool GetLookupSetDBChunkFromLookup(
+      const std::vector<unsigned char>& src, const unsigned int offset,
+      PubKey& lookupPubKey, unsigned char& dbType, std::string& rangeBegin,
+      std::string& startAfter, std::string& lastKey, bool& complete,
+      std::vector<std::pair<std::string, std::string>>& entries);
+
   // ============================================================================
   // Consensus messages
   // ============================================================================
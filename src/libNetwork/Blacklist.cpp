@@ -17,11 +17,20 @@
  * program files.
  */
 
+#include <thread>
+
 #include "Blacklist.h"
 
 using namespace std;
 
-Blacklist::Blacklist() {}
+namespace {
+const size_t INITIAL_CAPACITY = 64;
+}
+
+Blacklist::Blacklist() {
+  m_tables.emplace_back(new Table(INITIAL_CAPACITY));
+  m_table.store(m_tables.back().get(), memory_order_release);
+}
 
 Blacklist::~Blacklist() {}
 
@@ -30,26 +39,150 @@ Blacklist& Blacklist::GetInstance() {
   return blacklist;
 }
 
+size_t Blacklist::Find(const Table& table, uint64_t high, uint64_t low) {
+  size_t index = IPAddr::Hash(high, low) & table.m_mask;
+  for (size_t probes = 0; probes <= table.m_mask; probes++) {
+    const Slot& slot = table.m_slots[index];
+    if (!slot.m_used.load(memory_order_relaxed) ||
+        ((slot.m_high.load(memory_order_relaxed) == high) &&
+         (slot.m_low.load(memory_order_relaxed) == low))) {
+      return index;
+    }
+    index = (index + 1) & table.m_mask;
+  }
+  return table.m_mask + 1;
+}
+
+void Blacklist::BeginWrite() {
+  m_version.store(m_version.load(memory_order_relaxed) + 1,
+                  memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+}
+
+void Blacklist::EndWrite() {
+  m_version.store(m_version.load(memory_order_relaxed) + 1,
+                  memory_order_release);
+}
+
+void Blacklist::Grow() {
+  const Table& oldTable = *m_table.load(memory_order_relaxed);
+  unique_ptr<Table> newTable(new Table((oldTable.m_mask + 1) * 2));
+
+  for (size_t i = 0; i <= oldTable.m_mask; i++) {
+    const Slot& oldSlot = oldTable.m_slots[i];
+    if (!oldSlot.m_used.load(memory_order_relaxed)) {
+      continue;
+    }
+    const uint64_t high = oldSlot.m_high.load(memory_order_relaxed);
+    const uint64_t low = oldSlot.m_low.load(memory_order_relaxed);
+    Slot& newSlot = newTable->m_slots[Find(*newTable, high, low)];
+    newSlot.m_high.store(high, memory_order_relaxed);
+    newSlot.m_low.store(low, memory_order_relaxed);
+    newSlot.m_used.store(true, memory_order_relaxed);
+  }
+
+  // Lookups still probing the old table keep seeing consistent contents
+  m_table.store(newTable.get(), memory_order_release);
+  m_tables.emplace_back(move(newTable));
+}
+
 /// P2PComm may use this function
-bool Blacklist::Exist(const boost::multiprecision::uint128_t& ip) {
-  lock_guard<mutex> g(m_mutexBlacklistIP);
-  return (m_blacklistIP.end() != m_blacklistIP.find(ip));
+bool Blacklist::Exist(const IPAddr& ip) {
+  const uint64_t high = ip.GetHalf(0);
+  const uint64_t low = ip.GetHalf(1);
+
+  while (true) {
+    const uint64_t version = m_version.load(memory_order_acquire);
+    if ((version & 1) != 0) {
+      this_thread::yield();
+      continue;
+    }
+
+    const Table& table = *m_table.load(memory_order_acquire);
+    const size_t index = Find(table, high, low);
+    const bool found = (index <= table.m_mask) &&
+                       table.m_slots[index].m_used.load(memory_order_relaxed);
+
+    atomic_thread_fence(memory_order_acquire);
+    if (m_version.load(memory_order_relaxed) == version) {
+      return found;
+    }
+  }
 }
 
 /// Reputation Manager may use this function
-void Blacklist::Add(const boost::multiprecision::uint128_t& ip) {
+void Blacklist::Add(const IPAddr& ip) {
   lock_guard<mutex> g(m_mutexBlacklistIP);
-  m_blacklistIP.emplace(ip, true);
+
+  const uint64_t high = ip.GetHalf(0);
+  const uint64_t low = ip.GetHalf(1);
+
+  // Keep the load factor at most one half so probes stay short
+  if ((m_size + 1) * 2 > m_table.load(memory_order_relaxed)->m_mask + 1) {
+    Grow();
+  }
+
+  Table& table = *m_table.load(memory_order_relaxed);
+  Slot& slot = table.m_slots[Find(table, high, low)];
+  if (slot.m_used.load(memory_order_relaxed)) {
+    return;
+  }
+
+  BeginWrite();
+  slot.m_high.store(high, memory_order_relaxed);
+  slot.m_low.store(low, memory_order_relaxed);
+  slot.m_used.store(true, memory_order_relaxed);
+  EndWrite();
+  m_size++;
 }
 
 /// Reputation Manager may use this function
-void Blacklist::Remove(const boost::multiprecision::uint128_t& ip) {
+void Blacklist::Remove(const IPAddr& ip) {
   lock_guard<mutex> g(m_mutexBlacklistIP);
-  m_blacklistIP.erase(ip);
+
+  Table& table = *m_table.load(memory_order_relaxed);
+  size_t hole = Find(table, ip.GetHalf(0), ip.GetHalf(1));
+  if (!table.m_slots[hole].m_used.load(memory_order_relaxed)) {
+    return;
+  }
+
+  BeginWrite();
+
+  // Backward-shift deletion, so no tombstones are left behind: later entries
+  // of the probe run move into the hole unless that would put them before
+  // their home slot
+  size_t next = hole;
+  while (true) {
+    next = (next + 1) & table.m_mask;
+    Slot& nextSlot = table.m_slots[next];
+    if (!nextSlot.m_used.load(memory_order_relaxed)) {
+      break;
+    }
+    const uint64_t high = nextSlot.m_high.load(memory_order_relaxed);
+    const uint64_t low = nextSlot.m_low.load(memory_order_relaxed);
+    const size_t home = IPAddr::Hash(high, low) & table.m_mask;
+    if (((next - home) & table.m_mask) >= ((next - hole) & table.m_mask)) {
+      Slot& holeSlot = table.m_slots[hole];
+      holeSlot.m_high.store(high, memory_order_relaxed);
+      holeSlot.m_low.store(low, memory_order_relaxed);
+      hole = next;
+    }
+  }
+  table.m_slots[hole].m_used.store(false, memory_order_relaxed);
+
+  EndWrite();
+  m_size--;
 }
 
 /// Reputation Manager may use this function
 void Blacklist::Clear() {
   lock_guard<mutex> g(m_mutexBlacklistIP);
-  m_blacklistIP.clear();
+
+  Table& table = *m_table.load(memory_order_relaxed);
+  BeginWrite();
+  for (size_t i = 0; i <= table.m_mask; i++) {
+    table.m_slots[i].m_used.store(false, memory_order_relaxed);
+  }
+  EndWrite();
+  m_size = 0;
 }
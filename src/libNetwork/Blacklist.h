@@ -20,19 +20,21 @@
 #ifndef __BLACKLIST_H__
 #define __BLACKLIST_H__
 
-#include <boost/multiprecision/cpp_int.hpp>
+#include <atomic>
+#include <memory>
 #include <mutex>
-#include <unordered_map>
-
-namespace std {
-template <>
-struct hash<boost::multiprecision::uint128_t> {
-  std::size_t operator()(const boost::multiprecision::uint128_t& key) const {
-    return std::hash<std::string>()(key.convert_to<std::string>());
-  }
-};
-}  // namespace std
+#include <vector>
+
+#include "IPAddr.h"
 
+/// Set of blacklisted IPs, checked on every send and accepted connection.
+///
+/// Lookups take no lock. The IPs live in an open-addressing table of atomic
+/// slots guarded by a seqlock: writers, serialized by a mutex, make the
+/// version odd while they change slots, and a lookup that overlapped a change
+/// simply runs again. Outgrown tables are kept until destruction so a lookup
+/// still probing one never reads freed memory; tables only ever double, so
+/// this at most doubles the memory used.
 class Blacklist {
   Blacklist();
   ~Blacklist();
@@ -41,23 +43,50 @@ class Blacklist {
   Blacklist(Blacklist const&) = delete;
   void operator=(Blacklist const&) = delete;
 
+  struct Slot {
+    std::atomic<uint64_t> m_high{0};
+    std::atomic<uint64_t> m_low{0};
+    std::atomic<bool> m_used{false};
+  };
+
+  struct Table {
+    explicit Table(size_t capacity)
+        : m_slots(new Slot[capacity]), m_mask(capacity - 1) {}
+    std::unique_ptr<Slot[]> m_slots;
+    const size_t m_mask;
+  };
+
   std::mutex m_mutexBlacklistIP;
-  std::unordered_map<boost::multiprecision::uint128_t, bool> m_blacklistIP;
+  std::atomic<uint64_t> m_version{0};
+  std::atomic<Table*> m_table{nullptr};
+  std::vector<std::unique_ptr<Table>> m_tables;
+  size_t m_size = 0;
+
+  /// Returns the index of the slot holding the IP, or of the empty slot where
+  /// the probe for it stopped. Returns mask + 1 if the probe found neither,
+  /// which only happens to a lookup racing with a writer.
+  static size_t Find(const Table& table, uint64_t high, uint64_t low);
+
+  void BeginWrite();
+  void EndWrite();
+
+  /// Moves every IP into a table twice the size and publishes it.
+  void Grow();
 
  public:
   static Blacklist& GetInstance();
 
   /// P2PComm may use this function
-  bool Exist(const boost::multiprecision::uint128_t& ip);
+  bool Exist(const IPAddr& ip);
 
   /// Reputation Manager may use this function
-  void Add(const boost::multiprecision::uint128_t& ip);
+  void Add(const IPAddr& ip);
 
   /// Reputation Manager may use this function
-  void Remove(const boost::multiprecision::uint128_t& ip);
+  void Remove(const IPAddr& ip);
 
   /// Reputation Manager may use this function
   void Clear();
 };
 
-#endif  // __BLACKLIST_H__
\ No newline at end of file
+#endif  // __BLACKLIST_H__
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2018 Zilliqa
+ * This source code is being disclosed to you solely for the purpose of your
+ * participation in testing Zilliqa. You may view, compile and run the code for
+ * that purpose and pursuant to the protocols and algorithms that are programmed
+ * into, and intended by, the code. You may not do anything else with the code
+ * without express permission from Zilliqa Research Pte. Ltd., including
+ * modifying or publishing the code (or any part of it), and developing or
+ * forming another public or private blockchain network. This source code is
+ * provided 'as is' and no warranties are given as to title or non-infringement,
+ * merchantability or fitness for purpose and, to the extent permitted by law,
+ * all liability for your use of the code is disclaimed. Some programs in this
+ * code are governed by the GNU General Public License v3.0 (available at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html) ('GPLv3'). The programs that
+ * are governed by GPLv3.0 are those programs that are located in the folders
+ * src/depends and tests/depends and which include a reference to GPLv3 in their
+ * program files.
+ */
+
+#ifndef __IPADDR_H__
+#define __IPADDR_H__
+
+#include <array>
+#include <boost/multiprecision/cpp_int.hpp>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <ostream>
+
+/// IPv4 or IPv6 address held as a fixed 16-byte array.
+///
+/// The bytes are the address' numeric value most significant first, which is
+/// also how Peer puts it on the wire. IPv4 addresses are stored by their
+/// net-encoded s_addr, so they occupy the last four bytes.
+class IPAddr {
+ public:
+  static constexpr unsigned int SIZE = 16;
+
+ private:
+  std::array<unsigned char, SIZE> m_bytes;
+
+  void SetHalf(unsigned int i, uint64_t value) {
+    for (unsigned int j = 8; j > 0; j--) {
+      m_bytes[i * 8 + j - 1] = static_cast<unsigned char>(value);
+      value >>= 8;
+    }
+  }
+
+ public:
+  IPAddr() : m_bytes() {}
+
+  /// Constructs from a number, e.g. the net-encoded s_addr of an IPv4 address.
+  IPAddr(uint64_t value) : m_bytes() { SetHalf(1, value); }
+
+  /// Constructs from the numeric form used before Peer held an IPAddr.
+  IPAddr(const boost::multiprecision::uint128_t& value) {
+    SetHalf(0, static_cast<uint64_t>((value >> 64) & UINT64_MAX));
+    SetHalf(1, static_cast<uint64_t>(value & UINT64_MAX));
+  }
+
+  operator boost::multiprecision::uint128_t() const {
+    boost::multiprecision::uint128_t result = GetHalf(0);
+    result <<= 64;
+    result |= GetHalf(1);
+    return result;
+  }
+
+  /// Constructs from SIZE bytes, most significant first.
+  static IPAddr FromBytes(const unsigned char* src) {
+    IPAddr result;
+    std::memcpy(result.m_bytes.data(), src, SIZE);
+    return result;
+  }
+
+  /// Returns the SIZE bytes, most significant first.
+  const std::array<unsigned char, SIZE>& GetBytes() const { return m_bytes; }
+
+  /// True if the address is an IPv4 one, i.e. fits in the last four bytes.
+  bool IsIPv4() const {
+    return (GetHalf(0) == 0) && ((GetHalf(1) >> 32) == 0);
+  }
+
+  /// Returns the net-encoded s_addr of an IPv4 address.
+  uint32_t GetIPv4() const { return static_cast<uint32_t>(GetHalf(1)); }
+
+  /// Returns bytes [8 * i, 8 * i + 8) as a number, so GetHalf(0) is the high
+  /// half of the address and GetHalf(1) the low half.
+  uint64_t GetHalf(unsigned int i) const {
+    uint64_t result = 0;
+    for (unsigned int j = 0; j < 8; j++) {
+      result = (result << 8) | m_bytes[i * 8 + j];
+    }
+    return result;
+  }
+
+  bool IsZero() const { return (GetHalf(0) | GetHalf(1)) == 0; }
+
+  friend bool operator==(const IPAddr& l, const IPAddr& r) {
+    return l.m_bytes == r.m_bytes;
+  }
+
+  friend bool operator!=(const IPAddr& l, const IPAddr& r) {
+    return l.m_bytes != r.m_bytes;
+  }
+
+  friend bool operator<(const IPAddr& l, const IPAddr& r) {
+    return std::memcmp(l.m_bytes.data(), r.m_bytes.data(), SIZE) < 0;
+  }
+
+  /// Cheap hash of an address given by its two halves.
+  static size_t Hash(uint64_t high, uint64_t low) {
+    uint64_t h = (high * 0x9E3779B97F4A7C15ULL) ^ low;
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    return static_cast<size_t>(h);
+  }
+
+  size_t Hash() const { return Hash(GetHalf(0), GetHalf(1)); }
+};
+
+inline std::ostream& operator<<(std::ostream& os, const IPAddr& ip) {
+  os << static_cast<boost::multiprecision::uint128_t>(ip);
+  return os;
+}
+
+namespace std {
+template <>
+struct hash<IPAddr> {
+  size_t operator()(const IPAddr& ip) const { return ip.Hash(); }
+};
+}  // namespace std
+
+#endif  // __IPADDR_H__
@@ -34,6 +34,7 @@
 
 #include "Blacklist.h"
 #include "P2PComm.h"
+#include "PeerConnectionPool.h"
 #include "PeerStore.h"
 #include "common/Messages.h"
 #include "libCrypto/Sha2.h"
@@ -53,6 +54,7 @@ const unsigned int HASH_LEN = 32;
 const unsigned int GOSSIP_MSGTYPE_LEN = 1;
 const unsigned int GOSSIP_ROUND_LEN = 4;
 const unsigned int GOSSIP_SNDR_LISTNR_PORT_LEN = 4;
+const unsigned int SEND_DISPATCH_BATCH_SIZE = 64;
 
 P2PComm::Dispatcher P2PComm::m_dispatcher;
 P2PComm::BroadcastListFunc P2PComm::m_broadcast_list_retriever;
@@ -65,13 +67,6 @@ struct hash_compare {
   }
 };
 
-static void close_socket(int* cli_sock) {
-  if (cli_sock != NULL) {
-    shutdown(*cli_sock, SHUT_RDWR);
-    close(*cli_sock);
-  }
-}
-
 static bool comparePairSecond(
     const pair<vector<unsigned char>, chrono::time_point<chrono::system_clock>>&
         a,
@@ -86,6 +81,8 @@ P2PComm::P2PComm() : m_sendQueue(SENDQUEUE_SIZE) {
 
     while (true) {
       this_thread::sleep_for(chrono::seconds(BROADCAST_INTERVAL));
+      PeerConnectionPool::GetInstance().RemoveExpired();
+
       lock(m_broadcastToRemoveMutex, m_broadcastHashesMutex);
       lock_guard<mutex> g(m_broadcastToRemoveMutex, adopt_lock);
       lock_guard<mutex> g2(m_broadcastHashesMutex, adopt_lock);
@@ -110,12 +107,12 @@ P2PComm::P2PComm() : m_sendQueue(SENDQUEUE_SIZE) {
     }
   };
 
-  DetachedFunction(1, func);
+  DetachedFunction(DetachedFunction::LongRunning(), 1, func);
 }
 
 P2PComm::~P2PComm() {
   SendJob* job = NULL;
-  while (m_sendQueue.pop(job)) {
+  while (m_sendQueue.TryPopOne(job)) {
     delete job;
   }
 }
@@ -133,7 +130,9 @@ uint32_t SendJob::writeMsg(const void* buf, int cli_sock, const Peer& from,
     ssize_t n = write(cli_sock, (unsigned char*)buf + written_length,
                       message_length - written_length);
 
-    if (errno == EPIPE) {
+    // errno is only meaningful when the write itself failed; a stale EPIPE
+    // from an earlier dead connection must not fail this one
+    if ((n < 0) && (errno == EPIPE)) {
       LOG_GENERAL(WARNING, " SIGPIPE detected. Error No: "
                                << errno << " Desc: " << std::strerror(errno));
       return written_length;
@@ -176,35 +175,22 @@ bool SendJob::SendMessageSocketCore(const Peer& peer,
     return true;
   }
 
-  try {
-    int cli_sock = socket(AF_INET, SOCK_STREAM, 0);
-    unique_ptr<int, void (*)(int*)> cli_sock_closer(&cli_sock, close_socket);
-
-    // LINUX HAS NO SO_NOSIGPIPE
-    // int set = 1;
-    // setsockopt(cli_sock, SOL_SOCKET, SO_NOSIGPIPE, (void *)&set,
-    // sizeof(int));
-    signal(SIGPIPE, SIG_IGN);
-    if (cli_sock < 0) {
-      LOG_GENERAL(WARNING, "Socket creation failed. Code = "
-                               << errno << " Desc: " << std::strerror(errno)
-                               << ". IP address: " << peer);
-      return false;
-    }
+  // LINUX HAS NO SO_NOSIGPIPE
+  // int set = 1;
+  // setsockopt(cli_sock, SOL_SOCKET, SO_NOSIGPIPE, (void *)&set,
+  // sizeof(int));
+  signal(SIGPIPE, SIG_IGN);
 
-    struct sockaddr_in serv_addr;
-    serv_addr.sin_family = AF_INET;
-    serv_addr.sin_addr.s_addr = peer.m_ipAddress.convert_to<unsigned long>();
-    serv_addr.sin_port = htons(peer.m_listenPortHost);
+  PeerConnectionPool& pool = PeerConnectionPool::GetInstance();
+  bool reused = false;
+  int cli_sock = pool.Acquire(peer, reused);
+  if (cli_sock < 0) {
+    return false;
+  }
 
-    if (connect(cli_sock, (struct sockaddr*)&serv_addr, sizeof(serv_addr)) <
-        0) {
-      LOG_GENERAL(WARNING, "Socket connect failed. Code = "
-                               << errno << " Desc: " << std::strerror(errno)
-                               << ". IP address: " << peer);
-      return false;
-    }
+  bool written = false;
 
+  try {
     // Transmission format:
     // 0x01 ~ 0xFF - version, defined in constant file
     // 0x11 - start byte
@@ -220,6 +206,9 @@ bool SendJob::SendMessageSocketCore(const Peer& peer,
     // 0x33 - start byte (report)
     // 0x00 0x00 0x00 0x01 - 4-byte length of message
     // 0x00
+
+    // Several of these frames may be sent back-to-back over one pooled
+    // connection, so a frame is only complete once every byte is written
     uint32_t length = message.size();
 
     if (start_byte == START_BYTE_BROADCAST) {
@@ -233,26 +222,33 @@ bool SendJob::SendMessageSocketCore(const Peer& peer,
                                   (unsigned char)((length >> 8) & 0xFF),
                                   (unsigned char)(length & 0xFF)};
 
-    if (HDR_LEN != writeMsg(buf, cli_sock, peer, HDR_LEN)) {
-      LOG_GENERAL(INFO, "DEBUG: not written_length == " << HDR_LEN);
-    }
+    written = (HDR_LEN == writeMsg(buf, cli_sock, peer, HDR_LEN));
 
-    if (start_byte != START_BYTE_BROADCAST) {
-      writeMsg(&message.at(0), cli_sock, peer, length);
-      return true;
+    if (written && (start_byte == START_BYTE_BROADCAST)) {
+      written =
+          (HASH_LEN == writeMsg(&msg_hash.at(0), cli_sock, peer, HASH_LEN));
+      length -= HASH_LEN;
     }
 
-    if (HASH_LEN != writeMsg(&msg_hash.at(0), cli_sock, peer, HASH_LEN)) {
-      LOG_GENERAL(WARNING, "Wrong message hash length.");
-      return false;
+    if (written) {
+      written = (length == writeMsg(&message.at(0), cli_sock, peer, length));
     }
-
-    length -= HASH_LEN;
-    writeMsg(&message.at(0), cli_sock, peer, length);
   } catch (const std::exception& e) {
     LOG_GENERAL(WARNING, "Error with write socket." << ' ' << e.what());
+    pool.Discard(cli_sock);
     return false;
   }
+
+  if (!written) {
+    // A partially written frame leaves the stream unusable
+    pool.Discard(cli_sock);
+
+    // An idle pooled connection may have been dropped by the other end, so
+    // retry on a new one; a failure on a new connection is not retried
+    return !reused;
+  }
+
+  pool.Release(peer, cli_sock);
   return true;
 }
 
@@ -354,41 +350,105 @@ void P2PComm::EventCallback(struct bufferevent* bev, short events,
     return;
   }
 
-  // Not all bytes read out
-  if (!(events & (BEV_EVENT_EOF | BEV_EVENT_ERROR))) {
+  if (events & BEV_EVENT_TIMEOUT) {
+    LOG_GENERAL(DEBUG, "Closing idle incoming connection.");
+    return;
+  }
+
+  if (!(events & BEV_EVENT_EOF)) {
     LOG_GENERAL(WARNING, "Unknown error from bufferevent.");
     return;
   }
 
-  // Get the IP info
-  int fd = bufferevent_getfd(bev);
-  struct sockaddr_in cli_addr;
-  socklen_t addr_size = sizeof(struct sockaddr_in);
-  getpeername(fd, (struct sockaddr*)&cli_addr, &addr_size);
-  Peer from(cli_addr.sin_addr.s_addr, cli_addr.sin_port);
+  // Complete frames have already been dispatched by ReadCallback
+  struct evbuffer* input = bufferevent_get_input(bev);
+  if ((input != NULL) && (evbuffer_get_length(input) > 0)) {
+    LOG_GENERAL(WARNING, "Connection closed with incomplete message ("
+                             << evbuffer_get_length(input)
+                             << " bytes) in buffer.");
+  }
+}
 
+void P2PComm::ReadCallback(struct bufferevent* bev,
+                           [[gnu::unused]] void* ctx) {
   // Get the data stored in buffer
   struct evbuffer* input = bufferevent_get_input(bev);
   if (input == NULL) {
     LOG_GENERAL(WARNING, "bufferevent_get_input failure.");
+    bufferevent_free(bev);
     return;
   }
-  size_t len = evbuffer_get_length(input);
-  if (len == 0) {
-    LOG_GENERAL(WARNING, "evbuffer_get_length failure.");
-    return;
-  }
-  vector<unsigned char> message(len);
-  if (evbuffer_copyout(input, message.data(), len) !=
-      static_cast<ev_ssize_t>(len)) {
-    LOG_GENERAL(WARNING, "evbuffer_copyout failure.");
-    return;
-  }
-  if (evbuffer_drain(input, len) != 0) {
-    LOG_GENERAL(WARNING, "evbuffer_drain failure.");
-    return;
+
+  // Get the IP info
+  int fd = bufferevent_getfd(bev);
+  struct sockaddr_in cli_addr;
+  socklen_t addr_size = sizeof(struct sockaddr_in);
+  getpeername(fd, (struct sockaddr*)&cli_addr, &addr_size);
+  Peer from(cli_addr.sin_addr.s_addr, cli_addr.sin_port);
+
+  // The sender may stream several frames over the same connection, so
+  // dispatch each frame as soon as it has been completely read
+  while (true) {
+    size_t len = evbuffer_get_length(input);
+
+    if (len < HDR_LEN) {
+      bufferevent_setwatermark(bev, EV_READ, HDR_LEN, 0);
+      return;
+    }
+
+    unsigned char header[HDR_LEN];
+    if (evbuffer_copyout(input, header, HDR_LEN) !=
+        static_cast<ev_ssize_t>(HDR_LEN)) {
+      LOG_GENERAL(WARNING, "evbuffer_copyout failure.");
+      bufferevent_free(bev);
+      return;
+    }
+
+    // A frame with the wrong version means we can't find the next frame
+    // boundary either, so drop the connection
+    if (header[0] != (unsigned char)(MSG_VERSION & 0xFF)) {
+      LOG_GENERAL(WARNING, "Header version wrong, received ["
+                               << header[0] - 0x00 << "] while expected ["
+                               << MSG_VERSION << "].");
+      bufferevent_free(bev);
+      return;
+    }
+
+    const uint32_t messageLength =
+        ((uint32_t)header[2] << 24) + (header[3] << 16) + (header[4] << 8) +
+        header[5];
+
+    // Don't let a peer make us buffer an arbitrarily large frame
+    if (messageLength > MAX_MESSAGE_SIZE_IN_BYTES) {
+      LOG_GENERAL(WARNING, "Message of " << messageLength << " bytes from "
+                                        << from << " exceeds the limit of "
+                                        << MAX_MESSAGE_SIZE_IN_BYTES
+                                        << " bytes.");
+      bufferevent_free(bev);
+      return;
+    }
+
+    const size_t frameLength = HDR_LEN + messageLength;
+
+    if (len < frameLength) {
+      // Don't wake up again until the rest of the frame is here
+      bufferevent_setwatermark(bev, EV_READ, frameLength, 0);
+      return;
+    }
+
+    vector<unsigned char> message(frameLength);
+    if (evbuffer_remove(input, message.data(), frameLength) !=
+        static_cast<ev_ssize_t>(frameLength)) {
+      LOG_GENERAL(WARNING, "evbuffer_remove failure.");
+      bufferevent_free(bev);
+      return;
+    }
+
+    ProcessMessage(message, from);
   }
+}
 
+void P2PComm::ProcessMessage(const vector<unsigned char>& message, Peer from) {
   // Reception format:
   // 0x01 ~ 0xFF - version, defined in constant file
   // 0x11 - start byte
@@ -625,7 +685,14 @@ void P2PComm::AcceptConnectionCallback([[gnu::unused]] evconnlistener* listener,
     return;
   }
 
-  bufferevent_setcb(bev, NULL, NULL, EventCallback, NULL);
+  // Senders close their pooled connections well before this, so the timeout
+  // only reclaims connections that were abandoned without a FIN
+  struct timeval readTimeout = {
+      static_cast<time_t>(2 * PEER_CONN_IDLE_TIMEOUT_IN_SECONDS), 0};
+  bufferevent_set_timeouts(bev, &readTimeout, NULL);
+
+  bufferevent_setwatermark(bev, EV_READ, HDR_LEN, 0);
+  bufferevent_setcb(bev, ReadCallback, NULL, EventCallback, NULL);
   bufferevent_enable(bev, EV_READ | EV_WRITE);
 }
 
@@ -635,14 +702,19 @@ void P2PComm::StartMessagePump(uint32_t listen_port_host, Dispatcher dispatcher,
 
   // Launch the thread that reads messages from the send queue
   auto funcCheckSendQueue = [this]() mutable -> void {
-    SendJob* job = NULL;
+    vector<SendJob*> jobs;
     while (true) {
-      while (m_sendQueue.pop(job)) {
+      jobs.clear();
+      if (m_sendQueue.PopBatch(jobs, SEND_DISPATCH_BATCH_SIZE) ==
+          SEND_DISPATCH_BATCH_SIZE) {
+        LOG_GENERAL(INFO, "Send queue backlog: " << m_sendQueue.GetDepth());
+      }
+      for (auto job : jobs) {
         ProcessSendJob(job);
       }
     }
   };
-  DetachedFunction(1, funcCheckSendQueue);
+  DetachedFunction(DetachedFunction::LongRunning(), 1, funcCheckSendQueue);
 
   int serv_sock = socket(AF_INET, SOCK_STREAM, 0);
   if (serv_sock < 0) {
@@ -697,9 +769,7 @@ void P2PComm::SendMessage(const vector<Peer>& peers,
   job->m_hash.clear();
 
   // Queue job
-  while (!m_sendQueue.push(job)) {
-    // Keep attempting to push until success
-  }
+  m_sendQueue.Push(job);
 }
 
 void P2PComm::SendMessage(const deque<Peer>& peers,
@@ -720,9 +790,7 @@ void P2PComm::SendMessage(const deque<Peer>& peers,
   job->m_hash.clear();
 
   // Queue job
-  while (!m_sendQueue.push(job)) {
-    // Keep attempting to push until success
-  }
+  m_sendQueue.Push(job);
 }
 
 void P2PComm::SendMessage(const Peer& peer,
@@ -739,9 +807,7 @@ void P2PComm::SendMessage(const Peer& peer,
   job->m_hash.clear();
 
   // Queue job
-  while (!m_sendQueue.push(job)) {
-    // Keep attempting to push until success
-  }
+  m_sendQueue.Push(job);
 }
 
 void P2PComm::SendBroadcastMessage(const vector<Peer>& peers,
@@ -764,9 +830,7 @@ void P2PComm::SendBroadcastMessage(const vector<Peer>& peers,
   job->m_hash = sha256.Finalize();
 
   // Queue job
-  while (!m_sendQueue.push(job)) {
-    // Keep attempting to push until success
-  }
+  m_sendQueue.Push(job);
 
   lock_guard<mutex> guard(m_broadcastHashesMutex);
   m_broadcastHashes.insert(job->m_hash);
@@ -792,9 +856,7 @@ void P2PComm::SendBroadcastMessage(const deque<Peer>& peers,
   job->m_hash = sha256.Finalize();
 
   // Queue job
-  while (!m_sendQueue.push(job)) {
-    // Keep attempting to push until success
-  }
+  m_sendQueue.Push(job);
 
   lock_guard<mutex> guard(m_broadcastHashesMutex);
   m_broadcastHashes.insert(job->m_hash);
@@ -815,9 +877,7 @@ void P2PComm::RebroadcastMessage(const vector<Peer>& peers,
   job->m_hash = msg_hash;
 
   // Queue job
-  while (!m_sendQueue.push(job)) {
-    // Keep attempting to push until success
-  }
+  m_sendQueue.Push(job);
 }
 
 void P2PComm::SendMessageNoQueue(const Peer& peer,
@@ -21,7 +21,6 @@
 #define __P2PCOMM_H__
 
 #include <event2/util.h>
-#include <boost/lockfree/queue.hpp>
 #include <deque>
 #include <functional>
 #include <mutex>
@@ -31,6 +30,7 @@
 #include "Peer.h"
 #include "RumorManager.h"
 #include "common/Constants.h"
+#include "libUtils/BlockingQueue.h"
 #include "libUtils/Logger.h"
 #include "libUtils/ThreadPool.h"
 
@@ -107,9 +107,12 @@ class P2PComm {
 
   ThreadPool m_SendPool{MAXMESSAGE, "SendPool"};
 
-  boost::lockfree::queue<SendJob*> m_sendQueue;
+  BlockingQueue<SendJob*> m_sendQueue;
   void ProcessSendJob(SendJob* job);
 
+  static void ProcessMessage(const std::vector<unsigned char>& message,
+                             Peer from);
+  static void ReadCallback(struct bufferevent* bev, void* ctx);
   static void EventCallback(struct bufferevent* bev, short events, void* ctx);
   static void AcceptConnectionCallback(evconnlistener* listener,
                                        evutil_socket_t cli_sock,
@@ -22,15 +22,14 @@
 #include "common/Constants.h"
 
 using namespace std;
-using namespace boost::multiprecision;
 
-Peer::Peer() : m_ipAddress(0), m_listenPortHost(0) {}
+Peer::Peer() : m_ipAddress(), m_listenPortHost(0) {}
 
-Peer::Peer(const uint128_t& ip_address, uint32_t listen_port_host)
+Peer::Peer(const IPAddr& ip_address, uint32_t listen_port_host)
     : m_ipAddress(ip_address), m_listenPortHost(listen_port_host) {}
 
 Peer::Peer(const vector<unsigned char>& src, unsigned int offset)
-    : m_ipAddress(0), m_listenPortHost(0) {
+    : m_ipAddress(), m_listenPortHost(0) {
   if (Deserialize(src, offset) != 0) {
     LOG_GENERAL(WARNING, "We failed to init Peer.");
   }
@@ -54,13 +53,17 @@ bool Peer::operator<(const Peer& r) const {
 
 const char* Peer::GetPrintableIPAddress() const {
   struct sockaddr_in serv_addr;
-  serv_addr.sin_addr.s_addr = m_ipAddress.convert_to<unsigned long>();
+  serv_addr.sin_addr.s_addr = m_ipAddress.GetIPv4();
   return inet_ntoa(serv_addr.sin_addr);
 }
 
 unsigned int Peer::Serialize(vector<unsigned char>& dst,
                              unsigned int offset) const {
-  Serializable::SetNumber<uint128_t>(dst, offset, m_ipAddress, UINT128_SIZE);
+  if (dst.size() < offset + UINT128_SIZE) {
+    dst.resize(offset + UINT128_SIZE);
+  }
+  const auto& ipBytes = m_ipAddress.GetBytes();
+  copy(ipBytes.begin(), ipBytes.end(), dst.begin() + offset);
   Serializable::SetNumber<uint32_t>(dst, offset + UINT128_SIZE,
                                     m_listenPortHost, sizeof(uint32_t));
 
@@ -69,7 +72,9 @@ unsigned int Peer::Serialize(vector<unsigned char>& dst,
 
 int Peer::Deserialize(const vector<unsigned char>& src, unsigned int offset) {
   try {
-    m_ipAddress = Serializable::GetNumber<uint128_t>(src, offset, UINT128_SIZE);
+    m_ipAddress = (offset + UINT128_SIZE <= src.size())
+                      ? IPAddr::FromBytes(src.data() + offset)
+                      : IPAddr();
     m_listenPortHost = Serializable::GetNumber<uint32_t>(
         src, offset + UINT128_SIZE, sizeof(uint32_t));
   } catch (const std::exception& e) {
@@ -20,16 +20,16 @@
 #ifndef __PEER_H__
 #define __PEER_H__
 
-#include <boost/multiprecision/cpp_int.hpp>
 #include <cstdint>
 #include <functional>
 
+#include "IPAddr.h"
 #include "common/Serializable.h"
 
 /// Stores IP information on a single Zilliqa peer.
 struct Peer : public Serializable {
   /// Peer IP address (net-encoded)
-  boost::multiprecision::uint128_t m_ipAddress;  // net-encoded
+  IPAddr m_ipAddress;  // net-encoded
 
   /// Peer listen port (host-encoded)
   uint32_t m_listenPortHost;  // host-encoded
@@ -38,8 +38,7 @@ struct Peer : public Serializable {
   Peer();
 
   /// Constructor with specified IP info.
-  Peer(const boost::multiprecision::uint128_t& ip_address,
-       uint32_t listen_port_host);
+  Peer(const IPAddr& ip_address, uint32_t listen_port_host);
 
   /// Constructor for loading peer information from a byte stream.
   Peer(const std::vector<unsigned char>& src, unsigned int offset);
@@ -80,10 +79,8 @@ namespace std {
 template <>
 struct hash<Peer> {
   size_t operator()(const Peer& obj) const {
-    std::vector<unsigned char> s_peer;
-    obj.Serialize(s_peer, 0);
-    std::string str_peer(s_peer.begin(), s_peer.end());
-    return std::hash<string>()(str_peer);
+    return obj.m_ipAddress.Hash() ^
+           (static_cast<size_t>(obj.m_listenPortHost) * 0x9E3779B97F4A7C15ULL);
   }
 };
 }  // namespace std
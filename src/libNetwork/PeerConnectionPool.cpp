@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2018 Zilliqa
+ * This source code is being disclosed to you solely for the purpose of your
+ * participation in testing Zilliqa. You may view, compile and run the code for
+ * that purpose and pursuant to the protocols and algorithms that are programmed
+ * into, and intended by, the code. You may not do anything else with the code
+ * without express permission from Zilliqa Research Pte. Ltd., including
+ * modifying or publishing the code (or any part of it), and developing or
+ * forming another public or private blockchain network. This source code is
+ * provided 'as is' and no warranties are given as to title or non-infringement,
+ * merchantability or fitness for purpose and, to the extent permitted by law,
+ * all liability for your use of the code is disclaimed. Some programs in this
+ * code are governed by the GNU General Public License v3.0 (available at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html) ('GPLv3'). The programs that
+ * are governed by GPLv3.0 are those programs that are located in the folders
+ * src/depends and tests/depends and which include a reference to GPLv3 in their
+ * program files.
+ */
+
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+
+#include "PeerConnectionPool.h"
+#include "common/Constants.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+PeerConnectionPool::PeerConnectionPool()
+    : m_enabled(PERSISTENT_PEER_CONNECTIONS) {}
+
+PeerConnectionPool::~PeerConnectionPool() { Clear(); }
+
+PeerConnectionPool& PeerConnectionPool::GetInstance() {
+  static PeerConnectionPool pool;
+  return pool;
+}
+
+int PeerConnectionPool::Connect(const Peer& peer) {
+  int cli_sock = socket(AF_INET, SOCK_STREAM, 0);
+  if (cli_sock < 0) {
+    LOG_GENERAL(WARNING, "Socket creation failed. Code = "
+                             << errno << " Desc: " << std::strerror(errno)
+                             << ". IP address: " << peer);
+    return -1;
+  }
+
+  struct sockaddr_in serv_addr;
+  memset(&serv_addr, 0, sizeof(struct sockaddr_in));
+  serv_addr.sin_family = AF_INET;
+  serv_addr.sin_addr.s_addr = peer.m_ipAddress.GetIPv4();
+  serv_addr.sin_port = htons(peer.m_listenPortHost);
+
+  if (connect(cli_sock, (struct sockaddr*)&serv_addr, sizeof(serv_addr)) < 0) {
+    LOG_GENERAL(WARNING, "Socket connect failed. Code = "
+                             << errno << " Desc: " << std::strerror(errno)
+                             << ". IP address: " << peer);
+    CloseSocket(cli_sock);
+    return -1;
+  }
+
+  // Frames are written as header + body; don't let Nagle hold back the tail
+  // of a frame on a connection that stays open
+  int enable = 1;
+  if (setsockopt(cli_sock, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(int)) <
+      0) {
+    LOG_GENERAL(WARNING, "Socket set option TCP_NODELAY failed. Code = "
+                             << errno << " Desc: " << std::strerror(errno));
+  }
+
+  return cli_sock;
+}
+
+bool PeerConnectionPool::IsAlive(int sock) {
+  // The receiver never writes back on this connection, so anything other than
+  // "no data yet" means the connection was closed or reset by the other end
+  unsigned char c;
+  ssize_t n = recv(sock, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+  return (n < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK));
+}
+
+void PeerConnectionPool::CloseSocket(int sock) {
+  shutdown(sock, SHUT_RDWR);
+  close(sock);
+}
+
+int PeerConnectionPool::Acquire(const Peer& peer, bool& reused) {
+  reused = false;
+
+  if (m_enabled) {
+    const auto expiry = chrono::steady_clock::now() -
+                        chrono::seconds(PEER_CONN_IDLE_TIMEOUT_IN_SECONDS);
+
+    lock_guard<mutex> g(m_mutexIdleConnections);
+    auto it = m_idleConnections.find(peer);
+    if (it != m_idleConnections.end()) {
+      auto& idle = it->second;
+      while (!idle.empty()) {
+        IdleConnection conn = idle.back();
+        idle.pop_back();
+        if ((conn.m_lastUsed > expiry) && IsAlive(conn.m_socket)) {
+          reused = true;
+          return conn.m_socket;
+        }
+        CloseSocket(conn.m_socket);
+      }
+      m_idleConnections.erase(it);
+    }
+  }
+
+  return Connect(peer);
+}
+
+void PeerConnectionPool::Release(const Peer& peer, int sock) {
+  if (sock < 0) {
+    return;
+  }
+
+  if (m_enabled) {
+    lock_guard<mutex> g(m_mutexIdleConnections);
+    auto& idle = m_idleConnections[peer];
+    if (idle.size() < MAX_IDLE_CONN_PER_PEER) {
+      idle.push_back({sock, chrono::steady_clock::now()});
+      return;
+    }
+  }
+
+  CloseSocket(sock);
+}
+
+void PeerConnectionPool::Discard(int sock) {
+  if (sock >= 0) {
+    CloseSocket(sock);
+  }
+}
+
+void PeerConnectionPool::Evict(const Peer& peer) {
+  lock_guard<mutex> g(m_mutexIdleConnections);
+  auto it = m_idleConnections.find(peer);
+  if (it == m_idleConnections.end()) {
+    return;
+  }
+  for (const auto& conn : it->second) {
+    CloseSocket(conn.m_socket);
+  }
+  m_idleConnections.erase(it);
+}
+
+void PeerConnectionPool::Clear() {
+  lock_guard<mutex> g(m_mutexIdleConnections);
+  for (const auto& entry : m_idleConnections) {
+    for (const auto& conn : entry.second) {
+      CloseSocket(conn.m_socket);
+    }
+  }
+  m_idleConnections.clear();
+}
+
+void PeerConnectionPool::RemoveExpired() {
+  const auto expiry = chrono::steady_clock::now() -
+                      chrono::seconds(PEER_CONN_IDLE_TIMEOUT_IN_SECONDS);
+
+  lock_guard<mutex> g(m_mutexIdleConnections);
+  for (auto it = m_idleConnections.begin(); it != m_idleConnections.end();) {
+    auto& idle = it->second;
+    auto keep = remove_if(idle.begin(), idle.end(),
+                          [&expiry](const IdleConnection& conn) {
+                            if (conn.m_lastUsed > expiry) {
+                              return false;
+                            }
+                            CloseSocket(conn.m_socket);
+                            return true;
+                          });
+    idle.erase(keep, idle.end());
+    it = idle.empty() ? m_idleConnections.erase(it) : next(it);
+  }
+}
+
+void PeerConnectionPool::SetEnabled(bool enabled) {
+  m_enabled = enabled;
+  if (!enabled) {
+    Clear();
+  }
+}
+
+bool PeerConnectionPool::IsEnabled() const { return m_enabled; }
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2018 Zilliqa
+ * This source code is being disclosed to you solely for the purpose of your
+ * participation in testing Zilliqa. You may view, compile and run the code for
+ * that purpose and pursuant to the protocols and algorithms that are programmed
+ * into, and intended by, the code. You may not do anything else with the code
+ * without express permission from Zilliqa Research Pte. Ltd., including
+ * modifying or publishing the code (or any part of it), and developing or
+ * forming another public or private blockchain network. This source code is
+ * provided 'as is' and no warranties are given as to title or non-infringement,
+ * merchantability or fitness for purpose and, to the extent permitted by law,
+ * all liability for your use of the code is disclaimed. Some programs in this
+ * code are governed by the GNU General Public License v3.0 (available at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html) ('GPLv3'). The programs that
+ * are governed by GPLv3.0 are those programs that are located in the folders
+ * src/depends and tests/depends and which include a reference to GPLv3 in their
+ * program files.
+ */
+
+#ifndef __PEERCONNECTIONPOOL_H__
+#define __PEERCONNECTIONPOOL_H__
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "Peer.h"
+
+/// Keeps outgoing TCP connections to peers open after a message has been
+/// written, so that subsequent messages to the same peer are streamed over an
+/// existing connection instead of paying for a new handshake each time.
+class PeerConnectionPool {
+  struct IdleConnection {
+    int m_socket;
+    std::chrono::time_point<std::chrono::steady_clock> m_lastUsed;
+  };
+
+  std::mutex m_mutexIdleConnections;
+  std::map<Peer, std::vector<IdleConnection>> m_idleConnections;
+  std::atomic<bool> m_enabled;
+
+  PeerConnectionPool();
+  ~PeerConnectionPool();
+
+  // Singleton should not implement these
+  PeerConnectionPool(PeerConnectionPool const&) = delete;
+  void operator=(PeerConnectionPool const&) = delete;
+
+  static int Connect(const Peer& peer);
+  static bool IsAlive(int sock);
+  static void CloseSocket(int sock);
+
+ public:
+  static PeerConnectionPool& GetInstance();
+
+  /// Returns a connected socket to the peer (or -1 on failure). An idle pooled
+  /// connection is reused if one is still alive; reused is set accordingly.
+  int Acquire(const Peer& peer, bool& reused);
+
+  /// Hands a socket back after a complete frame has been written to it.
+  /// The socket is closed instead if pooling is disabled or the pool is full.
+  void Release(const Peer& peer, int sock);
+
+  /// Closes a socket whose stream state is unknown (e.g., failed write).
+  void Discard(int sock);
+
+  /// Closes all idle connections to the peer.
+  void Evict(const Peer& peer);
+
+  /// Closes all idle connections.
+  void Clear();
+
+  /// Closes idle connections that have not been used for a while.
+  void RemoveExpired();
+
+  /// Connections are pooled only while enabled (default from constants file).
+  void SetEnabled(bool enabled);
+  bool IsEnabled() const;
+};
+
+#endif  // __PEERCONNECTIONPOOL_H__
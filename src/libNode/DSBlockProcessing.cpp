@@ -17,6 +17,7 @@
  * program files.
  */
 
+#include <algorithm>
 #include <array>
 #include <boost/multiprecision/cpp_int.hpp>
 #include <chrono>
@@ -32,6 +33,7 @@
 #include "depends/libTrie/TrieDB.h"
 #include "depends/libTrie/TrieHash.h"
 #include "libConsensus/ConsensusUser.h"
+#include "libCrypto/AggregateKeyCache.h"
 #include "libCrypto/Sha2.h"
 #include "libData/AccountData/Account.h"
 #include "libData/AccountData/AccountStore.h"
@@ -130,9 +132,6 @@ bool Node::CheckWhetherDSBlockNumIsLatest(const uint64_t dsblockNum) {
 bool Node::VerifyDSBlockCoSignature(const DSBlock& dsblock) {
   LOG_MARKER();
 
-  unsigned int index = 0;
-  unsigned int count = 0;
-
   const vector<bool>& B2 = dsblock.GetB2();
   if (m_mediator.m_DSCommittee->size() != B2.size()) {
     LOG_GENERAL(WARNING, "Mismatch: DS committee size = "
@@ -141,22 +140,20 @@ bool Node::VerifyDSBlockCoSignature(const DSBlock& dsblock) {
     return false;
   }
 
-  // Generate the aggregated key
-  vector<PubKey> keys;
-  for (auto const& kv : *m_mediator.m_DSCommittee) {
-    if (B2.at(index)) {
-      keys.emplace_back(kv.first);
-      count++;
-    }
-    index++;
-  }
-
-  if (count != ConsensusCommon::NumForConsensus(B2.size())) {
+  if (count(B2.begin(), B2.end(), true) !=
+      ConsensusCommon::NumForConsensus(B2.size())) {
     LOG_GENERAL(WARNING, "Cosig was not generated by enough nodes");
     return false;
   }
 
-  shared_ptr<PubKey> aggregatedKey = MultiSig::AggregatePubKeys(keys);
+  // Generate the aggregated key
+  shared_ptr<const PubKey> aggregatedKey =
+      AggregateKeyCache::GetInstance().Aggregate(
+          *m_mediator.m_DSCommittee,
+          [](const pair<PubKey, Peer>& kv) -> const PubKey& {
+            return kv.first;
+          },
+          B2);
   if (aggregatedKey == nullptr) {
     LOG_GENERAL(WARNING, "Aggregated key generation failed");
     return false;
@@ -173,8 +170,10 @@ bool Node::VerifyDSBlockCoSignature(const DSBlock& dsblock) {
   if (!Schnorr::GetInstance().Verify(message, 0, message.size(),
                                      dsblock.GetCS2(), *aggregatedKey)) {
     LOG_GENERAL(WARNING, "Cosig verification failed");
-    for (auto& kv : keys) {
-      LOG_GENERAL(WARNING, kv);
+    for (unsigned int i = 0; i < B2.size(); i++) {
+      if (B2.at(i)) {
+        LOG_GENERAL(WARNING, m_mediator.m_DSCommittee->at(i).first);
+      }
     }
     return false;
   }
@@ -17,6 +17,7 @@
  * program files.
  */
 
+#include <algorithm>
 #include <array>
 #include <boost/multiprecision/cpp_int.hpp>
 #include <chrono>
@@ -27,6 +28,7 @@
 #include "common/Constants.h"
 #include "common/Messages.h"
 #include "common/Serializable.h"
+#include "libCrypto/AggregateKeyCache.h"
 #include "libCrypto/Sha2.h"
 #include "libMediator/Mediator.h"
 #include "libMessage/Messenger.h"
@@ -61,9 +63,6 @@ void Node::UpdateDSCommittee(const uint32_t& shard_id,
 bool Node::VerifyFallbackBlockCoSignature(const FallbackBlock& fallbackblock) {
   LOG_MARKER();
 
-  unsigned int index = 0;
-  unsigned int count = 0;
-
   uint32_t shard_id = fallbackblock.GetHeader().GetShardId();
 
   const vector<bool>& B2 = fallbackblock.GetB2();
@@ -76,23 +75,20 @@ bool Node::VerifyFallbackBlockCoSignature(const FallbackBlock& fallbackblock) {
     return false;
   }
 
-  // Generate the aggregated key
-  vector<PubKey> keys;
-
-  for (auto const& shardNode : m_mediator.m_ds->m_shards[shard_id]) {
-    if (B2.at(index)) {
-      keys.emplace_back(std::get<SHARD_NODE_PUBKEY>(shardNode));
-      count++;
-    }
-    index++;
-  }
-
-  if (count != ConsensusCommon::NumForConsensus(B2.size())) {
+  if (count(B2.begin(), B2.end(), true) !=
+      ConsensusCommon::NumForConsensus(B2.size())) {
     LOG_GENERAL(WARNING, "Cosig was not generated by enough nodes");
     return false;
   }
 
-  shared_ptr<PubKey> aggregatedKey = MultiSig::AggregatePubKeys(keys);
+  // Generate the aggregated key
+  shared_ptr<const PubKey> aggregatedKey =
+      AggregateKeyCache::GetInstance().Aggregate(
+          m_mediator.m_ds->m_shards[shard_id],
+          [](const auto& shardNode) -> const PubKey& {
+            return std::get<SHARD_NODE_PUBKEY>(shardNode);
+          },
+          B2);
   if (aggregatedKey == nullptr) {
     LOG_GENERAL(WARNING, "Aggregated key generation failed");
     return false;
@@ -109,8 +105,11 @@ bool Node::VerifyFallbackBlockCoSignature(const FallbackBlock& fallbackblock) {
   if (!Schnorr::GetInstance().Verify(message, 0, message.size(),
                                      fallbackblock.GetCS2(), *aggregatedKey)) {
     LOG_GENERAL(WARNING, "Cosig verification failed. Pubkeys");
-    for (auto& kv : keys) {
-      LOG_GENERAL(WARNING, kv);
+    for (unsigned int i = 0; i < B2.size(); i++) {
+      if (B2.at(i)) {
+        LOG_GENERAL(WARNING, std::get<SHARD_NODE_PUBKEY>(
+                                 m_mediator.m_ds->m_shards[shard_id].at(i)));
+      }
     }
     return false;
   }
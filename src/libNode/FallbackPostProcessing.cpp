@@ -25,6 +25,7 @@
 #include "common/Constants.h"
 #include "common/Messages.h"
 #include "common/Serializable.h"
+#include "libCrypto/AggregateKeyCache.h"
 #include "libCrypto/Sha2.h"
 #include "libMediator/Mediator.h"
 #include "libMessage/Messenger.h"
@@ -51,22 +52,19 @@ void Node::ProcessFallbackConsensusWhenDone() {
 
   m_pendingFallbackBlock->SetCoSignatures(*m_consensusObject);
 
-  unsigned int index = 0;
-  unsigned int count = 0;
-
-  vector<PubKey> keys;
-  for (auto const& kv : *m_myShardMembers) {
-    if (m_pendingFallbackBlock->GetB2().at(index)) {
-      keys.emplace_back(kv.first);
-      count++;
-    }
-    index++;
-  }
+  const vector<bool>& B2 = m_pendingFallbackBlock->GetB2();
 
   // Verify cosig agains fallbackblock
-  shared_ptr<PubKey> aggregatetdKey = MultiSig::AggregatePubKeys(keys);
+  shared_ptr<const PubKey> aggregatetdKey =
+      AggregateKeyCache::GetInstance().Aggregate(
+          *m_myShardMembers,
+          [](const pair<PubKey, Peer>& kv) -> const PubKey& {
+            return kv.first;
+          },
+          B2);
   if (aggregatetdKey == nullptr) {
     LOG_GENERAL(WARNING, "Aggregated key generation failed");
+    return;
   }
 
   vector<unsigned char> message;
@@ -81,8 +79,10 @@ void Node::ProcessFallbackConsensusWhenDone() {
                                      m_pendingFallbackBlock->GetCS2(),
                                      *aggregatetdKey)) {
     LOG_GENERAL(WARNING, "cosig verification fail");
-    for (auto& kv : keys) {
-      LOG_GENERAL(WARNING, kv);
+    for (unsigned int i = 0; i < B2.size(); i++) {
+      if (B2.at(i)) {
+        LOG_GENERAL(WARNING, m_myShardMembers->at(i).first);
+      }
     }
     return;
   }
@@ -17,6 +17,7 @@
  * program files.
  */
 
+#include <algorithm>
 #include <array>
 #include <boost/multiprecision/cpp_int.hpp>
 #include <chrono>
@@ -33,6 +34,7 @@
 #include "depends/libTrie/TrieDB.h"
 #include "depends/libTrie/TrieHash.h"
 #include "libConsensus/ConsensusUser.h"
+#include "libCrypto/AggregateKeyCache.h"
 #include "libCrypto/Sha2.h"
 #include "libData/AccountData/Account.h"
 #include "libData/AccountData/AccountStore.h"
@@ -225,9 +227,6 @@ bool Node::RemoveTxRootHashFromUnavailableMicroBlock(
 bool Node::VerifyFinalBlockCoSignature(const TxBlock& txblock) {
   LOG_MARKER();
 
-  unsigned int index = 0;
-  unsigned int count = 0;
-
   const vector<bool>& B2 = txblock.GetB2();
   if (m_mediator.m_DSCommittee->size() != B2.size()) {
     LOG_GENERAL(WARNING, "Mismatch: DS committee size = "
@@ -236,22 +235,20 @@ bool Node::VerifyFinalBlockCoSignature(const TxBlock& txblock) {
     return false;
   }
 
-  // Generate the aggregated key
-  vector<PubKey> keys;
-  for (auto const& kv : *m_mediator.m_DSCommittee) {
-    if (B2.at(index)) {
-      keys.emplace_back(kv.first);
-      count++;
-    }
-    index++;
-  }
-
-  if (count != ConsensusCommon::NumForConsensus(B2.size())) {
+  if (count(B2.begin(), B2.end(), true) !=
+      ConsensusCommon::NumForConsensus(B2.size())) {
     LOG_GENERAL(WARNING, "Cosig was not generated by enough nodes");
     return false;
   }
 
-  shared_ptr<PubKey> aggregatedKey = MultiSig::AggregatePubKeys(keys);
+  // Generate the aggregated key
+  shared_ptr<const PubKey> aggregatedKey =
+      AggregateKeyCache::GetInstance().Aggregate(
+          *m_mediator.m_DSCommittee,
+          [](const pair<PubKey, Peer>& kv) -> const PubKey& {
+            return kv.first;
+          },
+          B2);
   if (aggregatedKey == nullptr) {
     LOG_GENERAL(WARNING, "Aggregated key generation failed");
     return false;
@@ -268,8 +265,10 @@ bool Node::VerifyFinalBlockCoSignature(const TxBlock& txblock) {
   if (!Schnorr::GetInstance().Verify(message, 0, message.size(),
                                      txblock.GetCS2(), *aggregatedKey)) {
     LOG_GENERAL(WARNING, "Cosig verification failed");
-    for (auto& kv : keys) {
-      LOG_GENERAL(WARNING, kv);
+    for (unsigned int i = 0; i < B2.size(); i++) {
+      if (B2.at(i)) {
+        LOG_GENERAL(WARNING, m_mediator.m_DSCommittee->at(i).first);
+      }
     }
     return false;
   }
@@ -278,9 +277,9 @@ bool Node::VerifyFinalBlockCoSignature(const TxBlock& txblock) {
 }
 
 bool Node::CheckMicroBlockRootHash(const TxBlock& finalBlock,
-                                   [[gnu::unused]] const uint64_t& blocknum) {
+                                   const uint64_t& blocknum) {
   TxnHash microBlocksHash =
-      ComputeTransactionsRoot(finalBlock.GetMicroBlockHashes());
+      ComputeTransactionsRoot(finalBlock.GetMicroBlockHashes(), blocknum);
 
   LOG_EPOCH(INFO, to_string(m_mediator.m_currentEpochNum).c_str(),
             "Expected FinalBlock TxRoot hash: " << microBlocksHash.hex());
@@ -489,7 +488,7 @@ bool Node::FindTxnInProcessedTxnsList(
   // Check if transaction is part of submitted Tx list
   if (txnIt != processedTransactions.end()) {
     if ((sharing_mode == SEND_ONLY) || (sharing_mode == SEND_AND_FORWARD)) {
-      txns_to_send.emplace_back(txnIt->second);
+      txns_to_send.emplace_back(std::move(txnIt->second));
     }
 
     // Move entry from submitted Tx list to committed Tx list
@@ -751,6 +750,9 @@ bool Node::ProcessFinalBlock(const vector<unsigned char>& message,
             txBlock, txBlock.GetHeader().GetBlockNum(), toSendTxnToLookup)) {
       return false;
     }
+    if (!LOOKUP_NODE_MODE) {
+      ResolveStagedTransactions(txBlock);
+    }
     StoreFinalBlock(txBlock);
   } else {
     LOG_GENERAL(INFO, "isVacuousEpoch now");
@@ -882,23 +884,25 @@ bool Node::ProcessStateDeltaFromFinalBlock(
 void Node::CommitForwardedTransactions(const ForwardedTxnEntry& entry) {
   LOG_MARKER();
 
-  unsigned int txn_counter = 0;
+  TxBodyBatch bodies;
+  bodies.reserve(entry.m_transactions.size());
+
   for (const auto& twr : entry.m_transactions) {
     if (LOOKUP_NODE_MODE) {
       Server::AddToRecentTransactions(twr.GetTransaction().GetTranID());
+      BlockStorage::GetBlockStorage().PutContractCreation(twr);
     }
 
-    // Store TxBody to disk
-    vector<unsigned char> serializedTxBody;
-    twr.Serialize(serializedTxBody, 0);
-    BlockStorage::GetBlockStorage().PutTxBody(twr.GetTransaction().GetTranID(),
-                                              serializedTxBody);
+    bodies.emplace_back(twr.GetTransaction().GetTranID(),
+                        vector<unsigned char>());
+    twr.Serialize(bodies.back().second, 0);
+  }
 
-    txn_counter++;
-    if (txn_counter % 10000 == 0) {
-      LOG_EPOCH(INFO, to_string(m_mediator.m_currentEpochNum).c_str(),
-                "Proceessed " << txn_counter << " of txns.");
-    }
+  // Store TxBodies to disk
+  if (!BlockStorage::GetBlockStorage().PutTxBodies(move(bodies))) {
+    LOG_EPOCH(WARNING, to_string(m_mediator.m_currentEpochNum).c_str(),
+              "Failed to store " << entry.m_transactions.size()
+                                 << " txn bodies");
   }
 }
 
@@ -1009,7 +1013,7 @@ bool Node::ProcessForwardTransactionCore(const ForwardedTxnEntry& entry) {
     txns_map.emplace(txr.GetTransaction().GetTranID(), txr);
   }
 
-  txRootHash = ComputeTransactionsRoot(txns_order);
+  txRootHash = ComputeTransactionsRoot(txns_order, entry.m_blockNum);
 
   if (txRootHash != entry.m_hash.m_txRootHash) {
     LOG_GENERAL(WARNING, "TxRoot computed doesn't match"
@@ -155,7 +155,7 @@ void Node::CommitMicroBlockConsensusBuffer() {
     auto runconsensus = [this, i]() {
       ProcessMicroblockConsensusCore(i.second, MessageOffset::BODY, i.first);
     };
-    DetachedFunction(1, runconsensus);
+    DetachedFunction(Executor::CONSENSUS, 1, runconsensus);
   }
 }
 
@@ -253,10 +253,14 @@ bool Node::ProcessMicroblockConsensusCore(const vector<unsigned char>& message,
       lock_guard<mutex> g(
           m_mediator.m_ds->m_mutexPrepareRunFinalblockConsensus);
       if (!m_mediator.m_ds->m_startedRunFinalblockConsensus) {
-        m_mediator.m_ds->m_stateDeltaFromShards.clear();
-        AccountStore::GetInstance().SerializeDelta();
+        // The temp store now holds the delta of every shard and of the DS
+        // microblock, which replaces the shard deltas
+        m_mediator.m_ds->m_stateDeltasFromShards.clear();
+        AccountStore::GetInstance().SerializeDelta(
+            m_mediator.m_currentEpochNum);
+        m_mediator.m_ds->m_stateDeltasFromShards.emplace_back();
         AccountStore::GetInstance().GetSerializedDelta(
-            m_mediator.m_ds->m_stateDeltaFromShards);
+            m_mediator.m_ds->m_stateDeltasFromShards.back());
         m_mediator.m_ds->SaveCoinbase(m_microblock->GetB1(),
                                       m_microblock->GetB2(),
                                       m_microblock->GetHeader().GetShardId());
@@ -301,7 +305,7 @@ bool Node::ProcessMicroblockConsensusCore(const vector<unsigned char>& message,
         auto rerunconsensus = [this, message, offset, from]() {
           ProcessMicroblockConsensusCore(message, offset, from);
         };
-        DetachedFunction(1, rerunconsensus);
+        DetachedFunction(Executor::CONSENSUS, 1, rerunconsensus);
         return true;
       }
     } else {
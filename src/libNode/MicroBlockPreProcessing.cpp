@@ -91,7 +91,7 @@ bool Node::ComposeMicroBlock() {
 
     auto& processedTransactions = m_processedTransactions[blockNum];
 
-    txRootHash = ComputeTransactionsRoot(m_TxnOrder);
+    txRootHash = ComputeTransactionsRoot(m_TxnOrder, blockNum);
 
     numTxs = processedTransactions.size();
     if (numTxs != m_TxnOrder.size()) {
@@ -246,30 +246,16 @@ void Node::ProcessTransactionWhenShardLeader() {
 
   unsigned int txn_sent_count = 0;
 
-  auto findOneFromAddrNonceTxnMap = [this](Transaction& t) -> bool {
-    for (auto it = m_addrNonceTxnMap.begin(); it != m_addrNonceTxnMap.end();
-         it++) {
-      if (it->second.begin()->first ==
-          AccountStore::GetInstance().GetNonceTemp(it->first) + 1) {
-        t = std::move(it->second.begin()->second);
-        it->second.erase(it->second.begin());
-
-        if (it->second.empty()) {
-          m_addrNonceTxnMap.erase(it);
-        }
-        return true;
-      }
-    }
-    return false;
-  };
-
+  // The txn bodies are moved out of m_createdTransactions, which is the only
+  // owner of them here
   auto findSameNonceButHigherGasPrice = [this](Transaction& t) -> void {
     auto& compIdx = m_createdTransactions.get<MULTI_INDEX_KEY::PUBKEY_NONCE>();
     auto it = compIdx.find(make_tuple(t.GetSenderPubKey(), t.GetNonce()));
     if (it != compIdx.end()) {
-      if (it->GetGasPrice() > t.GetGasPrice()) {
-        t = std::move(*it);
+      if ((*it)->GetGasPrice() > t.GetGasPrice()) {
+        TransactionPtr found = *it;
         compIdx.erase(it);
+        t = std::move(*found);
       }
     }
   };
@@ -283,21 +269,30 @@ void Node::ProcessTransactionWhenShardLeader() {
     }
 
     auto it = listIdx.begin();
-    t = std::move(*it);
+    TransactionPtr found = *it;
     listIdx.erase(it);
+    t = std::move(*found);
     return true;
   };
 
-  auto appendOne = [this](const Transaction& t, const TransactionReceipt& tr) {
+  auto appendOne = [this](Transaction& t, TransactionReceipt& tr) {
     // LOG_GENERAL(INFO, "appendOne: " << t.GetTranID().hex());
     lock_guard<mutex> g(m_mutexProcessedTransactions);
     auto& processedTransactions =
         m_processedTransactions[m_mediator.m_currentEpochNum];
-    processedTransactions.insert(
-        make_pair(t.GetTranID(), TransactionWithReceipt(t, tr)));
-    m_TxnOrder.push_back(t.GetTranID());
+    const TxnHash tranID = t.GetTranID();
+    processedTransactions.emplace(
+        tranID, TransactionWithReceipt(std::move(t), std::move(tr)));
+    m_TxnOrder.push_back(tranID);
+  };
+
+  auto getNextNonce = [](const Address& addr) -> uint256_t {
+    return AccountStore::GetInstance().GetNonceTemp(addr) + 1;
   };
 
+  // Account nonces may have moved since the last microblock
+  m_addrNonceTxnPool.Refresh(getNextNonce);
+
   uint256_t gasUsedTotal = 0;
 
   while (txn_sent_count < MAXSUBMITTXNPERNODE * m_myShardMembers->size() &&
@@ -305,64 +300,59 @@ void Node::ProcessTransactionWhenShardLeader() {
     Transaction t;
     TransactionReceipt tr;
 
-    // check m_addrNonceTxnMap contains any txn meets right nonce,
+    // check m_addrNonceTxnPool contains any txn meets right nonce,
     // if contains, process it withou increment the txn_sent_count as it's
     // already incremented when inserting
-    if (findOneFromAddrNonceTxnMap(t)) {
+    if (m_addrNonceTxnPool.PopReady(t)) {
       // check whether m_createdTransaction have transaction with same Addr and
       // nonce if has and with larger gasPrice then replace with that one.
       // (*optional step)
       findSameNonceButHigherGasPrice(t);
 
       if (m_mediator.m_validator->CheckCreatedTransaction(t, tr)) {
-        appendOne(t, tr);
         gasUsedTotal += tr.GetCumGas();
+        Address senderAddr = t.GetSenderAddr();
+        appendOne(t, tr);
+        m_addrNonceTxnPool.SetNextNonce(senderAddr, getNextNonce(senderAddr));
         continue;
       }
     }
-    // if no txn in u_map meet right nonce process new come-in transactions
+    // if no txn in pool meet right nonce process new come-in transactions
     else if (findOneFromCreated(t)) {
       // LOG_GENERAL(INFO, "findOneFromCreated");
 
       Address senderAddr = t.GetSenderAddr();
+      uint256_t nextNonce = getNextNonce(senderAddr);
       // check nonce, if nonce larger than expected, put it into
-      // m_addrNonceTxnMap
-      if (t.GetNonce() >
-          AccountStore::GetInstance().GetNonceTemp(senderAddr) + 1) {
+      // m_addrNonceTxnPool, which keeps the higher gas price one if the
+      // same addr and nonce is already there
+      if (t.GetNonce() > nextNonce) {
         // LOG_GENERAL(INFO,
         //             "High nonce: "
         //                 << t.GetNonce() << " cur sender nonce: "
         //                 << AccountStore::GetInstance().GetNonceTemp(
         //                        senderAddr));
-        auto it1 = m_addrNonceTxnMap.find(senderAddr);
-        if (it1 != m_addrNonceTxnMap.end()) {
-          auto it2 = it1->second.find(t.GetNonce());
-          if (it2 != it1->second.end()) {
-            // found the txn with same addr and same nonce
-            // then compare the gasprice and remains the higher one
-            if (t.GetGasPrice() > it2->second.GetGasPrice()) {
-              it2->second = t;
-            }
-            txn_sent_count++;
-            continue;
-          }
-        }
-        m_addrNonceTxnMap[senderAddr].insert({t.GetNonce(), t});
+        m_addrNonceTxnPool.Insert(senderAddr, std::move(t), nextNonce);
       }
-      // if nonce too small, ignore it
-      else if (t.GetNonce() <
-               AccountStore::GetInstance().GetNonceTemp(senderAddr) + 1) {
+      // if nonce too small, ignore it. From the pipelined selection on it
+      // is not counted, so selection is the same whether or not it was
+      // already pruned by PreValidateNextTransactions
+      else if (t.GetNonce() < nextNonce) {
         // LOG_GENERAL(INFO,
         //             "Nonce too small"
         //                 << " Expected "
         //                 << AccountStore::GetInstance().GetNonceTemp(
         //                        senderAddr)
         //                 << " Found " << t.GetNonce());
+        if (IsPipelinedTxnSelectionBlock(m_mediator.m_currentEpochNum)) {
+          continue;
+        }
       }
       // if nonce correct, process it
       else if (m_mediator.m_validator->CheckCreatedTransaction(t, tr)) {
-        appendOne(t, tr);
         gasUsedTotal += tr.GetCumGas();
+        appendOne(t, tr);
+        m_addrNonceTxnPool.SetNextNonce(senderAddr, getNextNonce(senderAddr));
       } else {
         // LOG_GENERAL(WARNING, "CheckCreatedTransaction failed");
       }
@@ -405,72 +395,49 @@ bool Node::ProcessTransactionWhenShardBackup(
     return true;
   }
 
-  std::list<Transaction> curTxns;
-
-  if (!VerifyTxnsOrdering(tranHashes, curTxns)) {
-    return false;
+  AccountStore::GetInstance().InitTemp();
+  if (m_mediator.m_ds->m_mode != DirectoryService::Mode::IDLE) {
+    AccountStore::GetInstance().DeserializeDeltasTemp(
+        m_mediator.m_ds->m_stateDeltasWhenRunDSMB);
   }
 
-  auto appendOne = [this](const Transaction& t, const TransactionReceipt& tr) {
-    lock_guard<mutex> g(m_mutexProcessedTransactions);
-    auto& processedTransactions =
-        m_processedTransactions[m_mediator.m_currentEpochNum];
-    processedTransactions.insert(
-        make_pair(t.GetTranID(), TransactionWithReceipt(t, tr)));
-  };
+  // Checking the order executes the txns on the temp state, so their receipts
+  // are kept instead of executing them a second time
+  std::list<TransactionWithReceipt> curTxns;
 
-  AccountStore::GetInstance().InitTemp();
-  if (m_mediator.m_ds->m_mode != DirectoryService::Mode::IDLE) {
-    AccountStore::GetInstance().DeserializeDeltaTemp(
-        m_mediator.m_ds->m_stateDeltaWhenRunDSMB, 0);
+  if (!VerifyTxnsOrdering(tranHashes, curTxns)) {
+    return false;
   }
 
-  for (const auto& t : curTxns) {
-    TransactionReceipt tr;
-    if (m_mediator.m_validator->CheckCreatedTransaction(t, tr)) {
-      appendOne(t, tr);
-    }
+  lock_guard<mutex> g2(m_mutexProcessedTransactions);
+  auto& processedTransactions =
+      m_processedTransactions[m_mediator.m_currentEpochNum];
+  for (auto& t : curTxns) {
+    const TxnHash tranID = t.GetTransaction().GetTranID();
+    processedTransactions.emplace(tranID, std::move(t));
   }
 
   return true;
 }
 
 bool Node::VerifyTxnsOrdering(const vector<TxnHash>& tranHashes,
-                              list<Transaction>& curTxns) {
+                              list<TransactionWithReceipt>& curTxns) {
   LOG_MARKER();
 
-  std::unordered_map<Address,
-                     std::map<boost::multiprecision::uint256_t, Transaction>>
-      t_addrNonceTxnMap = m_addrNonceTxnMap;
+  TxnPool t_addrNonceTxnPool = m_addrNonceTxnPool;
   gas_txnid_comp_txns t_createdTransactions = m_createdTransactions;
   vector<TxnHash> t_tranHashes;
   unsigned int txn_sent_count = 0;
 
-  auto findOneFromAddrNonceTxnMap =
-      [&t_addrNonceTxnMap](Transaction& t) -> bool {
-    for (auto it = t_addrNonceTxnMap.begin(); it != t_addrNonceTxnMap.end();
-         it++) {
-      if (it->second.begin()->first ==
-          AccountStore::GetInstance().GetNonceTemp(it->first) + 1) {
-        t = std::move(it->second.begin()->second);
-        it->second.erase(it->second.begin());
-
-        if (it->second.empty()) {
-          t_addrNonceTxnMap.erase(it);
-        }
-        return true;
-      }
-    }
-    return false;
-  };
-
+  // t_createdTransactions shares the txn bodies with m_createdTransactions,
+  // so they are copied out rather than moved
   auto findSameNonceButHigherGasPrice =
       [&t_createdTransactions](Transaction& t) -> void {
     auto& compIdx = t_createdTransactions.get<MULTI_INDEX_KEY::PUBKEY_NONCE>();
     auto it = compIdx.find(make_tuple(t.GetSenderPubKey(), t.GetNonce()));
     if (it != compIdx.end()) {
-      if (it->GetGasPrice() > t.GetGasPrice()) {
-        t = std::move(*it);
+      if ((*it)->GetGasPrice() > t.GetGasPrice()) {
+        t = **it;
         compIdx.erase(it);
       }
     }
@@ -483,16 +450,24 @@ bool Node::VerifyTxnsOrdering(const vector<TxnHash>& tranHashes,
     }
 
     auto it = listIdx.begin();
-    t = std::move(*it);
+    t = **it;
     listIdx.erase(it);
     return true;
   };
 
-  auto appendOne = [&t_tranHashes, &curTxns](const Transaction& t) {
+  auto appendOne = [&t_tranHashes, &curTxns](Transaction& t,
+                                             TransactionReceipt& tr) {
     t_tranHashes.emplace_back(t.GetTranID());
-    curTxns.emplace_back(t);
+    curTxns.emplace_back(std::move(t), std::move(tr));
+  };
+
+  auto getNextNonce = [](const Address& addr) -> uint256_t {
+    return AccountStore::GetInstance().GetNonceTemp(addr) + 1;
   };
 
+  // Account nonces may have moved since the last microblock
+  t_addrNonceTxnPool.Refresh(getNextNonce);
+
   uint256_t gasUsedTotal = 0;
 
   while (txn_sent_count < MAXSUBMITTXNPERNODE * m_myShardMembers->size() &&
@@ -500,51 +475,43 @@ bool Node::VerifyTxnsOrdering(const vector<TxnHash>& tranHashes,
     Transaction t;
     TransactionReceipt tr;
 
-    // check t_addrNonceTxnMap contains any txn meets right nonce,
+    // check t_addrNonceTxnPool contains any txn meets right nonce,
     // if contains, process it withou increment the txn_sent_count as it's
     // already incremented when inserting
-    if (findOneFromAddrNonceTxnMap(t)) {
+    if (t_addrNonceTxnPool.PopReady(t)) {
       // check whether m_createdTransaction have transaction with same Addr and
       // nonce if has and with larger gasPrice then replace with that one.
       // (*optional step)
       findSameNonceButHigherGasPrice(t);
 
       if (m_mediator.m_validator->CheckCreatedTransaction(t, tr)) {
-        appendOne(t);
         gasUsedTotal += tr.GetCumGas();
+        Address senderAddr = t.GetSenderAddr();
+        appendOne(t, tr);
+        t_addrNonceTxnPool.SetNextNonce(senderAddr, getNextNonce(senderAddr));
         continue;
       }
     }
-    // if no txn in u_map meet right nonce process new come-in transactions
+    // if no txn in pool meet right nonce process new come-in transactions
     else if (findOneFromCreated(t)) {
       Address senderAddr = t.GetSenderAddr();
+      uint256_t nextNonce = getNextNonce(senderAddr);
       // check nonce, if nonce larger than expected, put it into
-      // t_addrNonceTxnMap
-      if (t.GetNonce() >
-          AccountStore::GetInstance().GetNonceTemp(senderAddr) + 1) {
-        auto it1 = t_addrNonceTxnMap.find(senderAddr);
-        if (it1 != t_addrNonceTxnMap.end()) {
-          auto it2 = it1->second.find(t.GetNonce());
-          if (it2 != it1->second.end()) {
-            // found the txn with same addr and same nonce
-            // then compare the gasprice and remains the higher one
-            if (t.GetGasPrice() > it2->second.GetGasPrice()) {
-              it2->second = t;
-            }
-            txn_sent_count++;
-            continue;
-          }
-        }
-        t_addrNonceTxnMap[senderAddr].insert({t.GetNonce(), t});
+      // t_addrNonceTxnPool
+      if (t.GetNonce() > nextNonce) {
+        t_addrNonceTxnPool.Insert(senderAddr, std::move(t), nextNonce);
       }
-      // if nonce too small, ignore it
-      else if (t.GetNonce() <
-               AccountStore::GetInstance().GetNonceTemp(senderAddr) + 1) {
+      // if nonce too small, ignore it, counted only as on the leader
+      else if (t.GetNonce() < nextNonce) {
+        if (IsPipelinedTxnSelectionBlock(m_mediator.m_currentEpochNum)) {
+          continue;
+        }
       }
       // if nonce correct, process it
       else if (m_mediator.m_validator->CheckCreatedTransaction(t, tr)) {
-        appendOne(t);
         gasUsedTotal += tr.GetCumGas();
+        appendOne(t, tr);
+        t_addrNonceTxnPool.SetNextNonce(senderAddr, getNextNonce(senderAddr));
       }
     } else {
       break;
@@ -553,7 +520,7 @@ bool Node::VerifyTxnsOrdering(const vector<TxnHash>& tranHashes,
   }
 
   if (t_tranHashes == tranHashes) {
-    m_addrNonceTxnMap = std::move(t_addrNonceTxnMap);
+    m_addrNonceTxnPool = std::move(t_addrNonceTxnPool);
     m_createdTransactions = std::move(t_createdTransactions);
     return true;
   }
@@ -590,7 +557,7 @@ bool Node::RunConsensusOnMicroBlockWhenShardLeader() {
               "Vacuous epoch: Skipping submit transactions");
   }
 
-  AccountStore::GetInstance().SerializeDelta();
+  AccountStore::GetInstance().SerializeDelta(m_mediator.m_currentEpochNum);
 
   // composed microblock stored in m_microblock
   if (!ComposeMicroBlock()) {
@@ -598,6 +565,8 @@ bool Node::RunConsensusOnMicroBlockWhenShardLeader() {
     return false;
   }
 
+  StartTxnPreValidation();
+
   // m_consensusID = 0;
   m_consensusBlockHash = m_mediator.m_txBlockChain.GetLastBlock()
                              .GetHeader()
@@ -734,8 +703,8 @@ bool Node::RunConsensusOnMicroBlock() {
   if (m_mediator.m_ds->m_mode != DirectoryService::Mode::IDLE) {
     m_mediator.m_ds->m_toSendTxnToLookup = false;
     m_mediator.m_ds->m_startedRunFinalblockConsensus = false;
-    m_mediator.m_ds->m_stateDeltaWhenRunDSMB =
-        m_mediator.m_ds->m_stateDeltaFromShards;
+    m_mediator.m_ds->m_stateDeltasWhenRunDSMB =
+        m_mediator.m_ds->m_stateDeltasFromShards;
 
     if (m_mediator.GetIsVacuousEpoch()) {
       // Coinbase
@@ -743,10 +712,11 @@ bool Node::RunConsensusOnMicroBlock() {
                 "[CNBSE]");
 
       m_mediator.m_ds->InitCoinbase();
-      m_mediator.m_ds->m_stateDeltaWhenRunDSMB.clear();
-      AccountStore::GetInstance().SerializeDelta();
+      m_mediator.m_ds->m_stateDeltasWhenRunDSMB.clear();
+      AccountStore::GetInstance().SerializeDelta(m_mediator.m_currentEpochNum);
+      m_mediator.m_ds->m_stateDeltasWhenRunDSMB.emplace_back();
       AccountStore::GetInstance().GetSerializedDelta(
-          m_mediator.m_ds->m_stateDeltaWhenRunDSMB);
+          m_mediator.m_ds->m_stateDeltasWhenRunDSMB.back());
     }
   }
   if (m_isPrimary) {
@@ -932,14 +902,14 @@ unsigned char Node::CheckLegitimacyOfTxnHashes(
       AccountStore::GetInstance().InitTemp();
       if (m_mediator.m_ds->m_mode != DirectoryService::Mode::IDLE) {
         LOG_GENERAL(WARNING, "Got missing txns, revert state delta");
-        AccountStore::GetInstance().DeserializeDeltaTemp(
-            m_mediator.m_ds->m_stateDeltaWhenRunDSMB, 0);
+        AccountStore::GetInstance().DeserializeDeltasTemp(
+            m_mediator.m_ds->m_stateDeltasWhenRunDSMB);
       }
 
       return LEGITIMACYRESULT::MISSEDTXN;
     }
 
-    AccountStore::GetInstance().SerializeDelta();
+    AccountStore::GetInstance().SerializeDelta(m_mediator.m_currentEpochNum);
   } else {
     LOG_EPOCH(INFO, to_string(m_mediator.m_currentEpochNum).c_str(),
               "Vacuous epoch: Skipping processing transactions");
@@ -1003,7 +973,8 @@ bool Node::CheckMicroBlockTxnRootHash() {
 
   // Check transaction root
   TxnHash expectedTxRootHash =
-      ComputeTransactionsRoot(m_microblock->GetTranHashes());
+      ComputeTransactionsRoot(m_microblock->GetTranHashes(),
+                              m_microblock->GetHeader().GetBlockNum());
 
   LOG_GENERAL(INFO, "Microblock root computation done "
                         << DataConversion::charArrToHexStr(
@@ -1136,5 +1107,7 @@ bool Node::MicroBlockValidator(const vector<unsigned char>& message,
   // some rework to be able to access DS blockchain (or we switch to using the
   // persistent storage lib)
 
+  StartTxnPreValidation();
+
   return true;
 }
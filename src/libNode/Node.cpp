@@ -21,6 +21,7 @@
 #include <chrono>
 #include <functional>
 #include <thread>
+#include <unordered_set>
 
 #include <boost/multiprecision/cpp_int.hpp>
 
@@ -44,6 +45,7 @@
 #include "libPersistence/Retriever.h"
 #include "libUtils/DataConversion.h"
 #include "libUtils/DetachedFunction.h"
+#include "libUtils/Executor.h"
 #include "libUtils/Logger.h"
 #include "libUtils/SanityChecks.h"
 #include "libUtils/TimeLockedFunction.h"
@@ -162,17 +164,18 @@ void Node::Install(unsigned int syncType, bool toRetrieveHistory) {
                                            .GetBlockNum() +
                                        1);
 
+          LOG_EPOCH(INFO, to_string(m_mediator.m_currentEpochNum).c_str(),
+                    "Waiting " << POW_WINDOW_IN_SECONDS
+                               << " seconds, accepting PoW "
+                                  "submissions...");
           auto func = [this]() mutable -> void {
-            LOG_EPOCH(INFO, to_string(m_mediator.m_currentEpochNum).c_str(),
-                      "Waiting " << POW_WINDOW_IN_SECONDS
-                                 << " seconds, accepting PoW "
-                                    "submissions...");
-            this_thread::sleep_for(chrono::seconds(POW_WINDOW_IN_SECONDS));
             LOG_EPOCH(INFO, to_string(m_mediator.m_currentEpochNum).c_str(),
                       "Starting consensus on ds block");
             m_mediator.m_ds->RunConsensusOnDSBlock();
           };
-          DetachedFunction(1, func);
+          Executor::GetInstance().SubmitAfter(
+              Executor::CONSENSUS, chrono::seconds(POW_WINDOW_IN_SECONDS),
+              func);
           return;
         }
       }
@@ -191,16 +194,17 @@ void Node::Install(unsigned int syncType, bool toRetrieveHistory) {
           m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetDifficulty();
       SetState(POW_SUBMISSION);
 
+      LOG_GENERAL(INFO, "Shard node, wait "
+                            << SHARD_DELAY_WAKEUP_IN_SECONDS
+                            << " seconds for lookup and DS nodes wakeup...");
       auto func = [this, block_num, dsDifficulty,
                    difficulty]() mutable -> void {
-        LOG_GENERAL(INFO, "Shard node, wait "
-                              << SHARD_DELAY_WAKEUP_IN_SECONDS
-                              << " seconds for lookup and DS nodes wakeup...");
-        this_thread::sleep_for(chrono::seconds(SHARD_DELAY_WAKEUP_IN_SECONDS));
         StartPoW(block_num, dsDifficulty, difficulty, m_mediator.m_dsBlockRand,
                  m_mediator.m_txBlockRand);
       };
-      DetachedFunction(1, func);
+      Executor::GetInstance().SubmitAfter(
+          Executor::BLOCK_PROCESSING,
+          chrono::seconds(SHARD_DELAY_WAKEUP_IN_SECONDS), func);
     } else {
       LOG_GENERAL(INFO, "RetrieveHistory cancelled");
     }
@@ -358,7 +362,8 @@ void Node::StartSynchronization() {
     }
   };
 
-  DetachedFunction(1, func);
+  // Polls for the whole sync
+  DetachedFunction(DetachedFunction::LongRunning(), 1, func);
 }
 
 bool Node::CheckState(Action action) {
@@ -581,7 +586,7 @@ bool Node::ProcessSubmitMissingTxn(const vector<unsigned char>& message,
 
     lock_guard<mutex> g(m_mutexCreatedTransactions);
     auto& hashIdx = m_createdTransactions.get<MULTI_INDEX_KEY::TXN_ID>();
-    hashIdx.insert(submittedTransaction);
+    hashIdx.insert(make_shared<Transaction>(std::move(submittedTransaction)));
   }
 
   // vector<TxnHash> missingTxnHashes;
@@ -667,8 +672,8 @@ bool Node::ProcessCreateTransactionFromLookup(
     auto& compIdx = m_createdTransactions.get<MULTI_INDEX_KEY::PUBKEY_NONCE>();
     auto it = compIdx.find(make_tuple(tx.GetSenderPubKey(), tx.GetNonce()));
     if (it != compIdx.end()) {
-      if (it->GetGasPrice() < tx.GetGasPrice()) {
-        compIdx.replace(it, tx);
+      if ((*it)->GetGasPrice() < tx.GetGasPrice()) {
+        compIdx.replace(it, make_shared<Transaction>(std::move(tx)));
         return true;
       } else {
         // LOG_GENERAL(WARNING,
@@ -677,7 +682,7 @@ bool Node::ProcessCreateTransactionFromLookup(
         return false;
       }
     }
-    compIdx.insert(tx);
+    compIdx.insert(make_shared<Transaction>(std::move(tx)));
   } else {
     LOG_GENERAL(WARNING, "Txn is not valid.");
     return false;
@@ -760,7 +765,8 @@ bool Node::ProcessTxnPacketFromLookup(
     LOG_GENERAL(WARNING, "Txn packet from older epoch, discard");
     return false;
   } else if (epochNumber == m_mediator.m_currentEpochNum) {
-    return ProcessTxnPacketFromLookupCore(message, shardId, transactions);
+    return ProcessTxnPacketFromLookupCore(message, shardId,
+                                          std::move(transactions));
   } else {
     lock_guard<mutex> g(m_mutexTxnPacketBuffer);
     m_txnPacketBuffer.emplace(epochNumber, message);
@@ -771,7 +777,7 @@ bool Node::ProcessTxnPacketFromLookup(
 
 bool Node::ProcessTxnPacketFromLookupCore(
     const vector<unsigned char>& message, const uint32_t shardId,
-    const vector<Transaction>& transactions) {
+    vector<Transaction>&& transactions) {
   LOG_MARKER();
 
   if (LOOKUP_NODE_MODE) {
@@ -808,20 +814,32 @@ bool Node::ProcessTxnPacketFromLookupCore(
   unsigned int txn_sent_count = 0;
   {
     LOG_GENERAL(INFO, "Start check txn packet from lookup");
+
+    // Check all signatures of the packet in parallel, before taking the lock
+    vector<bool> sigVerified;
+    m_mediator.m_validator->VerifyTransactions(transactions, sigVerified);
+
     lock_guard<mutex> g(m_mutexCreatedTransactions);
     auto& compIdx = m_createdTransactions.get<MULTI_INDEX_KEY::PUBKEY_NONCE>();
 
     unsigned int processed_count = 0;
 
-    for (const auto& tx : transactions) {
-      if (m_mediator.m_validator->CheckCreatedTransactionFromLookup(tx)) {
+    for (unsigned int i = 0; i < transactions.size(); i++) {
+      auto& tx = transactions.at(i);
+
+      if (!sigVerified.at(i)) {
+        LOG_GENERAL(WARNING,
+                    "Signature incorrect. Transaction rejected: "
+                        << tx.GetTranID());
+      } else if (m_mediator.m_validator->CheckVerifiedTransactionFromLookup(
+                     tx)) {
         auto it = compIdx.find(make_tuple(tx.GetSenderPubKey(), tx.GetNonce()));
         if (it != compIdx.end()) {
-          if (it->GetGasPrice() < tx.GetGasPrice()) {
-            compIdx.replace(it, tx);
+          if ((*it)->GetGasPrice() < tx.GetGasPrice()) {
+            compIdx.replace(it, make_shared<Transaction>(std::move(tx)));
           }
         } else {
-          compIdx.insert(tx);
+          compIdx.insert(make_shared<Transaction>(std::move(tx)));
         }
         txn_sent_count++;
       } else {
@@ -879,7 +897,8 @@ void Node::CommitTxnPacketBuffer() {
       return;
     }
 
-    ProcessTxnPacketFromLookupCore(it->second, shardId, transactions);
+    ProcessTxnPacketFromLookupCore(it->second, shardId,
+                                   std::move(transactions));
   }
 }
 
@@ -1019,7 +1038,8 @@ void Node::CleanCreatedTransaction() {
   {
     std::lock_guard<mutex> g(m_mutexCreatedTransactions);
     m_createdTransactions.clear();
-    m_addrNonceTxnMap.clear();
+    m_addrNonceTxnPool.clear();
+    m_stagedSpentTransactions.clear();
   }
   {
     std::lock_guard<mutex> g(m_mutexTxnPacketBuffer);
@@ -1027,6 +1047,110 @@ void Node::CleanCreatedTransaction() {
   }
 }
 
+bool Node::IsPipelinedTxnSelectionBlock(const uint64_t& blockNum) {
+  return TXN_SELECTION_VERSION >= PIPELINED_TXN_SELECTION_VERSION &&
+         blockNum >= TXN_SELECTION_VERSION_EPOCH;
+}
+
+void Node::StartTxnPreValidation() {
+  // Staging changes the pool the next round selects from, which only leaves
+  // the selection unchanged if spent txns aren't counted there
+  if (!IsPipelinedTxnSelectionBlock(m_mediator.m_currentEpochNum + 1) ||
+      m_mediator.GetIsVacuousEpoch() ||
+      m_mediator.m_ds->m_mode != DirectoryService::Mode::IDLE) {
+    return;
+  }
+
+  const MicroBlockHashSet microBlockHash = m_microblock->GetHeader().GetHash();
+  auto prevalidate = [this, microBlockHash]() mutable -> void {
+    PreValidateNextTransactions(microBlockHash);
+  };
+  DetachedFunction(1, prevalidate);
+}
+
+void Node::PreValidateNextTransactions(
+    const MicroBlockHashSet& microBlockHash) {
+  LOG_MARKER();
+
+  vector<SpentTxnStage::Candidate> candidates;
+  {
+    lock_guard<mutex> g(m_mutexCreatedTransactions);
+
+    // Txns staged for a microblock that never made it are still valid
+    m_stagedSpentTransactions.Restore(m_createdTransactions);
+    m_stagedMicroBlockHash = microBlockHash;
+    candidates = SpentTxnStage::Snapshot(m_createdTransactions);
+  }
+
+  // Nonces only go up, and the temp state holds my microblock's txns, so any
+  // nonce below it is spent if the final block includes my microblock. This
+  // holds even if the final block replaces the temp state midway. The nonces
+  // may be read from disk, so this runs without m_mutexCreatedTransactions.
+  const vector<TxnHash> spent = SpentTxnStage::FindSpent(
+      candidates, [](const Address& addr) -> uint256_t {
+        return AccountStore::GetInstance().GetNonceTemp(addr) + 1;
+      });
+
+  // Signatures were verified when the txns were received. For the others,
+  // page in the sender and recipient accounts, so the next round doesn't
+  // load them from the trie, and check the sender can cover the amount.
+  // Balances may still go up with the final block, so this only reports.
+  const unordered_set<TxnHash> spentSet(spent.begin(), spent.end());
+  AccountStore& accountStore = AccountStore::GetInstance();
+  size_t unfunded = 0;
+  for (const auto& c : candidates) {
+    if (spentSet.find(c.m_tranID) != spentSet.end()) {
+      continue;
+    }
+    Account sender;
+    if (!accountStore.GetAccountCopy(c.m_senderAddr, sender) ||
+        sender.GetBalance() < c.m_amount) {
+      unfunded++;
+    }
+    accountStore.IsAccountExist(c.m_toAddr);
+  }
+
+  lock_guard<mutex> g(m_mutexCreatedTransactions);
+
+  // The final block was processed or a newer microblock is pending
+  if (!(m_stagedMicroBlockHash == microBlockHash)) {
+    LOG_GENERAL(INFO, "Staged microblock changed, not staging spent txns");
+    return;
+  }
+
+  const size_t staged =
+      m_stagedSpentTransactions.Stage(m_createdTransactions, spent);
+
+  LOG_GENERAL(INFO, "Staged " << staged << " spent txns out of "
+                              << candidates.size()
+                              << " candidates for the next round, "
+                              << unfunded << " can't cover their amount yet");
+}
+
+void Node::ResolveStagedTransactions(const TxBlock& finalBlock) {
+  lock_guard<mutex> g(m_mutexCreatedTransactions);
+
+  // Pre-validation still running for this microblock no longer stages
+  const MicroBlockHashSet stagedMicroBlockHash = m_stagedMicroBlockHash;
+  m_stagedMicroBlockHash = MicroBlockHashSet();
+
+  if (m_stagedSpentTransactions.empty()) {
+    return;
+  }
+
+  const auto& hashes = finalBlock.GetMicroBlockHashes();
+  if (find(hashes.begin(), hashes.end(), stagedMicroBlockHash) !=
+      hashes.end()) {
+    LOG_GENERAL(INFO, "Dropping " << m_stagedSpentTransactions.size()
+                                  << " staged spent txns");
+    m_stagedSpentTransactions.clear();
+  } else {
+    LOG_GENERAL(INFO, "Staged microblock not in final block, restoring "
+                          << m_stagedSpentTransactions.size() << " txns");
+    m_stagedSpentTransactions.Restore(m_createdTransactions);
+  }
+}
+
 bool Node::ProcessDoRejoin(const std::vector<unsigned char>& message,
                            unsigned int offset,
                            [[gnu::unused]] const Peer& from) {
@@ -39,6 +39,8 @@
 #include "libData/BlockData/Block.h"
 #include "libData/BlockData/BlockHeader/UnavailableMicroBlock.h"
 #include "libData/DataStructures/MultiIndexContainer.h"
+#include "libData/DataStructures/SpentTxnStage.h"
+#include "libData/DataStructures/TxnPool.h"
 #include "libLookup/Synchronizer.h"
 #include "libNetwork/P2PComm.h"
 #include "libNetwork/PeerStore.h"
@@ -48,6 +50,11 @@
 class Mediator;
 class Retriever;
 
+/// Version of TXN_SELECTION_VERSION from which txns with a spent nonce don't
+/// count towards a microblock's txn limit, which lets the next round's txns
+/// be pre-validated while a microblock is pending.
+const unsigned int PIPELINED_TXN_SELECTION_VERSION = 2;
+
 /// Implements PoW submission and sharding node functionality.
 class Node : public Executable, public Broadcastable {
   enum Action {
@@ -122,9 +129,14 @@ class Node : public Executable, public Broadcastable {
   std::mutex m_mutexCreatedTransactions;
   gas_txnid_comp_txns m_createdTransactions;
 
-  std::unordered_map<Address,
-                     std::map<boost::multiprecision::uint256_t, Transaction>>
-      m_addrNonceTxnMap;
+  // Transactions with a nonce ahead of their sender's account nonce
+  TxnPool m_addrNonceTxnPool;
+
+  // Transactions taken out of m_createdTransactions while my microblock is
+  // pending, as their nonce is spent once the staged microblock is in the
+  // final block. Operates under m_mutexCreatedTransactions.
+  SpentTxnStage m_stagedSpentTransactions;
+  MicroBlockHashSet m_stagedMicroBlockHash;
   std::vector<TxnHash> m_txnsOrdering;
 
   std::mutex m_mutexProcessedTransactions;
@@ -256,7 +268,7 @@ class Node : public Executable, public Broadcastable {
                                   unsigned int offset, const Peer& from);
   bool ProcessTxnPacketFromLookupCore(
       const std::vector<unsigned char>& message, const uint32_t shardId,
-      const std::vector<Transaction>& transactions);
+      std::vector<Transaction>&& transactions);
 
 #ifdef HEARTBEAT_TEST
   bool ProcessKillPulse(const std::vector<unsigned char>& message,
@@ -312,7 +324,7 @@ class Node : public Executable, public Broadcastable {
 
   void BroadcastMicroBlockToLookup();
   bool VerifyTxnsOrdering(const std::vector<TxnHash>& tranHashes,
-                          std::list<Transaction>& curTxns);
+                          std::list<TransactionWithReceipt>& curTxns);
 
   void ProcessTransactionWhenShardLeader();
   bool ProcessTransactionWhenShardBackup(
@@ -485,6 +497,23 @@ class Node : public Executable, public Broadcastable {
 
   void CleanCreatedTransaction();
 
+  // Returns true if the txns of Tx block blockNum are selected with
+  // PIPELINED_TXN_SELECTION_VERSION
+  static bool IsPipelinedTxnSelectionBlock(const uint64_t& blockNum);
+
+  // Starts pre-validating the next round's txns against the temp state of
+  // m_microblock, alongside its co-signing
+  void StartTxnPreValidation();
+
+  // Pre-validates the next round's candidate txns while the microblock and
+  // final block are pending: stages the txns whose nonce my microblock spends
+  // and pages in and checks the accounts the others touch
+  void PreValidateNextTransactions(const MicroBlockHashSet& microBlockHash);
+
+  // Drops the staged txns if the final block has the staged microblock, or
+  // puts them back otherwise
+  void ResolveStagedTransactions(const TxBlock& finalBlock);
+
   void CleanMicroblockConsensusBuffer();
 
   void CallActOnFinalblock();
@@ -38,6 +38,8 @@
 
 POW::POW() {
   currentBlockNum = 0;
+  m_fullClientEpoch = 0;
+  m_cpuHashCount = 0;
   ethash_light_client = EthashLightNew(
       0);  // TODO: Do we still need this? Can we call it at mediator?
 
@@ -164,50 +166,107 @@ ethash_full_t POW::EthashFullNew(ethash_light_t& light,
 
 void POW::EthashFullDelete(ethash_full_t& full) { ethash_full_delete(full); }
 
+std::shared_ptr<ethash_full> POW::GetFullClient(uint64_t blockNum) {
+  std::lock_guard<std::mutex> g(m_mutexFullClient);
+
+  const uint64_t epoch = blockNum / ETHASH_EPOCH_LENGTH;
+  if (m_fullClient && m_fullClientEpoch == epoch) {
+    return m_fullClient;
+  }
+
+  LOG_GENERAL(INFO, "Loading full dataset for epoch " << epoch);
+
+  // The DAG is memory-mapped from the ethash directory, so it is only
+  // generated if no complete file for this epoch exists yet.
+  ethash_light_t light = EthashLightNew(blockNum);
+  ethash_callback_t CallBack = NULL;
+  ethash_full_t full = EthashFullNew(light, CallBack);
+  EthashLightDelete(light);
+
+  if (full == NULL) {
+    LOG_GENERAL(WARNING, "Failed to load full dataset for epoch " << epoch);
+    return nullptr;
+  }
+
+  // Mining or verification still holding the previous epoch's dataset keeps
+  // it alive until done
+  m_fullClient.reset(full, ethash_full_delete);
+  m_fullClientEpoch = epoch;
+  return m_fullClient;
+}
+
 ethash_return_value_t POW::EthashFullCompute(ethash_full_t& full,
                                              ethash_h256_t const& header_hash,
                                              uint64_t nonce) {
   return ethash_full_compute(full, header_hash, nonce);
 }
 
-ethash_mining_result_t POW::MineLight(ethash_light_t& light,
-                                      ethash_h256_t const& header_hash,
-                                      ethash_h256_t& difficulty) {
-  uint64_t nonce = std::time(0);
-  while (m_shouldMine) {
-    ethash_return_value_t mineResult =
-        EthashLightCompute(light, header_hash, nonce);
-    if (ethash_check_difficulty(&mineResult.result, &difficulty)) {
-      ethash_mining_result_t winning_result = {
-          BlockhashToHexString(&mineResult.result),
-          BlockhashToHexString(&mineResult.mix_hash), nonce, true};
-      return winning_result;
+ethash_mining_result_t POW::MineCPU(
+    const std::function<ethash_return_value_t(uint64_t)>& compute,
+    ethash_h256_t const& difficulty) {
+  const unsigned int numThreads =
+      NUM_CPU_MINING_THREADS > 0
+          ? NUM_CPU_MINING_THREADS
+          : std::max(1u, std::thread::hardware_concurrency());
+  const uint64_t startNonce = std::time(0);
+  const uint64_t nonceSegment = UINT64_MAX / numThreads;
+
+  std::atomic<bool> found{false};
+  std::mutex mutexResult;
+  ethash_mining_result_t result = {"", "", 0, false};
+
+  auto worker = [&](unsigned int index) {
+    uint64_t nonce = startNonce + index * nonceSegment;
+    uint64_t hashCount = 0;
+
+    while (m_shouldMine && !found) {
+      ethash_return_value_t mineResult = compute(nonce);
+      hashCount++;
+      if (ethash_check_difficulty(&mineResult.result, &difficulty)) {
+        std::lock_guard<std::mutex> g(mutexResult);
+        if (!found) {
+          result = {BlockhashToHexString(&mineResult.result),
+                    BlockhashToHexString(&mineResult.mix_hash), nonce, true};
+          found = true;
+        }
+        break;
+      }
+      nonce++;
     }
-    nonce++;
+
+    m_cpuHashCount += hashCount;
+  };
+
+  std::vector<std::thread> threads;
+  for (unsigned int i = 1; i < numThreads; i++) {
+    threads.emplace_back(worker, i);
+  }
+  worker(0);
+  for (auto& t : threads) {
+    t.join();
   }
 
-  ethash_mining_result_t failure_result = {"", "", 0, false};
-  return failure_result;
+  return result;
+}
+
+ethash_mining_result_t POW::MineLight(ethash_light_t& light,
+                                      ethash_h256_t const& header_hash,
+                                      ethash_h256_t& difficulty) {
+  return MineCPU(
+      [&light, &header_hash, this](uint64_t nonce) {
+        return EthashLightCompute(light, header_hash, nonce);
+      },
+      difficulty);
 }
 
 ethash_mining_result_t POW::MineFull(ethash_full_t& full,
                                      ethash_h256_t const& header_hash,
                                      ethash_h256_t& difficulty) {
-  uint64_t nonce = std::time(0);
-  while (m_shouldMine) {
-    ethash_return_value_t mineResult =
-        EthashFullCompute(full, header_hash, nonce);
-    if (ethash_check_difficulty(&mineResult.result, &difficulty)) {
-      ethash_mining_result_t winning_result = {
-          BlockhashToHexString(&mineResult.result),
-          BlockhashToHexString(&mineResult.mix_hash), nonce, true};
-      return winning_result;
-    }
-    nonce++;
-  }
-
-  ethash_mining_result_t failure_result = {"", "", 0, false};
-  return failure_result;
+  return MineCPU(
+      [&full, &header_hash, this](uint64_t nonce) {
+        return EthashFullCompute(full, header_hash, nonce);
+      },
+      difficulty);
 }
 
 ethash_mining_result_t POW::MineFullGPU(uint64_t blockNum,
@@ -356,11 +415,13 @@ ethash_mining_result_t POW::PoWMine(
     if (OPENCL_GPU_MINE || CUDA_GPU_MINE) {
       result = MineFullGPU(blockNum, headerHash, difficulty);
     } else {
-      ethash_callback_t CallBack = NULL;
-      ethash_full_t fullClient =
-          POW::EthashFullNew(ethash_light_client, CallBack);
-      result = MineFull(fullClient, headerHash, diffForPoW);
-      EthashFullDelete(fullClient);
+      std::shared_ptr<ethash_full> fullClient = GetFullClient(blockNum);
+      if (fullClient) {
+        ethash_full_t full = fullClient.get();
+        result = MineFull(full, headerHash, diffForPoW);
+      } else {
+        result = MineLight(ethash_light_client, headerHash, diffForPoW);
+      }
     }
   } else {
     result = MineLight(ethash_light_client, headerHash, diffForPoW);
@@ -396,13 +457,12 @@ bool POW::PoWVerify(uint64_t blockNum, uint8_t difficulty,
   }
 
   bool result;
-  if (fullDataset) {
-    ethash_callback_t CallBack = NULL;
-    ethash_full_t fullClient =
-        POW::EthashFullNew(ethash_light_client, CallBack);
-    result = VerifyFull(fullClient, headerHash, winning_nonce, diffForPoW,
+  std::shared_ptr<ethash_full> fullClient =
+      fullDataset ? GetFullClient(blockNum) : nullptr;
+  if (fullClient) {
+    ethash_full_t full = fullClient.get();
+    result = VerifyFull(full, headerHash, winning_nonce, diffForPoW,
                         winnning_result, winnning_mixhash);
-    EthashFullDelete(fullClient);
   } else {
     result = VerifyLight(ethash_light_client, headerHash, winning_nonce,
                          diffForPoW, winnning_result, winnning_mixhash);
@@ -430,6 +490,8 @@ bool POW::CheckSolnAgainstsTargetedDifficulty(const std::string& result,
   return ethash_check_difficulty(&hashResult, &diffForPoW);
 }
 
+uint64_t POW::GetCPUHashCount() const { return m_cpuHashCount; }
+
 void POW::InitOpenCL() {
 #ifdef OPENCL_MINE
   using namespace dev::eth;
@@ -22,7 +22,11 @@
 
 #include <stdint.h>
 #include <array>
+#include <atomic>
 #include <boost/multiprecision/cpp_int.hpp>
+#include <condition_variable>
+#include <functional>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
@@ -97,6 +101,9 @@ class POW {
   bool CheckSolnAgainstsTargetedDifficulty(const std::string& result,
                                            uint8_t difficulty);
 
+  /// Returns the number of hashes computed by the CPU miner so far.
+  uint64_t GetCPUHashCount() const;
+
  private:
   ethash_light_t ethash_light_client;
   uint64_t currentBlockNum;
@@ -106,6 +113,10 @@ class POW {
   std::atomic<int> m_minerIndex;
   std::condition_variable m_cvMiningResult;
   std::mutex m_mutexMiningResult;
+  std::shared_ptr<ethash_full> m_fullClient;
+  uint64_t m_fullClientEpoch;
+  std::mutex m_mutexFullClient;
+  std::atomic<uint64_t> m_cpuHashCount;
 
   ethash_light_t EthashLightNew(uint64_t block_number);
   ethash_light_t EthashLightReuse(ethash_light_t ethashLight,
@@ -120,6 +131,14 @@ class POW {
   ethash_return_value_t EthashFullCompute(ethash_full_t& full,
                                           ethash_h256_t const& header_hash,
                                           uint64_t nonce);
+  /// Returns the full dataset for the epoch of the block, building or loading
+  /// it only when the epoch changes. Returns nullptr on failure.
+  std::shared_ptr<ethash_full> GetFullClient(uint64_t blockNum);
+  /// Searches the nonce space on NUM_CPU_MINING_THREADS threads, each taking
+  /// its own contiguous range, until one finds a solution or mining stops.
+  ethash_mining_result_t MineCPU(
+      const std::function<ethash_return_value_t(uint64_t)>& compute,
+      ethash_h256_t const& difficulty);
   ethash_mining_result_t MineLight(ethash_light_t& light,
                                    ethash_h256_t const& header_hash,
                                    ethash_h256_t& difficulty);
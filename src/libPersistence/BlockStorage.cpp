@@ -22,7 +22,10 @@
 #include <unistd.h>
 #include <algorithm>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <limits>
+#include <map>
 #include <sstream>
 #include <string>
 
@@ -32,11 +35,23 @@
 #include "BlockStorage.h"
 #include "common/Constants.h"
 #include "common/Serializable.h"
+#include "libData/AccountData/Account.h"
 #include "libMessage/Messenger.h"
 #include "libUtils/DataConversion.h"
 
 using namespace std;
 
+BlockStorage::~BlockStorage() {
+  if (m_txBodyWriter.joinable()) {
+    {
+      lock_guard<mutex> g(m_mutexPendingTxBodies);
+      m_stopTxBodyWriter = true;
+    }
+    m_cvPendingTxBodies.notify_all();
+    m_txBodyWriter.join();
+  }
+}
+
 BlockStorage& BlockStorage::GetBlockStorage() {
   static BlockStorage bs;
   return bs;
@@ -94,6 +109,10 @@ bool BlockStorage::PutBlockLink(const uint64_t& index,
 
 bool BlockStorage::PutTxBlock(const uint64_t& blockNum,
                               const vector<unsigned char>& body) {
+  // The txn bodies queued so far must not be lost once a later tx block is
+  // on disk
+  FlushTxBodies();
+
   return PutBlock(blockNum, body, BlockType::Tx);
 }
 
@@ -112,6 +131,303 @@ bool BlockStorage::PutTxBody(const dev::h256& key,
   return (ret == 0);
 }
 
+bool BlockStorage::GetTxBodiesChunk(const string& rangeBegin,
+                                    const string& rangeEnd,
+                                    const string& startAfter, size_t maxBytes,
+                                    vector<pair<string, string>>& entries,
+                                    string& lastKey) {
+  if (!LOOKUP_NODE_MODE) {
+    LOG_GENERAL(WARNING, "Non lookup node should not trigger this.");
+    lastKey = startAfter;
+    return false;
+  }
+
+  FlushTxBodies();
+
+  return m_txBodyDB->GetRange(rangeBegin, rangeEnd, startAfter, maxBytes,
+                              entries, lastKey);
+}
+
+bool BlockStorage::PutTxBodiesChunk(
+    const vector<pair<string, string>>& entries) {
+  if (!LOOKUP_NODE_MODE) {
+    LOG_GENERAL(WARNING, "Non lookup node should not trigger this.");
+    return false;
+  }
+
+  if (m_txBodyDB->BatchInsert(entries) != 0) {
+    return false;
+  }
+
+  // Synced bodies may include contract creations this node never committed
+  for (const auto& entry : entries) {
+    TransactionWithReceipt twr;
+    if (twr.Deserialize(vector<unsigned char>(entry.second.begin(),
+                                              entry.second.end()),
+                        0) != 0) {
+      continue;
+    }
+    PutContractCreation(twr);
+  }
+
+  return true;
+}
+
+namespace {
+// Keys of the contract index: the number of contracts of a creator, each
+// contract under its creator and creation number, and the creator of each
+// contract so that a creation seen twice is indexed once
+string ContractCountKey(const Address& creator) { return "n" + creator.hex(); }
+
+string ContractKey(const Address& creator, const uint64_t& num) {
+  ostringstream key;
+  key << "c" << creator.hex() << setw(16) << setfill('0') << hex << num;
+  return key.str();
+}
+
+string ContractCreatorKey(const Address& contract) {
+  return "a" + contract.hex();
+}
+
+// Set once the index holds the contracts of all the stored txn bodies
+const string CONTRACT_INDEX_BUILT_KEY = "built";
+
+// Returns false if twr is not a successful contract creation
+bool GetContractCreation(const TransactionWithReceipt& twr, Address& creator,
+                         Address& contract) {
+  const Transaction& tx = twr.GetTransaction();
+  if (tx.GetCode().empty() || tx.GetToAddr() != NullAddress ||
+      tx.GetNonce() == 0) {
+    return false;
+  }
+
+  const Json::Value& receipt = twr.GetTransactionReceipt().GetJsonValue();
+  if (!receipt.isObject() || !receipt.get("success", false).asBool()) {
+    return false;
+  }
+
+  creator = tx.GetSenderAddr();
+  contract = Account::GetAddressForContract(creator, tx.GetNonce() - 1);
+  return true;
+}
+}  // namespace
+
+bool BlockStorage::BuildContractIndex() {
+  if (!LOOKUP_NODE_MODE) {
+    LOG_GENERAL(WARNING, "Non lookup node should not trigger this.");
+    return false;
+  }
+
+  FlushTxBodies();
+
+  lock_guard<mutex> g(m_mutexContractIndex);
+
+  if (m_contractIndexDB->Exists(CONTRACT_INDEX_BUILT_KEY)) {
+    return true;
+  }
+
+  LOG_GENERAL(INFO, "Building the contract index from the txn bodies");
+
+  // Contracts of each creator ordered by creation nonce
+  map<Address, map<boost::multiprecision::uint256_t, Address>> creations;
+  const size_t CHUNK_SIZE = 4 * 1024 * 1024;
+  string lastKey;
+  bool done = false;
+
+  while (!done) {
+    vector<pair<string, string>> entries;
+    done = m_txBodyDB->GetRange("", "", lastKey, CHUNK_SIZE, entries, lastKey);
+    if (!done && entries.empty()) {
+      LOG_GENERAL(WARNING, "Failed to read the txn bodies");
+      return false;
+    }
+
+    for (const auto& entry : entries) {
+      TransactionWithReceipt twr;
+      Address creator, contract;
+      if (twr.Deserialize(vector<unsigned char>(entry.second.begin(),
+                                                entry.second.end()),
+                          0) != 0 ||
+          !GetContractCreation(twr, creator, contract)) {
+        continue;
+      }
+      creations[creator][twr.GetTransaction().GetNonce()] = contract;
+    }
+  }
+
+  // Contracts indexed live so far may be numbered out of creation order
+  if (!m_contractIndexDB->ResetDB()) {
+    LOG_GENERAL(WARNING, "Failed to reset the contract index");
+    return false;
+  }
+
+  uint64_t total = 0;
+  for (const auto& creator : creations) {
+    vector<pair<string, string>> entries;
+    uint64_t num = 0;
+    for (const auto& contract : creator.second) {
+      entries.emplace_back(ContractKey(creator.first, num++),
+                           contract.second.hex());
+      entries.emplace_back(ContractCreatorKey(contract.second),
+                           creator.first.hex());
+    }
+    entries.emplace_back(ContractCountKey(creator.first), to_string(num));
+    total += num;
+
+    if (m_contractIndexDB->BatchInsert(entries) != 0) {
+      LOG_GENERAL(WARNING, "Failed to index the contracts of "
+                               << creator.first.hex());
+      return false;
+    }
+  }
+
+  if (m_contractIndexDB->BatchInsert(
+          vector<pair<string, string>>{{CONTRACT_INDEX_BUILT_KEY, "1"}}) != 0) {
+    LOG_GENERAL(WARNING, "Failed to mark the contract index built");
+    return false;
+  }
+
+  LOG_GENERAL(INFO, "Indexed " << total << " contracts of " << creations.size()
+                               << " creators");
+  return true;
+}
+
+bool BlockStorage::PutContractCreation(const TransactionWithReceipt& twr) {
+  if (!LOOKUP_NODE_MODE) {
+    LOG_GENERAL(WARNING, "Non lookup node should not trigger this.");
+    return false;
+  }
+
+  Address creator, contract;
+  if (!GetContractCreation(twr, creator, contract)) {
+    return true;
+  }
+
+  lock_guard<mutex> g(m_mutexContractIndex);
+
+  if (m_contractIndexDB->Exists(ContractCreatorKey(contract))) {
+    return true;
+  }
+
+  const uint64_t num = GetNumContractsByCreator(creator);
+  const vector<pair<string, string>> entries = {
+      {ContractKey(creator, num), contract.hex()},
+      {ContractCreatorKey(contract), creator.hex()},
+      {ContractCountKey(creator), to_string(num + 1)}};
+
+  if (m_contractIndexDB->BatchInsert(entries) != 0) {
+    LOG_GENERAL(WARNING, "Failed to index contract " << contract.hex());
+    return false;
+  }
+
+  return true;
+}
+
+uint64_t BlockStorage::GetNumContractsByCreator(const Address& creator) {
+  if (!LOOKUP_NODE_MODE) {
+    return 0;
+  }
+
+  const string count = m_contractIndexDB->Lookup(ContractCountKey(creator));
+  if (count.empty()) {
+    return 0;
+  }
+
+  try {
+    return stoull(count);
+  } catch (exception& e) {
+    LOG_GENERAL(WARNING, "Bad contract count " << count << " for "
+                                               << creator.hex());
+    return 0;
+  }
+}
+
+bool BlockStorage::GetContractsByCreator(const Address& creator,
+                                         const uint64_t& start,
+                                         const uint64_t& count,
+                                         vector<Address>& contracts) {
+  if (!LOOKUP_NODE_MODE) {
+    LOG_GENERAL(WARNING, "Non lookup node should not trigger this.");
+    return false;
+  }
+
+  const uint64_t total = GetNumContractsByCreator(creator);
+  const uint64_t end = start + min(count, total - min(start, total));
+
+  for (uint64_t num = start; num < end; num++) {
+    const string contract =
+        m_contractIndexDB->Lookup(ContractKey(creator, num));
+    if (contract.size() != ACC_ADDR_SIZE * 2) {
+      LOG_GENERAL(WARNING, "Contract " << num << " of " << creator.hex()
+                                       << " missing from the index");
+      return false;
+    }
+    contracts.emplace_back(DataConversion::HexStrToUint8Vec(contract));
+  }
+
+  return true;
+}
+
+bool BlockStorage::WriteTxBodies(const TxBodyBatch& bodies) {
+  return (m_txBodyDB->BatchInsert(bodies) == 0) &&
+         (m_txBodyTmpDB->BatchInsert(bodies) == 0);
+}
+
+void BlockStorage::TxBodyWriterThread() {
+  unique_lock<mutex> lock(m_mutexPendingTxBodies);
+
+  while (true) {
+    m_cvPendingTxBodies.wait(lock, [this] {
+      return m_stopTxBodyWriter || !m_pendingTxBodies.empty();
+    });
+
+    // Stop only once everything queued has been written
+    if (m_pendingTxBodies.empty()) {
+      return;
+    }
+
+    // Leave the batch queued while writing so GetTxBody can still find it;
+    // deque references stay valid while PutTxBodies appends
+    const TxBodyBatch& bodies = m_pendingTxBodies.front();
+    lock.unlock();
+
+    if (!WriteTxBodies(bodies)) {
+      LOG_GENERAL(WARNING, "Failed to write " << bodies.size()
+                                              << " txn bodies");
+    }
+
+    lock.lock();
+    m_pendingTxBodies.pop_front();
+    m_cvPendingTxBodies.notify_all();
+  }
+}
+
+bool BlockStorage::PutTxBodies(TxBodyBatch&& bodies) {
+  if (!LOOKUP_NODE_MODE) {
+    LOG_GENERAL(WARNING, "Non lookup node should not trigger this.");
+    return false;
+  }
+
+  if (bodies.empty()) {
+    return true;
+  }
+
+  if (!m_txBodyWriter.joinable()) {
+    return WriteTxBodies(bodies);
+  }
+
+  lock_guard<mutex> g(m_mutexPendingTxBodies);
+  m_pendingTxBodies.emplace_back(move(bodies));
+  m_cvPendingTxBodies.notify_all();
+  return true;
+}
+
+void BlockStorage::FlushTxBodies() {
+  unique_lock<mutex> lock(m_mutexPendingTxBodies);
+  m_cvPendingTxBodies.wait(lock,
+                           [this] { return m_pendingTxBodies.empty(); });
+}
+
 string MakeKey(const uint64_t& blockNum, const uint32_t& shardId) {
   unsigned int curr_offset = 0;
   vector<unsigned char> vec;
@@ -250,6 +566,29 @@ bool BlockStorage::GetTxBody(const dev::h256& key, TxBodySharedPtr& body) {
     bodyString = m_txBodyDB->Lookup(key);
   }
 
+  if (bodyString.empty() && m_txBodyWriter.joinable()) {
+    // The body may still be queued for the writer thread. Batches leave the
+    // queue only after they are written, so a body missing from both the
+    // queue and the DB does not exist.
+    {
+      lock_guard<mutex> g(m_mutexPendingTxBodies);
+      for (const auto& bodies : m_pendingTxBodies) {
+        for (const auto& entry : bodies) {
+          if (entry.first == key) {
+            bodyString.assign(entry.second.begin(), entry.second.end());
+            break;
+          }
+        }
+        if (!bodyString.empty()) {
+          break;
+        }
+      }
+    }
+    if (bodyString.empty()) {
+      bodyString = m_txBodyDB->Lookup(key);
+    }
+  }
+
   if (bodyString.empty()) {
     return false;
   }
@@ -300,62 +639,85 @@ bool BlockStorage::DeleteTxBody(const dev::h256& key) {
 //                                             0) );
 // }
 
-bool BlockStorage::GetAllDSBlocks(std::list<DSBlockSharedPtr>& blocks) {
-  LOG_MARKER();
+namespace {
+template <class T>
+bool GetBlockRange(const shared_ptr<LevelDB>& db, const uint64_t& lo,
+                   const uint64_t& hi,
+                   const function<bool(const shared_ptr<T>&)>& f) {
+  unique_ptr<leveldb::Iterator> it(
+      db->GetDB()->NewIterator(leveldb::ReadOptions()));
+
+  for (it->Seek(LevelDB::BlockNumToKey(lo)); it->Valid(); it->Next()) {
+    if (LevelDB::KeyToBlockNum(it->key()) > hi) {
+      break;
+    }
 
-  leveldb::Iterator* it =
-      m_dsBlockchainDB->GetDB()->NewIterator(leveldb::ReadOptions());
-  for (it->SeekToFirst(); it->Valid(); it->Next()) {
-    string bns = it->key().ToString();
     string blockString = it->value().ToString();
     if (blockString.empty()) {
       LOG_GENERAL(WARNING, "Lost one block in the chain");
-      delete it;
       return false;
     }
 
-    DSBlockSharedPtr block = DSBlockSharedPtr(new DSBlock(
-        std::vector<unsigned char>(blockString.begin(), blockString.end()), 0));
-    blocks.emplace_back(block);
-    LOG_GENERAL(INFO, "Retrievd DsBlock Num:" << bns);
+    auto block = make_shared<T>(
+        vector<unsigned char>(blockString.begin(), blockString.end()), 0);
+    if (!f(block)) {
+      break;
+    }
   }
 
-  delete it;
+  return it->status().ok();
+}
+}  // namespace
+
+bool BlockStorage::GetDSBlocks(
+    const uint64_t& lo, const uint64_t& hi,
+    const function<bool(const DSBlockSharedPtr&)>& f) {
+  return GetBlockRange<DSBlock>(m_dsBlockchainDB, lo, hi, f);
+}
+
+bool BlockStorage::GetTxBlocks(
+    const uint64_t& lo, const uint64_t& hi,
+    const function<bool(const TxBlockSharedPtr&)>& f) {
+  return GetBlockRange<TxBlock>(m_txBlockchainDB, lo, hi, f);
+}
+
+bool BlockStorage::GetAllDSBlocks(std::list<DSBlockSharedPtr>& blocks) {
+  LOG_MARKER();
+
+  if (!GetDSBlocks(0, numeric_limits<uint64_t>::max(),
+                   [&blocks](const DSBlockSharedPtr& block) {
+                     blocks.emplace_back(block);
+                     return true;
+                   })) {
+    return false;
+  }
 
   if (blocks.empty()) {
     LOG_GENERAL(INFO, "Disk has no DSBlock");
     return false;
   }
 
+  LOG_GENERAL(INFO, "Retrieved " << blocks.size() << " DSBlocks");
   return true;
 }
 
 bool BlockStorage::GetAllTxBlocks(std::list<TxBlockSharedPtr>& blocks) {
   LOG_MARKER();
 
-  leveldb::Iterator* it =
-      m_txBlockchainDB->GetDB()->NewIterator(leveldb::ReadOptions());
-  for (it->SeekToFirst(); it->Valid(); it->Next()) {
-    string bns = it->key().ToString();
-    string blockString = it->value().ToString();
-    if (blockString.empty()) {
-      LOG_GENERAL(WARNING, "Lost one block in the chain");
-      delete it;
-      return false;
-    }
-    TxBlockSharedPtr block = TxBlockSharedPtr(new TxBlock(
-        std::vector<unsigned char>(blockString.begin(), blockString.end()), 0));
-    blocks.emplace_back(block);
-    LOG_GENERAL(INFO, "Retrievd TxBlock Num:" << bns);
+  if (!GetTxBlocks(0, numeric_limits<uint64_t>::max(),
+                   [&blocks](const TxBlockSharedPtr& block) {
+                     blocks.emplace_back(block);
+                     return true;
+                   })) {
+    return false;
   }
 
-  delete it;
-
   if (blocks.empty()) {
     LOG_GENERAL(INFO, "Disk has no TxBlock");
     return false;
   }
 
+  LOG_GENERAL(INFO, "Retrieved " << blocks.size() << " TxBlocks");
   return true;
 }
 
@@ -369,6 +731,8 @@ bool BlockStorage::GetAllTxBodiesTmp(std::list<TxnHash>& txnHashes) {
 
   LOG_MARKER();
 
+  FlushTxBodies();
+
   leveldb::Iterator* it =
       m_txBodyTmpDB->GetDB()->NewIterator(leveldb::ReadOptions());
   for (it->SeekToFirst(); it->Valid(); it->Next()) {
@@ -389,6 +753,10 @@ bool BlockStorage::GetAllTxBodiesTmp(std::list<TxnHash>& txnHashes) {
 bool BlockStorage::PutMetadata(MetaType type,
                                const std::vector<unsigned char>& data) {
   LOG_MARKER();
+
+  // The metadata, e.g. the state root, may refer to queued txn bodies
+  FlushTxBodies();
+
   int ret = m_metadataDB->Insert(std::to_string((int)type), data);
   return (ret == 0);
 }
@@ -490,9 +858,11 @@ bool BlockStorage::ResetDB(DBTYPE type) {
       ret = m_txBlockchainDB->ResetDB();
       break;
     case TX_BODY:
+      FlushTxBodies();
       ret = m_txBodyDB->ResetDB();
       break;
     case TX_BODY_TMP:
+      FlushTxBodies();
       ret = m_txBodyTmpDB->ResetDB();
       break;
     case MICROBLOCK:
@@ -510,6 +880,9 @@ bool BlockStorage::ResetDB(DBTYPE type) {
     case BLOCKLINK:
       ret = m_blockLinkDB->ResetDB();
       break;
+    case CONTRACT_INDEX:
+      ret = m_contractIndexDB->ResetDB();
+      break;
   }
   if (!ret) {
     LOG_GENERAL(INFO, "FAIL: Reset DB " << type << " failed");
@@ -550,6 +923,9 @@ std::vector<std::string> BlockStorage::GetDBName(DBTYPE type) {
     case BLOCKLINK:
       ret.push_back(m_blockLinkDB->GetDBName());
       break;
+    case CONTRACT_INDEX:
+      ret.push_back(m_contractIndexDB->GetDBName());
+      break;
   }
 
   return ret;
@@ -565,6 +941,6 @@ bool BlockStorage::ResetAll() {
     return ResetDB(META) && ResetDB(DS_BLOCK) && ResetDB(TX_BLOCK) &&
            ResetDB(TX_BODY) && ResetDB(TX_BODY_TMP) && ResetDB(MICROBLOCK) &&
            ResetDB(DS_COMMITTEE) && ResetDB(VC_BLOCK) && ResetDB(FB_BLOCK) &&
-           ResetDB(BLOCKLINK);
+           ResetDB(BLOCKLINK) && ResetDB(CONTRACT_INDEX);
   }
 }
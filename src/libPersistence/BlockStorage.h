@@ -20,9 +20,13 @@
 #ifndef BLOCKSTORAGE_H
 #define BLOCKSTORAGE_H
 
+#include <condition_variable>
+#include <deque>
+#include <functional>
 #include <list>
 #include <mutex>
 #include <shared_mutex>
+#include <thread>
 #include <vector>
 
 #include "common/Singleton.h"
@@ -39,6 +43,8 @@ typedef std::shared_ptr<FallbackBlockWShardingStructure> FallbackBlockSharedPtr;
 typedef std::shared_ptr<BlockLink> BlockLinkSharedPtr;
 typedef std::shared_ptr<MicroBlock> MicroBlockSharedPtr;
 typedef std::shared_ptr<TransactionWithReceipt> TxBodySharedPtr;
+typedef std::vector<std::pair<dev::h256, std::vector<unsigned char>>>
+    TxBodyBatch;
 
 /// Manages persistent storage of DS and Tx blocks.
 class BlockStorage : public Singleton<BlockStorage> {
@@ -52,6 +58,17 @@ class BlockStorage : public Singleton<BlockStorage> {
   std::shared_ptr<LevelDB> m_VCBlockDB;
   std::shared_ptr<LevelDB> m_fallbackBlockDB;
   std::shared_ptr<LevelDB> m_blockLinkDB;
+  std::shared_ptr<LevelDB> m_contractIndexDB;
+
+  std::mutex m_mutexContractIndex;
+
+  /// Batches queued by PutTxBodies for the writer thread. A batch stays at
+  /// the front until it has been written.
+  std::deque<TxBodyBatch> m_pendingTxBodies;
+  bool m_stopTxBodyWriter = false;
+  std::mutex m_mutexPendingTxBodies;
+  std::condition_variable m_cvPendingTxBodies;
+  std::thread m_txBodyWriter;
 
   BlockStorage()
       : m_metadataDB(std::make_shared<LevelDB>("metadata")),
@@ -61,16 +78,29 @@ class BlockStorage : public Singleton<BlockStorage> {
         m_VCBlockDB(std::make_shared<LevelDB>("VCBlocks")),
         m_fallbackBlockDB(std::make_shared<LevelDB>("fallbackBlocks")),
         m_blockLinkDB(std::make_shared<LevelDB>("blockLinks")) {
+    for (const auto& db : {m_dsBlockchainDB, m_txBlockchainDB,
+                           m_dsCommitteeDB, m_blockLinkDB}) {
+      if (db->MigrateBlockNumKeys() < 0) {
+        LOG_GENERAL(WARNING, "Failed to migrate keys of " << db->GetDBName());
+      }
+    }
     if (LOOKUP_NODE_MODE) {
       m_txBodyDB = std::make_shared<LevelDB>("txBodies");
       m_txBodyTmpDB = std::make_shared<LevelDB>("txBodiesTmp");
       m_microBlockDB = std::make_shared<LevelDB>("microBlocks");
+      m_contractIndexDB = std::make_shared<LevelDB>("contractIndex");
+      BuildContractIndex();
+      if (ASYNC_TXBODY_COMMIT) {
+        m_txBodyWriter = std::thread(&BlockStorage::TxBodyWriterThread, this);
+      }
     }
   };
-  ~BlockStorage() = default;
+  ~BlockStorage();
   bool PutBlock(const uint64_t& blockNum,
                 const std::vector<unsigned char>& body,
                 const BlockType& blockType);
+  bool WriteTxBodies(const TxBodyBatch& bodies);
+  void TxBodyWriterThread();
 
  public:
   enum DBTYPE {
@@ -83,7 +113,8 @@ class BlockStorage : public Singleton<BlockStorage> {
     DS_COMMITTEE,
     VC_BLOCK,
     FB_BLOCK,
-    BLOCKLINK
+    BLOCKLINK,
+    CONTRACT_INDEX
   };
 
   /// Returns the singleton BlockStorage instance.
@@ -113,6 +144,47 @@ class BlockStorage : public Singleton<BlockStorage> {
   /// Adds a transaction body to storage.
   bool PutTxBody(const dev::h256& key, const std::vector<unsigned char>& body);
 
+  /// Adds transaction bodies to storage using one write batch per database.
+  /// With ASYNC_TXBODY_COMMIT the batch is written by a dedicated thread and
+  /// this returns once it is queued. Queued batches are written before any
+  /// later tx block or metadata.
+  bool PutTxBodies(TxBodyBatch&& bodies);
+
+  /// Waits until all queued transaction bodies are written.
+  void FlushTxBodies();
+
+  /// Reads the stored transaction bodies of [rangeBegin, rangeEnd) following
+  /// startAfter, up to about maxBytes, as raw database entries.
+  /// Returns true if the range has been read to its end.
+  bool GetTxBodiesChunk(
+      const std::string& rangeBegin, const std::string& rangeEnd,
+      const std::string& startAfter, size_t maxBytes,
+      std::vector<std::pair<std::string, std::string>>& entries,
+      std::string& lastKey);
+
+  /// Adds raw transaction body entries read by GetTxBodiesChunk on another
+  /// node to storage.
+  bool PutTxBodiesChunk(
+      const std::vector<std::pair<std::string, std::string>>& entries);
+
+  /// Adds the contract created by a committed transaction to the index of
+  /// contracts by creator. Other transactions are ignored.
+  bool PutContractCreation(const TransactionWithReceipt& twr);
+
+  /// Rebuilds the contract index from the stored transaction bodies, unless
+  /// it has been built already. Bodies stored before the index existed are
+  /// only indexed this way.
+  bool BuildContractIndex();
+
+  /// Returns the number of indexed contracts created by the creator.
+  uint64_t GetNumContractsByCreator(const Address& creator);
+
+  /// Retrieves up to count contracts created by the creator, in creation
+  /// order, starting from the one numbered start.
+  bool GetContractsByCreator(const Address& creator, const uint64_t& start,
+                             const uint64_t& count,
+                             std::vector<Address>& contracts);
+
   /// Retrieves the requested DS block.
   bool GetDSBlock(const uint64_t& blockNum, DSBlockSharedPtr& block);
 
@@ -150,10 +222,20 @@ class BlockStorage : public Singleton<BlockStorage> {
   // /// Retrieves the requested transaction body.
   // void GetTxBody(const std::string & key, TxBodySharedPtr & body);
 
-  /// Retrieves all the DSBlocks
+  /// Calls f on each stored DSBlock numbered lo to hi, in order, until f
+  /// returns false.
+  bool GetDSBlocks(const uint64_t& lo, const uint64_t& hi,
+                   const std::function<bool(const DSBlockSharedPtr&)>& f);
+
+  /// Calls f on each stored TxBlock numbered lo to hi, in order, until f
+  /// returns false.
+  bool GetTxBlocks(const uint64_t& lo, const uint64_t& hi,
+                   const std::function<bool(const TxBlockSharedPtr&)>& f);
+
+  /// Retrieves all the DSBlocks, ordered by block number
   bool GetAllDSBlocks(std::list<DSBlockSharedPtr>& blocks);
 
-  /// Retrieves all the TxBlocks
+  /// Retrieves all the TxBlocks, ordered by block number
   bool GetAllTxBlocks(std::list<TxBlockSharedPtr>& blocks);
 
   /// Retrieves all the TxBodiesTmp
@@ -46,10 +46,6 @@ void Retriever::RetrieveDSBlocks(bool& result) {
     return;
   }
 
-  blocks.sort([](const DSBlockSharedPtr& a, const DSBlockSharedPtr& b) {
-    return a->GetHeader().GetBlockNum() < b->GetHeader().GetBlockNum();
-  });
-
   if (!blocks.empty()) {
     if (m_mediator.m_ds->m_latestActiveDSBlockNum == 0) {
       std::vector<unsigned char> latestActiveDSBlockNumVec;
@@ -100,10 +96,6 @@ void Retriever::RetrieveTxBlocks(bool& result) {
     return;
   }
 
-  blocks.sort([](const TxBlockSharedPtr& a, const TxBlockSharedPtr& b) {
-    return a->GetHeader().GetBlockNum() < b->GetHeader().GetBlockNum();
-  });
-
   // truncate the extra final blocks at last
   int totalSize = blocks.size();
   int extra_txblocks = totalSize % NUM_FINAL_BLOCK_PER_POW;
@@ -151,7 +143,10 @@ bool Retriever::ValidateStates() {
   if (m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetStateRootHash() ==
       AccountStore::GetInstance().GetStateRootHash()) {
     LOG_GENERAL(INFO, "ValidateStates passed.");
-    AccountStore::GetInstance().RepopulateStateTrie();
+    // The trie on disk is already complete when loading lazily
+    if (!LAZY_STATE_LOADING) {
+      AccountStore::GetInstance().RepopulateStateTrie();
+    }
     return true;
   } else {
     LOG_GENERAL(WARNING, "ValidateStates failed.");
@@ -37,7 +37,9 @@
 #include "libNetwork/Peer.h"
 #include "libPersistence/BlockStorage.h"
 #include "libUtils/Logger.h"
+#include "libUtils/MerkleTree.h"
 #include "libUtils/TimeUtils.h"
+#include "libUtils/TxnRootComputation.h"
 
 using namespace jsonrpc;
 using namespace std;
@@ -48,6 +50,7 @@ std::mutex Server::m_mutexRecentTxns;
 const unsigned int PAGE_SIZE = 10;
 const unsigned int NUM_PAGES_CACHE = 2;
 const unsigned int TXN_PAGE_SIZE = 100;
+const unsigned int CONTRACT_PAGE_SIZE = 100;
 
 //[warning] do not make this constant too big as it loops over blockchain
 const unsigned int REF_BLOCK_DIFF = 5;
@@ -102,9 +105,9 @@ Json::Value Server::CreateTransaction(const Json::Value& _json) {
 
     const PubKey& senderPubKey = tx.GetSenderPubKey();
     const Address fromAddr = Account::GetAddressFromPublicKey(senderPubKey);
-    const Account* sender = AccountStore::GetInstance().GetAccount(fromAddr);
+    Account sender;
 
-    if (sender == nullptr) {
+    if (!AccountStore::GetInstance().GetAccountCopy(fromAddr, sender)) {
       ret["Error"] = "The sender of the txn is null";
       return ret;
     }
@@ -114,30 +117,30 @@ Json::Value Server::CreateTransaction(const Json::Value& _json) {
       unsigned int shard = Transaction::GetShardIndex(fromAddr, num_shards);
       if (tx.GetData().empty() || tx.GetToAddr() == NullAddress) {
         if (tx.GetData().empty() && tx.GetCode().empty()) {
-          m_mediator.m_lookup->AddToTxnShardMap(tx, shard);
           ret["Info"] = "Non-contract txn, sent to shard";
           ret["TranID"] = tx.GetTranID().hex();
+          m_mediator.m_lookup->AddToTxnShardMap(std::move(tx), shard);
         } else if (!tx.GetCode().empty() && tx.GetToAddr() == NullAddress) {
-          m_mediator.m_lookup->AddToTxnShardMap(tx, shard);
           ret["Info"] = "Contract Creation txn, sent to shard";
           ret["TranID"] = tx.GetTranID().hex();
+          m_mediator.m_lookup->AddToTxnShardMap(std::move(tx), shard);
           ret["ContractAddress"] =
-              Account::GetAddressForContract(fromAddr, sender->GetNonce())
+              Account::GetAddressForContract(fromAddr, sender.GetNonce())
                   .hex();
         } else {
           ret["Error"] = "Code is empty and To addr is null";
         }
         return ret;
       } else {
-        const Account* account =
-            AccountStore::GetInstance().GetAccount(tx.GetToAddr());
+        Account account;
 
-        if (account == nullptr) {
+        if (!AccountStore::GetInstance().GetAccountCopy(tx.GetToAddr(),
+                                                        account)) {
           ret["Error"] = "To Addr is null";
           return ret;
         }
 
-        else if (!account->isContract()) {
+        else if (!account.isContract()) {
           ret["Error"] = "Non - contract address called";
           return ret;
         }
@@ -145,16 +148,16 @@ Json::Value Server::CreateTransaction(const Json::Value& _json) {
         unsigned int to_shard =
             Transaction::GetShardIndex(tx.GetToAddr(), num_shards);
         if (to_shard == shard) {
-          m_mediator.m_lookup->AddToTxnShardMap(tx, shard);
           ret["Info"] =
               "Contract Txn, Shards Match of the sender "
               "and reciever";
           ret["TranID"] = tx.GetTranID().hex();
+          m_mediator.m_lookup->AddToTxnShardMap(std::move(tx), shard);
           return ret;
         } else {
-          m_mediator.m_lookup->AddToTxnShardMap(tx, num_shards);
           ret["Info"] = "Contract Txn, Sent To Ds";
           ret["TranID"] = tx.GetTranID().hex();
+          m_mediator.m_lookup->AddToTxnShardMap(std::move(tx), num_shards);
           return ret;
         }
       }
@@ -321,19 +324,19 @@ Json::Value Server::GetBalance(const string& address) {
     }
     vector<unsigned char> tmpaddr = DataConversion::HexStrToUint8Vec(address);
     Address addr(tmpaddr);
-    const Account* account = AccountStore::GetInstance().GetAccount(addr);
+    Account account;
 
     Json::Value ret;
-    if (account != nullptr) {
-      boost::multiprecision::uint256_t balance = account->GetBalance();
-      boost::multiprecision::uint256_t nonce = account->GetNonce();
+    if (AccountStore::GetInstance().GetAccountCopy(addr, account)) {
+      boost::multiprecision::uint256_t balance = account.GetBalance();
+      boost::multiprecision::uint256_t nonce = account.GetNonce();
 
       ret["balance"] = balance.str();
       // FIXME: a workaround, 256-bit unsigned int being truncated
       ret["nonce"] = nonce.convert_to<unsigned int>();
       LOG_GENERAL(INFO, "balance " << balance.str() << " nonce: "
                                    << nonce.convert_to<unsigned int>());
-    } else if (account == nullptr) {
+    } else {
       ret["balance"] = 0;
       ret["nonce"] = 0;
     }
@@ -359,14 +362,14 @@ Json::Value Server::GetSmartContractState(const string& address) {
     }
     vector<unsigned char> tmpaddr = DataConversion::HexStrToUint8Vec(address);
     Address addr(tmpaddr);
-    const Account* account = AccountStore::GetInstance().GetAccount(addr);
+    Account account;
 
-    if (account == nullptr) {
+    if (!AccountStore::GetInstance().GetAccountCopy(addr, account)) {
       _json["Error"] = "Address does not exist";
       return _json;
     }
 
-    return account->GetStorageJson();
+    return account.GetStorageJson();
   } catch (exception& e) {
     LOG_GENERAL(INFO, "[Error]" << e.what() << " Input: " << address);
     Json::Value _json;
@@ -387,18 +390,18 @@ Json::Value Server::GetSmartContractInit(const string& address) {
     }
     vector<unsigned char> tmpaddr = DataConversion::HexStrToUint8Vec(address);
     Address addr(tmpaddr);
-    const Account* account = AccountStore::GetInstance().GetAccount(addr);
+    Account account;
 
-    if (account == nullptr) {
+    if (!AccountStore::GetInstance().GetAccountCopy(addr, account)) {
       _json["Error"] = "Address does not exist";
       return _json;
     }
-    if (!account->isContract()) {
+    if (!account.isContract()) {
       _json["Error"] = "Address not contract address";
       return _json;
     }
 
-    return account->GetInitJson();
+    return account.GetInitJson();
   } catch (exception& e) {
     LOG_GENERAL(INFO, "[Error]" << e.what() << " Input: " << address);
     Json::Value _json;
@@ -419,19 +422,19 @@ Json::Value Server::GetSmartContractCode(const string& address) {
     }
     vector<unsigned char> tmpaddr = DataConversion::HexStrToUint8Vec(address);
     Address addr(tmpaddr);
-    const Account* account = AccountStore::GetInstance().GetAccount(addr);
+    Account account;
 
-    if (account == nullptr) {
+    if (!AccountStore::GetInstance().GetAccountCopy(addr, account)) {
       _json["Error"] = "Address does not exist";
       return _json;
     }
 
-    if (!account->isContract()) {
+    if (!account.isContract()) {
       _json["Error"] = "Address is not a contract account";
       return _json;
     }
 
-    _json["code"] = DataConversion::CharArrayToString(account->GetCode());
+    _json["code"] = DataConversion::CharArrayToString(account.GetCode());
     return _json;
   } catch (exception& e) {
     LOG_GENERAL(INFO, "[Error]" << e.what() << " Input: " << address);
@@ -447,44 +450,114 @@ string Server::GetStorageAt([[gnu::unused]] const string& address,
   return "Hello";
 }
 
+namespace {
+/// Checks that address names an existing non-contract account and fills
+/// _json with the error otherwise.
+bool GetCreatorAddress(const string& address, Address& addr,
+                       Json::Value& _json) {
+  if (address.size() != ACC_ADDR_SIZE * 2) {
+    _json["Error"] = "Address size inappropriate";
+    return false;
+  }
+  addr = Address(DataConversion::HexStrToUint8Vec(address));
+  Account account;
+
+  if (!AccountStore::GetInstance().GetAccountCopy(addr, account)) {
+    _json["Error"] = "Address does not exist";
+    return false;
+  }
+  if (account.isContract()) {
+    _json["Error"] = "A contract account queried";
+    return false;
+  }
+  return true;
+}
+
+/// Appends the contracts numbered start to start + count - 1 of the creator,
+/// with their states if includeState is set.
+bool AppendSmartContracts(const Address& creator, const uint64_t& start,
+                          const uint64_t& count, bool includeState,
+                          Json::Value& _json) {
+  vector<Address> contracts;
+  if (!BlockStorage::GetBlockStorage().GetContractsByCreator(
+          creator, start, count, contracts)) {
+    return false;
+  }
+
+  for (const auto& contractAddr : contracts) {
+    Json::Value tmpJson;
+    tmpJson["address"] = contractAddr.hex();
+    if (includeState) {
+      Account contractAccount;
+      if (!AccountStore::GetInstance().GetAccountCopy(contractAddr,
+                                                      contractAccount) ||
+          !contractAccount.isContract()) {
+        continue;
+      }
+      tmpJson["state"] = contractAccount.GetStorageJson();
+    }
+
+    _json.append(tmpJson);
+  }
+  return true;
+}
+}  // namespace
+
 Json::Value Server::GetSmartContracts(const string& address) {
-  Json::Value _json;
   LOG_MARKER();
   try {
     Json::Value _json;
-    if (address.size() != ACC_ADDR_SIZE * 2) {
-      _json["Error"] = "Address size inappropriate";
+    Address addr;
+    if (!GetCreatorAddress(address, addr, _json)) {
       return _json;
     }
-    vector<unsigned char> tmpaddr = DataConversion::HexStrToUint8Vec(address);
-    Address addr(tmpaddr);
-    const Account* account = AccountStore::GetInstance().GetAccount(addr);
 
-    if (account == nullptr) {
-      _json["Error"] = "Address does not exist";
+    const uint64_t numContracts =
+        BlockStorage::GetBlockStorage().GetNumContractsByCreator(addr);
+    Json::Value contracts = Json::arrayValue;
+    if (!AppendSmartContracts(addr, 0, numContracts, true, contracts)) {
+      _json["Error"] = "Unable To Process";
       return _json;
     }
-    if (account->isContract()) {
-      _json["Error"] = "A contract account queried";
+    return contracts;
+  } catch (exception& e) {
+    LOG_GENERAL(INFO, "[Error]" << e.what() << " Input: " << address);
+    Json::Value _json;
+    _json["Error"] = "Unable To Process";
+
+    return _json;
+  }
+}
+
+Json::Value Server::GetSmartContractsPage(const string& address,
+                                          unsigned int page,
+                                          bool includeState) {
+  LOG_MARKER();
+  try {
+    Json::Value _json;
+    Address addr;
+    if (!GetCreatorAddress(address, addr, _json)) {
       return _json;
     }
-    boost::multiprecision::uint256_t nonce = account->GetNonce();
-    //[TODO] find out a more efficient way (using storage)
 
-    for (boost::multiprecision::uint256_t i = 0; i < nonce; i++) {
-      Address contractAddr = Account::GetAddressForContract(addr, i);
-      const Account* contractAccount =
-          AccountStore::GetInstance().GetAccount(contractAddr);
+    const uint64_t numContracts =
+        BlockStorage::GetBlockStorage().GetNumContractsByCreator(addr);
+    const uint64_t maxPages =
+        max<uint64_t>((numContracts + CONTRACT_PAGE_SIZE - 1) /
+                          CONTRACT_PAGE_SIZE,
+                      1);
+    _json["maxPages"] = Json::UInt64(maxPages);
 
-      if (contractAccount == nullptr || !contractAccount->isContract()) {
-        continue;
-      }
-
-      Json::Value tmpJson;
-      tmpJson["address"] = contractAddr.hex();
-      tmpJson["state"] = contractAccount->GetStorageJson();
+    if (page > maxPages || page < 1) {
+      _json["Error"] = "Pages out of limit";
+      return _json;
+    }
 
-      _json.append(tmpJson);
+    _json["contracts"] = Json::arrayValue;
+    if (!AppendSmartContracts(addr, uint64_t(page - 1) * CONTRACT_PAGE_SIZE,
+                              CONTRACT_PAGE_SIZE, includeState,
+                              _json["contracts"])) {
+      _json["Error"] = "Unable To Process";
     }
     return _json;
   } catch (exception& e) {
@@ -538,6 +611,91 @@ Json::Value Server::GetTransactionReceipt([
   return "Hello";
 }
 
+namespace {
+Json::Value ProofToJson(const MerkleProof& proof, const dev::h256& root) {
+  Json::Value _json;
+  _json["index"] = proof.m_index;
+  _json["leafCount"] = proof.m_leafCount;
+  _json["root"] = root.hex();
+  _json["siblings"] = Json::Value(Json::arrayValue);
+  for (const auto& sibling : proof.m_siblings) {
+    _json["siblings"].append(sibling.hex());
+  }
+  return _json;
+}
+}  // namespace
+
+Json::Value Server::GetTransactionProof(const string& transactionHash,
+                                        const string& txBlockNum) {
+  LOG_MARKER();
+
+  Json::Value _json;
+
+  if (transactionHash.size() != TRAN_HASH_SIZE * 2) {
+    _json["Error"] = "Size not appropriate";
+    return _json;
+  }
+
+  try {
+    TxnHash tranHash(transactionHash);
+    const TxBlock& txBlock =
+        m_mediator.m_txBlockChain.GetBlock(stoull(txBlockNum));
+    const uint64_t& blockNum = txBlock.GetHeader().GetBlockNum();
+
+    if (!IsMerkleRootBlock(blockNum)) {
+      _json["Error"] = "Proofs not supported by this root hash version";
+      return _json;
+    }
+
+    const auto& shardIds = txBlock.GetShardIds();
+    const auto& microBlockHashes = txBlock.GetMicroBlockHashes();
+
+    for (unsigned int i = 0; i < shardIds.size(); i++) {
+      MicroBlockSharedPtr mbptr;
+      if (!BlockStorage::GetBlockStorage().GetMicroBlock(blockNum, shardIds[i],
+                                                         mbptr)) {
+        continue;
+      }
+
+      MerkleTree mbTree(mbptr->GetTranHashes());
+      MerkleProof mbProof;
+      if (!mbTree.GetInclusionProof(tranHash, mbProof)) {
+        continue;
+      }
+
+      vector<dev::h256> mbRoots;
+      for (const auto& hashSet : microBlockHashes) {
+        mbRoots.emplace_back(hashSet.m_txRootHash);
+      }
+      MerkleTree txTree(mbRoots);
+      MerkleProof txProof;
+      txTree.GetInclusionProof(i, txProof);
+
+      _json["shardId"] = shardIds[i];
+      _json["microBlockProof"] =
+          ProofToJson(mbProof, mbptr->GetHeader().GetTxRootHash());
+      _json["txBlockProof"] =
+          ProofToJson(txProof, txBlock.GetHeader().GetTxRootHash());
+      return _json;
+    }
+
+    _json["Error"] = "Txn Hash not Present in block";
+    return _json;
+  } catch (invalid_argument& e) {
+    LOG_GENERAL(INFO, "[Error]" << e.what() << " Input: " << txBlockNum);
+    _json["Error"] = "Invalid arugment";
+    return _json;
+  } catch (out_of_range& e) {
+    LOG_GENERAL(INFO, "[Error]" << e.what() << " Input: " << txBlockNum);
+    _json["Error"] = "Out of range";
+    return _json;
+  } catch (exception& e) {
+    LOG_GENERAL(INFO, "[Error]" << e.what() << " Input: " << transactionHash);
+    _json["Error"] = "Unable to Process";
+    return _json;
+  }
+}
+
 bool Server::isNodeSyncing() { return "Hello"; }
 
 bool Server::isNodeMining() { return "Hello"; }
@@ -898,15 +1056,35 @@ Json::Value Server::TxBlockListing(unsigned int page) {
       _json["data"].append(tmpJson);
     }
   } else {
-    for (uint64_t i = offset; i < PAGE_SIZE + offset && i <= currBlockNum;
-         i++) {
-      tmpJson.clear();
-      tmpJson["Hash"] = m_mediator.m_txBlockChain.GetBlock(currBlockNum - i + 1)
-                            .GetHeader()
-                            .GetPrevHash()
-                            .hex();
-      tmpJson["BlockNum"] = int(currBlockNum - i);
-      _json["data"].append(tmpJson);
+    // Block n + 1 holds the hash of block n
+    const uint64_t hi = currBlockNum - offset + 1;
+    const uint64_t lo = (hi > PAGE_SIZE) ? hi - PAGE_SIZE + 1 : 1;
+    vector<TxBlockSharedPtr> blocks;
+    BlockStorage::GetBlockStorage().GetTxBlocks(
+        lo, hi, [&blocks](const TxBlockSharedPtr& block) {
+          blocks.emplace_back(block);
+          return true;
+        });
+
+    if (blocks.size() == hi - lo + 1) {
+      for (auto it = blocks.rbegin(); it != blocks.rend(); it++) {
+        tmpJson.clear();
+        tmpJson["Hash"] = (*it)->GetHeader().GetPrevHash().hex();
+        tmpJson["BlockNum"] = int((*it)->GetHeader().GetBlockNum() - 1);
+        _json["data"].append(tmpJson);
+      }
+    } else {
+      for (uint64_t i = offset; i < PAGE_SIZE + offset && i <= currBlockNum;
+           i++) {
+        tmpJson.clear();
+        tmpJson["Hash"] =
+            m_mediator.m_txBlockChain.GetBlock(currBlockNum - i + 1)
+                .GetHeader()
+                .GetPrevHash()
+                .hex();
+        tmpJson["BlockNum"] = int(currBlockNum - i);
+        _json["data"].append(tmpJson);
+      }
     }
   }
 
@@ -91,6 +91,13 @@ class AbstractZServer : public jsonrpc::AbstractServer<AbstractZServer> {
                            jsonrpc::JSON_ARRAY, "param01", jsonrpc::JSON_STRING,
                            NULL),
         &AbstractZServer::GetSmartContractsI);
+    this->bindAndAddMethod(
+        jsonrpc::Procedure("GetSmartContractsPage", jsonrpc::PARAMS_BY_POSITION,
+                           jsonrpc::JSON_OBJECT, "param01",
+                           jsonrpc::JSON_STRING, "param02",
+                           jsonrpc::JSON_INTEGER, "param03",
+                           jsonrpc::JSON_BOOLEAN, NULL),
+        &AbstractZServer::GetSmartContractsPageI);
     this->bindAndAddMethod(
         jsonrpc::Procedure("GetBlockTransactionCount",
                            jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_STRING,
@@ -116,6 +123,12 @@ class AbstractZServer : public jsonrpc::AbstractServer<AbstractZServer> {
                            jsonrpc::JSON_OBJECT, "param01",
                            jsonrpc::JSON_STRING, NULL),
         &AbstractZServer::GetTransactionReceiptI);
+    this->bindAndAddMethod(
+        jsonrpc::Procedure("GetTransactionProof", jsonrpc::PARAMS_BY_POSITION,
+                           jsonrpc::JSON_OBJECT, "param01",
+                           jsonrpc::JSON_STRING, "param02",
+                           jsonrpc::JSON_STRING, NULL),
+        &AbstractZServer::GetTransactionProofI);
     this->bindAndAddMethod(
         jsonrpc::Procedure("isNodeSyncing", jsonrpc::PARAMS_BY_POSITION,
                            jsonrpc::JSON_BOOLEAN, NULL),
@@ -270,6 +283,11 @@ class AbstractZServer : public jsonrpc::AbstractServer<AbstractZServer> {
                                          Json::Value& response) {
     response = this->GetSmartContracts(request[0u].asString());
   }
+  inline virtual void GetSmartContractsPageI(const Json::Value& request,
+                                             Json::Value& response) {
+    response = this->GetSmartContractsPage(
+        request[0u].asString(), request[1u].asUInt(), request[2u].asBool());
+  }
   inline virtual void GetBlockTransactionCountI(const Json::Value& request,
                                                 Json::Value& response) {
     response = this->GetBlockTransactionCount(request[0u].asString());
@@ -291,6 +309,11 @@ class AbstractZServer : public jsonrpc::AbstractServer<AbstractZServer> {
                                              Json::Value& response) {
     response = this->GetTransactionReceipt(request[0u].asString());
   }
+  inline virtual void GetTransactionProofI(const Json::Value& request,
+                                           Json::Value& response) {
+    response = this->GetTransactionProof(request[0u].asString(),
+                                         request[1u].asString());
+  }
   inline virtual void isNodeSyncingI(const Json::Value& request,
                                      Json::Value& response) {
     (void)request;
@@ -412,12 +435,17 @@ class AbstractZServer : public jsonrpc::AbstractServer<AbstractZServer> {
   virtual std::string GetStorageAt(const std::string& param01,
                                    const std::string& param02) = 0;
   virtual Json::Value GetSmartContracts(const std::string& param01) = 0;
+  virtual Json::Value GetSmartContractsPage(const std::string& param01,
+                                            unsigned int param02,
+                                            bool param03) = 0;
   virtual std::string GetBlockTransactionCount(const std::string& param01) = 0;
   virtual std::string GetContractAddressFromTransactionID(
       const std::string& param01) = 0;
   virtual std::string CreateMessage(const Json::Value& param01) = 0;
   virtual std::string GetGasEstimate(const Json::Value& param01) = 0;
   virtual Json::Value GetTransactionReceipt(const std::string& param01) = 0;
+  virtual Json::Value GetTransactionProof(const std::string& param01,
+                                          const std::string& param02) = 0;
   virtual bool isNodeSyncing() = 0;
   virtual bool isNodeMining() = 0;
   virtual std::string GetHashrate() = 0;
@@ -471,12 +499,17 @@ class Server : public AbstractZServer {
   virtual std::string GetStorageAt(const std::string& address,
                                    const std::string& position);
   virtual Json::Value GetSmartContracts(const std::string& address);
+  virtual Json::Value GetSmartContractsPage(const std::string& address,
+                                            unsigned int page,
+                                            bool includeState);
   virtual std::string GetBlockTransactionCount(const std::string& blockHash);
   virtual std::string GetContractAddressFromTransactionID(
       const std::string& tranID);
   virtual std::string CreateMessage(const Json::Value& _json);
   virtual std::string GetGasEstimate(const Json::Value& _json);
   virtual Json::Value GetTransactionReceipt(const std::string& transactionHash);
+  virtual Json::Value GetTransactionProof(const std::string& transactionHash,
+                                          const std::string& txBlockNum);
   virtual bool isNodeSyncing();
   virtual bool isNodeMining();
   virtual std::string GetHashrate();
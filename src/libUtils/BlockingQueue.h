@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2018 Zilliqa
+ * This source code is being disclosed to you solely for the purpose of your
+ * participation in testing Zilliqa. You may view, compile and run the code for
+ * that purpose and pursuant to the protocols and algorithms that are programmed
+ * into, and intended by, the code. You may not do anything else with the code
+ * without express permission from Zilliqa Research Pte. Ltd., including
+ * modifying or publishing the code (or any part of it), and developing or
+ * forming another public or private blockchain network. This source code is
+ * provided 'as is' and no warranties are given as to title or non-infringement,
+ * merchantability or fitness for purpose and, to the extent permitted by law,
+ * all liability for your use of the code is disclaimed. Some programs in this
+ * code are governed by the GNU General Public License v3.0 (available at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html) ('GPLv3'). The programs that
+ * are governed by GPLv3.0 are those programs that are located in the folders
+ * src/depends and tests/depends and which include a reference to GPLv3 in their
+ * program files.
+ */
+
+#ifndef __BLOCKINGQUEUE_H__
+#define __BLOCKINGQUEUE_H__
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <boost/lockfree/queue.hpp>
+
+/// Multi-producer multi-consumer queue whose consumers spin briefly and then
+/// sleep until an element is pushed, instead of polling forever. Producers
+/// stay lock-free unless a consumer is asleep.
+template <class T>
+class BlockingQueue {
+  boost::lockfree::queue<T> m_queue;
+  const unsigned int m_spinCount;
+
+  std::mutex m_mutexSleep;
+  std::condition_variable m_cvSleep;
+  std::atomic<unsigned int> m_sleepers{0};
+
+  std::atomic<int64_t> m_depth{0};
+  std::atomic<uint64_t> m_sleepCount{0};
+  std::atomic<uint64_t> m_sleepTimeUs{0};
+
+  bool TryPop(T& item) {
+    if (m_queue.pop(item)) {
+      --m_depth;
+      return true;
+    }
+    return false;
+  }
+
+ public:
+  /// capacity is the initial number of preallocated nodes; spinCount is how
+  /// many empty polls a consumer makes before sleeping.
+  explicit BlockingQueue(size_t capacity, unsigned int spinCount = 1000)
+      : m_queue(capacity), m_spinCount(spinCount) {}
+
+  BlockingQueue(BlockingQueue const&) = delete;
+  void operator=(BlockingQueue const&) = delete;
+
+  void Push(const T& item) {
+    while (!m_queue.push(item)) {
+      std::this_thread::yield();
+    }
+    ++m_depth;
+
+    // Pairs with the fence in Pop, so either the consumer sees this element
+    // or we see the consumer asleep
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_sleepers.load(std::memory_order_relaxed) > 0) {
+      std::lock_guard<std::mutex> g(m_mutexSleep);
+      m_cvSleep.notify_one();
+    }
+  }
+
+  /// Pops one element without waiting.
+  bool TryPopOne(T& item) { return TryPop(item); }
+
+  /// Pops one element, waiting for it if the queue is empty.
+  void Pop(T& item) {
+    for (unsigned int i = 0; i < m_spinCount; i++) {
+      if (TryPop(item)) {
+        return;
+      }
+      std::this_thread::yield();
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutexSleep);
+    ++m_sleepers;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto start = std::chrono::steady_clock::now();
+    while (!TryPop(item)) {
+      m_cvSleep.wait(lock);
+    }
+    --m_sleepers;
+    ++m_sleepCount;
+    m_sleepTimeUs += std::chrono::duration_cast<std::chrono::microseconds>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+  }
+
+  /// Waits for at least one element and then takes up to maxItems that are
+  /// already queued, appending them to items. Returns the number taken.
+  size_t PopBatch(std::vector<T>& items, size_t maxItems) {
+    T item;
+    Pop(item);
+    items.emplace_back(item);
+
+    size_t count = 1;
+    while (count < maxItems && TryPop(item)) {
+      items.emplace_back(item);
+      count++;
+    }
+    return count;
+  }
+
+  /// Number of elements queued.
+  int64_t GetDepth() const { return m_depth.load(); }
+
+  /// Number of times a consumer had to sleep, and the total time spent
+  /// asleep.
+  uint64_t GetSleepCount() const { return m_sleepCount.load(); }
+  uint64_t GetSleepTimeUs() const { return m_sleepTimeUs.load(); }
+};
+
+#endif  // __BLOCKINGQUEUE_H__
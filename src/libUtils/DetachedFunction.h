@@ -21,39 +21,45 @@
 #define __DETACHEDFUNCTION_H__
 
 #include <functional>
-#include <thread>
-#include "libUtils/Logger.h"
+#include "libUtils/Executor.h"
 
 /// Utility class for executing a function in one or more separate detached
-/// threads.
+/// jobs on the shared Executor.
 class DetachedFunction {
  public:
-  /// Retry limit for launching the detached threads.
-  const static int MaxAttempt = 3;
+  /// Tag for functions that loop for the life of the process.
+  struct LongRunning {};
 
-  /// Template constructor.
+  /// Template constructor. Runs num_threads copies of f on the block
+  /// processing lane.
   template <class callable, class... arguments>
-  DetachedFunction(int num_threads, callable&& f, arguments&&... args) {
-    std::function<typename std::result_of<callable(arguments...)>::type()> task(
-        std::bind(std::forward<callable>(f), std::forward<arguments>(args)...));
+  DetachedFunction(int num_threads, callable&& f, arguments&&... args)
+      : DetachedFunction(Executor::BLOCK_PROCESSING, num_threads,
+                         std::forward<callable>(f),
+                         std::forward<arguments>(args)...) {}
 
-    bool attemp_flag = false;
+  /// Template constructor. Runs num_threads copies of f on the given lane.
+  template <class callable, class... arguments>
+  DetachedFunction(Executor::Lane lane, int num_threads, callable&& f,
+                   arguments&&... args) {
+    auto task =
+        std::bind(std::forward<callable>(f), std::forward<arguments>(args)...);
+
+    for (int i = 0; i < num_threads; i++) {
+      Executor::GetInstance().Submit(lane, [task]() mutable { task(); });
+    }
+  }
+
+  /// Template constructor. Runs num_threads copies of f on dedicated threads,
+  /// so that loops which never return do not hold Executor workers.
+  template <class callable, class... arguments>
+  DetachedFunction(LongRunning, int num_threads, callable&& f,
+                   arguments&&... args) {
+    auto task =
+        std::bind(std::forward<callable>(f), std::forward<arguments>(args)...);
 
     for (int i = 0; i < num_threads; i++) {
-      for (int j = 0; j < MaxAttempt; j++) {
-        try {
-          if (!attemp_flag) {
-            std::thread(task).detach();  // attempt to detach a non-thread
-            attemp_flag = true;
-          }
-        } catch (const std::system_error& e) {
-          LOG_GENERAL(WARNING,
-                      j << " times tried. Caught system_error with code "
-                        << e.code() << " meaning " << e.what() << '\n');
-          std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        }
-      }
-      attemp_flag = false;
+      Executor::StartLongRunning([task]() mutable { task(); });
     }
   }
 };
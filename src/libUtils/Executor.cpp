@@ -0,0 +1,362 @@
+/*
+ * Copyright (c) 2018 Zilliqa
+ * This source code is being disclosed to you solely for the purpose of your
+ * participation in testing Zilliqa. You may view, compile and run the code for
+ * that purpose and pursuant to the protocols and algorithms that are programmed
+ * into, and intended by, the code. You may not do anything else with the code
+ * without express permission from Zilliqa Research Pte. Ltd., including
+ * modifying or publishing the code (or any part of it), and developing or
+ * forming another public or private blockchain network. This source code is
+ * provided 'as is' and no warranties are given as to title or non-infringement,
+ * merchantability or fitness for purpose and, to the extent permitted by law,
+ * all liability for your use of the code is disclaimed. Some programs in this
+ * code are governed by the GNU General Public License v3.0 (available at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html) ('GPLv3'). The programs that
+ * are governed by GPLv3.0 are those programs that are located in the folders
+ * src/depends and tests/depends and which include a reference to GPLv3 in their
+ * program files.
+ */
+
+#include "Executor.h"
+
+#include <algorithm>
+
+#include "common/Constants.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+namespace {
+/// How often the monitor looks for stalled workers.
+const chrono::milliseconds STALL_CHECK_INTERVAL{50};
+
+/// How long an extra worker stays idle before it exits.
+const chrono::seconds EXTRA_WORKER_IDLE_TIMEOUT{10};
+
+/// How often the monitor logs the lane counters.
+const chrono::seconds STATS_LOG_INTERVAL{60};
+
+const char* LANE_NAMES[Executor::NUM_LANES] = {"CONSENSUS", "BLOCK",
+                                               "TXN_INTAKE", "BACKGROUND"};
+
+/// Executor and queue index of the worker running on this thread, if any.
+thread_local const Executor* t_executor = nullptr;
+thread_local int t_queueIndex = -1;
+
+uint64_t MicrosecondsBetween(chrono::steady_clock::time_point from,
+                             chrono::steady_clock::time_point to) {
+  return chrono::duration_cast<chrono::microseconds>(to - from).count();
+}
+}  // namespace
+
+Executor::Executor(unsigned int numWorkers)
+    : m_nextQueue(0),
+      m_numQueued(0),
+      m_numStarted(0),
+      m_numSleepers(0),
+      m_numExtraWorkers(0),
+      m_stop(false) {
+  if (numWorkers == 0) {
+    numWorkers = max(thread::hardware_concurrency(), 2u);
+  }
+
+  for (auto& queued : m_queuedPerLane) {
+    queued = 0;
+  }
+
+  m_queues.reserve(numWorkers);
+  for (unsigned int i = 0; i < numWorkers; i++) {
+    m_queues.emplace_back(make_unique<WorkerQueue>());
+  }
+
+  m_workers.reserve(numWorkers);
+  for (unsigned int i = 0; i < numWorkers; i++) {
+    m_workers.emplace_back([this, i]() { WorkerLoop(i); });
+  }
+
+  m_monitor = thread([this]() { MonitorLoop(); });
+}
+
+Executor::~Executor() {
+  {
+    lock_guard<mutex> g(m_mutexIdle);
+    m_stop = true;
+  }
+  m_cvIdle.notify_all();
+
+  {
+    lock_guard<mutex> g(m_mutexDelayed);
+    m_delayed.clear();
+  }
+  m_cvDelayed.notify_all();
+
+  m_monitor.join();
+  for (auto& worker : m_workers) {
+    worker.join();
+  }
+
+  unique_lock<mutex> lock(m_mutexIdle);
+  m_cvIdle.wait(lock, [this] { return m_numExtraWorkers == 0; });
+}
+
+Executor& Executor::GetInstance() {
+  static Executor* executor = new Executor(EXECUTOR_NUM_THREADS);
+  return *executor;
+}
+
+void Executor::Submit(Lane lane, Job job) {
+  Enqueue(lane, Task{move(job), Clock::now()});
+}
+
+void Executor::SubmitAfter(Lane lane, chrono::milliseconds delay, Job job) {
+  if (delay.count() <= 0) {
+    Submit(lane, move(job));
+    return;
+  }
+
+  const auto when = Clock::now() + delay;
+  bool earliest = false;
+  {
+    lock_guard<mutex> g(m_mutexDelayed);
+    auto it = m_delayed.emplace(when, make_pair(lane, move(job)));
+    earliest = (it == m_delayed.begin());
+  }
+
+  if (earliest) {
+    m_cvDelayed.notify_one();
+  }
+}
+
+void Executor::StartLongRunning(Job job) {
+  const int MAX_ATTEMPT = 3;
+
+  for (int i = 0; i < MAX_ATTEMPT; i++) {
+    try {
+      thread(job).detach();
+      return;
+    } catch (const system_error& e) {
+      LOG_GENERAL(WARNING, i << " times tried. Caught system_error with code "
+                             << e.code() << " meaning " << e.what());
+      this_thread::sleep_for(chrono::milliseconds(100));
+    }
+  }
+}
+
+unsigned int Executor::GetNumWorkers() const { return m_workers.size(); }
+
+unsigned int Executor::GetNumExtraWorkers() const { return m_numExtraWorkers; }
+
+unsigned int Executor::GetNumQueued() const { return m_numQueued; }
+
+Executor::LaneStats Executor::GetLaneStats(Lane lane) const {
+  const LaneCounters& counters = m_stats[lane];
+  return {counters.m_submitted, counters.m_completed, counters.m_queuedUs,
+          counters.m_runUs};
+}
+
+void Executor::LogStats() const {
+  for (unsigned int i = 0; i < NUM_LANES; i++) {
+    const LaneStats stats = GetLaneStats(static_cast<Lane>(i));
+    const uint64_t completed = max<uint64_t>(stats.m_completed, 1);
+    LOG_GENERAL(INFO, "Lane " << LANE_NAMES[i]
+                              << " submitted=" << stats.m_submitted
+                              << " completed=" << stats.m_completed
+                              << " queued=" << m_queuedPerLane[i]
+                              << " avgWaitUs=" << stats.m_queuedUs / completed
+                              << " avgRunUs=" << stats.m_runUs / completed);
+  }
+}
+
+void Executor::Enqueue(Lane lane, Task&& task) {
+  const unsigned int queueIndex =
+      ((t_executor == this) && (t_queueIndex >= 0))
+          ? t_queueIndex
+          : m_nextQueue++ % m_queues.size();
+
+  {
+    WorkerQueue& queue = *m_queues[queueIndex];
+    lock_guard<mutex> g(queue.m_mutex);
+    queue.m_tasks[lane].emplace_back(move(task));
+    // Counted under the queue lock so a taker never sees them go negative
+    m_queuedPerLane[lane]++;
+    m_numQueued++;
+  }
+  m_stats[lane].m_submitted++;
+
+  // Pairs with the sleeper count being raised before the queue is checked
+  if (m_numSleepers > 0) {
+    lock_guard<mutex> g(m_mutexIdle);
+    m_cvIdle.notify_one();
+  }
+}
+
+bool Executor::TakeTask(int queueIndex, Lane& lane, Task& task) {
+  const unsigned int numQueues = m_queues.size();
+
+  for (unsigned int l = 0; l < NUM_LANES; l++) {
+    if (m_queuedPerLane[l] == 0) {
+      continue;
+    }
+
+    // Own queue first, oldest job first
+    if (queueIndex >= 0) {
+      WorkerQueue& own = *m_queues[queueIndex];
+      lock_guard<mutex> g(own.m_mutex);
+      auto& tasks = own.m_tasks[l];
+      if (!tasks.empty()) {
+        task = move(tasks.front());
+        tasks.pop_front();
+        m_queuedPerLane[l]--;
+        m_numQueued--;
+        lane = static_cast<Lane>(l);
+        return true;
+      }
+    }
+
+    // Then steal from the other end of everyone else's
+    const unsigned int start = (queueIndex >= 0) ? queueIndex + 1 : 0;
+    for (unsigned int i = 0; i < numQueues; i++) {
+      const unsigned int victim = (start + i) % numQueues;
+      if (static_cast<int>(victim) == queueIndex) {
+        continue;
+      }
+
+      WorkerQueue& other = *m_queues[victim];
+      lock_guard<mutex> g(other.m_mutex);
+      auto& tasks = other.m_tasks[l];
+      if (!tasks.empty()) {
+        task = move(tasks.back());
+        tasks.pop_back();
+        m_queuedPerLane[l]--;
+        m_numQueued--;
+        lane = static_cast<Lane>(l);
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+void Executor::RunTask(Lane lane, Task& task) {
+  LaneCounters& counters = m_stats[lane];
+  const auto start = Clock::now();
+  counters.m_queuedUs += MicrosecondsBetween(task.m_queuedAt, start);
+  m_numStarted++;
+
+  try {
+    task.m_job();
+  } catch (const exception& e) {
+    LOG_GENERAL(WARNING, "Job on lane " << LANE_NAMES[lane]
+                                        << " threw: " << e.what());
+  } catch (...) {
+    LOG_GENERAL(WARNING, "Job on lane " << LANE_NAMES[lane]
+                                        << " threw an unknown exception");
+  }
+
+  counters.m_runUs += MicrosecondsBetween(start, Clock::now());
+  counters.m_completed++;
+
+  // Release whatever the job captured before going idle
+  task.m_job = nullptr;
+}
+
+void Executor::WorkerLoop(int queueIndex) {
+  t_executor = this;
+  t_queueIndex = queueIndex;
+  const bool extra = (queueIndex < 0);
+
+  while (true) {
+    Lane lane;
+    Task task;
+    if (TakeTask(queueIndex, lane, task)) {
+      RunTask(lane, task);
+      continue;
+    }
+
+    unique_lock<mutex> lock(m_mutexIdle);
+    m_numSleepers++;
+    auto ready = [this] { return (m_numQueued > 0) || m_stop; };
+    bool woken = true;
+    if (extra) {
+      woken = m_cvIdle.wait_for(lock, EXTRA_WORKER_IDLE_TIMEOUT, ready);
+    } else {
+      m_cvIdle.wait(lock, ready);
+    }
+    m_numSleepers--;
+
+    if ((!woken || m_stop) && (m_numQueued == 0)) {
+      break;
+    }
+  }
+
+  if (extra) {
+    lock_guard<mutex> g(m_mutexIdle);
+    m_numExtraWorkers--;
+    m_cvIdle.notify_all();
+  }
+}
+
+void Executor::MonitorLoop() {
+  uint64_t lastStarted = m_numStarted;
+  auto nextStallCheck = Clock::now() + STALL_CHECK_INTERVAL;
+  auto nextStatsLog = Clock::now() + STATS_LOG_INTERVAL;
+
+  unique_lock<mutex> lock(m_mutexDelayed);
+  while (!m_stop) {
+    auto now = Clock::now();
+
+    while (!m_delayed.empty() && (m_delayed.begin()->first <= now)) {
+      auto due = move(m_delayed.begin()->second);
+      m_delayed.erase(m_delayed.begin());
+      lock.unlock();
+      Submit(due.first, move(due.second));
+      lock.lock();
+    }
+
+    if (now >= nextStallCheck) {
+      const uint64_t started = m_numStarted;
+      if ((m_numQueued > 0) && (m_numSleepers == 0) &&
+          (started == lastStarted)) {
+        SpawnExtraWorker();
+      }
+      lastStarted = started;
+      nextStallCheck = now + STALL_CHECK_INTERVAL;
+    }
+
+    if (now >= nextStatsLog) {
+      LogStats();
+      nextStatsLog = now + STATS_LOG_INTERVAL;
+    }
+
+    auto wakeAt = nextStallCheck;
+    if (!m_delayed.empty()) {
+      wakeAt = min(wakeAt, m_delayed.begin()->first);
+    }
+    m_cvDelayed.wait_until(lock, wakeAt);
+  }
+}
+
+void Executor::SpawnExtraWorker() {
+  {
+    lock_guard<mutex> g(m_mutexIdle);
+    if (m_stop) {
+      return;
+    }
+    m_numExtraWorkers++;
+  }
+
+  try {
+    thread([this]() { WorkerLoop(-1); }).detach();
+  } catch (const system_error& e) {
+    LOG_GENERAL(WARNING, "Failed to start extra worker: " << e.what());
+    lock_guard<mutex> g(m_mutexIdle);
+    m_numExtraWorkers--;
+    m_cvIdle.notify_all();
+    return;
+  }
+
+  LOG_GENERAL(INFO, "Workers stalled with " << m_numQueued
+                                            << " jobs queued, extra workers: "
+                                            << m_numExtraWorkers);
+}
@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2018 Zilliqa
+ * This source code is being disclosed to you solely for the purpose of your
+ * participation in testing Zilliqa. You may view, compile and run the code for
+ * that purpose and pursuant to the protocols and algorithms that are programmed
+ * into, and intended by, the code. You may not do anything else with the code
+ * without express permission from Zilliqa Research Pte. Ltd., including
+ * modifying or publishing the code (or any part of it), and developing or
+ * forming another public or private blockchain network. This source code is
+ * provided 'as is' and no warranties are given as to title or non-infringement,
+ * merchantability or fitness for purpose and, to the extent permitted by law,
+ * all liability for your use of the code is disclaimed. Some programs in this
+ * code are governed by the GNU General Public License v3.0 (available at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html) ('GPLv3'). The programs that
+ * are governed by GPLv3.0 are those programs that are located in the folders
+ * src/depends and tests/depends and which include a reference to GPLv3 in their
+ * program files.
+ */
+
+#ifndef __EXECUTOR_H__
+#define __EXECUTOR_H__
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/// Shared work-stealing executor behind DetachedFunction, TimeLockedFunction
+/// and Scheduler.
+///
+/// Each worker owns one deque per priority lane. Jobs submitted from a worker
+/// go to its own deques and jobs submitted from other threads are spread
+/// round-robin. A worker runs the oldest job of the highest non-empty lane,
+/// taking it from its own deques first and otherwise stealing from the back
+/// of another worker's. Idle workers park until a job arrives.
+///
+/// Loops that run for the life of the process (message pumps, heartbeats)
+/// must go through StartLongRunning instead, which gives each its own
+/// thread. Jobs may still block for a while (consensus rounds), so a monitor
+/// thread starts an extra worker whenever jobs are queued while every worker
+/// is busy and none has started a job since the last check. Extra workers
+/// exit once idle for a while.
+class Executor {
+ public:
+  /// Priority lanes, highest first.
+  enum Lane : unsigned char {
+    CONSENSUS = 0x00,
+    BLOCK_PROCESSING,
+    TXN_INTAKE,
+    BACKGROUND,
+    NUM_LANES
+  };
+
+  using Job = std::function<void()>;
+
+  /// Per-lane counters. Times are totals in microseconds.
+  struct LaneStats {
+    uint64_t m_submitted;
+    uint64_t m_completed;
+    uint64_t m_queuedUs;
+    uint64_t m_runUs;
+  };
+
+  /// Starts numWorkers workers (one per hardware thread if 0).
+  explicit Executor(unsigned int numWorkers);
+
+  /// Runs the jobs already queued, drops pending delayed jobs and joins all
+  /// workers.
+  ~Executor();
+
+  /// Returns the process-wide executor with EXECUTOR_NUM_THREADS workers. It
+  /// is never destroyed, so jobs that never return do not block exit.
+  static Executor& GetInstance();
+
+  /// Queues job on lane.
+  void Submit(Lane lane, Job job);
+
+  /// Queues job on lane once delay has passed.
+  void SubmitAfter(Lane lane, std::chrono::milliseconds delay, Job job);
+
+  /// Runs job on a detached thread of its own, outside the workers.
+  static void StartLongRunning(Job job);
+
+  /// Returns the number of regular workers.
+  unsigned int GetNumWorkers() const;
+
+  /// Returns the number of extra workers currently running.
+  unsigned int GetNumExtraWorkers() const;
+
+  /// Returns the number of jobs queued and not yet started.
+  unsigned int GetNumQueued() const;
+
+  LaneStats GetLaneStats(Lane lane) const;
+
+  /// Logs one line of counters per lane.
+  void LogStats() const;
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Task {
+    Job m_job;
+    Clock::time_point m_queuedAt;
+  };
+
+  struct WorkerQueue {
+    std::mutex m_mutex;
+    std::deque<Task> m_tasks[NUM_LANES];
+  };
+
+  struct LaneCounters {
+    std::atomic<uint64_t> m_submitted{0};
+    std::atomic<uint64_t> m_completed{0};
+    std::atomic<uint64_t> m_queuedUs{0};
+    std::atomic<uint64_t> m_runUs{0};
+  };
+
+  std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+  std::vector<std::thread> m_workers;
+  std::atomic<unsigned int> m_nextQueue;
+
+  std::atomic<unsigned int> m_queuedPerLane[NUM_LANES];
+  std::atomic<unsigned int> m_numQueued;
+  std::atomic<uint64_t> m_numStarted;
+  std::atomic<unsigned int> m_numSleepers;
+  std::atomic<unsigned int> m_numExtraWorkers;
+  std::atomic<bool> m_stop;
+  std::mutex m_mutexIdle;
+  std::condition_variable m_cvIdle;
+
+  std::multimap<Clock::time_point, std::pair<Lane, Job>> m_delayed;
+  std::mutex m_mutexDelayed;
+  std::condition_variable m_cvDelayed;
+  std::thread m_monitor;
+
+  LaneCounters m_stats[NUM_LANES];
+
+  Executor(Executor const&) = delete;
+  void operator=(Executor const&) = delete;
+
+  void Enqueue(Lane lane, Task&& task);
+  bool TakeTask(int queueIndex, Lane& lane, Task& task);
+  void RunTask(Lane lane, Task& task);
+  void WorkerLoop(int queueIndex);
+  void MonitorLoop();
+  void SpawnExtraWorker();
+};
+
+#endif  // __EXECUTOR_H__
@@ -17,108 +17,103 @@
  * program files.
  */
 
-#include <limits.h>
-#include <stdio.h>
-#include <unistd.h>
-#include <fstream>
-#include <string>
-#include <vector>
-
 #ifndef __GetTxnFromFile_H__
 #define __GetTxnFromFile_H__
 
+#include <algorithm>
+#include <string>
+#include <vector>
+
 #include "Logger.h"
+#include "TxnFileStore.h"
 #include "libData/AccountData/Transaction.h"
 
-unsigned int TXN_SIZE = Transaction::GetMinSerializedSize();
+class GetTxnFromFile {
+ public:
+  /// Returns the size of one serialized transaction in the txn files.
+  static unsigned int GetTxnSize() {
+    static const unsigned int txnSize = Transaction::GetMinSerializedSize();
+    return txnSize;
+  }
 
-bool getTransactionsFromFile(std::fstream& f, unsigned int startNum,
-                             unsigned int totalNum,
-                             std::vector<unsigned char>& vec) {
-  f.seekg(startNum * TXN_SIZE, std::ios::beg);
-  // vec.resize(TXN_SIZE * totalNum);
-  for (unsigned int i = 0; i < TXN_SIZE * totalNum; i++) {
-    if (!f.good()) {
-      LOG_GENERAL(WARNING, "Bad byte accessed");
-      return false;
-    }
-    vec.emplace_back(f.get());
+  /// Returns the name of the txn file holding batch fileNum of addr.
+  static std::string GetFileName(const Address& addr, unsigned int fileNum) {
+    return TXN_PATH + "/" + addr.hex() + "_" +
+           std::to_string(fileNum * NUM_TXN_TO_SEND_PER_ACCOUNT) + ".zil";
   }
-  return true;
-}
 
-class GetTxnFromFile {
- public:
-  // clears vec
-  static bool GetFromFile(Address addr, unsigned int startNum,
-                          unsigned int totalNum,
-                          std::vector<unsigned char>& vec) {
-    if (NUM_TXN_TO_SEND_PER_ACCOUNT == 0) {
+  /// Appends to slices the mapped bytes of the totalNum txns of addr starting
+  /// at nonce startNum, one slice per txn file spanned by the range.
+  /// The slices stay valid as long as the TxnFileStore keeps the files mapped.
+  static bool GetSlices(const Address& addr, unsigned int startNum,
+                        unsigned int totalNum,
+                        std::vector<dev::bytesConstRef>& slices) {
+    if ((NUM_TXN_TO_SEND_PER_ACCOUNT == 0) || (totalNum == 0)) {
       return true;
     }
 
-    const auto num_txn = NUM_TXN_TO_SEND_PER_ACCOUNT;
-    std::fstream file;
-    vec.clear();
-
-    if (totalNum > num_txn) {
-      LOG_GENERAL(WARNING, "A single file is holding too many txns ("
-                               << totalNum << " > " << num_txn);
+    if (startNum == 0) {
+      LOG_GENERAL(WARNING, "Txn nonces in files start from 1");
       return false;
     }
 
-    auto getFile = [&addr](const unsigned int& num, std::fstream& file,
-                           const auto num_txn) {
-      std::string fileString = TXN_PATH + "/" + addr.hex() + "_" +
-                               std::to_string(num * num_txn) + ".zil";
-
-      file.open(fileString, std::ios::binary | std::ios::in);
-
-      if (!file.is_open()) {
-        LOG_GENERAL(WARNING, "File failed to open " << fileString);
-        return false;
-      }
-
-      return true;
-    };
+    const unsigned int num_txn = NUM_TXN_TO_SEND_PER_ACCOUNT;
+    const size_t txnSize = GetTxnSize();
+    const size_t origSize = slices.size();
 
     unsigned int fileNum = (startNum - 1) / num_txn;
-    bool breakCall = false;
-    bool b = false;
-    std::vector<unsigned char> remainTxn;
     unsigned int startNumInFile = (startNum - 1) % num_txn;
-    if (startNumInFile + totalNum > num_txn) {
-      breakCall = true;
-      unsigned int remainNum = totalNum + startNumInFile - num_txn;
-      if (!getFile(fileNum + 1, file, num_txn)) {
-        return false;
-      }
 
-      b = getTransactionsFromFile(file, 0, remainNum, remainTxn);
+    while (totalNum > 0) {
+      unsigned int numInFile = std::min(totalNum, num_txn - startNumInFile);
 
-      file.close();
+      dev::bytesConstRef slice = TxnFileStore::GetInstance().GetSlice(
+          GetFileName(addr, fileNum), startNumInFile * txnSize,
+          numInFile * txnSize);
 
-      if (!b) {
+      if (slice.empty()) {
+        slices.resize(origSize);
         return false;
       }
 
-      totalNum -= remainNum;
+      slices.emplace_back(slice);
+      totalNum -= numInFile;
+      startNumInFile = 0;
+      fileNum++;
     }
 
-    if (!getFile(fileNum, file, num_txn)) {
-      return false;
+    return true;
+  }
+
+  /// Unmaps the txn files of addr that only hold nonces below nextNonce,
+  /// i.e. the ones whose txns have all been sent.
+  static void ReleaseSentFiles(const Address& addr, unsigned int nextNonce) {
+    if ((NUM_TXN_TO_SEND_PER_ACCOUNT == 0) || (nextNonce == 0)) {
+      return;
     }
 
-    b = getTransactionsFromFile(file, startNumInFile, totalNum, vec);
+    unsigned int fileNum = (nextNonce - 1) / NUM_TXN_TO_SEND_PER_ACCOUNT;
+
+    // Older files were released as the nonce moved past them
+    while ((fileNum > 0) &&
+           TxnFileStore::GetInstance().Release(GetFileName(addr, --fileNum))) {
+    }
+  }
 
-    file.close();
+  // clears vec
+  static bool GetFromFile(const Address& addr, unsigned int startNum,
+                          unsigned int totalNum,
+                          std::vector<unsigned char>& vec) {
+    std::vector<dev::bytesConstRef> slices;
+    vec.clear();
 
-    if (!b) {
+    if (!GetSlices(addr, startNum, totalNum, slices)) {
       return false;
     }
 
-    if (breakCall) {
-      copy(remainTxn.begin(), remainTxn.end(), back_inserter(vec));
+    vec.reserve(totalNum * GetTxnSize());
+    for (const auto& slice : slices) {
+      vec.insert(vec.end(), slice.begin(), slice.end());
     }
 
     return true;
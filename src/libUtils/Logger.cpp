@@ -22,8 +22,12 @@
 #include <pthread.h>
 #include <sys/syscall.h>
 #include <unistd.h>
+#include <algorithm>
+#include <condition_variable>
 #include <cstring>
 #include <iostream>
+#include <memory>
+#include <thread>
 using namespace std;
 using namespace g3;
 
@@ -52,14 +56,245 @@ inline pid_t getCurrentPid() {
   return 0;
 #endif
 }
+
+unsigned int LevelIndex(const LEVELS& level) {
+  if (level.value >= FATAL.value) {
+    return LOG_LEVEL_FATAL;
+  } else if (level.value >= WARNING.value) {
+    return LOG_LEVEL_WARNING;
+  } else if (level.value >= INFO.value) {
+    return LOG_LEVEL_INFO;
+  }
+  return LOG_LEVEL_DEBUG;
+}
+
+const LEVELS& LevelFromIndex(unsigned int index) {
+  switch (index) {
+    case LOG_LEVEL_FATAL:
+      return FATAL;
+    case LOG_LEVEL_WARNING:
+      return WARNING;
+    case LOG_LEVEL_INFO:
+      return INFO;
+    default:
+      return DEBUG;
+  }
+}
+
+/// Returns "HH:MM:SS:" for t, reformatting only when the second changes. Only
+/// called from the writer thread.
+const char* FormatSeconds(time_t t) {
+  static time_t cachedTime = -1;
+  static char cachedText[16];
+
+  if (t != cachedTime) {
+    struct tm cur_tm;
+    gmtime_r(&t, &cur_tm);
+    strftime(cachedText, sizeof(cachedText), "%H:%M:%S:", &cur_tm);
+    cachedTime = t;
+  }
+  return cachedText;
+}
+
+/// Records per thread buffered before the logging thread blocks.
+const size_t LOG_RING_SIZE = 4096;
+
+/// How long the writer sleeps when no thread has woken it.
+const chrono::milliseconds LOG_WRITER_IDLE_WAIT{100};
 };  // namespace
 
+/// One log call, captured before any prefix formatting.
+struct LogRecord {
+  enum Kind : unsigned char { GENERAL, EPOCH, PAYLOAD, STATE, EPOCHINFO };
+
+  Logger* m_logger = nullptr;
+  Kind m_kind = GENERAL;
+  unsigned int m_level = LOG_LEVEL_INFO;
+  chrono::system_clock::time_point m_time;
+  pid_t m_tid = 0;
+  const char* m_function = "";
+  string m_epoch;
+  string m_msg;
+  vector<unsigned char> m_payload;
+  size_t m_payloadSize = 0;
+};
+
+/// Background thread that drains the per-thread rings and writes the records
+/// in timestamp order.
+class LogWriter {
+  /// Single-producer single-consumer ring owned by one logging thread.
+  struct Ring {
+    vector<LogRecord> m_slots;
+    atomic<size_t> m_head{0};
+    atomic<size_t> m_tail{0};
+    atomic<bool> m_retired{false};
+    pid_t m_tid;
+
+    Ring() : m_slots(LOG_RING_SIZE), m_tid(getCurrentPid()) {}
+  };
+
+  /// Marks the thread's ring for removal once the thread exits.
+  struct RingHolder {
+    shared_ptr<Ring> m_ring;
+    ~RingHolder() {
+      if (m_ring) {
+        m_ring->m_retired = true;
+      }
+    }
+  };
+
+  mutex m_mutexRings;
+  vector<shared_ptr<Ring>> m_rings;
+
+  mutex m_mutexWake;
+  condition_variable m_cvWake;
+  condition_variable m_cvFlushed;
+  atomic<bool> m_idle;
+  uint64_t m_flushRequested;
+  uint64_t m_flushDone;
+
+  thread m_thread;
+
+  LogWriter() : m_idle(false), m_flushRequested(0), m_flushDone(0) {
+    m_thread = thread([this]() { Run(); });
+    m_thread.detach();
+  }
+
+  Ring& GetRing() {
+    thread_local RingHolder holder;
+    if (!holder.m_ring) {
+      holder.m_ring = make_shared<Ring>();
+      lock_guard<mutex> g(m_mutexRings);
+      m_rings.emplace_back(holder.m_ring);
+    }
+    return *holder.m_ring;
+  }
+
+  void Wake() {
+    lock_guard<mutex> g(m_mutexWake);
+    m_cvWake.notify_one();
+  }
+
+  bool HasPending() {
+    lock_guard<mutex> g(m_mutexRings);
+    for (const auto& ring : m_rings) {
+      if (ring->m_head != ring->m_tail) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void Collect(vector<LogRecord>& batch) {
+    lock_guard<mutex> g(m_mutexRings);
+    for (auto& ring : m_rings) {
+      size_t tail = ring->m_tail.load(memory_order_relaxed);
+      const size_t head = ring->m_head.load(memory_order_acquire);
+      for (; tail != head; tail++) {
+        batch.emplace_back(move(ring->m_slots[tail % LOG_RING_SIZE]));
+      }
+      ring->m_tail.store(tail, memory_order_release);
+    }
+
+    m_rings.erase(remove_if(m_rings.begin(), m_rings.end(),
+                            [](const shared_ptr<Ring>& ring) {
+                              return ring->m_retired &&
+                                     (ring->m_head == ring->m_tail);
+                            }),
+                  m_rings.end());
+  }
+
+  void Run() {
+    vector<LogRecord> batch;
+    vector<Logger*> loggers;
+
+    while (true) {
+      uint64_t flushRequested;
+      {
+        lock_guard<mutex> g(m_mutexWake);
+        flushRequested = m_flushRequested;
+      }
+
+      batch.clear();
+      Collect(batch);
+      stable_sort(batch.begin(), batch.end(),
+                  [](const LogRecord& a, const LogRecord& b) {
+                    return a.m_time < b.m_time;
+                  });
+
+      loggers.clear();
+      for (const auto& record : batch) {
+        record.m_logger->Write(record);
+        if (find(loggers.begin(), loggers.end(), record.m_logger) ==
+            loggers.end()) {
+          loggers.emplace_back(record.m_logger);
+        }
+      }
+      for (auto logger : loggers) {
+        logger->FlushOutput();
+      }
+
+      unique_lock<mutex> lock(m_mutexWake);
+      if (flushRequested > m_flushDone) {
+        m_flushDone = flushRequested;
+        m_cvFlushed.notify_all();
+      }
+
+      if (batch.empty()) {
+        // Pairs with producers publishing a record before reading m_idle
+        m_idle = true;
+        m_cvWake.wait_for(lock, LOG_WRITER_IDLE_WAIT, [this] {
+          return (m_flushRequested > m_flushDone) || HasPending();
+        });
+        m_idle = false;
+      }
+    }
+  }
+
+ public:
+  static LogWriter& GetInstance() {
+    // Never destroyed, so threads can still log during static destruction
+    static LogWriter* writer = new LogWriter();
+    return *writer;
+  }
+
+  void Push(LogRecord&& record) {
+    Ring& ring = GetRing();
+    record.m_tid = ring.m_tid;
+
+    const size_t head = ring.m_head.load(memory_order_relaxed);
+    while (head - ring.m_tail.load(memory_order_acquire) >= LOG_RING_SIZE) {
+      Wake();
+      this_thread::yield();
+    }
+
+    ring.m_slots[head % LOG_RING_SIZE] = move(record);
+    ring.m_head.store(head + 1);
+
+    if (m_idle) {
+      Wake();
+    }
+  }
+
+  void Flush() {
+    unique_lock<mutex> lock(m_mutexWake);
+    const uint64_t request = ++m_flushRequested;
+    m_cvWake.notify_one();
+    m_cvFlushed.wait(lock, [this, request] { return m_flushDone >= request; });
+  }
+};
+
+atomic<unsigned int> Logger::s_levelMask{
+    (1u << LOG_LEVEL_DEBUG) | (1u << LOG_LEVEL_INFO) |
+    (1u << LOG_LEVEL_WARNING) | (1u << LOG_LEVEL_FATAL)};
+
 const streampos Logger::MAX_FILE_SIZE =
     1024 * 1024 * 100;  // 100MB per log file
 
 Logger::Logger(const char* prefix, bool log_to_file, streampos max_file_size) {
   this->m_logToFile = log_to_file;
   this->m_maxFileSize = max_file_size;
+  this->m_bRefactor = false;
 
   if (log_to_file) {
     m_fileNamePrefix = prefix ? prefix : "common";
@@ -68,13 +303,13 @@ Logger::Logger(const char* prefix, bool log_to_file, streampos max_file_size) {
   }
 }
 
-Logger::~Logger() { m_logFile.close(); }
+Logger::~Logger() {
+  Flush();
+  m_logFile.close();
+}
 
 void Logger::checkLog() {
-  std::ifstream in(m_fileName.c_str(),
-                   std::ifstream::ate | std::ifstream::binary);
-
-  if (in.tellg() >= m_maxFileSize) {
+  if (m_logFile.tellp() >= m_maxFileSize) {
     m_logFile.close();
     newLog();
   }
@@ -122,160 +357,159 @@ Logger& Logger::GetEpochInfoLogger(const char* fname_prefix, bool log_to_file,
   return logger;
 }
 
-void Logger::LogState(const char* msg, const char*) {
-  lock_guard<mutex> guard(m);
+void Logger::Enqueue(LogRecord&& record) {
+  const bool fatal = (record.m_level == LOG_LEVEL_FATAL);
+  record.m_logger = this;
+  record.m_time = chrono::system_clock::now();
+  LogWriter::GetInstance().Push(move(record));
 
-  if (m_logToFile) {
-    checkLog();
-    m_logFile << msg << endl << flush;
-  } else {
-    cout << msg << endl << flush;
+  if (fatal) {
+    Flush();
   }
 }
 
-void Logger::LogGeneral(LEVELS level, const char* msg, const char* function) {
-  if (IsG3Log()) {
-    auto cur = chrono::system_clock::now();
-    auto cur_time_t = chrono::system_clock::to_time_t(cur);
-    LOG(level) << "[TID " << PAD(GetPid(), TID_LEN) << "]["
-               << put_time(gmtime(&cur_time_t), "%H:%M:%S:")
-               << PAD(get_ms(cur), 3) << "]["
-               << LIMIT(function, MAX_FUNCNAME_LEN) << "] " << msg;
-    return;
-  }
+void Logger::LogState(string msg, const char* function) {
+  LogRecord record;
+  record.m_kind = LogRecord::STATE;
+  record.m_function = function;
+  record.m_msg = move(msg);
+  Enqueue(move(record));
+}
 
-  lock_guard<mutex> guard(m);
+void Logger::LogGeneral(LEVELS level, string msg, const char* function) {
+  LogRecord record;
+  record.m_kind = LogRecord::GENERAL;
+  record.m_level = LevelIndex(level);
+  record.m_function = function;
+  record.m_msg = move(msg);
+  Enqueue(move(record));
+}
 
-  if (m_logToFile) {
-    checkLog();
-    auto cur = chrono::system_clock::now();
-    auto cur_time_t = chrono::system_clock::to_time_t(cur);
-    m_logFile << "[TID " << PAD(GetPid(), TID_LEN) << "]["
-              << put_time(gmtime(&cur_time_t), "%H:%M:%S:")
-              << PAD(get_ms(cur), 3) << "]["
-              << LIMIT(function, MAX_FUNCNAME_LEN) << "] " << msg << endl
-              << flush;
-  } else {
-    auto cur = chrono::system_clock::now();
-    auto cur_time_t = chrono::system_clock::to_time_t(cur);
-    cout << "[TID " << PAD(GetPid(), TID_LEN) << "]["
-         << put_time(gmtime(&cur_time_t), "%H:%M:%S:") << PAD(get_ms(cur), 3)
-         << "][" << LIMIT(function, MAX_FUNCNAME_LEN) << "] " << msg << endl
-         << flush;
-  }
+void Logger::LogEpoch(LEVELS level, string msg, const char* epoch,
+                      const char* function) {
+  LogRecord record;
+  record.m_kind = LogRecord::EPOCH;
+  record.m_level = LevelIndex(level);
+  record.m_function = function;
+  record.m_epoch = epoch;
+  record.m_msg = move(msg);
+  Enqueue(move(record));
 }
 
-void Logger::LogEpoch([[gnu::unused]] LEVELS level, const char* msg,
-                      const char* epoch, const char* function) {
-  lock_guard<mutex> guard(m);
+void Logger::LogPayload(LEVELS level, string msg,
+                        const std::vector<unsigned char>& payload,
+                        size_t max_bytes_to_display, const char* function) {
+  LogRecord record;
+  record.m_kind = LogRecord::PAYLOAD;
+  record.m_level = LevelIndex(level);
+  record.m_function = function;
+  record.m_msg = move(msg);
+  record.m_payload.assign(
+      payload.begin(),
+      payload.begin() + min(payload.size(), max_bytes_to_display));
+  record.m_payloadSize = payload.size();
+  Enqueue(move(record));
+}
 
-  if (m_logToFile) {
-    checkLog();
-    auto cur = chrono::system_clock::now();
-    auto cur_time_t = chrono::system_clock::to_time_t(cur);
-    m_logFile << "[TID " << PAD(GetPid(), TID_LEN) << "]["
-              << put_time(gmtime(&cur_time_t), "%H:%M:%S:")
-              << PAD(get_ms(cur), 3) << "]["
-              << LIMIT(function, MAX_FUNCNAME_LEN) << "]"
-              << "[Epoch " << epoch << "] " << msg << endl
-              << flush;
+void Logger::LogEpochInfo(string msg, const char* function,
+                          const char* epoch) {
+  LogRecord record;
+  record.m_kind = LogRecord::EPOCHINFO;
+  record.m_function = function;
+  record.m_epoch = epoch;
+  record.m_msg = move(msg);
+  Enqueue(move(record));
+}
+
+void Logger::Flush() { LogWriter::GetInstance().Flush(); }
+
+void Logger::Write(const LogRecord& record) {
+  string line;
+
+  if (record.m_kind == LogRecord::STATE) {
+    line = record.m_msg;
   } else {
-    auto cur = chrono::system_clock::now();
-    auto cur_time_t = chrono::system_clock::to_time_t(cur);
-    cout << "[TID " << PAD(GetPid(), TID_LEN) << "]["
-         << put_time(gmtime(&cur_time_t), "%H:%M:%S:") << PAD(get_ms(cur), 3)
-         << "][" << LIMIT(function, MAX_FUNCNAME_LEN) << "]"
-         << "[Epoch " << epoch << "] " << msg << endl
-         << flush;
+    char prefix[128];
+    snprintf(prefix, sizeof(prefix), "[TID %*d][%s%3ld][%-*.*s]",
+             static_cast<int>(TID_LEN), record.m_tid,
+             FormatSeconds(chrono::system_clock::to_time_t(record.m_time)),
+             get_ms(record.m_time), static_cast<int>(MAX_FUNCNAME_LEN),
+             static_cast<int>(MAX_FUNCNAME_LEN), record.m_function);
+    line.reserve(strlen(prefix) + record.m_msg.size() + 32);
+    line = prefix;
+
+    switch (record.m_kind) {
+      case LogRecord::EPOCH:
+      case LogRecord::EPOCHINFO:
+        line += "[Epoch " + record.m_epoch + "] " + record.m_msg;
+        break;
+      case LogRecord::PAYLOAD: {
+        std::unique_ptr<char[]> payload_string;
+        GetPayloadS(record.m_payload, record.m_payload.size(), payload_string);
+        line += " " + record.m_msg +
+                " (Len=" + to_string(record.m_payloadSize) +
+                "): " + payload_string.get();
+        if (record.m_payloadSize > record.m_payload.size()) {
+          line += "...";
+        }
+        break;
+      }
+      default:
+        line += " " + record.m_msg;
+        break;
+    }
+  }
+
+  if (IsG3Log()) {
+    LOG(LevelFromIndex(record.m_level)) << line;
+    return;
   }
-}
 
-void Logger::LogPayload([[gnu::unused]] LEVELS level, const char* msg,
-                        const std::vector<unsigned char>& payload,
-                        size_t max_bytes_to_display, const char* function) {
-  std::unique_ptr<char[]> payload_string;
-  GetPayloadS(payload, max_bytes_to_display, payload_string);
   lock_guard<mutex> guard(m);
 
   if (m_logToFile) {
     checkLog();
-    auto cur = chrono::system_clock::now();
-    auto cur_time_t = chrono::system_clock::to_time_t(cur);
-
-    if (payload.size() > max_bytes_to_display) {
-      m_logFile << "[TID " << PAD(GetPid(), TID_LEN) << "]["
-                << put_time(gmtime(&cur_time_t), "%H:%M:%S:")
-                << PAD(get_ms(cur), 3) << "]["
-                << LIMIT(function, MAX_FUNCNAME_LEN) << "] " << msg
-                << " (Len=" << payload.size() << "): " << payload_string.get()
-                << "..." << endl
-                << flush;
-    } else {
-      m_logFile << "[TID " << PAD(GetPid(), TID_LEN) << "]["
-                << put_time(gmtime(&cur_time_t), "%H:%M:%S:")
-                << PAD(get_ms(cur), 3) << "]["
-                << LIMIT(function, MAX_FUNCNAME_LEN) << "] " << msg
-                << " (Len=" << payload.size() << "): " << payload_string.get()
-                << endl
-                << flush;
-    }
+    m_logFile << line << '\n';
   } else {
-    auto cur = chrono::system_clock::now();
-    auto cur_time_t = chrono::system_clock::to_time_t(cur);
-
-    if (payload.size() > max_bytes_to_display) {
-      cout << "[TID " << PAD(GetPid(), TID_LEN) << "]["
-           << put_time(gmtime(&cur_time_t), "%H:%M:%S:") << PAD(get_ms(cur), 3)
-           << "][" << LIMIT(function, MAX_FUNCNAME_LEN) << "] " << msg
-           << " (Len=" << payload.size() << "): " << payload_string.get()
-           << "..." << endl
-           << flush;
-    } else {
-      cout << "[TID " << PAD(GetPid(), TID_LEN) << "]["
-           << put_time(gmtime(&cur_time_t), "%H:%M:%S:") << PAD(get_ms(cur), 3)
-           << "][" << LIMIT(function, MAX_FUNCNAME_LEN) << "] " << msg
-           << " (Len=" << payload.size() << "): " << payload_string.get()
-           << endl
-           << flush;
-    }
+    cout << line << '\n';
   }
 }
 
-void Logger::LogEpochInfo(const char* msg, const char* function,
-                          const char* epoch) {
-  pid_t tid = getCurrentPid();
+void Logger::FlushOutput() {
+  if (IsG3Log()) {
+    return;
+  }
+
   lock_guard<mutex> guard(m);
 
   if (m_logToFile) {
-    checkLog();
-    auto cur = chrono::system_clock::now();
-    auto cur_time_t = chrono::system_clock::to_time_t(cur);
-    m_logFile << "[TID " << PAD(tid, TID_LEN) << "]["
-              << put_time(gmtime(&cur_time_t), "%H:%M:%S:")
-              << PAD(get_ms(cur), 3) << "]["
-              << LIMIT(function, MAX_FUNCNAME_LEN) << "]"
-              << "[Epoch " << epoch << "] " << msg << endl
-              << flush;
+    m_logFile.flush();
   } else {
-    auto cur = chrono::system_clock::now();
-    auto cur_time_t = chrono::system_clock::to_time_t(cur);
-    cout << "[TID " << PAD(tid, TID_LEN) << "]["
-         << put_time(gmtime(&cur_time_t), "%H:%M:%S:") << PAD(get_ms(cur), 3)
-         << "][" << LIMIT(function, MAX_FUNCNAME_LEN) << "]"
-         << "[Epoch " << epoch << "] " << msg << endl
-         << flush;
+    cout.flush();
   }
 }
 
 void Logger::DisplayLevelAbove(LEVELS level) {
   if (level != INFO && level != WARNING && level != FATAL) return;
 
+  unsigned int mask = 0;
+  for (unsigned int i = LevelIndex(level); i <= LOG_LEVEL_FATAL; i++) {
+    mask |= (1u << i);
+  }
+  s_levelMask = mask;
+
   g3::log_levels::setHighest(level);
 }
 
-void Logger::EnableLevel(LEVELS level) { g3::log_levels::enable(level); }
+void Logger::EnableLevel(LEVELS level) {
+  s_levelMask |= (1u << LevelIndex(level));
+  g3::log_levels::enable(level);
+}
 
-void Logger::DisableLevel(LEVELS level) { g3::log_levels::disable(level); }
+void Logger::DisableLevel(LEVELS level) {
+  s_levelMask &= ~(1u << LevelIndex(level));
+  g3::log_levels::disable(level);
+}
 
 pid_t Logger::GetPid() { return getCurrentPid(); }
 
@@ -303,12 +537,15 @@ void Logger::GetPayloadS(const std::vector<unsigned char>& payload,
   res.get()[payload_string_len - 1] = '\0';
 }
 
-ScopeMarker::ScopeMarker(const char* function) : m_function(function) {
-  Logger& logger = Logger::GetLogger(NULL, true);
-  logger.LogGeneral(INFO, "BEGIN", this->m_function.c_str());
+ScopeMarker::ScopeMarker(const char* function)
+    : m_function(function), m_enabled(LOG_ENABLED(INFO)) {
+  if (m_enabled) {
+    Logger::GetLogger(NULL, true).LogGeneral(INFO, "BEGIN", m_function);
+  }
 }
 
 ScopeMarker::~ScopeMarker() {
-  Logger& logger = Logger::GetLogger(NULL, true);
-  logger.LogGeneral(INFO, "END", m_function.c_str());
+  if (m_enabled) {
+    Logger::GetLogger(NULL, true).LogGeneral(INFO, "END", m_function);
+  }
 }
@@ -21,6 +21,7 @@
 #define __LOGGER_H__
 
 #include <boost/multiprecision/cpp_int.hpp>
+#include <atomic>
 #include <chrono>
 #include <fstream>
 #include <iomanip>
@@ -38,7 +39,31 @@
                  << std::string(s).substr(0, len)
 #define PAD(n, len) std::setw(len) << std::setfill(' ') << std::right << n
 
+/// Level numbers used by the level checks in the LOG_* macros.
+#define LOG_LEVEL_DEBUG 0
+#define LOG_LEVEL_INFO 1
+#define LOG_LEVEL_WARNING 2
+#define LOG_LEVEL_FATAL 3
+
+/// Calls below this level are compiled out, e.g. -DLOG_COMPILED_LEVEL=2 keeps
+/// only WARNING and FATAL.
+#ifndef LOG_COMPILED_LEVEL
+#define LOG_COMPILED_LEVEL LOG_LEVEL_DEBUG
+#endif
+
+/// True if messages of level (DEBUG, INFO, WARNING or FATAL) are compiled in
+/// and currently enabled. Checked before the message is formatted.
+#define LOG_ENABLED(level)                      \
+  ((LOG_LEVEL_##level >= LOG_COMPILED_LEVEL) && \
+   Logger::IsLevelEnabled(LOG_LEVEL_##level))
+
+struct LogRecord;
+
 /// Utility logging class for outputting messages to stdout or file.
+///
+/// The LOG_* macros only format the message text. The record, with its raw
+/// timestamp, thread ID and function name, goes into a per-thread ring
+/// buffer, and a background thread adds the prefix and writes it out.
 class Logger {
  private:
   std::mutex m;
@@ -46,12 +71,24 @@ class Logger {
   std::streampos m_maxFileSize;
   std::unique_ptr<g3::LogWorker> logworker;
 
+  static std::atomic<unsigned int> s_levelMask;
+
   Logger(const char* prefix, bool log_to_file, std::streampos max_file_size);
   ~Logger();
 
   void checkLog();
   void newLog();
 
+  friend class LogWriter;
+
+  /// Formats and outputs one record. Only called by the writer thread.
+  void Write(const LogRecord& record);
+
+  /// Flushes the output stream after a batch of records.
+  void FlushOutput();
+
+  void Enqueue(LogRecord&& record);
+
   std::string m_fileNamePrefix;
   std::string m_fileName;
   std::ofstream m_logFile;
@@ -89,27 +126,33 @@ class Logger {
 
   /// Outputs the specified message and function name to the state/reporting
   /// log.
-  void LogState(const char* msg, const char* function);
+  void LogState(std::string msg, const char* function);
 
   /// Outputs the specified message and function name to the main log.
-  void LogGeneral(LEVELS level, const char* msg, const char* function);
+  void LogGeneral(LEVELS level, std::string msg, const char* function);
 
   /// Outputs the specified message, function name, and block number to the main
   /// log.
-  void LogEpoch(LEVELS level, const char* msg, const char* epoch,
+  void LogEpoch(LEVELS level, std::string msg, const char* epoch,
                 const char* function);
 
-  /// Outputs the specified message, function name, and payload to the main log.
-  void LogMessageAndPayload(const char* msg,
-                            const std::vector<unsigned char>& payload,
-                            size_t max_bytes_to_display, const char* function);
   /// Outputs the specified message and function name to the epoch info log.
-  void LogEpochInfo(const char* msg, const char* function, const char* epoch);
+  void LogEpochInfo(std::string msg, const char* function, const char* epoch);
 
-  void LogPayload(LEVELS level, const char* msg,
+  /// Outputs the specified message, function name, and payload to the main log.
+  /// Only the first max_bytes_to_display bytes of payload are kept.
+  void LogPayload(LEVELS level, std::string msg,
                   const std::vector<unsigned char>& payload,
                   size_t max_bytes_to_display, const char* function);
 
+  /// Blocks until every record logged so far has been written.
+  static void Flush();
+
+  /// Returns true if the given LOG_LEVEL_* level is enabled at runtime.
+  static bool IsLevelEnabled(unsigned int level) {
+    return ((s_levelMask.load(std::memory_order_relaxed) >> level) & 1) != 0;
+  }
+
   /// Setup the display debug level
   ///     INFO: display all message
   ///     WARNING: display warning and fatal message
@@ -136,7 +179,8 @@ class Logger {
 
 /// Utility class for automatically logging function or code block exit.
 class ScopeMarker {
-  std::string m_function;
+  const char* m_function;
+  bool m_enabled;
 
  public:
   /// Constructor.
@@ -152,77 +196,44 @@ class ScopeMarker {
   Logger::GetStateLogger(fname_prefix, true)
 #define INIT_EPOCHINFO_LOGGER(fname_prefix) \
   Logger::GetEpochInfoLogger(fname_prefix, true)
+#if LOG_COMPILED_LEVEL > LOG_LEVEL_INFO
+#define LOG_MARKER()
+#else
 #define LOG_MARKER() ScopeMarker marker(__FUNCTION__)
-#define LOG_STATE(msg)                              \
-  {                                                 \
-    std::ostringstream oss;                         \
-    oss << msg;                                     \
-    Logger::GetStateLogger(NULL, true)              \
-        .LogState(oss.str().c_str(), __FUNCTION__); \
+#endif
+#define LOG_STATE(msg)                                                    \
+  {                                                                       \
+    std::ostringstream oss;                                               \
+    oss << msg;                                                           \
+    Logger::GetStateLogger(NULL, true).LogState(oss.str(), __FUNCTION__); \
   }
-#define LOG_GENERAL(level, msg)                                               \
-  {                                                                           \
-    if (Logger::GetLogger(NULL, true).IsG3Log()) {                            \
-      auto cur = std::chrono::system_clock::now();                            \
-      auto cur_time_t = std::chrono::system_clock::to_time_t(cur);            \
-      LOG(level) << "[TID " << PAD(Logger::GetPid(), Logger::TID_LEN) << "][" \
-                 << std::put_time(gmtime(&cur_time_t), "%H:%M:%S:")           \
-                 << PAD(get_ms(cur), 3) << "]["                               \
-                 << LIMIT(__FUNCTION__, Logger::MAX_FUNCNAME_LEN) << "] "     \
-                 << msg;                                                      \
-    } else {                                                                  \
-      std::ostringstream oss;                                                 \
-      oss << msg;                                                             \
-      Logger::GetLogger(NULL, true)                                           \
-          .LogGeneral(level, oss.str().c_str(), __FUNCTION__);                \
-    }                                                                         \
+#define LOG_GENERAL(level, msg)                        \
+  {                                                    \
+    if (LOG_ENABLED(level)) {                          \
+      std::ostringstream oss;                          \
+      oss << msg;                                      \
+      Logger::GetLogger(NULL, true)                    \
+          .LogGeneral(level, oss.str(), __FUNCTION__); \
+    }                                                  \
   }
-#define LOG_EPOCH(level, epoch, msg)                                          \
-  {                                                                           \
-    if (Logger::GetLogger(NULL, true).IsG3Log()) {                            \
-      auto cur = std::chrono::system_clock::now();                            \
-      auto cur_time_t = std::chrono::system_clock::to_time_t(cur);            \
-      LOG(level) << "[TID " << PAD(Logger::GetPid(), Logger::TID_LEN) << "][" \
-                 << std::put_time(gmtime(&cur_time_t), "%H:%M:%S:")           \
-                 << PAD(get_ms(cur), 3) << "]["                               \
-                 << LIMIT(__FUNCTION__, Logger::MAX_FUNCNAME_LEN) << "]"      \
-                 << "[Epoch " << epoch << "] " << msg;                        \
-    } else {                                                                  \
-      std::ostringstream oss;                                                 \
-      oss << msg;                                                             \
-      Logger::GetLogger(NULL, true)                                           \
-          .LogEpoch(level, epoch, oss.str().c_str(), __FUNCTION__);           \
-    }                                                                         \
+#define LOG_EPOCH(level, epoch, msg)                        \
+  {                                                         \
+    if (LOG_ENABLED(level)) {                               \
+      std::ostringstream oss;                               \
+      oss << msg;                                           \
+      Logger::GetLogger(NULL, true)                         \
+          .LogEpoch(level, oss.str(), epoch, __FUNCTION__); \
+    }                                                       \
   }
-#define LOG_PAYLOAD(level, msg, payload, max_bytes_to_display)                 \
-  {                                                                            \
-    if (Logger::GetLogger(NULL, true).IsG3Log()) {                             \
-      std::unique_ptr<char[]> payload_string;                                  \
-      Logger::GetPayloadS(payload, max_bytes_to_display, payload_string);      \
-      auto cur = std::chrono::system_clock::now();                             \
-      auto cur_time_t = std::chrono::system_clock::to_time_t(cur);             \
-      if ((payload).size() > max_bytes_to_display) {                           \
-        LOG(level) << "[TID " << PAD(Logger::GetPid(), Logger::TID_LEN)        \
-                   << "][" << std::put_time(gmtime(&cur_time_t), "%H:%M:%S:")  \
-                   << PAD(get_ms(cur), 3) << "]["                              \
-                   << LIMIT(__FUNCTION__, Logger::MAX_FUNCNAME_LEN) << "] "    \
-                   << msg << " (Len=" << (payload).size()                      \
-                   << "): " << payload_string.get() << "...";                  \
-      } else {                                                                 \
-        LOG(level) << "[TID " << PAD(Logger::GetPid(), Logger::TID_LEN)        \
-                   << "][" << std::put_time(gmtime(&cur_time_t), "%H:%M:%S:")  \
-                   << PAD(get_ms(cur), 3) << "]["                              \
-                   << LIMIT(__FUNCTION__, Logger::MAX_FUNCNAME_LEN) << "] "    \
-                   << msg << " (Len=" << (payload).size()                      \
-                   << "): " << payload_string.get();                           \
-      }                                                                        \
-    } else {                                                                   \
-      std::ostringstream oss;                                                  \
-      oss << msg;                                                              \
-      Logger::GetLogger(NULL, true)                                            \
-          .LogPayload(level, oss.str().c_str(), payload, max_bytes_to_display, \
-                      __FUNCTION__);                                           \
-    }                                                                          \
+#define LOG_PAYLOAD(level, msg, payload, max_bytes_to_display)         \
+  {                                                                    \
+    if (LOG_ENABLED(level)) {                                          \
+      std::ostringstream oss;                                          \
+      oss << msg;                                                      \
+      Logger::GetLogger(NULL, true)                                    \
+          .LogPayload(level, oss.str(), payload, max_bytes_to_display, \
+                      __FUNCTION__);                                   \
+    }                                                                  \
   }
 #define LOG_DISPLAY_LEVEL_ABOVE(level) \
   { Logger::GetLogger(NULL, true).DisplayLevelAbove(level); }
@@ -230,11 +241,11 @@ class ScopeMarker {
   { Logger::GetLogger(NULL, true).EnableLevel(level); }
 #define LOG_DISABLE_LEVEL(level) \
   { Logger::GetLogger(NULL, true).DisableLevel(level); }
-#define LOG_EPOCHINFO(blockNum, msg)                              \
-  {                                                               \
-    std::ostringstream oss;                                       \
-    oss << msg;                                                   \
-    Logger::GetEpochInfoLogger(NULL, true)                        \
-        .LogEpochInfo(oss.str().c_str(), __FUNCTION__, blockNum); \
+#define LOG_EPOCHINFO(blockNum, msg)                      \
+  {                                                       \
+    std::ostringstream oss;                               \
+    oss << msg;                                           \
+    Logger::GetEpochInfoLogger(NULL, true)                \
+        .LogEpochInfo(oss.str(), __FUNCTION__, blockNum); \
   }
 #endif  // __LOGGER_H__
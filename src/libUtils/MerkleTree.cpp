@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2018 Zilliqa
+ * This source code is being disclosed to you solely for the purpose of your
+ * participation in testing Zilliqa. You may view, compile and run the code for
+ * that purpose and pursuant to the protocols and algorithms that are programmed
+ * into, and intended by, the code. You may not do anything else with the code
+ * without express permission from Zilliqa Research Pte. Ltd., including
+ * modifying or publishing the code (or any part of it), and developing or
+ * forming another public or private blockchain network. This source code is
+ * provided 'as is' and no warranties are given as to title or non-infringement,
+ * merchantability or fitness for purpose and, to the extent permitted by law,
+ * all liability for your use of the code is disclaimed. Some programs in this
+ * code are governed by the GNU General Public License v3.0 (available at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html) ('GPLv3'). The programs that
+ * are governed by GPLv3.0 are those programs that are located in the folders
+ * src/depends and tests/depends and which include a reference to GPLv3 in their
+ * program files.
+ */
+
+#include <openssl/sha.h>
+#include <algorithm>
+#include <array>
+
+#include "MerkleTree.h"
+
+using namespace std;
+using namespace dev;
+
+namespace {
+const unsigned char LEAF_PREFIX = 0x00;
+const unsigned char NODE_PREFIX = 0x01;
+
+h256 HashLeaf(const h256& leaf) {
+  array<unsigned char, 1 + h256::size> buf;
+  buf[0] = LEAF_PREFIX;
+  copy(leaf.begin(), leaf.end(), buf.begin() + 1);
+
+  h256 result;
+  SHA256(buf.data(), buf.size(), result.data());
+  return result;
+}
+
+h256 HashNode(const h256& left, const h256& right) {
+  array<unsigned char, 1 + 2 * h256::size> buf;
+  buf[0] = NODE_PREFIX;
+  copy(left.begin(), left.end(), buf.begin() + 1);
+  copy(right.begin(), right.end(), buf.begin() + 1 + h256::size);
+
+  h256 result;
+  SHA256(buf.data(), buf.size(), result.data());
+  return result;
+}
+
+/// Hashes one level into the next one. A last node without sibling is
+/// carried up unchanged.
+void HashLevel(const vector<h256>& level, vector<h256>& next) {
+  next.resize((level.size() + 1) / 2);
+  for (size_t i = 0; i + 1 < level.size(); i += 2) {
+    next[i / 2] = HashNode(level[i], level[i + 1]);
+  }
+  if (level.size() % 2 == 1) {
+    next.back() = level.back();
+  }
+}
+}  // namespace
+
+MerkleTree::MerkleTree(const vector<h256>& leaves) : m_leaves(leaves) {
+  if (leaves.empty()) {
+    return;
+  }
+
+  m_levels.emplace_back(leaves.size());
+  transform(leaves.begin(), leaves.end(), m_levels[0].begin(), HashLeaf);
+
+  while (m_levels.back().size() > 1) {
+    vector<h256> next;
+    HashLevel(m_levels.back(), next);
+    m_levels.emplace_back(move(next));
+  }
+}
+
+h256 MerkleTree::GetRoot() const {
+  return m_levels.empty() ? h256() : m_levels.back().front();
+}
+
+uint32_t MerkleTree::GetLeafCount() const { return m_leaves.size(); }
+
+bool MerkleTree::UpdateLeaf(uint32_t index, const h256& leaf) {
+  if (index >= m_leaves.size()) {
+    return false;
+  }
+
+  m_leaves[index] = leaf;
+  m_levels[0][index] = HashLeaf(leaf);
+
+  for (size_t level = 1; level < m_levels.size(); level++) {
+    const vector<h256>& below = m_levels[level - 1];
+    uint32_t left = index & ~1u;
+    index /= 2;
+    m_levels[level][index] = (left + 1 < below.size())
+                                 ? HashNode(below[left], below[left + 1])
+                                 : below[left];
+  }
+
+  return true;
+}
+
+bool MerkleTree::GetInclusionProof(uint32_t index, MerkleProof& proof) const {
+  if (index >= m_leaves.size()) {
+    return false;
+  }
+
+  proof.m_index = index;
+  proof.m_leafCount = m_leaves.size();
+  proof.m_siblings.clear();
+
+  for (size_t level = 0; level + 1 < m_levels.size(); level++) {
+    const vector<h256>& nodes = m_levels[level];
+    uint32_t sibling = index ^ 1u;
+    if (sibling < nodes.size()) {
+      proof.m_siblings.emplace_back(nodes[sibling]);
+    }
+    index /= 2;
+  }
+
+  return true;
+}
+
+bool MerkleTree::GetInclusionProof(const h256& leaf, MerkleProof& proof) const {
+  auto it = find(m_leaves.begin(), m_leaves.end(), leaf);
+  if (it == m_leaves.end()) {
+    return false;
+  }
+
+  return GetInclusionProof(distance(m_leaves.begin(), it), proof);
+}
+
+bool MerkleTree::VerifyInclusionProof(const h256& root, const h256& leaf,
+                                      const MerkleProof& proof) {
+  if (proof.m_index >= proof.m_leafCount) {
+    return false;
+  }
+
+  h256 node = HashLeaf(leaf);
+  uint32_t index = proof.m_index;
+  uint32_t count = proof.m_leafCount;
+  size_t used = 0;
+
+  while (count > 1) {
+    uint32_t sibling = index ^ 1u;
+    if (sibling < count) {
+      if (used == proof.m_siblings.size()) {
+        return false;
+      }
+      const h256& other = proof.m_siblings[used++];
+      node = (index % 2 == 0) ? HashNode(node, other) : HashNode(other, node);
+    }
+    index /= 2;
+    count = (count + 1) / 2;
+  }
+
+  return (used == proof.m_siblings.size()) && (node == root);
+}
+
+h256 MerkleTree::ComputeRoot(const vector<h256>& leaves) {
+  if (leaves.empty()) {
+    return h256();
+  }
+
+  vector<h256> level(leaves.size());
+  transform(leaves.begin(), leaves.end(), level.begin(), HashLeaf);
+
+  vector<h256> next;
+  while (level.size() > 1) {
+    HashLevel(level, next);
+    level.swap(next);
+  }
+
+  return level.front();
+}
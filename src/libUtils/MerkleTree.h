@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2018 Zilliqa
+ * This source code is being disclosed to you solely for the purpose of your
+ * participation in testing Zilliqa. You may view, compile and run the code for
+ * that purpose and pursuant to the protocols and algorithms that are programmed
+ * into, and intended by, the code. You may not do anything else with the code
+ * without express permission from Zilliqa Research Pte. Ltd., including
+ * modifying or publishing the code (or any part of it), and developing or
+ * forming another public or private blockchain network. This source code is
+ * provided 'as is' and no warranties are given as to title or non-infringement,
+ * merchantability or fitness for purpose and, to the extent permitted by law,
+ * all liability for your use of the code is disclaimed. Some programs in this
+ * code are governed by the GNU General Public License v3.0 (available at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html) ('GPLv3'). The programs that
+ * are governed by GPLv3.0 are those programs that are located in the folders
+ * src/depends and tests/depends and which include a reference to GPLv3 in their
+ * program files.
+ */
+
+#ifndef __MERKLETREE_H__
+#define __MERKLETREE_H__
+
+#include <cstdint>
+#include <vector>
+
+#include "depends/common/FixedHash.h"
+
+/// Version of ROOT_HASH_VERSION from which block roots are Merkle roots.
+const unsigned int MERKLE_ROOT_HASH_VERSION = 2;
+
+/// Proof that a leaf is part of a MerkleTree.
+struct MerkleProof {
+  /// Position of the leaf.
+  uint32_t m_index = 0;
+
+  /// Number of leaves in the tree.
+  uint32_t m_leafCount = 0;
+
+  /// Sibling hashes from the leaf level up to the root.
+  std::vector<dev::h256> m_siblings;
+};
+
+/// Binary Merkle tree over a list of 32-byte hashes.
+/// Leaf nodes are SHA256(0x00 || leaf) and inner nodes are
+/// SHA256(0x01 || left || right). A node without a sibling moves up a level
+/// unchanged.
+class MerkleTree {
+  std::vector<dev::h256> m_leaves;
+
+  /// m_levels[0] holds the leaf nodes and m_levels.back() the root.
+  std::vector<std::vector<dev::h256>> m_levels;
+
+ public:
+  /// Constructor for an empty tree.
+  MerkleTree() = default;
+
+  /// Constructor that builds the tree over the specified leaves.
+  explicit MerkleTree(const std::vector<dev::h256>& leaves);
+
+  /// Returns the root, or an all-zero hash if the tree is empty.
+  dev::h256 GetRoot() const;
+
+  /// Returns the number of leaves.
+  uint32_t GetLeafCount() const;
+
+  /// Replaces a leaf and rehashes its path to the root.
+  bool UpdateLeaf(uint32_t index, const dev::h256& leaf);
+
+  /// Fills in the inclusion proof of the leaf at the specified position.
+  bool GetInclusionProof(uint32_t index, MerkleProof& proof) const;
+
+  /// Fills in the inclusion proof of the first occurrence of the leaf.
+  bool GetInclusionProof(const dev::h256& leaf, MerkleProof& proof) const;
+
+  /// Checks that the proof links the leaf to the root.
+  static bool VerifyInclusionProof(const dev::h256& root,
+                                   const dev::h256& leaf,
+                                   const MerkleProof& proof);
+
+  /// Computes the root without keeping the tree.
+  static dev::h256 ComputeRoot(const std::vector<dev::h256>& leaves);
+};
+
+#endif  // __MERKLETREE_H__
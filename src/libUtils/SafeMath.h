@@ -22,6 +22,7 @@
 
 #include <boost/multiprecision/cpp_int.hpp>
 #include "Logger.h"
+#include "common/Uint256.h"
 
 template <class T>
 class SafeMath {
@@ -112,4 +113,43 @@ class SafeMath {
   }
 };
 
+/// Uint256 is unsigned, so overflow and underflow are checked on the limbs
+/// directly instead of through the signed-aware comparisons above.
+template <>
+class SafeMath<Uint256> {
+ public:
+  static bool mul(const Uint256& a, const Uint256& b, Uint256& result) {
+    if (!Uint256::CheckedMul(a, b, result)) {
+      LOG_GENERAL(WARNING, "Multiplication Underflow/Overflow!");
+      return false;
+    }
+    return true;
+  }
+
+  static bool div(const Uint256& a, const Uint256& b, Uint256& result) {
+    if (b.IsZero()) {
+      LOG_GENERAL(WARNING, "Denominator cannot be zero!");
+      return false;
+    }
+    result = a / b;
+    return true;
+  }
+
+  static bool sub(const Uint256& a, const Uint256& b, Uint256& result) {
+    if (!Uint256::CheckedSub(a, b, result)) {
+      LOG_GENERAL(WARNING, "Subtraction Underflow!");
+      return false;
+    }
+    return true;
+  }
+
+  static bool add(const Uint256& a, const Uint256& b, Uint256& result) {
+    if (!Uint256::CheckedAdd(a, b, result)) {
+      LOG_GENERAL(WARNING, "Addition Overflow!");
+      return false;
+    }
+    return true;
+  }
+};
+
 #endif  //__SafeMath_H__
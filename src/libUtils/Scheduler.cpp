@@ -18,63 +18,26 @@
  */
 
 #include "Scheduler.h"
-#include "ReverseLock.h"
 
 using namespace std;
 
-Scheduler::Scheduler() {}
+Scheduler::Scheduler(Executor::Lane lane) : m_lane(lane) {}
 
 Scheduler::~Scheduler() {}
 
-void Scheduler::ServiceQueue() {
-  unique_lock<mutex> lock(newTaskMutex);
-
-  while (true) {
-    try {
-      while (taskQueue.empty()) {
-        newTaskScheduled.wait(lock);
-      }
-
-      while (!taskQueue.empty()) {
-        std::chrono::time_point<std::chrono::system_clock> timeToWaitFor =
-            taskQueue.begin()->first;
-        if (newTaskScheduled.wait_until(lock, timeToWaitFor) ==
-            std::cv_status::timeout) {
-          break;
-        }
-      }
-
-      if (taskQueue.empty()) {
-        continue;
-      }
-
-      std::function<void(void)> f = taskQueue.begin()->second;
-      taskQueue.erase(taskQueue.begin());
-
-      {
-        ReverseLock<unique_lock<mutex>> rlock(lock);
-        f();
-      }
-    } catch (...) {
-      throw;
-    }
-  }
-  newTaskScheduled.notify_one();
-}
-
 void Scheduler::ScheduleAt(std::function<void(void)> f,
                            chrono::time_point<chrono::system_clock> t) {
-  {
-    lock_guard<mutex> lock(newTaskMutex);
-    taskQueue.emplace(t, f);
-  }
-  newTaskScheduled.notify_one();
+  Executor::GetInstance().SubmitAfter(
+      m_lane,
+      chrono::duration_cast<chrono::milliseconds>(t -
+                                                  chrono::system_clock::now()),
+      f);
 }
 
 void Scheduler::ScheduleAfter(std::function<void(void)> f,
                               int64_t deltaMilliSeconds) {
-  ScheduleAt(
-      f, chrono::system_clock::now() + chrono::milliseconds(deltaMilliSeconds));
+  Executor::GetInstance().SubmitAfter(
+      m_lane, chrono::milliseconds(deltaMilliSeconds), f);
 }
 
 static void SchedulePeriodicallyHelper(Scheduler* s,
@@ -89,4 +52,4 @@ void Scheduler::SchedulePeriodically(std::function<void(void)> f,
                                      int64_t deltaMilliSeconds) {
   ScheduleAfter(bind(&SchedulePeriodicallyHelper, this, f, deltaMilliSeconds),
                 deltaMilliSeconds);
-}
\ No newline at end of file
+}
@@ -21,22 +21,15 @@
 #define __SCHEDULER_H__
 
 #include <chrono>
-#include <condition_variable>
+#include <cstdint>
 #include <functional>
-#include <map>
-#include <mutex>
-#include <thread>
 
-// should be initialized this way
-// CScheduler::Function serviceLoop = boost::bind(&CScheduler::serviceQueue,
-// &scheduler);
-// threadGroup.create_thread(boost::bind(&TraceThread<CScheduler::Function>,
-// "scheduler", serviceLoop));
+#include "libUtils/Executor.h"
 
-/// [TODO] Currently unused
+/// Runs functions at a later time as delayed jobs on the shared Executor.
 class Scheduler {
  public:
-  Scheduler();
+  explicit Scheduler(Executor::Lane lane = Executor::BACKGROUND);
   ~Scheduler();
 
   void ScheduleAt(std::function<void(void)> f,
@@ -48,14 +41,8 @@ class Scheduler {
   void SchedulePeriodically(std::function<void(void)> f,
                             int64_t deltaMilliSeconds);
 
-  void ServiceQueue();
-
  private:
-  std::multimap<std::chrono::time_point<std::chrono::system_clock>,
-                std::function<void(void)>>
-      taskQueue;
-  std::condition_variable newTaskScheduled;
-  mutable std::mutex newTaskMutex;
+  Executor::Lane m_lane;
 };
 
 #endif  // __SCHEDULER_H__
\ No newline at end of file
@@ -23,7 +23,11 @@
 #include <condition_variable>
 #include <functional>
 #include <mutex>
+#include <string>
 #include <thread>
+#include <vector>
+
+#include "libUtils/Logger.h"
 
 /**
  *  Set to 1 to use vector instead of queue for jobs container to improve
@@ -98,6 +102,36 @@ class ThreadPool {
     }
   }
 
+  /// Adds several jobs at once, taking the queue lock a single time.
+  void AddJobs(const std::vector<Job>& jobs) {
+    if (jobs.empty()) {
+      return;
+    }
+
+    std::lock(_queueMutex, _jobsLeftMutex);
+    std::lock_guard<std::mutex> lg1(_queueMutex, std::adopt_lock);
+    std::lock_guard<std::mutex> lg2(_jobsLeftMutex, std::adopt_lock);
+
+    for (const auto& job : jobs) {
+#if CONTIGUOUS_JOBS_MEMORY
+      _queue.push_back(job);
+#else
+      _queue.push(job);
+#endif
+    }
+    _jobsLeft += jobs.size();
+    if (jobs.size() == 1) {
+      _jobAvailableVar.notify_one();
+    } else {
+      _jobAvailableVar.notify_all();
+    }
+
+    if (_jobsLeft / 10 != (_jobsLeft - static_cast<int>(jobs.size())) / 10) {
+      LOG_GENERAL(
+          INFO, "PoolName: " << _poolName << " JobLeft: " << _jobsLeft << '\n');
+    }
+  }
+
   /// Joins with all threads. Blocks until all threads have completed. The queue
   /// may be filled after this call, but the threads will be done. After
   /// invoking JoinAll, the pool can no longer be used.
@@ -137,9 +171,8 @@ class ThreadPool {
     }
   }
 
-  /// Gets the vector of threads themselves, in order to set the affinity, or
-  /// anything else you might want to do
-  std::vector<std::thread>& GetThreads() { return _threads; }
+  /// Returns the number of threads owned by the pool.
+  unsigned int GetNumThreads() const { return _threads.size(); }
 
  private:
   /**
@@ -24,19 +24,20 @@
 #include <functional>
 #include <future>
 #include <memory>
-#include <thread>
 
+#include "libUtils/Executor.h"
 #include "libUtils/Logger.h"
 
 /// Utility class for executing a primary function and a subsequent expiry
-/// function in separate join-able threads.
+/// function as jobs on the shared Executor. The expiry job is a delayed job
+/// rather than a sleeping thread.
 class TimeLockedFunction {
  private:
   std::shared_ptr<std::promise<int>> result_promise;
   std::future<int> result_future;
 
-  std::unique_ptr<std::thread> thread_main;
-  std::unique_ptr<std::thread> thread_timer;
+  std::future<void> main_done;
+  std::future<void> timer_done;
 
  public:
   /// Template constructor.
@@ -51,48 +52,55 @@ class TimeLockedFunction {
 
     result_future = result_promise->get_future();
 
-    auto func_main =
-        [task_main, task_expiry, call_expiry_always](
-            std::shared_ptr<std::promise<int>> result_promise) -> void {
+    auto main_promise = std::make_shared<std::promise<void>>();
+    auto timer_promise = std::make_shared<std::promise<void>>();
+    main_done = main_promise->get_future();
+    timer_done = timer_promise->get_future();
+
+    std::shared_ptr<std::promise<int>> result = result_promise;
+
+    auto func_main = [task_main, task_expiry, call_expiry_always, result,
+                      main_promise]() -> void {
       try {
         task_main();
-        result_promise->set_value(0);
+        result->set_value(0);
         if (call_expiry_always) {
           task_expiry();
         }
       } catch (std::future_error&) {
         // Function returned too late
       }
+      main_promise->set_value();
     };
 
-    thread_main = std::make_unique<std::thread>(func_main, result_promise);
-
-    auto func_timer =
-        [expiration_in_seconds, task_expiry](
-            std::shared_ptr<std::promise<int>> result_promise) -> void {
+    auto func_timer = [expiration_in_seconds, task_expiry, result,
+                       timer_promise]() -> void {
       try {
-        LOG_GENERAL(INFO, "Entering sleep for " +
+        LOG_GENERAL(INFO, "Expiry of " +
                               std::to_string(expiration_in_seconds) +
-                              " seconds");
-        std::this_thread::sleep_for(
-            std::chrono::seconds(expiration_in_seconds));
-        LOG_GENERAL(INFO, "Woken up from the sleep of " +
-                              std::to_string(expiration_in_seconds) +
-                              " seconds");
-        result_promise->set_value(-1);
+                              " seconds reached");
+        result->set_value(-1);
         task_expiry();
       } catch (std::future_error&) {
         // Function returned on time
       }
+      timer_promise->set_value();
     };
 
-    thread_timer = std::make_unique<std::thread>(func_timer, result_promise);
+    LOG_GENERAL(INFO, "Expiry set for " +
+                          std::to_string(expiration_in_seconds) + " seconds");
+
+    Executor& executor = Executor::GetInstance();
+    executor.Submit(Executor::BLOCK_PROCESSING, func_main);
+    executor.SubmitAfter(Executor::BLOCK_PROCESSING,
+                         std::chrono::seconds(expiration_in_seconds),
+                         func_timer);
   }
 
-  /// Destructor. Joins both launched threads.
+  /// Destructor. Waits for both jobs to finish.
   ~TimeLockedFunction() {
-    thread_main->join();
-    thread_timer->join();
+    main_done.wait();
+    timer_done.wait();
     result_future.get();
   }
 };
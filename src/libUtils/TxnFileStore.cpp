@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2018 Zilliqa
+ * This source code is being disclosed to you solely for the purpose of your
+ * participation in testing Zilliqa. You may view, compile and run the code for
+ * that purpose and pursuant to the protocols and algorithms that are programmed
+ * into, and intended by, the code. You may not do anything else with the code
+ * without express permission from Zilliqa Research Pte. Ltd., including
+ * modifying or publishing the code (or any part of it), and developing or
+ * forming another public or private blockchain network. This source code is
+ * provided 'as is' and no warranties are given as to title or non-infringement,
+ * merchantability or fitness for purpose and, to the extent permitted by law,
+ * all liability for your use of the code is disclaimed. Some programs in this
+ * code are governed by the GNU General Public License v3.0 (available at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html) ('GPLv3'). The programs that
+ * are governed by GPLv3.0 are those programs that are located in the folders
+ * src/depends and tests/depends and which include a reference to GPLv3 in their
+ * program files.
+ */
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "TxnFileStore.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+TxnFileStore& TxnFileStore::GetInstance() {
+  static TxnFileStore store;
+  return store;
+}
+
+TxnFileStore::~TxnFileStore() { Clear(); }
+
+dev::bytesConstRef TxnFileStore::GetFile(const string& path) {
+  lock_guard<mutex> g(m_mutexFiles);
+
+  auto it = m_files.find(path);
+  if (it != m_files.end()) {
+    return dev::bytesConstRef(it->second.m_data, it->second.m_size);
+  }
+
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    LOG_GENERAL(WARNING, "File failed to open " << path);
+    return dev::bytesConstRef();
+  }
+
+  struct stat st;
+  if ((fstat(fd, &st) != 0) || (st.st_size <= 0)) {
+    LOG_GENERAL(WARNING, "File is empty or cannot be read " << path);
+    close(fd);
+    return dev::bytesConstRef();
+  }
+
+  size_t size = static_cast<size_t>(st.st_size);
+  void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // The mapping keeps its own reference to the file
+  close(fd);
+
+  if (data == MAP_FAILED) {
+    LOG_GENERAL(WARNING, "File failed to map " << path);
+    return dev::bytesConstRef();
+  }
+
+  // Slices are read front to back once per epoch
+  madvise(data, size, MADV_SEQUENTIAL);
+
+  Mapping mapping{static_cast<const unsigned char*>(data), size};
+  m_files.emplace(path, mapping);
+
+  return dev::bytesConstRef(mapping.m_data, mapping.m_size);
+}
+
+dev::bytesConstRef TxnFileStore::GetSlice(const string& path, size_t offset,
+                                          size_t size) {
+  dev::bytesConstRef file = GetFile(path);
+
+  if ((offset > file.size()) || (size > file.size() - offset)) {
+    LOG_GENERAL(WARNING, "Bad byte accessed in "
+                             << path << " (offset " << offset << " size "
+                             << size << " file size " << file.size() << ")");
+    return dev::bytesConstRef();
+  }
+
+  return file.cropped(offset, size);
+}
+
+bool TxnFileStore::Release(const string& path) {
+  lock_guard<mutex> g(m_mutexFiles);
+
+  auto it = m_files.find(path);
+  if (it == m_files.end()) {
+    return false;
+  }
+
+  Unmap(it->second);
+  m_files.erase(it);
+  return true;
+}
+
+void TxnFileStore::Clear() {
+  lock_guard<mutex> g(m_mutexFiles);
+
+  for (const auto& file : m_files) {
+    Unmap(file.second);
+  }
+
+  m_files.clear();
+}
+
+void TxnFileStore::Unmap(const Mapping& mapping) {
+  munmap(const_cast<unsigned char*>(mapping.m_data), mapping.m_size);
+}
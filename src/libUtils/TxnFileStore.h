@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2018 Zilliqa
+ * This source code is being disclosed to you solely for the purpose of your
+ * participation in testing Zilliqa. You may view, compile and run the code for
+ * that purpose and pursuant to the protocols and algorithms that are programmed
+ * into, and intended by, the code. You may not do anything else with the code
+ * without express permission from Zilliqa Research Pte. Ltd., including
+ * modifying or publishing the code (or any part of it), and developing or
+ * forming another public or private blockchain network. This source code is
+ * provided 'as is' and no warranties are given as to title or non-infringement,
+ * merchantability or fitness for purpose and, to the extent permitted by law,
+ * all liability for your use of the code is disclaimed. Some programs in this
+ * code are governed by the GNU General Public License v3.0 (available at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html) ('GPLv3'). The programs that
+ * are governed by GPLv3.0 are those programs that are located in the folders
+ * src/depends and tests/depends and which include a reference to GPLv3 in their
+ * program files.
+ */
+
+#ifndef __TXNFILESTORE_H__
+#define __TXNFILESTORE_H__
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "depends/common/Common.h"
+
+/// Read-only memory mapped view over the pre-generated transaction files.
+/// Each file is mapped once on first use and stays mapped until released, so
+/// the views it hands out can be read without copying and without holding
+/// any lock.
+class TxnFileStore {
+ public:
+  /// Returns the singleton TxnFileStore instance.
+  static TxnFileStore& GetInstance();
+
+  /// Returns a view over the whole content of the file at path, mapping it
+  /// on first use. The view is empty if the file cannot be mapped.
+  dev::bytesConstRef GetFile(const std::string& path);
+
+  /// Returns a view over size bytes of the file at path starting at offset.
+  /// The view is empty if the file is shorter than offset + size.
+  dev::bytesConstRef GetSlice(const std::string& path, size_t offset,
+                              size_t size);
+
+  /// Unmaps the file at path. Views of it handed out before must not be used
+  /// anymore. Returns false if the file was not mapped.
+  bool Release(const std::string& path);
+
+  /// Unmaps all the files. Views handed out before must not be used anymore.
+  void Clear();
+
+ private:
+  TxnFileStore() = default;
+  ~TxnFileStore();
+
+  TxnFileStore(TxnFileStore const&) = delete;
+  void operator=(TxnFileStore const&) = delete;
+
+  struct Mapping {
+    const unsigned char* m_data;
+    size_t m_size;
+  };
+
+  static void Unmap(const Mapping& mapping);
+
+  std::mutex m_mutexFiles;
+  std::unordered_map<std::string, Mapping> m_files;
+};
+
+#endif  // __TXNFILESTORE_H__
@@ -18,6 +18,8 @@
  */
 
 #include "TxnRootComputation.h"
+#include "MerkleTree.h"
+#include "common/Constants.h"
 #include "libCrypto/Sha2.h"
 
 using namespace dev;
@@ -50,107 +52,131 @@ inline const TxnHash& GetTranReceiptID(const MicroBlockHashSet& item) {
 }
 };  // namespace
 
-template <typename... Container>
-TxnHash ConcatTranAndHash(const Container&... conts) {
-  LOG_MARKER();
+bool IsMerkleRootBlock(const uint64_t& blockNum) {
+  return ROOT_HASH_VERSION >= MERKLE_ROOT_HASH_VERSION &&
+         blockNum >= ROOT_HASH_VERSION_EPOCH;
+}
+
+/// Hashes the IDs returned by getID for every item of the containers, in
+/// order. Uses a Merkle root or the legacy hash of the concatenated IDs
+/// depending on the block number.
+template <typename GetID, typename... Container>
+h256 HashIDs(const uint64_t& blockNum, GetID getID,
+             const Container&... conts) {
+  if (IsMerkleRootBlock(blockNum)) {
+    std::vector<h256> leaves;
+
+    (void)std::initializer_list<int>{(
+        [&leaves, &getID](const auto& list) {
+          for (auto& item : list) {
+            leaves.emplace_back(getID(item));
+          }
+        }(conts),
+        0)...};
+
+    return MerkleTree::ComputeRoot(leaves);
+  }
 
   SHA2<HASH_TYPE::HASH_VARIANT_256> sha2;
 
   (void)std::initializer_list<int>{(
-      [](const auto& list, decltype(sha2)& sha2) {
+      [&sha2, &getID](const auto& list) {
         for (auto& item : list) {
-          sha2.Update(GetTranID(item).asBytes());
+          sha2.Update(getID(item).asBytes());
         }
-      }(conts, sha2),
+      }(conts),
       0)...};
 
-  return TxnHash{sha2.Finalize()};
+  return h256{sha2.Finalize()};
 }
 
 template <typename... Container>
-StateHash ConcatStateAndHash(const Container&... conts) {
+TxnHash ConcatTranAndHash(const uint64_t& blockNum,
+                          const Container&... conts) {
   LOG_MARKER();
 
-  SHA2<HASH_TYPE::HASH_VARIANT_256> sha2;
-
-  (void)std::initializer_list<int>{(
-      [](const auto& list, decltype(sha2)& sha2) {
-        for (auto& item : list) {
-          sha2.Update(GetStateID(item).asBytes());
-        }
-      }(conts, sha2),
-      0)...};
-
-  return StateHash{sha2.Finalize()};
+  return HashIDs(blockNum, [](const auto& item) { return GetTranID(item); },
+                 conts...);
 }
 
 template <typename... Container>
-TxnHash ConcatTranReceiptAndHash(const Container&... conts) {
+StateHash ConcatStateAndHash(const uint64_t& blockNum,
+                             const Container&... conts) {
   LOG_MARKER();
 
-  SHA2<HASH_TYPE::HASH_VARIANT_256> sha2;
+  return HashIDs(blockNum, [](const auto& item) { return GetStateID(item); },
+                 conts...);
+}
 
-  (void)std::initializer_list<int>{(
-      [](const auto& list, decltype(sha2)& sha2) {
-        for (auto& item : list) {
-          sha2.Update(GetTranReceiptID(item).asBytes());
-        }
-      }(conts, sha2),
-      0)...};
+template <typename... Container>
+TxnHash ConcatTranReceiptAndHash(const uint64_t& blockNum,
+                                 const Container&... conts) {
+  LOG_MARKER();
 
-  return TxnHash{sha2.Finalize()};
+  return HashIDs(blockNum,
+                 [](const auto& item) { return GetTranReceiptID(item); },
+                 conts...);
 }
 
-TxnHash ComputeTransactionsRoot(const std::vector<TxnHash>& transactionHashes) {
+TxnHash ComputeTransactionsRoot(const std::vector<TxnHash>& transactionHashes,
+                                const uint64_t& blockNum) {
   LOG_MARKER();
 
   if (transactionHashes.empty()) {
     return TxnHash();
   }
 
-  return ConcatTranAndHash(transactionHashes);
+  return ConcatTranAndHash(blockNum, transactionHashes);
 }
 
 TxnHash ComputeTransactionsRoot(
     const std::list<Transaction>& receivedTransactions,
-    const std::list<Transaction>& submittedTransactions) {
+    const std::list<Transaction>& submittedTransactions,
+    const uint64_t& blockNum) {
   LOG_MARKER();
 
-  return ConcatTranAndHash(receivedTransactions, submittedTransactions);
+  return ConcatTranAndHash(blockNum, receivedTransactions,
+                           submittedTransactions);
 }
 
 TxnHash ComputeTransactionsRoot(
-    const std::unordered_map<TxnHash, Transaction>& processedTransactions) {
+    const std::unordered_map<TxnHash, Transaction>& processedTransactions,
+    const uint64_t& blockNum) {
   LOG_MARKER();
 
-  return ConcatTranAndHash(processedTransactions);
+  return ConcatTranAndHash(blockNum, processedTransactions);
 }
 
 TxnHash ComputeTransactionsRoot(
     const std::unordered_map<TxnHash, Transaction>& receivedTransactions,
-    const std::unordered_map<TxnHash, Transaction>& submittedTransactions) {
+    const std::unordered_map<TxnHash, Transaction>& submittedTransactions,
+    const uint64_t& blockNum) {
   LOG_MARKER();
 
-  return ConcatTranAndHash(receivedTransactions, submittedTransactions);
+  return ConcatTranAndHash(blockNum, receivedTransactions,
+                           submittedTransactions);
 }
 
 TxnHash ComputeTransactionsRoot(
-    const std::vector<MicroBlockHashSet>& microBlockHashes) {
+    const std::vector<MicroBlockHashSet>& microBlockHashes,
+    const uint64_t& blockNum) {
   LOG_MARKER();
 
-  return ConcatTranAndHash(microBlockHashes);
+  return ConcatTranAndHash(blockNum, microBlockHashes);
 }
 
 StateHash ComputeDeltasRoot(
-    const std::vector<MicroBlockHashSet>& microBlockHashes) {
+    const std::vector<MicroBlockHashSet>& microBlockHashes,
+    const uint64_t& blockNum) {
   LOG_MARKER();
 
-  return ConcatStateAndHash(microBlockHashes);
+  return ConcatStateAndHash(blockNum, microBlockHashes);
 }
 
 TxnHash ComputeTranReceiptsRoot(
-    const std::vector<MicroBlockHashSet>& microBlockHashes) {
+    const std::vector<MicroBlockHashSet>& microBlockHashes,
+    const uint64_t& blockNum) {
   LOG_MARKER();
 
-  return ConcatTranReceiptAndHash(microBlockHashes);
+  return ConcatTranReceiptAndHash(blockNum, microBlockHashes);
 }
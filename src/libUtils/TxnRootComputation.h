@@ -32,26 +32,38 @@
 #include "depends/libTrie/TrieDB.h"
 #include "libData/BlockData/BlockHeader/BlockHashSet.h"
 
+/// Returns true if the roots of the given Tx block are Merkle roots, i.e.
+/// ROOT_HASH_VERSION enables them and the block is at or after
+/// ROOT_HASH_VERSION_EPOCH.
+bool IsMerkleRootBlock(const uint64_t& blockNum);
+
 StateHash ComputeDeltasRoot(
-    const std::vector<MicroBlockHashSet>& microBlockHashes);
+    const std::vector<MicroBlockHashSet>& microBlockHashes,
+    const uint64_t& blockNum);
 
 TxnHash ComputeTranReceiptsRoot(
-    const std::vector<MicroBlockHashSet>& microBlockHashes);
+    const std::vector<MicroBlockHashSet>& microBlockHashes,
+    const uint64_t& blockNum);
 
-TxnHash ComputeTransactionsRoot(const std::vector<TxnHash>& transactionHashes);
+TxnHash ComputeTransactionsRoot(const std::vector<TxnHash>& transactionHashes,
+                                const uint64_t& blockNum);
 
 TxnHash ComputeTransactionsRoot(
     const std::list<Transaction>& receivedTransactions,
-    const std::list<Transaction>& submittedTransactions);
+    const std::list<Transaction>& submittedTransactions,
+    const uint64_t& blockNum);
 
 TxnHash ComputeTransactionsRoot(
-    const std::unordered_map<TxnHash, Transaction>& processedTransactions);
+    const std::unordered_map<TxnHash, Transaction>& processedTransactions,
+    const uint64_t& blockNum);
 
 TxnHash ComputeTransactionsRoot(
     const std::unordered_map<TxnHash, Transaction>& receivedTransactions,
-    const std::unordered_map<TxnHash, Transaction>& submittedTransactions);
+    const std::unordered_map<TxnHash, Transaction>& submittedTransactions,
+    const uint64_t& blockNum);
 
 TxnHash ComputeTransactionsRoot(
-    const std::vector<MicroBlockHashSet>& microBlockHashes);
+    const std::vector<MicroBlockHashSet>& microBlockHashes,
+    const uint64_t& blockNum);
 
 #endif  // __TXNROOTCOMPUTATION_H__
@@ -38,6 +38,21 @@ bool Validator::VerifyTransaction(const Transaction& tran) const {
                                        tran.GetSenderPubKey());
 }
 
+bool Validator::VerifyTransactions(const vector<Transaction>& txns,
+                                   vector<bool>& results) const {
+  vector<Schnorr::VerifyEntry> entries;
+  entries.reserve(txns.size());
+
+  for (const auto& tran : txns) {
+    vector<unsigned char> txnData;
+    tran.SerializeCoreFields(txnData, 0);
+    entries.emplace_back(move(txnData), tran.GetSignature(),
+                         tran.GetSenderPubKey());
+  }
+
+  return Schnorr::GetInstance().BatchVerify(entries, results);
+}
+
 bool Validator::CheckCreatedTransaction(const Transaction& tx,
                                         TransactionReceipt& receipt) const {
   if (LOOKUP_NODE_MODE) {
@@ -78,6 +93,15 @@ bool Validator::CheckCreatedTransaction(const Transaction& tx,
 }
 
 bool Validator::CheckCreatedTransactionFromLookup(const Transaction& tx) {
+  return CheckCreatedTransactionFromLookupCore(tx, true);
+}
+
+bool Validator::CheckVerifiedTransactionFromLookup(const Transaction& tx) {
+  return CheckCreatedTransactionFromLookupCore(tx, false);
+}
+
+bool Validator::CheckCreatedTransactionFromLookupCore(const Transaction& tx,
+                                                      bool verifySignature) {
   if (LOOKUP_NODE_MODE) {
     LOG_GENERAL(WARNING,
                 "Validator::CheckCreatedTransactionFromLookup not expected "
@@ -121,7 +145,7 @@ bool Validator::CheckCreatedTransactionFromLookup(const Transaction& tx) {
     }
   }
 
-  if (!VerifyTransaction(tx)) {
+  if (verifySignature && !VerifyTransaction(tx)) {
     LOG_EPOCH(WARNING, to_string(m_mediator.m_currentEpochNum).c_str(),
               "Signature incorrect: " << fromAddr << ". Transaction rejected: "
                                       << tx.GetTranID());
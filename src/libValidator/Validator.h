@@ -21,6 +21,7 @@
 #define __VALIDATOR_H__
 
 #include <string>
+#include <vector>
 
 #include "libData/AccountData/Transaction.h"
 #include "libData/AccountData/TransactionReceipt.h"
@@ -35,10 +36,18 @@ class ValidatorBase {
   /// Verifies the transaction w.r.t given pubKey and signature
   virtual bool VerifyTransaction(const Transaction& tran) const = 0;
 
+  /// Verifies the signatures of many transactions in parallel
+  virtual bool VerifyTransactions(const std::vector<Transaction>& txns,
+                                  std::vector<bool>& results) const = 0;
+
   virtual bool CheckCreatedTransaction(const Transaction& tx,
                                        TransactionReceipt& receipt) const = 0;
 
   virtual bool CheckCreatedTransactionFromLookup(const Transaction& tx) = 0;
+
+  /// Same checks as CheckCreatedTransactionFromLookup, minus the signature
+  /// which has already been checked through VerifyTransactions
+  virtual bool CheckVerifiedTransactionFromLookup(const Transaction& tx) = 0;
 };
 
 class Validator : public ValidatorBase {
@@ -47,17 +56,25 @@ class Validator : public ValidatorBase {
   // std::unordered_map<Address, boost::multiprecision::uint256_t>
   // m_txnNonceMap;
 
+  bool CheckCreatedTransactionFromLookupCore(const Transaction& tx,
+                                             bool verifySignature);
+
  public:
   Validator(Mediator& mediator);
   ~Validator();
   std::string name() const override { return "Validator"; }
   bool VerifyTransaction(const Transaction& tran) const override;
 
+  bool VerifyTransactions(const std::vector<Transaction>& txns,
+                          std::vector<bool>& results) const override;
+
   bool CheckCreatedTransaction(const Transaction& tx,
                                TransactionReceipt& receipt) const override;
 
   bool CheckCreatedTransactionFromLookup(const Transaction& tx) override;
 
+  bool CheckVerifiedTransactionFromLookup(const Transaction& tx) override;
+
   Mediator& m_mediator;
 };
 
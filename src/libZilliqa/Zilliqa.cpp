@@ -36,6 +36,9 @@
 using namespace std;
 using namespace jsonrpc;
 
+/// Most queued messages handed to the thread pool at once.
+const unsigned int MSG_DISPATCH_BATCH_SIZE = 64;
+
 void Zilliqa::LogSelfNodeInfo(const std::pair<PrivKey, PubKey>& key,
                               const Peer& peer) {
   vector<unsigned char> tmp1;
@@ -105,17 +108,25 @@ Zilliqa::Zilliqa(const std::pair<PrivKey, PubKey>& key, const Peer& peer,
   LOG_MARKER();
   // Launch the thread that reads messages from the queue
   auto funcCheckMsgQueue = [this]() mutable -> void {
-    pair<vector<unsigned char>, Peer>* message = NULL;
+    vector<pair<vector<unsigned char>, Peer>*> messages;
+    vector<ThreadPool::Job> jobs;
     while (true) {
-      while (m_msgQueue.pop(message)) {
+      messages.clear();
+      jobs.clear();
+      if (m_msgQueue.PopBatch(messages, MSG_DISPATCH_BATCH_SIZE) ==
+          MSG_DISPATCH_BATCH_SIZE) {
+        LOG_GENERAL(INFO, "Message queue backlog: " << m_msgQueue.GetDepth());
+      }
+      for (auto message : messages) {
         // For now, we use a thread pool to handle this message
         // Eventually processing will be single-threaded
-        m_queuePool.AddJob(
+        jobs.emplace_back(
             [this, message]() mutable -> void { ProcessMessage(message); });
       }
+      m_queuePool.AddJobs(jobs);
     }
   };
-  DetachedFunction(1, funcCheckMsgQueue);
+  DetachedFunction(DetachedFunction::LongRunning(), 1, funcCheckMsgQueue);
 
   m_validator = make_shared<Validator>(m_mediator);
   if (ARCHIVAL_NODE) {
@@ -187,7 +198,7 @@ Zilliqa::Zilliqa(const std::pair<PrivKey, PubKey>& key, const Peer& peer,
 
 Zilliqa::~Zilliqa() {
   pair<vector<unsigned char>, Peer>* message = NULL;
-  while (m_msgQueue.pop(message)) {
+  while (m_msgQueue.TryPopOne(message)) {
     delete message;
   }
 }
@@ -196,9 +207,7 @@ void Zilliqa::Dispatch(pair<vector<unsigned char>, Peer>* message) {
   // LOG_MARKER();
 
   // Queue message
-  while (!m_msgQueue.push(message)) {
-    // Keep attempting to push until success
-  }
+  m_msgQueue.Push(message);
 }
 
 vector<Peer> Zilliqa::RetrieveBroadcastList(unsigned char msg_type,
@@ -34,6 +34,7 @@
 #include "libNetwork/PeerStore.h"
 #include "libNode/Node.h"
 #include "libServer/Server.h"
+#include "libUtils/BlockingQueue.h"
 #include "libUtils/ThreadPool.h"
 
 /// Main Zilliqa class.
@@ -48,8 +49,7 @@ class Zilliqa {
   Archival m_arch;
   // ConsensusUser m_cu; // Note: This is just a test class to demo Consensus
   // usage
-  boost::lockfree::queue<std::pair<std::vector<unsigned char>, Peer>*>
-      m_msgQueue;
+  BlockingQueue<std::pair<std::vector<unsigned char>, Peer>*> m_msgQueue;
 
   jsonrpc::HttpServer m_httpserver;
   Server m_server;
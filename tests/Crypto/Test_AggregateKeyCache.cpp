@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2018 Zilliqa
+ * This source code is being disclosed to you solely for the purpose of your
+ * participation in testing Zilliqa. You may view, compile and run the code for
+ * that purpose and pursuant to the protocols and algorithms that are programmed
+ * into, and intended by, the code. You may not do anything else with the code
+ * without express permission from Zilliqa Research Pte. Ltd., including
+ * modifying or publishing the code (or any part of it), and developing or
+ * forming another public or private blockchain network. This source code is
+ * provided 'as is' and no warranties are given as to title or non-infringement,
+ * merchantability or fitness for purpose and, to the extent permitted by law,
+ * all liability for your use of the code is disclaimed. Some programs in this
+ * code are governed by the GNU General Public License v3.0 (available at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html) ('GPLv3'). The programs that
+ * are governed by GPLv3.0 are those programs that are located in the folders
+ * src/depends and tests/depends and which include a reference to GPLv3 in their
+ * program files.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <numeric>
+#include <random>
+
+#include "libCrypto/AggregateKeyCache.h"
+#include "libCrypto/MultiSig.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE aggregatekeycachetest
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+namespace {
+const unsigned int DS_COMMITTEE_SIZE = 600;
+
+vector<pair<PrivKey, PubKey>> MakeCommittee(unsigned int size) {
+  vector<pair<PrivKey, PubKey>> committee;
+  for (unsigned int i = 0; i < size; i++) {
+    committee.emplace_back(Schnorr::GetInstance().GenKeyPair());
+  }
+  return committee;
+}
+
+const PubKey& KeyOf(const pair<PrivKey, PubKey>& member) {
+  return member.second;
+}
+
+/// A bitmap with all but numAbsent random members set.
+vector<bool> MakeBitmap(unsigned int size, unsigned int numAbsent,
+                        mt19937& rng) {
+  vector<bool> bitmap(size, true);
+  vector<unsigned int> order(size);
+  iota(order.begin(), order.end(), 0);
+  shuffle(order.begin(), order.end(), rng);
+  for (unsigned int i = 0; i < numAbsent; i++) {
+    bitmap.at(order.at(i)) = false;
+  }
+  return bitmap;
+}
+
+shared_ptr<PubKey> AggregateFromScratch(
+    const vector<pair<PrivKey, PubKey>>& committee,
+    const vector<bool>& bitmap) {
+  vector<PubKey> keys;
+  for (unsigned int i = 0; i < committee.size(); i++) {
+    if (bitmap.at(i)) {
+      keys.emplace_back(committee.at(i).second);
+    }
+  }
+  return MultiSig::AggregatePubKeys(keys);
+}
+
+/// Co-signs message with the members set in bitmap.
+shared_ptr<Signature> CoSign(const vector<pair<PrivKey, PubKey>>& committee,
+                             const vector<bool>& bitmap,
+                             const vector<unsigned char>& message) {
+  vector<CommitSecret> secrets;
+  vector<CommitPoint> points;
+  for (unsigned int i = 0; i < committee.size(); i++) {
+    if (bitmap.at(i)) {
+      secrets.emplace_back();
+      points.emplace_back(secrets.back());
+    }
+  }
+
+  shared_ptr<PubKey> aggregatedKey = AggregateFromScratch(committee, bitmap);
+  shared_ptr<CommitPoint> aggregatedCommit = MultiSig::AggregateCommits(points);
+  Challenge challenge(*aggregatedCommit, *aggregatedKey, message);
+
+  vector<Response> responses;
+  for (unsigned int i = 0, j = 0; i < committee.size(); i++) {
+    if (bitmap.at(i)) {
+      responses.emplace_back(secrets.at(j++), challenge, committee.at(i).first);
+    }
+  }
+
+  return MultiSig::AggregateSign(challenge,
+                                 *MultiSig::AggregateResponses(responses));
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(aggregatekeycachetest)
+
+BOOST_AUTO_TEST_CASE(test_matches_aggregate_pubkeys) {
+  INIT_STDOUT_LOGGER();
+
+  AggregateKeyCache& cache = AggregateKeyCache::GetInstance();
+  cache.Clear();
+
+  auto committee = MakeCommittee(50);
+  mt19937 rng(1);
+
+  // Mostly full bitmaps take the subtraction path, sparse ones the addition
+  for (unsigned int numAbsent : {0, 1, 16, 24, 26, 40, 49}) {
+    const vector<bool> bitmap = MakeBitmap(committee.size(), numAbsent, rng);
+    auto aggregate = cache.Aggregate(committee, KeyOf, bitmap);
+    BOOST_REQUIRE(aggregate != nullptr);
+    BOOST_CHECK(*aggregate == *AggregateFromScratch(committee, bitmap));
+  }
+
+  BOOST_CHECK(cache.Aggregate(committee, KeyOf,
+                              vector<bool>(committee.size(), false)) ==
+              nullptr);
+  BOOST_CHECK(cache.Aggregate(committee, KeyOf,
+                              vector<bool>(committee.size() - 1, true)) ==
+              nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(test_memoized_by_bitmap) {
+  INIT_STDOUT_LOGGER();
+
+  AggregateKeyCache& cache = AggregateKeyCache::GetInstance();
+  cache.Clear();
+
+  auto committee = MakeCommittee(20);
+  mt19937 rng(2);
+  const vector<bool> bitmap = MakeBitmap(committee.size(), 3, rng);
+
+  auto first = cache.Aggregate(committee, KeyOf, bitmap);
+  auto second = cache.Aggregate(committee, KeyOf, bitmap);
+  BOOST_REQUIRE(first != nullptr);
+  BOOST_CHECK(first == second);
+}
+
+BOOST_AUTO_TEST_CASE(test_committee_change) {
+  INIT_STDOUT_LOGGER();
+
+  AggregateKeyCache& cache = AggregateKeyCache::GetInstance();
+  cache.Clear();
+
+  auto committee = MakeCommittee(20);
+  auto shard = MakeCommittee(20);
+  const vector<bool> bitmap(committee.size(), true);
+
+  auto before = cache.Aggregate(committee, KeyOf, bitmap);
+
+  // Another committee of the same size must not reuse the cached sum
+  BOOST_CHECK(*cache.Aggregate(shard, KeyOf, bitmap) ==
+              *AggregateFromScratch(shard, bitmap));
+
+  // Neither must the same committee with one member replaced
+  committee.at(7) = Schnorr::GetInstance().GenKeyPair();
+  auto after = cache.Aggregate(committee, KeyOf, bitmap);
+  BOOST_CHECK(*after == *AggregateFromScratch(committee, bitmap));
+  BOOST_CHECK(!(*after == *before));
+}
+
+BOOST_AUTO_TEST_CASE(test_block_verification_latency) {
+  INIT_STDOUT_LOGGER();
+
+  AggregateKeyCache& cache = AggregateKeyCache::GetInstance();
+  cache.Clear();
+
+  auto committee = MakeCommittee(DS_COMMITTEE_SIZE);
+  mt19937 rng(3);
+
+  // Each block is co-signed by just over two thirds of the DS committee,
+  // as required for consensus
+  const unsigned int numBlocks = 10;
+  const unsigned int numAbsent =
+      DS_COMMITTEE_SIZE - (DS_COMMITTEE_SIZE * 2 / 3 + 1);
+  vector<unsigned char> message(1024);
+  vector<vector<bool>> bitmaps;
+  vector<shared_ptr<Signature>> signatures;
+  for (unsigned int i = 0; i < numBlocks; i++) {
+    message.at(0) = i;
+    bitmaps.emplace_back(MakeBitmap(DS_COMMITTEE_SIZE, numAbsent, rng));
+    signatures.emplace_back(CoSign(committee, bitmaps.back(), message));
+  }
+
+  auto verifyAll = [&](const function<shared_ptr<const PubKey>(
+                           const vector<bool>&)>& aggregate) {
+    auto start = chrono::steady_clock::now();
+    for (unsigned int i = 0; i < numBlocks; i++) {
+      message.at(0) = i;
+      auto aggregatedKey = aggregate(bitmaps.at(i));
+      BOOST_REQUIRE(aggregatedKey != nullptr);
+      BOOST_CHECK(Schnorr::GetInstance().Verify(message, *signatures.at(i),
+                                                *aggregatedKey));
+    }
+    return chrono::duration_cast<chrono::microseconds>(
+               chrono::steady_clock::now() - start)
+               .count() /
+           numBlocks;
+  };
+
+  auto fromScratch = verifyAll([&](const vector<bool>& bitmap) {
+    return AggregateFromScratch(committee, bitmap);
+  });
+  auto firstPass = verifyAll([&](const vector<bool>& bitmap) {
+    return cache.Aggregate(committee, KeyOf, bitmap);
+  });
+  auto secondPass = verifyAll([&](const vector<bool>& bitmap) {
+    return cache.Aggregate(committee, KeyOf, bitmap);
+  });
+
+  LOG_GENERAL(INFO, "Block verification with " << DS_COMMITTEE_SIZE
+                                               << " DS members: "
+                                               << fromScratch
+                                               << " us from scratch, "
+                                               << firstPass << " us cached, "
+                                               << secondPass
+                                               << " us for a known bitmap");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -18,6 +18,8 @@
  */
 
 #include <cstring>
+#include <map>
+#include <unordered_map>
 #include "libCrypto/Schnorr.h"
 #include "libUtils/Logger.h"
 #include "libUtils/TimeUtils.h"
@@ -261,4 +263,150 @@ BOOST_AUTO_TEST_CASE(test_serialization) {
                       "Signature serialization check #2 failed");
 }
 
+BOOST_AUTO_TEST_CASE(test_batch_verif) {
+  Schnorr& schnorr = Schnorr::GetInstance();
+
+  const unsigned int num_signatures = 1000;
+  const unsigned int message_size = 256;
+
+  vector<Schnorr::VerifyEntry> entries;
+  for (unsigned int i = 0; i < num_signatures; i++) {
+    pair<PrivKey, PubKey> keypair = schnorr.GenKeyPair();
+
+    vector<unsigned char> message(message_size);
+    generate(message.begin(), message.end(), std::rand);
+
+    Signature signature;
+    BOOST_CHECK_MESSAGE(
+        schnorr.Sign(message, keypair.first, keypair.second, signature) == true,
+        "Signing failed");
+
+    // Tamper with every 10th message after signing
+    if (i % 10 == 0) {
+      message.at(0) ^= 0xFF;
+    }
+
+    entries.emplace_back(message, signature, keypair.second);
+  }
+
+  // Sequential verification as reference
+  auto t = r_timer_start();
+  for (const auto& entry : entries) {
+    schnorr.Verify(get<0>(entry), get<1>(entry), get<2>(entry));
+  }
+  LOG_GENERAL(INFO, "Verify x" << num_signatures
+                               << " (usec)      = " << r_timer_end(t));
+
+  vector<bool> results;
+  t = r_timer_start();
+  BOOST_CHECK_MESSAGE(schnorr.BatchVerify(entries, results) == false,
+                      "Batch verification should fail on tampered messages");
+  LOG_GENERAL(INFO, "BatchVerify x" << num_signatures
+                                    << " (usec) = " << r_timer_end(t));
+
+  BOOST_REQUIRE(results.size() == num_signatures);
+  for (unsigned int i = 0; i < num_signatures; i++) {
+    BOOST_CHECK_MESSAGE(results.at(i) == (i % 10 != 0),
+                        "Wrong batch verification result for signature " << i);
+  }
+
+  // Drop the tampered entries and check that the rest passes as a whole
+  vector<Schnorr::VerifyEntry> valid_entries;
+  for (unsigned int i = 0; i < num_signatures; i++) {
+    if (i % 10 != 0) {
+      valid_entries.emplace_back(entries.at(i));
+    }
+  }
+  BOOST_CHECK_MESSAGE(schnorr.BatchVerify(valid_entries, results) == true,
+                      "Batch verification of valid signatures failed");
+}
+
+/// Key ordering by allocating BIGNUMs per comparison, as done before
+/// PubKey cached its compressed encoding.
+struct BIGNUMPubKeyLess {
+  bool operator()(const PubKey& l, const PubKey& r) const {
+    const Curve& curve = Schnorr::GetInstance().GetCurve();
+    unique_ptr<BN_CTX, void (*)(BN_CTX*)> ctx(BN_CTX_new(), BN_CTX_free);
+    unique_ptr<BIGNUM, void (*)(BIGNUM*)> lhs(
+        EC_POINT_point2bn(curve.m_group.get(), l.m_P.get(),
+                          POINT_CONVERSION_COMPRESSED, NULL, ctx.get()),
+        BN_clear_free);
+    unique_ptr<BIGNUM, void (*)(BIGNUM*)> rhs(
+        EC_POINT_point2bn(curve.m_group.get(), r.m_P.get(),
+                          POINT_CONVERSION_COMPRESSED, NULL, ctx.get()),
+        BN_clear_free);
+    return BN_cmp(lhs.get(), rhs.get()) == -1;
+  }
+};
+
+BOOST_AUTO_TEST_CASE(test_pubkey_map) {
+  Schnorr& schnorr = Schnorr::GetInstance();
+
+  const unsigned int num_keys = 10000;
+
+  vector<PubKey> keys;
+  keys.reserve(num_keys);
+  for (unsigned int i = 0; i < num_keys; i++) {
+    keys.emplace_back(schnorr.GenKeyPair().second);
+  }
+
+  // Cached ordering must agree with the BIGNUM ordering
+  BIGNUMPubKeyLess bnLess;
+  for (unsigned int i = 1; i < num_keys; i++) {
+    BOOST_CHECK_MESSAGE((keys.at(i - 1) < keys.at(i)) ==
+                            bnLess(keys.at(i - 1), keys.at(i)),
+                        "PubKey ordering mismatch at " << i);
+  }
+
+  // A deserialized key must compare and hash equal to its source
+  vector<unsigned char> bytes;
+  keys.front().Serialize(bytes, 0);
+  PubKey deserialized(bytes, 0);
+  BOOST_CHECK_MESSAGE(deserialized == keys.front(),
+                      "Deserialized PubKey comparison failed");
+  BOOST_CHECK_MESSAGE(
+      hash<PubKey>()(deserialized) == hash<PubKey>()(keys.front()),
+      "Deserialized PubKey hash mismatch");
+
+  map<PubKey, unsigned int, BIGNUMPubKeyLess> bnMap;
+  auto t = r_timer_start();
+  for (unsigned int i = 0; i < num_keys; i++) {
+    bnMap.emplace(keys.at(i), i);
+  }
+  for (const auto& key : keys) {
+    BOOST_CHECK(bnMap.find(key) != bnMap.end());
+  }
+  LOG_GENERAL(INFO, "map<PubKey> (BIGNUM) insert+find x"
+                        << num_keys << " (usec) = " << r_timer_end(t));
+
+  map<PubKey, unsigned int> cachedMap;
+  t = r_timer_start();
+  for (unsigned int i = 0; i < num_keys; i++) {
+    cachedMap.emplace(keys.at(i), i);
+  }
+  for (const auto& key : keys) {
+    BOOST_CHECK(cachedMap.find(key) != cachedMap.end());
+  }
+  LOG_GENERAL(INFO, "map<PubKey> insert+find x"
+                        << num_keys << " (usec)          = " << r_timer_end(t));
+
+  unordered_map<PubKey, unsigned int> hashMap;
+  t = r_timer_start();
+  for (unsigned int i = 0; i < num_keys; i++) {
+    hashMap.emplace(keys.at(i), i);
+  }
+  for (const auto& key : keys) {
+    BOOST_CHECK(hashMap.find(key) != hashMap.end());
+  }
+  LOG_GENERAL(INFO, "unordered_map<PubKey> insert+find x"
+                        << num_keys << " (usec) = " << r_timer_end(t));
+
+  BOOST_CHECK_MESSAGE(bnMap.size() == num_keys &&
+                          cachedMap.size() == num_keys &&
+                          hashMap.size() == num_keys,
+                      "Unexpected number of distinct keys");
+  BOOST_CHECK_MESSAGE(cachedMap.at(deserialized) == 0,
+                      "Lookup by deserialized PubKey failed");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
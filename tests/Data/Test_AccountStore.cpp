@@ -18,6 +18,8 @@
  */
 
 #include <array>
+#include <chrono>
+#include <set>
 #include <string>
 
 #define BOOST_TEST_MODULE accountstoretest
@@ -31,6 +33,8 @@
 #include "libUtils/DataConversion.h"
 #include "libUtils/Logger.h"
 
+using namespace std;
+
 BOOST_AUTO_TEST_SUITE(accountstoretest)
 
 BOOST_AUTO_TEST_CASE(commitAndRollback) {
@@ -405,4 +409,163 @@ BOOST_AUTO_TEST_CASE(commitAndRollback) {
   //     root!");
 }
 
+BOOST_AUTO_TEST_CASE(dirtyAccounts) {
+  INIT_STDOUT_LOGGER();
+
+  LOG_MARKER();
+
+  AccountStore::GetInstance().Init();
+
+  Address address1, address2;
+  address1.asArray()[0] = 1;
+  address2.asArray()[0] = 2;
+  AccountStore::GetInstance().AddAccount(address1, {10, 0});
+  AccountStore::GetInstance().AddAccount(address2, {20, 0});
+  BOOST_CHECK_EQUAL(AccountStore::GetInstance().GetDirtyAccounts().size(), 2);
+
+  AccountStore::GetInstance().MoveUpdatesToDisk();
+  BOOST_CHECK_MESSAGE(AccountStore::GetInstance().GetDirtyAccounts().empty(),
+                      "Dirty set not cleared by MoveUpdatesToDisk!");
+
+  // Reads leave the dirty set alone
+  AccountStore::GetInstance().GetBalance(address1);
+  AccountStore::GetInstance().GetNonce(address2);
+  BOOST_CHECK(AccountStore::GetInstance().GetDirtyAccounts().empty());
+
+  AccountStore::GetInstance().IncreaseNonce(address2);
+  BOOST_CHECK_MESSAGE(
+      AccountStore::GetInstance().GetDirtyAccounts() ==
+          set<Address>({address2}),
+      "Dirty set should hold exactly the changed account!");
+}
+
+BOOST_AUTO_TEST_CASE(lazyRetrieveFromDisk) {
+  INIT_STDOUT_LOGGER();
+
+  LOG_MARKER();
+
+  const unsigned int NUM_ACCOUNTS = 10000;
+
+  AccountStore::GetInstance().Init();
+
+  vector<Address> addresses;
+  for (unsigned int i = 0; i < NUM_ACCOUNTS; i++) {
+    Address address;
+    address.asArray()[0] = i & 0xFF;
+    address.asArray()[1] = (i >> 8) & 0xFF;
+    address.asArray()[2] = (i >> 16) & 0xFF;
+    AccountStore::GetInstance().AddAccount(address, {i + 1, i});
+    addresses.emplace_back(address);
+  }
+  AccountStore::GetInstance().UpdateStateTrieAll();
+  AccountStore::GetInstance().MoveUpdatesToDisk();
+  auto root = AccountStore::GetInstance().GetStateRootHash();
+
+  // Drop everything held in memory, as after a restart
+  AccountStore::GetInstance().DiscardUnsavedUpdates();
+
+  auto start = chrono::steady_clock::now();
+  BOOST_CHECK_MESSAGE(AccountStore::GetInstance().RetrieveFromDisk(),
+                      "RetrieveFromDisk failed!");
+  auto retrieved = chrono::steady_clock::now();
+
+  BOOST_CHECK_MESSAGE(AccountStore::GetInstance().GetStateRootHash() == root,
+                      "Wrong root: RetrieveFromDisk did not restore the root!");
+
+  // State served to joining nodes must include accounts not yet paged in
+  vector<unsigned char> serialized;
+  AccountStore::GetInstance().Serialize(serialized, 0);
+  BOOST_CHECK_MESSAGE(
+      Serializable::GetNumber<boost::multiprecision::uint256_t>(
+          serialized, 0, UINT256_SIZE) == NUM_ACCOUNTS,
+      "Wrong count: Serialize skipped accounts on disk!");
+
+  Account copy;
+  BOOST_CHECK_MESSAGE(
+      AccountStore::GetInstance().GetAccountCopy(addresses.back(), copy) &&
+          copy.GetBalance() == NUM_ACCOUNTS,
+      "Wrong balance: GetAccountCopy did not page in the account!");
+
+  for (unsigned int i = 0; i < NUM_ACCOUNTS; i++) {
+    BOOST_CHECK_MESSAGE(
+        AccountStore::GetInstance().GetBalance(addresses[i]) == i + 1,
+        "Wrong balance: account was not paged in from the trie!");
+  }
+  auto pagedIn = chrono::steady_clock::now();
+
+  LOG_GENERAL(
+      INFO, "RetrieveFromDisk ("
+                << (LAZY_STATE_LOADING ? "lazy" : "eager") << ") of "
+                << NUM_ACCOUNTS << " accounts took "
+                << chrono::duration_cast<chrono::milliseconds>(retrieved -
+                                                               start)
+                       .count()
+                << " ms, reading all of them took "
+                << chrono::duration_cast<chrono::milliseconds>(pagedIn -
+                                                               retrieved)
+                       .count()
+                << " ms");
+}
+
+BOOST_AUTO_TEST_CASE(mergeShardDeltas) {
+  INIT_STDOUT_LOGGER();
+
+  LOG_MARKER();
+
+  AccountStore::GetInstance().Init();
+
+  Address sender, receiver;
+  sender.asArray()[0] = 1;
+  receiver.asArray()[0] = 2;
+  const Account senderAccount(100, 0), receiverAccount(100, 0);
+  AccountStore::GetInstance().AddAccount(sender, senderAccount);
+  AccountStore::GetInstance().AddAccount(receiver, receiverAccount);
+  AccountStore::GetInstance().MoveUpdatesToDisk();
+
+  // [Number of accounts] [Addr 1] [AccountDelta 1] [Addr 2] [AccountDelta 2]
+  auto makeDelta = [&](const Account& newSender, const Account& newReceiver) {
+    vector<unsigned char> delta;
+    Serializable::SetNumber<boost::multiprecision::uint256_t>(delta, 0, 2,
+                                                              UINT256_SIZE);
+    for (const auto& change : {make_pair(sender, newSender),
+                               make_pair(receiver, newReceiver)}) {
+      const auto& address = change.first.asBytes();
+      delta.insert(delta.end(), address.begin(), address.end());
+      Account old = change.first == sender ? senderAccount : receiverAccount;
+      Account::SerializeDelta(delta, delta.size(), &old, change.second);
+    }
+    return delta;
+  };
+
+  // Both shards send from the same account, only one of them may do that
+  const auto delta1 = makeDelta({90, 1}, {110, 0});
+  const auto delta2 = makeDelta({95, 1}, {105, 0});
+
+  AccountStore::GetInstance().InitTemp();
+  BOOST_CHECK_EQUAL(AccountStore::GetInstance().MergeShardDeltaTemp(delta1, 0),
+                    0);
+  BOOST_CHECK_EQUAL(AccountStore::GetInstance().MergeShardDeltaTemp(delta2, 1),
+                    1);
+  BOOST_CHECK_EQUAL(AccountStore::GetInstance().GetNonceTemp(sender), 2);
+
+  AccountStore::GetInstance().SerializeDelta(0);
+  vector<unsigned char> merged;
+  AccountStore::GetInstance().GetSerializedDelta(merged);
+  const StateHash mergedHash = AccountStore::GetInstance().GetStateDeltaHash();
+  BOOST_CHECK(mergedHash != StateHash());
+
+  // Replaying the shard deltas gives the same combined delta
+  AccountStore::GetInstance().InitTemp();
+  BOOST_CHECK_EQUAL(AccountStore::GetInstance().GetStateDeltaHash(),
+                    StateHash());
+  BOOST_CHECK_EQUAL(
+      AccountStore::GetInstance().DeserializeDeltasTemp({delta1, delta2}), 0);
+  AccountStore::GetInstance().SerializeDelta(0);
+  vector<unsigned char> replayed;
+  AccountStore::GetInstance().GetSerializedDelta(replayed);
+  BOOST_CHECK(replayed == merged);
+  BOOST_CHECK_EQUAL(AccountStore::GetInstance().GetStateDeltaHash(),
+                    mergedHash);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -56,20 +56,20 @@ BOOST_AUTO_TEST_CASE(MultiIndex_test) {
   LOG_GENERAL(INFO, "mark1");
 
   // container.insert(tx1);
-  listIdx.insert(tx1);
-  listIdx.insert(tx2);
-  listIdx.insert(tx3);
+  listIdx.insert(make_shared<Transaction>(tx1));
+  listIdx.insert(make_shared<Transaction>(tx2));
+  listIdx.insert(make_shared<Transaction>(tx3));
 
   BOOST_CHECK_MESSAGE(listIdx.size() == 3, "listIdx size doesn't match");
 
   uint256_t index = 1;
 
-  for (Transaction tx : listIdx) {
-    LOG_GENERAL(INFO, "Tx nonce: " << tx.GetNonce());
-    BOOST_CHECK_MESSAGE(tx.GetNonce() == index,
+  for (const TransactionPtr& tx : listIdx) {
+    LOG_GENERAL(INFO, "Tx nonce: " << tx->GetNonce());
+    BOOST_CHECK_MESSAGE(tx->GetNonce() == index,
                         "transaction got from listIdx is not correctly "
                         "ordered by gasPrice, current nonce: "
-                            << tx.GetNonce() << " desired nonce: " << index);
+                            << tx->GetNonce() << " desired nonce: " << index);
     index++;
   }
 
@@ -80,12 +80,12 @@ BOOST_AUTO_TEST_CASE(MultiIndex_test) {
 
   BOOST_CHECK_MESSAGE(hashIdx.end() != it, "txn is not found");
 
-  BOOST_CHECK_MESSAGE(*it == tx1, "txn found in hashIdx is not identical");
+  BOOST_CHECK_MESSAGE(**it == tx1, "txn found in hashIdx is not identical");
 
   auto& compIdx = container.get<MULTI_INDEX_KEY::PUBKEY_NONCE>();
   auto it2 = compIdx.find(make_tuple(tx2.GetSenderPubKey(), tx2.GetNonce()));
   BOOST_CHECK_MESSAGE(compIdx.end() != it2, "txn is not found");
-  BOOST_CHECK_MESSAGE(*it2 == tx2, "txn found in compIdx is not identical");
+  BOOST_CHECK_MESSAGE(**it2 == tx2, "txn found in compIdx is not identical");
 }
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2018 Zilliqa
+ * This source code is being disclosed to you solely for the purpose of your
+ * participation in testing Zilliqa. You may view, compile and run the code for
+ * that purpose and pursuant to the protocols and algorithms that are programmed
+ * into, and intended by, the code. You may not do anything else with the code
+ * without express permission from Zilliqa Research Pte. Ltd., including
+ * modifying or publishing the code (or any part of it), and developing or
+ * forming another public or private blockchain network. This source code is
+ * provided 'as is' and no warranties are given as to title or non-infringement,
+ * merchantability or fitness for purpose and, to the extent permitted by law,
+ * all liability for your use of the code is disclaimed. Some programs in this
+ * code are governed by the GNU General Public License v3.0 (available at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html) ('GPLv3'). The programs that
+ * are governed by GPLv3.0 are those programs that are located in the folders
+ * src/depends and tests/depends and which include a reference to GPLv3 in their
+ * program files.
+ */
+
+#include <memory>
+#include <vector>
+
+#include "libCrypto/Schnorr.h"
+#include "libData/AccountData/Account.h"
+#include "libData/AccountData/Transaction.h"
+#include "libData/DataStructures/MultiIndexContainer.h"
+#include "libData/DataStructures/SpentTxnStage.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE spenttxnstagetest
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+using namespace boost::multiprecision;
+
+BOOST_AUTO_TEST_SUITE(spenttxnstagetest)
+
+TransactionPtr MakeTransaction(const KeyPair& sender, const uint256_t& nonce,
+                               const uint256_t& gasPrice) {
+  return make_shared<Transaction>(1, nonce, NullAddress, sender, 1, gasPrice,
+                                  1, vector<unsigned char>(),
+                                  vector<unsigned char>());
+}
+
+BOOST_AUTO_TEST_CASE(test_stage_and_restore) {
+  INIT_STDOUT_LOGGER();
+
+  const KeyPair sender1 = Schnorr::GetInstance().GenKeyPair();
+  const KeyPair sender2 = Schnorr::GetInstance().GenKeyPair();
+  const Address addr1 = Account::GetAddressFromPublicKey(sender1.second);
+
+  gas_txnid_comp_txns pool;
+  for (unsigned int nonce = 1; nonce <= 4; nonce++) {
+    pool.insert(MakeTransaction(sender1, nonce, 10));
+    pool.insert(MakeTransaction(sender2, nonce, 10));
+  }
+
+  const auto candidates = SpentTxnStage::Snapshot(pool);
+  BOOST_CHECK_EQUAL(candidates.size(), 8);
+
+  // sender1 has spent nonces 1 and 2, sender2 none; each is looked up once
+  unsigned int lookups = 0;
+  const vector<TxnHash> spent = SpentTxnStage::FindSpent(
+      candidates, [&](const Address& addr) -> uint256_t {
+        lookups++;
+        return (addr == addr1) ? 3 : 1;
+      });
+  BOOST_CHECK_EQUAL(lookups, 2);
+  BOOST_CHECK_EQUAL(spent.size(), 2);
+
+  // A txn taken out of the pool after the snapshot is not staged
+  auto& compIdx = pool.get<MULTI_INDEX_KEY::PUBKEY_NONCE>();
+  compIdx.erase(compIdx.find(make_tuple(sender1.second, uint256_t(1))));
+
+  SpentTxnStage stage;
+  BOOST_CHECK_EQUAL(stage.Stage(pool, spent), 1);
+  BOOST_CHECK_EQUAL(stage.size(), 1);
+  BOOST_CHECK_EQUAL(pool.size(), 6);
+  BOOST_CHECK(compIdx.find(make_tuple(sender1.second, uint256_t(2))) ==
+              compIdx.end());
+
+  // A higher priced txn received meanwhile with the same nonce is kept
+  pool.insert(MakeTransaction(sender1, 2, 20));
+  stage.Restore(pool);
+  BOOST_CHECK(stage.empty());
+  BOOST_CHECK_EQUAL(pool.size(), 7);
+  auto it = compIdx.find(make_tuple(sender1.second, uint256_t(2)));
+  BOOST_REQUIRE(it != compIdx.end());
+  BOOST_CHECK_EQUAL((*it)->GetGasPrice(), 20);
+
+  // A staged txn priced higher replaces the one in the pool
+  BOOST_CHECK_EQUAL(stage.Stage(pool, {(*it)->GetTranID()}), 1);
+  pool.insert(MakeTransaction(sender1, 2, 5));
+  stage.Restore(pool);
+  it = compIdx.find(make_tuple(sender1.second, uint256_t(2)));
+  BOOST_REQUIRE(it != compIdx.end());
+  BOOST_CHECK_EQUAL((*it)->GetGasPrice(), 20);
+  BOOST_CHECK_EQUAL(pool.size(), 7);
+
+  // Txns gone from the pool are skipped, and dropped txns are not put back
+  BOOST_CHECK_EQUAL(stage.Stage(pool, spent), 0);
+  BOOST_CHECK_EQUAL(stage.Stage(pool, {(*it)->GetTranID()}), 1);
+  stage.clear();
+  stage.Restore(pool);
+  BOOST_CHECK_EQUAL(pool.size(), 6);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
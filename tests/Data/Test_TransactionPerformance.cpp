@@ -18,13 +18,19 @@
  */
 
 #include <array>
+#include <atomic>
+#include <cstdlib>
+#include <new>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include "libCrypto/Schnorr.h"
 #include "libCrypto/Sha2.h"
 #include "libData/AccountData/Account.h"
 #include "libData/AccountData/Address.h"
 #include "libData/AccountData/Transaction.h"
+#include "libData/AccountData/TransactionReceipt.h"
+#include "libData/DataStructures/MultiIndexContainer.h"
 #include "libUtils/DataConversion.h"
 #include "libUtils/Logger.h"
 
@@ -37,6 +43,22 @@ using namespace std;
 
 using KeyPair = std::pair<PrivKey, PubKey>;
 
+// Counts heap allocations made by this test program
+static std::atomic<size_t> g_allocCount(0);
+
+void* operator new(size_t size) {
+  g_allocCount++;
+  void* p = malloc(size);
+  if (p == nullptr) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void operator delete(void* p) noexcept { free(p); }
+
+void operator delete(void* p, size_t) noexcept { free(p); }
+
 BOOST_AUTO_TEST_SUITE(TransactionPrefillPerformance)
 
 // decltype(auto) GenWithSigning(const KeyPair& sender, const KeyPair& receiver,
@@ -229,4 +251,74 @@ BOOST_AUTO_TEST_CASE(GenTxn1000) {
                 << " ms");
 }
 
+// Takes txns through the node's mempool path: created txns container,
+// selection, processed txns map, and the list of txns to send.
+// Returns the number of heap allocations per txn.
+double HandoffAllocationsPerTxn(const std::vector<Transaction>& txns,
+                                bool useMove) {
+  std::vector<Transaction> input(txns);
+  gas_txnid_comp_txns createdTransactions;
+  std::unordered_map<TxnHash, TransactionWithReceipt> processedTransactions;
+  std::vector<TransactionWithReceipt> txns_to_send;
+  processedTransactions.reserve(input.size());
+  txns_to_send.reserve(input.size());
+
+  size_t start = g_allocCount;
+
+  for (auto& tx : input) {
+    if (useMove) {
+      createdTransactions.insert(std::make_shared<Transaction>(std::move(tx)));
+    } else {
+      createdTransactions.insert(std::make_shared<Transaction>(tx));
+    }
+  }
+
+  auto& listIdx = createdTransactions.get<MULTI_INDEX_KEY::GAS_PRICE>();
+  while (!listIdx.empty()) {
+    Transaction t;
+    TransactionReceipt tr;
+    TransactionPtr found = *listIdx.begin();
+    listIdx.erase(listIdx.begin());
+
+    const TxnHash tranID = found->GetTranID();
+    if (useMove) {
+      t = std::move(*found);
+      processedTransactions.emplace(
+          tranID, TransactionWithReceipt(std::move(t), std::move(tr)));
+    } else {
+      t = *found;
+      processedTransactions.emplace(tranID, TransactionWithReceipt(t, tr));
+    }
+  }
+
+  for (auto& it : processedTransactions) {
+    if (useMove) {
+      txns_to_send.emplace_back(std::move(it.second));
+    } else {
+      txns_to_send.emplace_back(it.second);
+    }
+  }
+
+  return static_cast<double>(g_allocCount - start) / txns.size();
+}
+
+BOOST_AUTO_TEST_CASE(TxnHandoffAllocations) {
+  INIT_STDOUT_LOGGER();
+
+  auto n = 1000u;
+  auto sender = Schnorr::GetInstance().GenKeyPair();
+  auto receiver = Schnorr::GetInstance().GenKeyPair();
+
+  auto txns = GenWithDummyValue(sender, receiver, n);
+
+  double copyAllocs = HandoffAllocationsPerTxn(txns, false);
+  double moveAllocs = HandoffAllocationsPerTxn(txns, true);
+
+  LOG_GENERAL(INFO, "Allocations per txn with copies: " << copyAllocs);
+  LOG_GENERAL(INFO, "Allocations per txn with moves:  " << moveAllocs);
+
+  BOOST_CHECK_MESSAGE(moveAllocs < copyAllocs,
+                      "Moving txns should allocate less than copying them");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2018 Zilliqa
+ * This source code is being disclosed to you solely for the purpose of your
+ * participation in testing Zilliqa. You may view, compile and run the code for
+ * that purpose and pursuant to the protocols and algorithms that are programmed
+ * into, and intended by, the code. You may not do anything else with the code
+ * without express permission from Zilliqa Research Pte. Ltd., including
+ * modifying or publishing the code (or any part of it), and developing or
+ * forming another public or private blockchain network. This source code is
+ * provided 'as is' and no warranties are given as to title or non-infringement,
+ * merchantability or fitness for purpose and, to the extent permitted by law,
+ * all liability for your use of the code is disclaimed. Some programs in this
+ * code are governed by the GNU General Public License v3.0 (available at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html) ('GPLv3'). The programs that
+ * are governed by GPLv3.0 are those programs that are located in the folders
+ * src/depends and tests/depends and which include a reference to GPLv3 in their
+ * program files.
+ */
+
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "libCrypto/Schnorr.h"
+#include "libData/AccountData/Address.h"
+#include "libData/AccountData/Transaction.h"
+#include "libData/DataStructures/TxnPool.h"
+#include "libUtils/Logger.h"
+#include "libUtils/TimeUtils.h"
+
+#define BOOST_TEST_MODULE txnpooltest
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+using namespace boost::multiprecision;
+
+BOOST_AUTO_TEST_SUITE(txnpooltest)
+
+Address MakeAddress(unsigned int i) {
+  Address addr;
+  for (unsigned int j = 0; j < sizeof(i); j++) {
+    addr.asArray().at(j) = (i >> (8 * j)) & 0xFF;
+  }
+  return addr;
+}
+
+Transaction MakeTransaction(const KeyPair& sender, const uint256_t& nonce,
+                            const uint256_t& gasPrice,
+                            const uint256_t& amount = 1) {
+  return Transaction(1, nonce, NullAddress, sender, amount, gasPrice, 1, {},
+                     {});
+}
+
+BOOST_AUTO_TEST_CASE(test_ready_order) {
+  INIT_STDOUT_LOGGER();
+
+  KeyPair sender = Schnorr::GetInstance().GenKeyPair();
+  Address addr1 = MakeAddress(1), addr2 = MakeAddress(2);
+
+  TxnPool pool;
+  Transaction t;
+
+  // addr1 has nonce 1 and 3 pending, addr2 has nonce 2 pending
+  BOOST_CHECK(pool.Insert(addr1, MakeTransaction(sender, 1, 10), 1));
+  BOOST_CHECK(pool.Insert(addr1, MakeTransaction(sender, 3, 30), 1));
+  BOOST_CHECK(pool.Insert(addr2, MakeTransaction(sender, 2, 20), 1));
+  BOOST_CHECK(pool.size() == 3);
+  BOOST_CHECK(pool.ready_size() == 1);
+
+  // Same nonce keeps the higher gas price only
+  BOOST_CHECK(!pool.Insert(addr1, MakeTransaction(sender, 1, 5), 1));
+  BOOST_CHECK(pool.Insert(addr1, MakeTransaction(sender, 1, 15), 1));
+  BOOST_CHECK(pool.size() == 3);
+
+  // Stale nonce is rejected
+  BOOST_CHECK(!pool.Insert(addr2, MakeTransaction(sender, 0, 100), 1));
+
+  BOOST_REQUIRE(pool.PopReady(t));
+  BOOST_CHECK(t.GetNonce() == 1 && t.GetGasPrice() == 15);
+
+  // addr1 nonce 3 is not ready until nonce 2 has been applied
+  BOOST_CHECK(!pool.PopReady(t));
+  pool.SetNextNonce(addr1, 2);
+  BOOST_CHECK(!pool.PopReady(t));
+
+  // addr2 becomes ready once its account nonce catches up
+  pool.Refresh([&addr2](const Address& addr) -> uint256_t {
+    return (addr == addr2) ? 2 : 3;
+  });
+  BOOST_CHECK(pool.ready_size() == 2);
+
+  // Highest head gas price comes first
+  BOOST_REQUIRE(pool.PopReady(t));
+  BOOST_CHECK(t.GetNonce() == 3 && t.GetGasPrice() == 30);
+  BOOST_REQUIRE(pool.PopReady(t));
+  BOOST_CHECK(t.GetNonce() == 2 && t.GetGasPrice() == 20);
+  BOOST_CHECK(!pool.PopReady(t));
+  BOOST_CHECK(pool.empty());
+
+  // Moving the nonce past pending transactions drops them
+  BOOST_CHECK(pool.Insert(addr1, MakeTransaction(sender, 5, 1), 4));
+  BOOST_CHECK(pool.Insert(addr1, MakeTransaction(sender, 6, 1), 4));
+  pool.SetNextNonce(addr1, 6);
+  BOOST_CHECK(pool.size() == 1 && pool.ready_size() == 1);
+  pool.clear();
+  BOOST_CHECK(pool.empty() && pool.ready_size() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_build_microblock) {
+  INIT_STDOUT_LOGGER();
+
+  const unsigned int num_senders = 10000;
+  const unsigned int txns_per_sender = 10;
+  const unsigned int num_gaps = 2;
+  const unsigned int microblock_size = 10000;
+
+  KeyPair sender = Schnorr::GetInstance().GenKeyPair();
+  mt19937 rng(0);
+
+  // Each sender has nonces 1..(txns_per_sender + num_gaps) minus a few
+  // missing ones, so only the part before the first gap can execute
+  vector<pair<Address, Transaction>> pending;
+  pending.reserve(num_senders * txns_per_sender);
+  for (unsigned int i = 0; i < num_senders; i++) {
+    vector<unsigned int> nonces(txns_per_sender + num_gaps);
+    iota(nonces.begin(), nonces.end(), 1);
+    shuffle(nonces.begin(), nonces.end(), rng);
+    nonces.resize(txns_per_sender);
+
+    Address addr = MakeAddress(i);
+    for (const auto& nonce : nonces) {
+      // Amount tells apart the txns of different senders
+      pending.emplace_back(addr,
+                           MakeTransaction(sender, nonce, rng() % 1000, i));
+    }
+  }
+
+  LOG_GENERAL(INFO, "Generated " << pending.size() << " pending txns from "
+                                 << num_senders << " senders");
+
+  // Previous approach: scan all senders for a ready one on every selection
+  {
+    unordered_map<Address, map<uint256_t, Transaction>> addrNonceTxnMap;
+    unordered_map<Address, uint256_t> accountNonces;
+    for (const auto& p : pending) {
+      addrNonceTxnMap[p.first].emplace(p.second.GetNonce(), p.second);
+    }
+
+    auto t = r_timer_start();
+    unsigned int selected = 0;
+    while (selected < microblock_size) {
+      bool found = false;
+      for (auto it = addrNonceTxnMap.begin(); it != addrNonceTxnMap.end();
+           it++) {
+        if (it->second.begin()->first == accountNonces[it->first] + 1) {
+          accountNonces[it->first] = it->second.begin()->first;
+          it->second.erase(it->second.begin());
+          if (it->second.empty()) {
+            addrNonceTxnMap.erase(it);
+          }
+          found = true;
+          break;
+        }
+      }
+      if (!found) {
+        break;
+      }
+      selected++;
+    }
+    LOG_GENERAL(INFO, "Scan: selected " << selected << " txns (usec) = "
+                                        << r_timer_end(t));
+  }
+
+  // Nonce-ready index
+  {
+    TxnPool pool;
+    unordered_map<Address, Uint256> accountNonces;
+    for (const auto& p : pending) {
+      pool.Insert(p.first, p.second, accountNonces[p.first] + 1);
+    }
+    BOOST_CHECK(pool.size() == pending.size());
+
+    // Transactions do not carry the synthetic sender addresses
+    unordered_map<TxnHash, Address> senderOf;
+    for (const auto& p : pending) {
+      senderOf.emplace(p.second.GetTranID(), p.first);
+    }
+
+    auto t = r_timer_start();
+    unsigned int selected = 0;
+    Transaction txn;
+    while (selected < microblock_size && pool.PopReady(txn)) {
+      const Address& addr = senderOf.at(txn.GetTranID());
+      BOOST_CHECK_MESSAGE(txn.GetNonce() == accountNonces[addr] + 1,
+                          "Selected txn nonce is not executable");
+      accountNonces[addr] = txn.GetNonce();
+      pool.SetNextNonce(addr, txn.GetNonce() + 1);
+      selected++;
+    }
+    LOG_GENERAL(INFO, "TxnPool: selected " << selected << " txns (usec) = "
+                                           << r_timer_end(t));
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2018 Zilliqa
+ * This source code is being disclosed to you solely for the purpose of your
+ * participation in testing Zilliqa. You may view, compile and run the code for
+ * that purpose and pursuant to the protocols and algorithms that are programmed
+ * into, and intended by, the code. You may not do anything else with the code
+ * without express permission from Zilliqa Research Pte. Ltd., including
+ * modifying or publishing the code (or any part of it), and developing or
+ * forming another public or private blockchain network. This source code is
+ * provided 'as is' and no warranties are given as to title or non-infringement,
+ * merchantability or fitness for purpose and, to the extent permitted by law,
+ * all liability for your use of the code is disclaimed. Some programs in this
+ * code are governed by the GNU General Public License v3.0 (available at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html) ('GPLv3'). The programs that
+ * are governed by GPLv3.0 are those programs that are located in the folders
+ * src/depends and tests/depends and which include a reference to GPLv3 in their
+ * program files.
+ */
+
+#include <random>
+#include <vector>
+
+#include "common/Constants.h"
+#include "common/Uint256.h"
+#include "libUtils/Logger.h"
+#include "libUtils/SafeMath.h"
+#include "libUtils/TimeUtils.h"
+
+#define BOOST_TEST_MODULE uint256test
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+using namespace boost::multiprecision;
+
+BOOST_AUTO_TEST_SUITE(uint256test)
+
+uint256_t RandomNumber(mt19937_64& rng) {
+  // Random width so that small values, like real balances and gas, show up
+  uint256_t result = 0;
+  const unsigned int numLimbs = rng() % 5;
+  for (unsigned int i = 0; i < numLimbs; i++) {
+    result <<= 64;
+    result |= rng() >> (rng() % 64);
+  }
+  return result;
+}
+
+BOOST_AUTO_TEST_CASE(test_matches_boost) {
+  INIT_STDOUT_LOGGER();
+
+  mt19937_64 rng(1);
+  for (unsigned int i = 0; i < 100000; i++) {
+    const uint256_t a = RandomNumber(rng);
+    const uint256_t b = RandomNumber(rng);
+    const Uint256 ua = a, ub = b;
+
+    BOOST_REQUIRE(uint256_t(ua) == a);
+    BOOST_REQUIRE(uint256_t(ua + ub) == uint256_t(a + b));
+    BOOST_REQUIRE(uint256_t(ua - ub) == uint256_t(a - b));
+    BOOST_REQUIRE(uint256_t(ua * ub) == uint256_t(a * b));
+    if (b != 0) {
+      BOOST_REQUIRE(uint256_t(ua / ub) == a / b);
+      BOOST_REQUIRE(uint256_t(ua % ub) == a % b);
+    }
+    BOOST_REQUIRE((ua < ub) == (a < b));
+    BOOST_REQUIRE((ua == ub) == (a == b));
+    BOOST_REQUIRE(ua.str() == a.str());
+
+    const unsigned int shift = rng() % 256;
+    BOOST_REQUIRE(uint256_t(ua << shift) == uint256_t(a << shift));
+    BOOST_REQUIRE(uint256_t(ua >> shift) == uint256_t(a >> shift));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_checked_arithmetic) {
+  INIT_STDOUT_LOGGER();
+
+  const uint512_t max = (uint512_t(1) << 256) - 1;
+  mt19937_64 rng(2);
+  for (unsigned int i = 0; i < 100000; i++) {
+    const uint256_t a = RandomNumber(rng);
+    const uint256_t b = RandomNumber(rng);
+    const Uint256 ua = a, ub = b;
+    Uint256 result = 7;
+
+    BOOST_REQUIRE(Uint256::CheckedAdd(ua, ub, result) ==
+                  (uint512_t(a) + b <= max));
+    BOOST_REQUIRE(Uint256::CheckedSub(ua, ub, result) == (a >= b));
+    BOOST_REQUIRE(Uint256::CheckedMul(ua, ub, result) ==
+                  (uint512_t(a) * b <= max));
+  }
+
+  const Uint256 maxValue = Uint256(0) - 1;
+  Uint256 result = 7;
+  BOOST_CHECK(!SafeMath<Uint256>::add(maxValue, 1, result));
+  BOOST_CHECK(!SafeMath<Uint256>::sub(1, 2, result));
+  BOOST_CHECK(!SafeMath<Uint256>::mul(maxValue, 2, result));
+  BOOST_CHECK(!SafeMath<Uint256>::div(maxValue, 0, result));
+  BOOST_CHECK(result == 7);
+  BOOST_CHECK(SafeMath<Uint256>::mul(maxValue, 1, result));
+  BOOST_CHECK(result == maxValue);
+
+  static_assert(Uint256(3) * Uint256(5) + Uint256(1) == Uint256(16),
+                "Arithmetic should be usable in constant expressions");
+  static_assert(is_trivially_copyable<Uint256>::value,
+                "Uint256 should be trivially copyable");
+}
+
+BOOST_AUTO_TEST_CASE(test_serialization) {
+  INIT_STDOUT_LOGGER();
+
+  mt19937_64 rng(3);
+  for (unsigned int i = 0; i < 10000; i++) {
+    const uint256_t a = RandomNumber(rng);
+
+    vector<unsigned char> expected(3), actual(3);
+    Serializable::SetNumber<uint256_t>(expected, 3, a, UINT256_SIZE);
+    Serializable::SetNumber<Uint256>(actual, 3, a, UINT256_SIZE);
+    BOOST_REQUIRE(expected == actual);
+    BOOST_REQUIRE(Serializable::GetNumber<Uint256>(actual, 3, UINT256_SIZE) ==
+                  a);
+
+    // Shorter fields, e.g. UINT128_SIZE, keep the low bytes
+    vector<unsigned char> expectedShort, actualShort;
+    Serializable::SetNumber<uint256_t>(expectedShort, 0, a, UINT128_SIZE);
+    Serializable::SetNumber<Uint256>(actualShort, 0, a, UINT128_SIZE);
+    BOOST_REQUIRE(expectedShort == actualShort);
+    BOOST_REQUIRE(
+        Serializable::GetNumber<Uint256>(actualShort, 0, UINT128_SIZE) ==
+        Serializable::GetNumber<uint256_t>(expectedShort, 0, UINT128_SIZE));
+  }
+}
+
+struct Transfer {
+  uint256_t m_amount;
+  uint256_t m_gasPrice;
+  uint256_t m_gasLimit;
+};
+
+/// The checks AccountStoreBase::UpdateAccounts makes on a normal transfer
+template <class T>
+bool ValidateTransfer(T& balance, const T& amount, const T& gasPrice,
+                      const T& gasLimit) {
+  T gasDeposit;
+  if (!SafeMath<T>::mul(gasLimit, gasPrice, gasDeposit)) {
+    return false;
+  }
+  T totalCost;
+  if (!SafeMath<T>::add(amount, gasDeposit, totalCost)) {
+    return false;
+  }
+  if (balance < totalCost) {
+    return false;
+  }
+  return SafeMath<T>::sub(balance, totalCost, balance);
+}
+
+template <class T>
+double TimeTransfers(const vector<Transfer>& transfers, unsigned int& valid) {
+  vector<T> amounts, gasPrices, gasLimits;
+  for (const auto& t : transfers) {
+    amounts.emplace_back(t.m_amount);
+    gasPrices.emplace_back(t.m_gasPrice);
+    gasLimits.emplace_back(t.m_gasLimit);
+  }
+
+  T balance = T(uint256_t(1) << 200);
+  valid = 0;
+  auto start = r_timer_start();
+  for (unsigned int i = 0; i < transfers.size(); i++) {
+    if (ValidateTransfer(balance, amounts[i], gasPrices[i], gasLimits[i])) {
+      valid++;
+    }
+  }
+  return r_timer_end(start);
+}
+
+BOOST_AUTO_TEST_CASE(test_transfer_validation_performance) {
+  INIT_STDOUT_LOGGER();
+
+  mt19937_64 rng(4);
+  vector<Transfer> transfers(500000);
+  for (auto& t : transfers) {
+    t.m_amount = uint256_t(rng() % 1000000000) * 1000000000;
+    t.m_gasPrice = 100 + rng() % 1000;
+    t.m_gasLimit = 1 + rng() % 10000;
+  }
+
+  unsigned int validBoost = 0, validFixed = 0;
+  const double boostTime = TimeTransfers<uint256_t>(transfers, validBoost);
+  const double fixedTime = TimeTransfers<Uint256>(transfers, validFixed);
+
+  BOOST_CHECK_EQUAL(validBoost, validFixed);
+  LOG_GENERAL(INFO, "Validated " << transfers.size() << " transfers: uint256_t "
+                                 << boostTime << " usec, Uint256 " << fixedTime
+                                 << " usec");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,408 @@
+/*
+ * Copyright (c) 2018 Zilliqa
+ * This source code is being disclosed to you solely for the purpose of your
+ * participation in testing Zilliqa. You may view, compile and run the code for
+ * that purpose and pursuant to the protocols and algorithms that are programmed
+ * into, and intended by, the code. You may not do anything else with the code
+ * without express permission from Zilliqa Research Pte. Ltd., including
+ * modifying or publishing the code (or any part of it), and developing or
+ * forming another public or private blockchain network. This source code is
+ * provided 'as is' and no warranties are given as to title or non-infringement,
+ * merchantability or fitness for purpose and, to the extent permitted by law,
+ * all liability for your use of the code is disclaimed. Some programs in this
+ * code are governed by the GNU General Public License v3.0 (available at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html) ('GPLv3'). The programs that
+ * are governed by GPLv3.0 are those programs that are located in the folders
+ * src/depends and tests/depends and which include a reference to GPLv3 in their
+ * program files.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "depends/common/SHA3.h"
+#include "depends/libDatabase/LevelDB.h"
+#include "libCrypto/Schnorr.h"
+#include "libLookup/ChunkSync.h"
+#include "libMessage/Messenger.h"
+#include "libUtils/IPConverter.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE chunksync
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+namespace {
+const unsigned int NUM_NODES = 3000;
+const uint32_t CHUNK_SIZE = 8 * 1024;
+
+/// Stands in for a lookup serving its database on 127.0.0.1.
+struct FakeLookup {
+  LevelDB& m_db;
+  pair<PrivKey, PubKey> m_key;
+  bool m_corrupt;
+  atomic<unsigned int> m_served{0};
+
+  FakeLookup(LevelDB& db, bool corrupt = false)
+      : m_db(db),
+        m_key(Schnorr::GetInstance().GenKeyPair()),
+        m_corrupt(corrupt) {}
+};
+
+/// Carries requests and chunks through their wire encoding, each request
+/// answered from its own thread like over the network.
+class Loopback {
+  pair<PrivKey, PubKey> m_key = Schnorr::GetInstance().GenKeyPair();
+  map<uint32_t, FakeLookup*> m_lookups;
+  mutex m_mutexThreads;
+  vector<thread> m_threads;
+
+  void Serve(FakeLookup& lookup, ChunkSync& sync,
+             const vector<unsigned char>& request) {
+    PubKey requesterPubKey;
+    uint32_t portNo, maxBytes;
+    unsigned char dbType;
+    string rangeBegin, rangeEnd, startAfter;
+    if (!Messenger::GetLookupGetDBChunkFromLookup(
+            request, 0, requesterPubKey, portNo, dbType, rangeBegin, rangeEnd,
+            startAfter, maxBytes) ||
+        !(requesterPubKey == m_key.second)) {
+      return;
+    }
+
+    ChunkSync::Entries entries;
+    string lastKey;
+    bool complete = lookup.m_db.GetRange(rangeBegin, rangeEnd, startAfter,
+                                         maxBytes, entries, lastKey);
+    if (lookup.m_corrupt && !entries.empty()) {
+      entries.front().second += "x";
+    }
+
+    vector<unsigned char> chunk;
+    if (!Messenger::SetLookupSetDBChunkFromLookup(
+            chunk, 0, lookup.m_key, dbType, rangeBegin, startAfter, lastKey,
+            complete, entries)) {
+      return;
+    }
+    lookup.m_served++;
+
+    PubKey pubKey;
+    ChunkSync::Entries received;
+    if (!Messenger::GetLookupSetDBChunkFromLookup(chunk, 0, pubKey, dbType,
+                                                  rangeBegin, startAfter,
+                                                  lastKey, complete,
+                                                  received)) {
+      return;
+    }
+
+    sync.ProcessChunk(rangeBegin, startAfter, lastKey, received, complete);
+  }
+
+ public:
+  atomic<unsigned int> m_requests{0};
+
+  vector<Peer> AddLookups(const vector<FakeLookup*>& lookups) {
+    vector<Peer> peers;
+    for (auto lookup : lookups) {
+      Peer peer(IPConverter::ToNumericalIPFromStr("127.0.0.1"),
+                5001 + m_lookups.size());
+      m_lookups[peer.m_listenPortHost] = lookup;
+      peers.emplace_back(peer);
+    }
+    return peers;
+  }
+
+  ChunkSync::Requester GetRequester(ChunkSync*& sync) {
+    return [this, &sync](const Peer& peer, const string& rangeBegin,
+                         const string& rangeEnd, const string& startAfter,
+                         uint32_t maxBytes) {
+      vector<unsigned char> request;
+      if (!Messenger::SetLookupGetDBChunkFromLookup(
+              request, 0, m_key, 6000, SyncDBType::SYNC_STATE, rangeBegin,
+              rangeEnd, startAfter, maxBytes)) {
+        return false;
+      }
+      m_requests++;
+
+      FakeLookup* lookup = m_lookups.at(peer.m_listenPortHost);
+      ChunkSync* target = sync;
+      lock_guard<mutex> g(m_mutexThreads);
+      m_threads.emplace_back([this, lookup, target, request]() {
+        Serve(*lookup, *target, request);
+      });
+      return true;
+    };
+  }
+
+  void Join() {
+    lock_guard<mutex> g(m_mutexThreads);
+    for (auto& t : m_threads) {
+      t.join();
+    }
+    m_threads.clear();
+  }
+};
+
+ChunkSync::Entries ReadAll(const LevelDB& db) {
+  ChunkSync::Entries entries;
+  string lastKey;
+  db.GetRange("", "", "", numeric_limits<size_t>::max(), entries, lastKey);
+  return entries;
+}
+
+string NodeKey(const string& node) {
+  const dev::h256 hash = dev::sha3(node);
+  return string(reinterpret_cast<const char*>(hash.data()), hash.size);
+}
+
+/// Fills db with random state trie nodes keyed by their hash.
+void FillWithNodes(LevelDB& db) {
+  db.ResetDB();
+
+  mt19937 rng(1234);
+  uniform_int_distribution<int> size(50, 300);
+  uniform_int_distribution<int> byte(0, 255);
+
+  ChunkSync::Entries nodes;
+  for (unsigned int i = 0; i < NUM_NODES; i++) {
+    string value(size(rng), '\0');
+    for (auto& c : value) {
+      c = static_cast<char>(byte(rng));
+    }
+    nodes.emplace_back(NodeKey(value), value);
+  }
+  db.BatchInsert(nodes);
+}
+
+string TempCheckpointPath() {
+  return (boost::filesystem::temp_directory_path() /
+          boost::filesystem::unique_path("chunksync-%%%%%%%%.sync"))
+      .string();
+}
+
+unique_ptr<ChunkSync> MakeSync(LevelDB& dst, const string& checkpointPath,
+                               Loopback& network, ChunkSync*& syncPtr) {
+  unique_ptr<ChunkSync> sync(new ChunkSync(
+      SyncDBType::SYNC_STATE, checkpointPath, ChunkSync::VerifyStateNode,
+      [&dst](const ChunkSync::Entries& entries) {
+        return dst.BatchInsert(entries) == 0;
+      },
+      network.GetRequester(syncPtr)));
+  sync->SetChunkSize(CHUNK_SIZE);
+  sync->SetNumRanges(8);
+  sync->SetKeyAlphabet(ChunkSync::BINARY_KEY_ALPHABET);
+  sync->SetTimeouts(chrono::milliseconds(2000), chrono::seconds(60));
+  syncPtr = sync.get();
+  return sync;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(chunksync)
+
+BOOST_AUTO_TEST_CASE(test_split_key_space) {
+  INIT_STDOUT_LOGGER();
+
+  auto ranges = ChunkSync::SplitKeySpace(16, ChunkSync::HEX_KEY_ALPHABET);
+  BOOST_REQUIRE_EQUAL(ranges.size(), 16);
+  BOOST_CHECK_EQUAL(ranges.front().m_begin, "");
+  BOOST_CHECK_EQUAL(ranges[1].m_begin, "10");
+  BOOST_CHECK_EQUAL(ranges.back().m_begin, "f0");
+  BOOST_CHECK_EQUAL(ranges.back().m_end, "");
+  for (size_t i = 0; i + 1 < ranges.size(); i++) {
+    BOOST_CHECK_EQUAL(ranges[i].m_end, ranges[i + 1].m_begin);
+    BOOST_CHECK(ranges[i].m_begin < ranges[i + 1].m_begin);
+  }
+
+  BOOST_CHECK_EQUAL(
+      ChunkSync::SplitKeySpace(1000, ChunkSync::HEX_KEY_ALPHABET).size(), 256);
+
+  ranges = ChunkSync::SplitKeySpace(0, ChunkSync::HEX_KEY_ALPHABET);
+  BOOST_REQUIRE_EQUAL(ranges.size(), 1);
+  BOOST_CHECK(ranges[0].m_begin.empty() && ranges[0].m_end.empty());
+
+  ranges = ChunkSync::SplitKeySpace(4, ChunkSync::BINARY_KEY_ALPHABET);
+  BOOST_REQUIRE_EQUAL(ranges.size(), 4);
+  BOOST_CHECK(ranges[1].m_begin == string("\x40\x00", 2));
+  BOOST_CHECK(ranges[3].m_begin == string("\xc0\x00", 2));
+  BOOST_CHECK(ranges[2].m_begin < ranges[3].m_begin);
+}
+
+BOOST_AUTO_TEST_CASE(test_verifiers) {
+  INIT_STDOUT_LOGGER();
+
+  const string node = "some trie node";
+  BOOST_CHECK(ChunkSync::VerifyStateNode(NodeKey(node), node));
+  BOOST_CHECK(!ChunkSync::VerifyStateNode(NodeKey(node), node + "x"));
+  BOOST_CHECK(!ChunkSync::VerifyStateNode(dev::sha3(node).hex(), node));
+
+  auto key = Schnorr::GetInstance().GenKeyPair();
+  Transaction txn(0, 1, Address(), key, 10, 1, 1, {}, {});
+  TransactionWithReceipt body(txn, TransactionReceipt());
+  vector<unsigned char> serialized;
+  body.Serialize(serialized, 0);
+  string value(serialized.begin(), serialized.end());
+
+  BOOST_CHECK(ChunkSync::VerifyTxBody(txn.GetTranID().hex(), value));
+  BOOST_CHECK(!ChunkSync::VerifyTxBody(dev::sha3(value).hex(), value));
+  // Flip a byte of the amount
+  value[TRAN_HASH_SIZE + TRAN_SIG_SIZE + 40] ^= 1;
+  BOOST_CHECK(!ChunkSync::VerifyTxBody(txn.GetTranID().hex(), value));
+}
+
+BOOST_AUTO_TEST_CASE(test_sync_from_several_lookups) {
+  INIT_STDOUT_LOGGER();
+
+  LevelDB src("chunksync_src"), dst("chunksync_dst");
+  FillWithNodes(src);
+  dst.ResetDB();
+
+  FakeLookup lookup1(src), lookup2(src), lookup3(src);
+  Loopback network;
+  auto peers = network.AddLookups({&lookup1, &lookup2, &lookup3});
+
+  const string checkpointPath = TempCheckpointPath();
+  ChunkSync* syncPtr = nullptr;
+  auto sync = MakeSync(dst, checkpointPath, network, syncPtr);
+
+  BOOST_CHECK(sync->Run(peers));
+  network.Join();
+
+  BOOST_CHECK(ReadAll(dst) == ReadAll(src));
+  BOOST_CHECK(!boost::filesystem::exists(checkpointPath));
+  BOOST_CHECK(lookup1.m_served > 0);
+  BOOST_CHECK(lookup2.m_served > 0);
+  BOOST_CHECK(lookup3.m_served > 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_resume_from_checkpoint) {
+  INIT_STDOUT_LOGGER();
+
+  LevelDB src("chunksync_src"), dst("chunksync_dst");
+  FillWithNodes(src);
+  dst.ResetDB();
+
+  FakeLookup lookup1(src), lookup2(src);
+  Loopback network;
+  auto peers = network.AddLookups({&lookup1, &lookup2});
+  const string checkpointPath = TempCheckpointPath();
+
+  uint64_t firstBytes;
+  {
+    ChunkSync* syncPtr = nullptr;
+    auto sync = MakeSync(dst, checkpointPath, network, syncPtr);
+
+    // Interrupt the sync once a few chunks are in
+    thread stopper([&sync]() {
+      while (sync->GetChunksReceived() < 10) {
+        this_thread::sleep_for(chrono::milliseconds(1));
+      }
+      sync->Stop();
+    });
+
+    BOOST_CHECK(!sync->Run(peers));
+    stopper.join();
+    network.Join();
+    firstBytes = sync->GetBytesReceived();
+  }
+
+  BOOST_REQUIRE(boost::filesystem::exists(checkpointPath));
+  BOOST_CHECK(ReadAll(dst) != ReadAll(src));
+
+  ChunkSync* syncPtr = nullptr;
+  auto sync = MakeSync(dst, checkpointPath, network, syncPtr);
+  BOOST_CHECK(sync->Run(peers));
+  network.Join();
+
+  BOOST_CHECK(ReadAll(dst) == ReadAll(src));
+
+  // Only what was missing was fetched again
+  uint64_t totalBytes = 0;
+  for (const auto& entry : ReadAll(src)) {
+    totalBytes += entry.first.size() + entry.second.size();
+  }
+  BOOST_CHECK(firstBytes > 0);
+  BOOST_CHECK_LE(sync->GetBytesReceived(), totalBytes - firstBytes);
+}
+
+BOOST_AUTO_TEST_CASE(test_corrupted_chunks) {
+  INIT_STDOUT_LOGGER();
+
+  LevelDB src("chunksync_src"), dst("chunksync_dst");
+  FillWithNodes(src);
+  dst.ResetDB();
+
+  FakeLookup good(src), bad(src, true);
+  Loopback network;
+  auto peers = network.AddLookups({&bad, &good});
+
+  {
+    const string checkpointPath = TempCheckpointPath();
+    ChunkSync* syncPtr = nullptr;
+    auto sync = MakeSync(dst, checkpointPath, network, syncPtr);
+
+    BOOST_CHECK(sync->Run(peers));
+    network.Join();
+    BOOST_CHECK(ReadAll(dst) == ReadAll(src));
+  }
+
+  // With only a bad lookup the sync gives up
+  dst.ResetDB();
+  const string checkpointPath = TempCheckpointPath();
+  ChunkSync* syncPtr = nullptr;
+  auto sync = MakeSync(dst, checkpointPath, network, syncPtr);
+
+  BOOST_CHECK(!sync->Run({peers[0]}));
+  network.Join();
+  BOOST_CHECK(ReadAll(dst).empty());
+  boost::filesystem::remove(checkpointPath);
+}
+
+BOOST_AUTO_TEST_CASE(test_bandwidth_limit) {
+  INIT_STDOUT_LOGGER();
+
+  LevelDB src("chunksync_src"), dst("chunksync_dst");
+  FillWithNodes(src);
+  dst.ResetDB();
+
+  uint64_t totalBytes = 0;
+  for (const auto& entry : ReadAll(src)) {
+    totalBytes += entry.first.size() + entry.second.size();
+  }
+
+  FakeLookup lookup1(src), lookup2(src);
+  Loopback network;
+  auto peers = network.AddLookups({&lookup1, &lookup2});
+
+  const string checkpointPath = TempCheckpointPath();
+  ChunkSync* syncPtr = nullptr;
+  auto sync = MakeSync(dst, checkpointPath, network, syncPtr);
+
+  // About one second worth of data
+  sync->SetBandwidthLimit(totalBytes);
+
+  auto start = chrono::steady_clock::now();
+  BOOST_CHECK(sync->Run(peers));
+  auto elapsed = chrono::steady_clock::now() - start;
+  network.Join();
+
+  BOOST_CHECK(ReadAll(dst) == ReadAll(src));
+  BOOST_CHECK(elapsed > chrono::milliseconds(700));
+  LOG_GENERAL(INFO, "Synced " << totalBytes << " bytes in "
+                              << chrono::duration_cast<chrono::milliseconds>(
+                                     elapsed)
+                                     .count()
+                              << " ms with the cap");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -18,7 +18,9 @@
  */
 
 #include <iostream>
+#include "libCrypto/Schnorr.h"
 #include "libMessage/Message.pb.h"
+#include "libMessage/Messenger.h"
 #include "libUtils/Logger.h"
 
 #define BOOST_TEST_MODULE message
@@ -163,4 +165,58 @@ BOOST_AUTO_TEST_CASE(testMessage) {
   }
 }
 
-BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
+BOOST_AUTO_TEST_CASE(testForwardTxnBlock) {
+  INIT_STDOUT_LOGGER();
+
+  LOG_MARKER();
+
+  const auto lookupKey = Schnorr::GetInstance().GenKeyPair();
+  const auto senderKey = Schnorr::GetInstance().GenKeyPair();
+
+  vector<Transaction> txnsCurrent;
+  vector<unsigned char> txnsGenerated;
+  for (unsigned int i = 0; i < 4; i++) {
+    Transaction txn(1, i, Address(), senderKey, i, 1, 1,
+                    vector<unsigned char>(i, 'c'),
+                    vector<unsigned char>(i * 2, 'd'));
+    if (i % 2 == 0) {
+      txnsCurrent.emplace_back(txn);
+    } else {
+      txn.Serialize(txnsGenerated, txnsGenerated.size());
+    }
+  }
+
+  vector<unsigned char> message;
+  BOOST_CHECK(Messenger::SetNodeForwardTxnBlock(
+      message, 0, 5, 1, lookupKey, txnsCurrent, txnsGenerated));
+
+  uint64_t epochNumber = 0;
+  uint32_t shardId = 0;
+  PubKey lookupPubKey;
+  vector<Transaction> txns;
+  BOOST_CHECK(Messenger::GetNodeForwardTxnBlock(message, 0, epochNumber,
+                                                shardId, lookupPubKey, txns));
+  BOOST_CHECK(epochNumber == 5);
+  BOOST_CHECK(shardId == 1);
+  BOOST_CHECK(lookupPubKey == lookupKey.second);
+  BOOST_REQUIRE(txns.size() == 4);
+  BOOST_CHECK(txns.at(0) == txnsCurrent.at(0));
+  BOOST_CHECK(txns.at(1) == txnsCurrent.at(1));
+  BOOST_CHECK(txns.at(2) == Transaction(txnsGenerated, 0));
+  BOOST_CHECK(txns.at(3).GetCode().size() == 3);
+  BOOST_CHECK(txns.at(3).GetData().size() == 6);
+
+  // Any change to the transaction bytes breaks the lookup's signature
+  vector<unsigned char> tampered = message;
+  tampered.at(tampered.size() / 2) ^= 0xFF;
+  txns.clear();
+  BOOST_CHECK(!Messenger::GetNodeForwardTxnBlock(tampered, 0, epochNumber,
+                                                 shardId, lookupPubKey, txns));
+
+  // A truncated pre-generated stream is rejected rather than forwarded
+  txnsGenerated.pop_back();
+  BOOST_CHECK(!Messenger::SetNodeForwardTxnBlock(
+      message, 0, 5, 1, lookupKey, txnsCurrent, txnsGenerated));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
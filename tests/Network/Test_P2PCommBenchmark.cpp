@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2018 Zilliqa
+ * This source code is being disclosed to you solely for the purpose of your
+ * participation in testing Zilliqa. You may view, compile and run the code for
+ * that purpose and pursuant to the protocols and algorithms that are programmed
+ * into, and intended by, the code. You may not do anything else with the code
+ * without express permission from Zilliqa Research Pte. Ltd., including
+ * modifying or publishing the code (or any part of it), and developing or
+ * forming another public or private blockchain network. This source code is
+ * provided 'as is' and no warranties are given as to title or non-infringement,
+ * merchantability or fitness for purpose and, to the extent permitted by law,
+ * all liability for your use of the code is disclaimed. Some programs in this
+ * code are governed by the GNU General Public License v3.0 (available at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html) ('GPLv3'). The programs that
+ * are governed by GPLv3.0 are those programs that are located in the folders
+ * src/depends and tests/depends and which include a reference to GPLv3 in their
+ * program files.
+ */
+
+#include <arpa/inet.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+#include "libNetwork/P2PComm.h"
+#include "libNetwork/PeerConnectionPool.h"
+#include "libUtils/DetachedFunction.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE p2pcommbenchmark
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+static const uint32_t LISTEN_PORT = 30313;
+static const size_t TIMESTAMP_LEN = sizeof(int64_t);
+
+static mutex mutexReceived;
+static condition_variable cvReceived;
+static vector<double> latenciesInUs;
+
+int64_t NowInNs() {
+  return chrono::duration_cast<chrono::nanoseconds>(
+             chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void process_message(pair<vector<unsigned char>, Peer>* message) {
+  const int64_t received = NowInNs();
+
+  if (message->first.size() >= TIMESTAMP_LEN) {
+    int64_t sent = 0;
+    copy(message->first.begin(), message->first.begin() + TIMESTAMP_LEN,
+         reinterpret_cast<unsigned char*>(&sent));
+
+    lock_guard<mutex> g(mutexReceived);
+    latenciesInUs.emplace_back((received - sent) / 1000.0);
+    cvReceived.notify_all();
+  }
+
+  delete message;
+}
+
+struct Fixture {
+  Fixture() {
+    INIT_STDOUT_LOGGER();
+
+    static once_flag pumpStarted;
+    call_once(pumpStarted, []() {
+      auto func = []() mutable -> void {
+        P2PComm::GetInstance().StartMessagePump(LISTEN_PORT, process_message,
+                                                nullptr);
+      };
+      DetachedFunction(1, func);
+      this_thread::sleep_for(chrono::seconds(1));  // prepare socket
+    });
+  }
+};
+
+/// Sends numMsgs messages of msgSize bytes one after the other and reports
+/// throughput and latency as seen by the receiving dispatcher.
+void RunBenchmark(bool persistent, size_t msgSize, size_t numMsgs) {
+  PeerConnectionPool::GetInstance().SetEnabled(persistent);
+
+  {
+    lock_guard<mutex> g(mutexReceived);
+    latenciesInUs.clear();
+  }
+
+  struct in_addr ip_addr;
+  inet_aton("127.0.0.1", &ip_addr);
+  Peer peer(ip_addr.s_addr, LISTEN_PORT);
+
+  vector<unsigned char> message(msgSize, 'z');
+
+  auto start = chrono::steady_clock::now();
+
+  for (size_t i = 0; i < numMsgs; i++) {
+    int64_t sent = NowInNs();
+    copy(reinterpret_cast<unsigned char*>(&sent),
+         reinterpret_cast<unsigned char*>(&sent) + TIMESTAMP_LEN,
+         message.begin());
+    P2PComm::GetInstance().SendMessageNoQueue(peer, message);
+  }
+
+  vector<double> latencies;
+  {
+    unique_lock<mutex> g(mutexReceived);
+    cvReceived.wait_for(g, chrono::seconds(60),
+                        [numMsgs] { return latenciesInUs.size() >= numMsgs; });
+    latencies = latenciesInUs;
+  }
+
+  chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+  BOOST_CHECK_MESSAGE(latencies.size() == numMsgs,
+                      "Received " << latencies.size() << " of " << numMsgs
+                                  << " messages");
+
+  if (latencies.empty()) {
+    return;
+  }
+
+  sort(latencies.begin(), latencies.end());
+  double p99 = latencies.at(
+      min(latencies.size() - 1, (latencies.size() * 99) / 100));
+
+  LOG_GENERAL(INFO, (persistent ? "Pooled    " : "Per-message")
+                        << " connection, " << msgSize << " bytes x "
+                        << numMsgs << ": "
+                        << latencies.size() / elapsed.count() << " msgs/s, p99 "
+                        << p99 << " us");
+}
+
+BOOST_FIXTURE_TEST_SUITE(p2pcommbenchmark, Fixture)
+
+BOOST_AUTO_TEST_CASE(test_1KB_messages) {
+  RunBenchmark(false, 1024, 2000);
+  RunBenchmark(true, 1024, 2000);
+}
+
+BOOST_AUTO_TEST_CASE(test_1MB_messages) {
+  RunBenchmark(false, 1024 * 1024, 100);
+  RunBenchmark(true, 1024 * 1024, 100);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -50,7 +50,7 @@ BOOST_AUTO_TEST_CASE(test1) {
   Peer peer2 = ps.GetPeer(keypair1.second);
   BOOST_CHECK_MESSAGE(peer == peer2, "PeerStore AddPeer check #1 failed");
 
-  peer.m_ipAddress++;
+  peer.m_ipAddress = peer.m_ipAddress.GetHalf(1) + 1;
   peer.m_listenPortHost--;
   ps.AddPeerPair(keypair1.second, peer);
   BOOST_CHECK_MESSAGE(ps.GetPeerCount() == 1,
@@ -984,6 +984,43 @@ BOOST_AUTO_TEST_CASE(difficulty_adjustment_for_ds_large) {
   BOOST_REQUIRE(newDifficulty == 15);
 }
 
+BOOST_AUTO_TEST_CASE(cpu_mining_hashrate) {
+  POW& POWClient = POW::GetInstance();
+  std::array<unsigned char, 32> rand1 = {{'0', '1'}};
+  std::array<unsigned char, 32> rand2 = {{'0', '2'}};
+  boost::multiprecision::uint128_t ipAddr = 2307193356;
+  PubKey pubKey = Schnorr::GetInstance().GenKeyPair().second;
+  const auto duration = std::chrono::seconds(3);
+
+  // Single thread baseline
+  ethash_h256_t headerHash{};
+  uint64_t singleCount = 0;
+  auto start = std::chrono::steady_clock::now();
+  while (std::chrono::steady_clock::now() - start < duration) {
+    POWClient.LightHash(0, headerHash, singleCount++);
+  }
+  double singleRate = (double)singleCount / duration.count();
+
+  // Unreachable difficulty so that the miner runs until stopped
+  uint64_t countBefore = POWClient.GetCPUHashCount();
+  std::thread miner([&]() {
+    ethash_mining_result_t result = POWClient.PoWMine(
+        0, 255, rand1, rand2, ipAddr, pubKey, false);
+    BOOST_CHECK(!result.success);
+  });
+  std::this_thread::sleep_for(duration);
+  POWClient.StopMining();
+  miner.join();
+  double minerRate =
+      (double)(POWClient.GetCPUHashCount() - countBefore) / duration.count();
+
+  LOG_GENERAL(INFO, "Light hashrate: single thread "
+                        << singleRate << " H/s, miner with "
+                        << std::thread::hardware_concurrency()
+                        << " hardware threads " << minerRate << " H/s");
+  BOOST_CHECK(minerRate > 0);
+}
+
 #if 0 
 
 // Test of Full DAG creation with the minimal ethash.h API.
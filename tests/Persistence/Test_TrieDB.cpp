@@ -18,7 +18,9 @@
  */
 
 #include <leveldb/db.h>
+#include <chrono>
 #include <string>
+#include <thread>
 
 #include "depends/common/CommonIO.h"
 #include "depends/common/FixedHash.h"
@@ -126,4 +128,58 @@ BOOST_AUTO_TEST_CASE(retrieveDataStoredInTheTwoTrie) {
                       "ERROR: Trie4 cannot get the element in Trie2");
 }
 
+BOOST_AUTO_TEST_CASE(migrateHexNodeKeys) {
+  const string node = "a trie node longer than the hash keying it";
+  const h256 hash = sha3(node);
+  {
+    LevelDB db("migrateDB");
+    db.ResetDB();
+    db.Insert(hash.hex(), vector<unsigned char>(node.begin(), node.end()));
+  }
+
+  dev::OverlayDB m_db("migrateDB");
+  BOOST_CHECK_EQUAL(m_db.lookup(hash), node);
+  BOOST_CHECK(!m_db.levelDB().Exists(hash.hex()));
+}
+
+BOOST_AUTO_TEST_CASE(pruneUnreferencedNodes) {
+  // Pruning is off by default
+  const unsigned int keepRoots = 8;
+  dev::OverlayDB m_db("pruneDB", keepRoots);
+  m_db.ResetDB();
+
+  SecureTrieDB<h256, dev::OverlayDB> m_trie(&m_db);
+  m_trie.init();
+  const h256 kept(1), updated(2);
+  m_trie.insert(kept, string(40, 'k'));
+
+  auto value = [](unsigned int i) { return to_string(i) + string(40, 'v'); };
+  auto onDisk = [&m_db](const h256& node) {
+    return m_db.levelDB().Exists(string((const char*)node.data(), h256::size));
+  };
+
+  vector<h256> roots;
+  for (unsigned int i = 0; i < keepRoots + 2; i++) {
+    m_trie.insert(updated, value(i));
+    m_trie.db()->commit();
+    roots.emplace_back(m_trie.root());
+  }
+
+  // The roots replaced more than keepRoots commits ago go
+  // away in the background
+  for (unsigned int i = 0; i < 500 && (onDisk(roots[0]) || onDisk(roots[1]));
+       i++) {
+    this_thread::sleep_for(chrono::milliseconds(10));
+  }
+  BOOST_CHECK(!onDisk(roots[0]));
+  BOOST_CHECK(!onDisk(roots[1]));
+
+  for (unsigned int i = 2; i < roots.size(); i++) {
+    BOOST_REQUIRE(onDisk(roots[i]));
+    m_trie.setRoot(roots[i]);
+    BOOST_CHECK_EQUAL(m_trie.at(updated), value(i));
+    BOOST_CHECK_EQUAL(m_trie.at(kept), string(40, 'k'));
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -21,6 +21,7 @@
 #include <string>
 #include <vector>
 #include "common/Constants.h"
+#include "libData/AccountData/Account.h"
 #include "libCrypto/Schnorr.h"
 #include "libData/AccountData/Address.h"
 #include "libData/AccountData/Transaction.h"
@@ -171,4 +172,130 @@ BOOST_AUTO_TEST_CASE(testRandomBlockAccesses) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(testPutTxBodies) {
+  INIT_STDOUT_LOGGER();
+
+  LOG_MARKER();
+  if (LOOKUP_NODE_MODE) {
+    const unsigned int numTxns = 1000;
+    vector<TxnHash> hashes;
+    TxBodyBatch bodies;
+
+    for (unsigned int i = 0; i < numTxns; i++) {
+      TransactionWithReceipt body = constructDummyTxBody(100 + i);
+      hashes.emplace_back(body.GetTransaction().GetTranID());
+      bodies.emplace_back(hashes.back(), vector<unsigned char>());
+      body.Serialize(bodies.back().second, 0);
+    }
+
+    BOOST_CHECK(BlockStorage::GetBlockStorage().PutTxBodies(move(bodies)));
+
+    // Reads must see bodies still queued for the writer thread
+    for (const auto& hash : hashes) {
+      TxBodySharedPtr blockRetrieved;
+      BOOST_CHECK(
+          BlockStorage::GetBlockStorage().GetTxBody(hash, blockRetrieved));
+      BOOST_CHECK(blockRetrieved &&
+                  blockRetrieved->GetTransaction().GetTranID() == hash);
+    }
+
+    BlockStorage::GetBlockStorage().FlushTxBodies();
+    list<TxnHash> tmpHashes;
+    BlockStorage::GetBlockStorage().GetAllTxBodiesTmp(tmpHashes);
+    for (const auto& hash : hashes) {
+      BOOST_CHECK(find(tmpHashes.begin(), tmpHashes.end(), hash) !=
+                  tmpHashes.end());
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(testContractIndex) {
+  INIT_STDOUT_LOGGER();
+
+  LOG_MARKER();
+  if (LOOKUP_NODE_MODE) {
+    BlockStorage::GetBlockStorage().ResetDB(BlockStorage::CONTRACT_INDEX);
+
+    const KeyPair creatorKey = Schnorr::GetInstance().GenKeyPair();
+    const Address creator = Account::GetAddressFromPublicKey(creatorKey.second);
+    const vector<unsigned char> code = {'c', 'o', 'd', 'e'};
+
+    auto createContract = [&](unsigned int nonce, bool success) {
+      TransactionReceipt receipt;
+      receipt.SetResult(success);
+      receipt.update();
+      return TransactionWithReceipt(
+          Transaction(0, nonce, NullAddress, creatorKey, 0, 1, 2, code, {}),
+          receipt);
+    };
+
+    // Only successful creations are indexed, each once
+    vector<Address> expected;
+    for (unsigned int nonce = 1; nonce <= 25; nonce++) {
+      const bool success = (nonce % 5 != 0);
+      BOOST_CHECK(BlockStorage::GetBlockStorage().PutContractCreation(
+          createContract(nonce, success)));
+      if (success) {
+        expected.emplace_back(
+            Account::GetAddressForContract(creator, nonce - 1));
+      }
+    }
+    BOOST_CHECK(BlockStorage::GetBlockStorage().PutContractCreation(
+        createContract(1, true)));
+    BOOST_CHECK(BlockStorage::GetBlockStorage().PutContractCreation(
+        constructDummyTxBody(7)));
+
+    BOOST_CHECK_EQUAL(
+        BlockStorage::GetBlockStorage().GetNumContractsByCreator(creator),
+        expected.size());
+    BOOST_CHECK_EQUAL(
+        BlockStorage::GetBlockStorage().GetNumContractsByCreator(Address()),
+        0);
+
+    vector<Address> contracts;
+    BOOST_CHECK(BlockStorage::GetBlockStorage().GetContractsByCreator(
+        creator, 0, expected.size(), contracts));
+    BOOST_CHECK(contracts == expected);
+
+    // Pages past the end are cut short
+    contracts.clear();
+    BOOST_CHECK(BlockStorage::GetBlockStorage().GetContractsByCreator(
+        creator, 15, 10, contracts));
+    BOOST_CHECK(contracts ==
+                vector<Address>(expected.begin() + 15, expected.end()));
+
+    contracts.clear();
+    BOOST_CHECK(BlockStorage::GetBlockStorage().GetContractsByCreator(
+        creator, 100, 10, contracts));
+    BOOST_CHECK(contracts.empty());
+
+    // Bodies stored without being indexed are picked up by a rebuild, in
+    // creation order whatever order they are stored in
+    BlockStorage::GetBlockStorage().ResetDB(BlockStorage::CONTRACT_INDEX);
+    for (unsigned int nonce = 25; nonce >= 1; nonce--) {
+      const TransactionWithReceipt twr = createContract(nonce, nonce % 5 != 0);
+      vector<unsigned char> body;
+      twr.Serialize(body, 0);
+      BOOST_CHECK(BlockStorage::GetBlockStorage().PutTxBody(
+          twr.GetTransaction().GetTranID(), body));
+    }
+    BOOST_CHECK_EQUAL(
+        BlockStorage::GetBlockStorage().GetNumContractsByCreator(creator), 0);
+
+    BOOST_CHECK(BlockStorage::GetBlockStorage().BuildContractIndex());
+    contracts.clear();
+    BOOST_CHECK(BlockStorage::GetBlockStorage().GetContractsByCreator(
+        creator, 0, expected.size() + 1, contracts));
+    BOOST_CHECK(contracts == expected);
+
+    // Once built, the index is only extended by new creations
+    BOOST_CHECK(BlockStorage::GetBlockStorage().PutContractCreation(
+        createContract(26, true)));
+    BOOST_CHECK(BlockStorage::GetBlockStorage().BuildContractIndex());
+    BOOST_CHECK_EQUAL(
+        BlockStorage::GetBlockStorage().GetNumContractsByCreator(creator),
+        expected.size() + 1);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -331,4 +331,42 @@ BOOST_AUTO_TEST_CASE(testRetrieveAllTheTxBlocksInDB) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(testTxBlocksRangeInNumericOrder) {
+  INIT_STDOUT_LOGGER();
+
+  LOG_MARKER();
+
+  if (BlockStorage::GetBlockStorage().ResetDB(BlockStorage::DBTYPE::TX_BLOCK)) {
+    // Decimal keys would order 10 before 9
+    for (int i = 120; i >= 0; i--) {
+      std::vector<unsigned char> serializedTxBlock;
+      constructDummyTxBlock(i).Serialize(serializedTxBlock, 0);
+      BlockStorage::GetBlockStorage().PutTxBlock(i, serializedTxBlock);
+    }
+
+    std::vector<uint64_t> blockNums;
+    BOOST_CHECK(BlockStorage::GetBlockStorage().GetTxBlocks(
+        8, 101, [&blockNums](const TxBlockSharedPtr& block) {
+          blockNums.emplace_back(block->GetHeader().GetDSBlockNum());
+          return true;
+        }));
+
+    BOOST_CHECK_EQUAL(blockNums.size(), 94);
+    for (unsigned int i = 0; i < blockNums.size(); i++) {
+      BOOST_CHECK_EQUAL(blockNums[i], 8 + i);
+    }
+
+    // Stops as soon as the callback says so
+    unsigned int count = 0;
+    BlockStorage::GetBlockStorage().GetTxBlocks(
+        0, 120, [&count](const TxBlockSharedPtr&) { return ++count < 3; });
+    BOOST_CHECK_EQUAL(count, 3);
+
+    std::list<TxBlockSharedPtr> all_blocks;
+    BOOST_CHECK(BlockStorage::GetBlockStorage().GetAllTxBlocks(all_blocks));
+    BOOST_CHECK_EQUAL(all_blocks.size(), 121);
+    BOOST_CHECK_EQUAL(all_blocks.back()->GetHeader().GetDSBlockNum(), 120);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
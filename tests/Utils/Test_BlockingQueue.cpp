@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2018 Zilliqa
+ * This source code is being disclosed to you solely for the purpose of your
+ * participation in testing Zilliqa. You may view, compile and run the code for
+ * that purpose and pursuant to the protocols and algorithms that are programmed
+ * into, and intended by, the code. You may not do anything else with the code
+ * without express permission from Zilliqa Research Pte. Ltd., including
+ * modifying or publishing the code (or any part of it), and developing or
+ * forming another public or private blockchain network. This source code is
+ * provided 'as is' and no warranties are given as to title or non-infringement,
+ * merchantability or fitness for purpose and, to the extent permitted by law,
+ * all liability for your use of the code is disclaimed. Some programs in this
+ * code are governed by the GNU General Public License v3.0 (available at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html) ('GPLv3'). The programs that
+ * are governed by GPLv3.0 are those programs that are located in the folders
+ * src/depends and tests/depends and which include a reference to GPLv3 in their
+ * program files.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "libUtils/BlockingQueue.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE blockingqueue
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(blockingqueue)
+
+BOOST_AUTO_TEST_CASE(test_batch) {
+  INIT_STDOUT_LOGGER();
+
+  BlockingQueue<unsigned int> queue(16);
+  for (unsigned int i = 0; i < 10; i++) {
+    queue.Push(i);
+  }
+  BOOST_CHECK_EQUAL(queue.GetDepth(), 10);
+
+  vector<unsigned int> items;
+  BOOST_CHECK_EQUAL(queue.PopBatch(items, 4), 4);
+  BOOST_CHECK_EQUAL(queue.PopBatch(items, 100), 6);
+  BOOST_CHECK_EQUAL(queue.GetDepth(), 0);
+  for (unsigned int i = 0; i < 10; i++) {
+    BOOST_CHECK_EQUAL(items[i], i);
+  }
+
+  unsigned int item;
+  BOOST_CHECK(!queue.TryPopOne(item));
+}
+
+BOOST_AUTO_TEST_CASE(test_multi_producer_multi_consumer) {
+  INIT_STDOUT_LOGGER();
+
+  const unsigned int NUM_PRODUCERS = 4;
+  const unsigned int NUM_CONSUMERS = 3;
+  const unsigned int ITEMS_PER_PRODUCER = 20000;
+
+  BlockingQueue<unsigned int> queue(128);
+  atomic<uint64_t> sum(0);
+  atomic<unsigned int> received(0);
+
+  vector<thread> consumers;
+  for (unsigned int c = 0; c < NUM_CONSUMERS; c++) {
+    consumers.emplace_back([&]() {
+      vector<unsigned int> items;
+      while (true) {
+        items.clear();
+        queue.PopBatch(items, 32);
+        for (auto item : items) {
+          if (item == 0) {
+            return;
+          }
+          sum += item;
+          received++;
+        }
+      }
+    });
+  }
+
+  vector<thread> producers;
+  for (unsigned int p = 0; p < NUM_PRODUCERS; p++) {
+    producers.emplace_back([&]() {
+      for (unsigned int i = 1; i <= ITEMS_PER_PRODUCER; i++) {
+        queue.Push(i);
+      }
+    });
+  }
+  for (auto& t : producers) {
+    t.join();
+  }
+
+  // Give the consumers time to drain and fall asleep
+  this_thread::sleep_for(chrono::milliseconds(100));
+  BOOST_CHECK_EQUAL(received, NUM_PRODUCERS * ITEMS_PER_PRODUCER);
+  BOOST_CHECK_EQUAL(queue.GetDepth(), 0);
+
+  for (unsigned int c = 0; c < NUM_CONSUMERS; c++) {
+    queue.Push(0);
+  }
+  for (auto& t : consumers) {
+    t.join();
+  }
+
+  uint64_t expected = static_cast<uint64_t>(ITEMS_PER_PRODUCER) *
+                      (ITEMS_PER_PRODUCER + 1) / 2 * NUM_PRODUCERS;
+  BOOST_CHECK_EQUAL(sum, expected);
+  BOOST_CHECK_MESSAGE(queue.GetSleepCount() > 0,
+                      "Idle consumers should sleep instead of spinning");
+  LOG_GENERAL(INFO, "Consumers slept " << queue.GetSleepCount()
+                                       << " times for "
+                                       << queue.GetSleepTimeUs() << " us");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
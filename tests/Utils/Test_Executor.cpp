@@ -0,0 +1,267 @@
+/*
+ * Copyright (c) 2018 Zilliqa
+ * This source code is being disclosed to you solely for the purpose of your
+ * participation in testing Zilliqa. You may view, compile and run the code for
+ * that purpose and pursuant to the protocols and algorithms that are programmed
+ * into, and intended by, the code. You may not do anything else with the code
+ * without express permission from Zilliqa Research Pte. Ltd., including
+ * modifying or publishing the code (or any part of it), and developing or
+ * forming another public or private blockchain network. This source code is
+ * provided 'as is' and no warranties are given as to title or non-infringement,
+ * merchantability or fitness for purpose and, to the extent permitted by law,
+ * all liability for your use of the code is disclaimed. Some programs in this
+ * code are governed by the GNU General Public License v3.0 (available at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html) ('GPLv3'). The programs that
+ * are governed by GPLv3.0 are those programs that are located in the folders
+ * src/depends and tests/depends and which include a reference to GPLv3 in their
+ * program files.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "libUtils/Executor.h"
+#include "libUtils/Logger.h"
+#include "libUtils/ThreadPool.h"
+
+#define BOOST_TEST_MODULE executor
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+namespace {
+/// Polls until counter reaches target or timeout passes.
+bool WaitFor(const atomic<unsigned int>& counter, unsigned int target,
+             chrono::milliseconds timeout = chrono::seconds(5)) {
+  const auto deadline = chrono::steady_clock::now() + timeout;
+  while (counter < target) {
+    if (chrono::steady_clock::now() > deadline) {
+      return false;
+    }
+    this_thread::sleep_for(chrono::milliseconds(1));
+  }
+  return true;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(executor)
+
+BOOST_AUTO_TEST_CASE(test_submit_and_stats) {
+  INIT_STDOUT_LOGGER();
+
+  const unsigned int NUM_JOBS = 10000;
+
+  Executor executor(4);
+  atomic<unsigned int> done(0);
+
+  const auto start = chrono::steady_clock::now();
+  for (unsigned int i = 0; i < NUM_JOBS; i++) {
+    executor.Submit(Executor::TXN_INTAKE, [&done]() { done++; });
+  }
+  BOOST_REQUIRE(WaitFor(done, NUM_JOBS));
+  const auto elapsed = chrono::duration_cast<chrono::microseconds>(
+                           chrono::steady_clock::now() - start)
+                           .count();
+  LOG_GENERAL(INFO, NUM_JOBS << " jobs in " << elapsed << " us");
+
+  // Counters are updated just after each job returns
+  this_thread::sleep_for(chrono::milliseconds(10));
+  const auto stats = executor.GetLaneStats(Executor::TXN_INTAKE);
+  BOOST_CHECK_EQUAL(stats.m_submitted, NUM_JOBS);
+  BOOST_CHECK_EQUAL(stats.m_completed, NUM_JOBS);
+  BOOST_CHECK_EQUAL(executor.GetLaneStats(Executor::CONSENSUS).m_submitted, 0);
+  executor.LogStats();
+}
+
+BOOST_AUTO_TEST_CASE(test_priority) {
+  INIT_STDOUT_LOGGER();
+
+  Executor executor(1);
+
+  promise<void> release;
+  shared_future<void> released = release.get_future().share();
+  atomic<unsigned int> started(0);
+  executor.Submit(Executor::BLOCK_PROCESSING, [released, &started]() {
+    started++;
+    released.wait();
+  });
+  BOOST_REQUIRE(WaitFor(started, 1));
+
+  mutex mutexOrder;
+  vector<Executor::Lane> order;
+  atomic<unsigned int> done(0);
+  const Executor::Lane lanes[] = {Executor::BACKGROUND, Executor::TXN_INTAKE,
+                                  Executor::BLOCK_PROCESSING,
+                                  Executor::CONSENSUS};
+  for (unsigned int i = 0; i < 5; i++) {
+    for (auto lane : lanes) {
+      executor.Submit(lane, [lane, &mutexOrder, &order, &done]() {
+        lock_guard<mutex> g(mutexOrder);
+        order.emplace_back(lane);
+        done++;
+      });
+    }
+  }
+  release.set_value();
+  BOOST_REQUIRE(WaitFor(done, 20));
+
+  for (unsigned int i = 1; i < order.size(); i++) {
+    BOOST_CHECK_LE(order[i - 1], order[i]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_stealing) {
+  INIT_STDOUT_LOGGER();
+
+  const unsigned int NUM_CHILDREN = 200;
+
+  Executor executor(4);
+  mutex mutexThreads;
+  set<thread::id> threads;
+  atomic<unsigned int> done(0);
+  atomic<unsigned int> childrenDone(0);
+
+  // The children land on the parent's own deque while the parent blocks, so
+  // they only finish if other workers steal them
+  executor.Submit(Executor::BLOCK_PROCESSING, [&]() {
+    for (unsigned int i = 0; i < NUM_CHILDREN; i++) {
+      executor.Submit(Executor::BLOCK_PROCESSING, [&]() {
+        {
+          lock_guard<mutex> g(mutexThreads);
+          threads.insert(this_thread::get_id());
+        }
+        this_thread::sleep_for(chrono::microseconds(100));
+        childrenDone++;
+      });
+    }
+    WaitFor(childrenDone, NUM_CHILDREN);
+    done++;
+  });
+
+  BOOST_REQUIRE(WaitFor(done, 1));
+  BOOST_CHECK_EQUAL(childrenDone, NUM_CHILDREN);
+  LOG_GENERAL(INFO, "Children ran on " << threads.size() << " threads");
+  BOOST_CHECK_GT(threads.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_delayed) {
+  INIT_STDOUT_LOGGER();
+
+  Executor executor(2);
+  mutex mutexOrder;
+  vector<unsigned int> order;
+  atomic<unsigned int> done(0);
+
+  const auto start = chrono::steady_clock::now();
+  chrono::milliseconds firstElapsed(0);
+  executor.SubmitAfter(Executor::BACKGROUND, chrono::milliseconds(200), [&]() {
+    lock_guard<mutex> g(mutexOrder);
+    order.emplace_back(2);
+    done++;
+  });
+  executor.SubmitAfter(Executor::BACKGROUND, chrono::milliseconds(50), [&]() {
+    lock_guard<mutex> g(mutexOrder);
+    firstElapsed = chrono::duration_cast<chrono::milliseconds>(
+        chrono::steady_clock::now() - start);
+    order.emplace_back(1);
+    done++;
+  });
+
+  BOOST_REQUIRE(WaitFor(done, 2));
+  const auto elapsed = chrono::duration_cast<chrono::milliseconds>(
+      chrono::steady_clock::now() - start);
+
+  BOOST_CHECK_EQUAL(order[0], 1);
+  BOOST_CHECK_EQUAL(order[1], 2);
+  BOOST_CHECK_GE(firstElapsed.count(), 50);
+  BOOST_CHECK_GE(elapsed.count(), 200);
+}
+
+BOOST_AUTO_TEST_CASE(test_blocked_workers_compensated) {
+  INIT_STDOUT_LOGGER();
+
+  Executor executor(2);
+  promise<void> release;
+  shared_future<void> released = release.get_future().share();
+  atomic<unsigned int> blocked(0);
+  atomic<unsigned int> done(0);
+
+  for (unsigned int i = 0; i < 2; i++) {
+    executor.Submit(Executor::BACKGROUND, [released, &blocked, &done]() {
+      blocked++;
+      released.wait();
+      done++;
+    });
+  }
+  BOOST_REQUIRE(WaitFor(blocked, 2));
+
+  // Both workers are stuck, so this only runs on an extra worker
+  executor.Submit(Executor::CONSENSUS, [&done]() { done++; });
+  BOOST_CHECK(WaitFor(done, 1, chrono::seconds(2)));
+  BOOST_CHECK_GE(executor.GetNumExtraWorkers(), 1);
+
+  release.set_value();
+  BOOST_CHECK(WaitFor(done, 3));
+}
+
+BOOST_AUTO_TEST_CASE(test_long_running) {
+  INIT_STDOUT_LOGGER();
+
+  Executor executor(1);
+  promise<void> release;
+  shared_future<void> released = release.get_future().share();
+  atomic<unsigned int> looping(0);
+  atomic<unsigned int> done(0);
+
+  for (unsigned int i = 0; i < 4; i++) {
+    Executor::StartLongRunning([released, &looping]() {
+      looping++;
+      released.wait();
+    });
+  }
+  BOOST_REQUIRE(WaitFor(looping, 4));
+
+  // The loops have threads of their own, so the only worker is still free
+  executor.Submit(Executor::BACKGROUND, [&done]() { done++; });
+  BOOST_CHECK(WaitFor(done, 1, chrono::seconds(2)));
+  BOOST_CHECK_EQUAL(executor.GetNumExtraWorkers(), 0);
+
+  release.set_value();
+}
+
+BOOST_AUTO_TEST_CASE(test_threadpool) {
+  INIT_STDOUT_LOGGER();
+
+  ThreadPool pool(4, "TestPool");
+  atomic<unsigned int> done(0);
+  atomic<unsigned int> running(0);
+  atomic<unsigned int> maxRunning(0);
+
+  vector<ThreadPool::Job> jobs;
+  for (unsigned int i = 0; i < 100; i++) {
+    jobs.emplace_back([&done, &running, &maxRunning]() {
+      unsigned int now = ++running;
+      unsigned int seen = maxRunning;
+      while (now > seen && !maxRunning.compare_exchange_weak(seen, now)) {
+      }
+      this_thread::sleep_for(chrono::milliseconds(1));
+      running--;
+      done++;
+    });
+  }
+  pool.AddJobs(jobs);
+  pool.AddJob([&done]() { done++; });
+  pool.WaitAll();
+
+  BOOST_CHECK_EQUAL(done, 101);
+  BOOST_CHECK_EQUAL(pool.GetNumThreads(), 4);
+  BOOST_CHECK_LE(maxRunning, 4);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
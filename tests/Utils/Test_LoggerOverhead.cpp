@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2018 Zilliqa
+ * This source code is being disclosed to you solely for the purpose of your
+ * participation in testing Zilliqa. You may view, compile and run the code for
+ * that purpose and pursuant to the protocols and algorithms that are programmed
+ * into, and intended by, the code. You may not do anything else with the code
+ * without express permission from Zilliqa Research Pte. Ltd., including
+ * modifying or publishing the code (or any part of it), and developing or
+ * forming another public or private blockchain network. This source code is
+ * provided 'as is' and no warranties are given as to title or non-infringement,
+ * merchantability or fitness for purpose and, to the extent permitted by law,
+ * all liability for your use of the code is disclaimed. Some programs in this
+ * code are governed by the GNU General Public License v3.0 (available at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html) ('GPLv3'). The programs that
+ * are governed by GPLv3.0 are those programs that are located in the folders
+ * src/depends and tests/depends and which include a reference to GPLv3 in their
+ * program files.
+ */
+
+#include <chrono>
+#include <string>
+
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE loggeroverhead
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+namespace {
+double NanosecondsPerCall(chrono::steady_clock::time_point start,
+                          unsigned int calls) {
+  return chrono::duration<double, nano>(chrono::steady_clock::now() - start)
+             .count() /
+         calls;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(loggeroverhead)
+
+BOOST_AUTO_TEST_CASE(test_disabled_and_enabled_calls) {
+  INIT_FILE_LOGGER("overhead");
+
+  const unsigned int DISABLED_CALLS = 10000000;
+  const unsigned int ENABLED_CALLS = 100000;
+  const string text = "payload";
+
+  LOG_DISPLAY_LEVEL_ABOVE(WARNING);
+  BOOST_CHECK(!LOG_ENABLED(INFO));
+  BOOST_CHECK(LOG_ENABLED(WARNING));
+
+  auto start = chrono::steady_clock::now();
+  for (unsigned int i = 0; i < DISABLED_CALLS; i++) {
+    LOG_GENERAL(INFO, "Disabled call " << i << " " << text);
+  }
+  const double disabledNs = NanosecondsPerCall(start, DISABLED_CALLS);
+
+  start = chrono::steady_clock::now();
+  for (unsigned int i = 0; i < DISABLED_CALLS; i++) {
+    LOG_MARKER();
+  }
+  const double markerNs = NanosecondsPerCall(start, DISABLED_CALLS);
+
+  LOG_DISPLAY_LEVEL_ABOVE(INFO);
+  start = chrono::steady_clock::now();
+  for (unsigned int i = 0; i < ENABLED_CALLS; i++) {
+    LOG_GENERAL(INFO, "Enabled call " << i << " " << text);
+  }
+  const double enabledNs = NanosecondsPerCall(start, ENABLED_CALLS);
+
+  start = chrono::steady_clock::now();
+  Logger::Flush();
+  const double flushMs =
+      chrono::duration<double, milli>(chrono::steady_clock::now() - start)
+          .count();
+
+  LOG_GENERAL(INFO, "Disabled LOG_GENERAL: " << disabledNs << " ns/call");
+  LOG_GENERAL(INFO, "Disabled LOG_MARKER: " << markerNs << " ns/call");
+  LOG_GENERAL(INFO, "Enabled LOG_GENERAL: " << enabledNs << " ns/call");
+  LOG_GENERAL(INFO, "Writer drained the backlog in " << flushMs << " ms");
+
+  // A disabled call is one relaxed load and a branch
+  BOOST_CHECK_LT(disabledNs, 20.0);
+  BOOST_CHECK_LT(markerNs, 20.0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
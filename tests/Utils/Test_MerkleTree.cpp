@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2018 Zilliqa
+ * This source code is being disclosed to you solely for the purpose of your
+ * participation in testing Zilliqa. You may view, compile and run the code for
+ * that purpose and pursuant to the protocols and algorithms that are programmed
+ * into, and intended by, the code. You may not do anything else with the code
+ * without express permission from Zilliqa Research Pte. Ltd., including
+ * modifying or publishing the code (or any part of it), and developing or
+ * forming another public or private blockchain network. This source code is
+ * provided 'as is' and no warranties are given as to title or non-infringement,
+ * merchantability or fitness for purpose and, to the extent permitted by law,
+ * all liability for your use of the code is disclaimed. Some programs in this
+ * code are governed by the GNU General Public License v3.0 (available at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html) ('GPLv3'). The programs that
+ * are governed by GPLv3.0 are those programs that are located in the folders
+ * src/depends and tests/depends and which include a reference to GPLv3 in their
+ * program files.
+ */
+
+#include "libCrypto/Sha2.h"
+#include "libUtils/Logger.h"
+#include "libUtils/MerkleTree.h"
+
+#include <vector>
+
+#define BOOST_TEST_MODULE merkletree
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+using namespace dev;
+
+BOOST_AUTO_TEST_SUITE(merkletree)
+
+vector<h256> generateLeaves(unsigned int n) {
+  vector<h256> leaves;
+
+  for (unsigned int i = 0; i < n; i++) {
+    SHA2<HASH_TYPE::HASH_VARIANT_256> sha2;
+    sha2.Update({(unsigned char)(i & 0xFF), (unsigned char)(i >> 8)});
+    leaves.emplace_back(sha2.Finalize());
+  }
+
+  return leaves;
+}
+
+BOOST_AUTO_TEST_CASE(test_empty) {
+  INIT_STDOUT_LOGGER();
+
+  MerkleTree tree;
+  MerkleProof proof;
+
+  BOOST_CHECK_EQUAL(tree.GetRoot(), h256());
+  BOOST_CHECK_EQUAL(MerkleTree::ComputeRoot(vector<h256>()), h256());
+  BOOST_CHECK(!tree.GetInclusionProof(0, proof));
+}
+
+BOOST_AUTO_TEST_CASE(test_inclusion_proofs) {
+  INIT_STDOUT_LOGGER();
+
+  for (unsigned int n : {1, 2, 3, 4, 5, 7, 8, 9, 16, 33, 100}) {
+    auto leaves = generateLeaves(n);
+    MerkleTree tree(leaves);
+    h256 root = tree.GetRoot();
+
+    BOOST_CHECK_EQUAL(root, MerkleTree::ComputeRoot(leaves));
+    BOOST_CHECK_EQUAL(tree.GetLeafCount(), n);
+
+    for (unsigned int i = 0; i < n; i++) {
+      MerkleProof proof;
+      BOOST_CHECK(tree.GetInclusionProof(i, proof));
+      BOOST_CHECK_MESSAGE(
+          MerkleTree::VerifyInclusionProof(root, leaves[i], proof),
+          "Valid proof rejected for leaf " << i << " of " << n);
+
+      // Wrong leaf
+      BOOST_CHECK(!MerkleTree::VerifyInclusionProof(
+          root, leaves[(i + 1) % n] ^ h256(1), proof));
+
+      if (!proof.m_siblings.empty()) {
+        // Tampered sibling
+        MerkleProof tampered = proof;
+        tampered.m_siblings.back() ^= h256(1);
+        BOOST_CHECK(!MerkleTree::VerifyInclusionProof(root, leaves[i],
+                                                      tampered));
+
+        // Truncated path
+        tampered = proof;
+        tampered.m_siblings.pop_back();
+        BOOST_CHECK(!MerkleTree::VerifyInclusionProof(root, leaves[i],
+                                                      tampered));
+      }
+
+      if (n > 1) {
+        // Wrong position
+        MerkleProof moved = proof;
+        moved.m_index = (i + 1) % n;
+        BOOST_CHECK(!MerkleTree::VerifyInclusionProof(root, leaves[i], moved));
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_proof_by_leaf) {
+  INIT_STDOUT_LOGGER();
+
+  auto leaves = generateLeaves(10);
+  MerkleTree tree(leaves);
+  MerkleProof proof;
+
+  BOOST_CHECK(tree.GetInclusionProof(leaves[6], proof));
+  BOOST_CHECK_EQUAL(proof.m_index, 6);
+  BOOST_CHECK(!tree.GetInclusionProof(h256(), proof));
+}
+
+BOOST_AUTO_TEST_CASE(test_update_leaf) {
+  INIT_STDOUT_LOGGER();
+
+  for (unsigned int n : {1, 2, 5, 12, 31}) {
+    auto leaves = generateLeaves(n);
+    MerkleTree tree(leaves);
+
+    for (unsigned int i = 0; i < n; i += 2) {
+      leaves[i] = generateLeaves(n + i + 1).back();
+      BOOST_CHECK(tree.UpdateLeaf(i, leaves[i]));
+      BOOST_CHECK_EQUAL(tree.GetRoot(), MerkleTree::ComputeRoot(leaves));
+
+      MerkleProof proof;
+      BOOST_CHECK(tree.GetInclusionProof(i, proof));
+      BOOST_CHECK(
+          MerkleTree::VerifyInclusionProof(tree.GetRoot(), leaves[i], proof));
+    }
+
+    BOOST_CHECK(!tree.UpdateLeaf(n, h256()));
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2018 Zilliqa
+ * This source code is being disclosed to you solely for the purpose of your
+ * participation in testing Zilliqa. You may view, compile and run the code for
+ * that purpose and pursuant to the protocols and algorithms that are programmed
+ * into, and intended by, the code. You may not do anything else with the code
+ * without express permission from Zilliqa Research Pte. Ltd., including
+ * modifying or publishing the code (or any part of it), and developing or
+ * forming another public or private blockchain network. This source code is
+ * provided 'as is' and no warranties are given as to title or non-infringement,
+ * merchantability or fitness for purpose and, to the extent permitted by law,
+ * all liability for your use of the code is disclaimed. Some programs in this
+ * code are governed by the GNU General Public License v3.0 (available at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html) ('GPLv3'). The programs that
+ * are governed by GPLv3.0 are those programs that are located in the folders
+ * src/depends and tests/depends and which include a reference to GPLv3 in their
+ * program files.
+ */
+
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "libUtils/Logger.h"
+#include "libUtils/TxnFileStore.h"
+
+#define BOOST_TEST_MODULE txnfilestore
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+namespace {
+/// Writes size bytes counting up from first to a fresh temporary file.
+string WriteTempFile(size_t size, unsigned char first = 0) {
+  auto path = boost::filesystem::temp_directory_path() /
+              boost::filesystem::unique_path("txnfilestore-%%%%%%%%.zil");
+
+  vector<unsigned char> content(size);
+  for (size_t i = 0; i < size; i++) {
+    content[i] = static_cast<unsigned char>(first + i);
+  }
+
+  ofstream file(path.string(), ios::binary);
+  file.write(reinterpret_cast<const char*>(content.data()), content.size());
+  return path.string();
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(txnfilestore)
+
+BOOST_AUTO_TEST_CASE(test_slices) {
+  INIT_STDOUT_LOGGER();
+
+  auto& store = TxnFileStore::GetInstance();
+  const string path = WriteTempFile(1000);
+
+  auto file = store.GetFile(path);
+  BOOST_REQUIRE_EQUAL(file.size(), 1000);
+
+  // The file is only mapped once
+  BOOST_CHECK(store.GetFile(path).data() == file.data());
+
+  auto slice = store.GetSlice(path, 100, 50);
+  BOOST_REQUIRE_EQUAL(slice.size(), 50);
+  BOOST_CHECK(slice.data() == file.data() + 100);
+  for (size_t i = 0; i < slice.size(); i++) {
+    BOOST_CHECK_EQUAL(slice[i], static_cast<unsigned char>(100 + i));
+  }
+
+  BOOST_CHECK_EQUAL(store.GetSlice(path, 950, 50).size(), 50);
+  BOOST_CHECK(store.GetSlice(path, 950, 51).empty());
+  BOOST_CHECK(store.GetSlice(path, 1001, 0).empty());
+
+  store.Clear();
+  boost::filesystem::remove(path);
+}
+
+BOOST_AUTO_TEST_CASE(test_release) {
+  INIT_STDOUT_LOGGER();
+
+  auto& store = TxnFileStore::GetInstance();
+  const string path = WriteTempFile(100);
+
+  BOOST_REQUIRE_EQUAL(store.GetFile(path).size(), 100);
+  BOOST_CHECK(store.Release(path));
+  BOOST_CHECK(!store.Release(path));
+
+  // A released file is mapped again on next use
+  auto slice = store.GetSlice(path, 10, 5);
+  BOOST_REQUIRE_EQUAL(slice.size(), 5);
+  BOOST_CHECK_EQUAL(slice[0], 10);
+
+  store.Clear();
+  boost::filesystem::remove(path);
+}
+
+BOOST_AUTO_TEST_CASE(test_missing_and_empty_files) {
+  INIT_STDOUT_LOGGER();
+
+  auto& store = TxnFileStore::GetInstance();
+
+  BOOST_CHECK(store.GetFile("/nonexistent/txnfilestore.zil").empty());
+  BOOST_CHECK(store.GetSlice("/nonexistent/txnfilestore.zil", 0, 1).empty());
+
+  const string path = WriteTempFile(0);
+  BOOST_CHECK(store.GetFile(path).empty());
+
+  store.Clear();
+  boost::filesystem::remove(path);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
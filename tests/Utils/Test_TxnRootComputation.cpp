@@ -16,10 +16,12 @@
  * src/depends and tests/depends and which include a reference to GPLv3 in their
  * program files.
  */
+#include "common/Constants.h"
 #include "common/Serializable.h"
 #include "libCrypto/Schnorr.h"
 #include "libCrypto/Sha2.h"
 #include "libData/AccountData/Transaction.h"
+#include "libUtils/MerkleTree.h"
 #include "libUtils/TxnRootComputation.h"
 
 #include <boost/multiprecision/cpp_int.hpp>
@@ -73,12 +75,47 @@ BOOST_AUTO_TEST_CASE(compareAllThreeVersions) {
     txnList2.emplace_back(txnPair.second);
   }
 
-  auto hashRoot1 = ComputeTransactionsRoot(txnHashVec);
-  auto hashRoot2 = ComputeTransactionsRoot(txnList1, txnList2);
-  auto hashRoot3 = ComputeTransactionsRoot(txnMap1, txnMap2);
+  auto hashRoot1 = ComputeTransactionsRoot(txnHashVec, 0);
+  auto hashRoot2 = ComputeTransactionsRoot(txnList1, txnList2, 0);
+  auto hashRoot3 = ComputeTransactionsRoot(txnMap1, txnMap2, 0);
 
   BOOST_CHECK_EQUAL(hashRoot1, hashRoot2);
   BOOST_CHECK_EQUAL(hashRoot1, hashRoot3);
 }
 
+BOOST_AUTO_TEST_CASE(switchToMerkleRoots) {
+  std::vector<TxnHash> txnHashVec;
+  for (auto& txnPair : generateDummyTransactions(10)) {
+    txnHashVec.emplace_back(txnPair.first);
+  }
+
+  SHA2<HASH_TYPE::HASH_VARIANT_256> sha2;
+  for (const auto& hash : txnHashVec) {
+    sha2.Update(hash.asBytes());
+  }
+  const TxnHash legacyRoot(sha2.Finalize());
+  const TxnHash merkleRoot(MerkleTree::ComputeRoot(txnHashVec));
+  BOOST_REQUIRE(legacyRoot != merkleRoot);
+
+  const bool merkleEnabled = ROOT_HASH_VERSION >= MERKLE_ROOT_HASH_VERSION;
+  BOOST_TEST_MESSAGE("Merkle roots " << (merkleEnabled ? "from" : "off at")
+                                     << " block " << ROOT_HASH_VERSION_EPOCH);
+
+  // Just before the switch-over the legacy root is kept
+  if (ROOT_HASH_VERSION_EPOCH > 0) {
+    const uint64_t blockNum = ROOT_HASH_VERSION_EPOCH - 1;
+    BOOST_CHECK(!IsMerkleRootBlock(blockNum));
+    BOOST_CHECK_EQUAL(ComputeTransactionsRoot(txnHashVec, blockNum),
+                      legacyRoot);
+  }
+
+  // From the switch-over on, the root is the Merkle root if enabled
+  for (uint64_t blockNum : {uint64_t(ROOT_HASH_VERSION_EPOCH),
+                            uint64_t(ROOT_HASH_VERSION_EPOCH + 1)}) {
+    BOOST_CHECK_EQUAL(IsMerkleRootBlock(blockNum), merkleEnabled);
+    BOOST_CHECK_EQUAL(ComputeTransactionsRoot(txnHashVec, blockNum),
+                      merkleEnabled ? merkleRoot : legacyRoot);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -66,4 +66,33 @@ BOOST_AUTO_TEST_CASE(fat_trie) {
   LOG_GENERAL(INFO, m_testDB.Lookup((boost::multiprecision::uint256_t)3));
 }
 
+BOOST_AUTO_TEST_CASE(block_num_key_migration) {
+  INIT_STDOUT_LOGGER();
+
+  LOG_MARKER();
+
+  LevelDB m_testDB("testMigration");
+  m_testDB.ResetDB();
+
+  // Keys as written before the big-endian encoding
+  for (uint64_t i = 0; i < 25; i++) {
+    m_testDB.Insert(to_string(i), std::vector<unsigned char>{(unsigned char)i});
+  }
+
+  BOOST_CHECK_EQUAL(m_testDB.MigrateBlockNumKeys(), 25);
+  BOOST_CHECK_EQUAL(m_testDB.MigrateBlockNumKeys(), 0);
+
+  uint64_t expected = 0;
+  std::unique_ptr<leveldb::Iterator> it(
+      m_testDB.GetDB()->NewIterator(leveldb::ReadOptions()));
+  for (it->SeekToFirst(); it->Valid(); it->Next(), expected++) {
+    BOOST_CHECK_EQUAL(LevelDB::KeyToBlockNum(it->key()), expected);
+    BOOST_CHECK_EQUAL((unsigned char)it->value()[0], expected);
+  }
+  BOOST_CHECK_EQUAL(expected, 25);
+
+  BOOST_CHECK_EQUAL(m_testDB.Lookup((boost::multiprecision::uint256_t)17),
+                    string(1, (char)17));
+}
+
 BOOST_AUTO_TEST_SUITE_END()